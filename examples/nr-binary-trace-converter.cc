@@ -0,0 +1,52 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+/**
+ * \file nr-binary-trace-converter.cc
+ * \ingroup examples
+ * \brief Converter of the binary NR traces
+ *
+ * This program converts a trace written by NrPhyRxTrace or NrMacSchedulingStats with the
+ * attribute TraceFormat set to BINARY into the text trace that the same sink writes with
+ * TraceFormat set to TEXT:
+ *
+ * \code{.unparsed}
+$ ./ns3 run "nr-binary-trace-converter --input=RxPacketTrace.bin --output=RxPacketTrace.txt"
+    \endcode
+ *
+ * If no output file is given, the text trace is written to the standard output.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/nr-binary-trace.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "The binary trace file to convert", input);
+    cmd.AddValue("output", "The text trace file to write (default: standard output)", output);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(input.empty(), "The input file must be given with --input");
+
+    if (output.empty())
+    {
+        NrBinaryTraceReader::ConvertToText(input, std::cout);
+        return 0;
+    }
+
+    std::ofstream os(output);
+    NS_ABORT_MSG_IF(!os.is_open(), "Could not open " << output);
+    NrBinaryTraceReader::ConvertToText(input, os);
+    return 0;
+}
@@ -6,6 +6,8 @@
 
 #include "hexagonal-grid-scenario-helper.h"
 
+#include "nr-spatial-index.h"
+
 #include "ns3/constant-velocity-mobility-model.h"
 #include <ns3/double.h>
 #include <ns3/mobility-helper.h>
@@ -260,30 +262,6 @@ PlotHexagonalDeployment(const Ptr<const ListPositionAllocator>& sitePosVector,
     topologyOutfile << "plot 1/0" << std::endl;  //!< Need to plot a function
 }
 
-static Vector
-GetClosestSitePosition(Vector cellCenterPos, const Ptr<ListPositionAllocator>& sitePosVector)
-{
-    double minDistance = UINT32_MAX;
-    Vector closestSitePosition;
-
-    for (uint32_t i = 0; i < sitePosVector->GetSize(); i++)
-    {
-        Vector sitePos = sitePosVector->GetNext();
-        double d_x = sitePos.x - cellCenterPos.x;
-        double d_y = sitePos.y - cellCenterPos.y;
-        double distance2D = sqrt(d_x * d_x + d_y * d_y);
-        if (distance2D < minDistance)
-        {
-            minDistance = distance2D;
-            closestSitePosition = sitePos;
-        }
-    }
-
-    NS_ABORT_MSG_IF(minDistance == UINT32_MAX,
-                    "Get closest site position function not executed properly.");
-    return closestSitePosition;
-}
-
 void
 HexagonalGridScenarioHelper::SetNumRings(uint8_t numRings)
 {
@@ -498,6 +476,8 @@ HexagonalGridScenarioHelper::CreateScenarioWithMobility(const Vector& speed, dou
     Ptr<ListPositionAllocator> bsCenterVector = CreateObject<ListPositionAllocator>();
     Ptr<ListPositionAllocator> sitePosVector = CreateObject<ListPositionAllocator>();
     Ptr<ListPositionAllocator> utPosVector = CreateObject<ListPositionAllocator>();
+    std::vector<Vector> sitePositions;
+    std::vector<Vector> cellCenterPositions;
 
     // BS position
     for (std::size_t cellId = 0; cellId < m_numBs; cellId++)
@@ -513,6 +493,7 @@ HexagonalGridScenarioHelper::CreateScenarioWithMobility(const Vector& speed, dou
         if (GetSectorIndex(cellId) == 0)
         {
             sitePosVector->Add(sitePos);
+            sitePositions.push_back(sitePos);
         }
 
         // FIXME: Until sites can have more than one antenna array, it is necessary to apply some
@@ -524,10 +505,20 @@ HexagonalGridScenarioHelper::CreateScenarioWithMobility(const Vector& speed, dou
         // Store cell center position for plotting the deployment
         Vector cellCenterPos = GetHexagonalCellCenter(bsPos, cellId);
         bsCenterVector->Add(cellCenterPos);
+        cellCenterPositions.push_back(cellCenterPos);
 
         // What about the antenna orientation? It should be dealt with when installing the gNB
     }
 
+    // The closest site of each cell, for the UEs of the cell
+    const NrSpatialIndex siteIndex(sitePositions, true);
+    std::vector<Vector> closestSitePositions;
+    closestSitePositions.reserve(cellCenterPositions.size());
+    for (const auto& cellCenterPos : cellCenterPositions)
+    {
+        closestSitePositions.push_back(sitePositions.at(siteIndex.FindNearest(cellCenterPos)));
+    }
+
     // To allocate UEs, I need the center of the hexagonal cell.
     // Allocate UE around the disk of radius isd/3, the diameter of a the
     // hexagon representing the footprint of a single sector.
@@ -558,7 +549,8 @@ HexagonalGridScenarioHelper::CreateScenarioWithMobility(const Vector& speed, dou
         Vector cellCenterPos = bsCenterVector->GetNext();
         Vector utPos;
 
-        Vector closestSitePosition = GetClosestSitePosition(cellCenterPos, sitePosVector);
+        // The UEs are distributed among the cells in the order of bsCenterVector
+        const Vector& closestSitePosition = closestSitePositions.at(utId % m_numBs);
 
         double distance2DToClosestSite = 0;
 
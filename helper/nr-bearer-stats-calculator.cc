@@ -12,6 +12,7 @@
 #include <ns3/log.h>
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace ns3
@@ -93,6 +94,8 @@ NrBearerStatsCalculator::DoDispose()
     {
         ShowResults();
     }
+    m_ulOutFile.close();
+    m_dlOutFile.close();
 }
 
 void
@@ -121,6 +124,109 @@ NrBearerStatsCalculator::GetEpoch() const
     return m_epochDuration;
 }
 
+void
+NrBearerStatsCalculator::StreamingStats::Update(double value)
+{
+    // Same computation as MinMaxAvgTotalCalculator::Update
+    m_count++;
+    if (m_count == 1)
+    {
+        m_min = value;
+        m_max = value;
+        m_mean = value;
+        m_s = 0;
+        return;
+    }
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    const double prevMean = m_mean;
+    m_mean = prevMean + (value - prevMean) / m_count;
+    m_s += (value - prevMean) * (value - m_mean);
+}
+
+std::vector<double>
+NrBearerStatsCalculator::StreamingStats::GetStats() const
+{
+    if (m_count == 0)
+    {
+        return {0.0, 0.0, 0.0, 0.0};
+    }
+    const double variance = m_count > 1 ? m_s / (m_count - 1) : 0.0;
+    return {m_mean, std::sqrt(variance), m_min, m_max};
+}
+
+void
+NrBearerStatsCalculator::DirectionStats::AddFlow()
+{
+    m_cellId.push_back(0);
+    m_txPackets.push_back(0);
+    m_rxPackets.push_back(0);
+    m_txData.push_back(0);
+    m_rxData.push_back(0);
+    m_delay.emplace_back();
+    m_pduSize.emplace_back();
+}
+
+void
+NrBearerStatsCalculator::DirectionStats::ResetEpoch()
+{
+    std::fill(m_txPackets.begin(), m_txPackets.end(), 0);
+    std::fill(m_rxPackets.begin(), m_rxPackets.end(), 0);
+    std::fill(m_txData.begin(), m_txData.end(), 0);
+    std::fill(m_rxData.begin(), m_rxData.end(), 0);
+    std::fill(m_delay.begin(), m_delay.end(), StreamingStats());
+    std::fill(m_pduSize.begin(), m_pduSize.end(), StreamingStats());
+}
+
+/**
+ * \brief Key of a flow in the index of the flows
+ * \param imsi the IMSI
+ * \param lcid the LCID
+ * \return the key
+ */
+static uint64_t
+GetFlowKey(uint64_t imsi, uint8_t lcid)
+{
+    NS_ASSERT_MSG(imsi < (uint64_t{1} << 56), "IMSI " << imsi << " is too large");
+    return (imsi << 8) | lcid;
+}
+
+uint32_t
+NrBearerStatsCalculator::GetFlowIndex(uint64_t imsi, uint8_t lcid)
+{
+    const auto [it, inserted] =
+        m_flowIndex.emplace(GetFlowKey(imsi, lcid), static_cast<uint32_t>(m_flows.size()));
+    if (inserted)
+    {
+        NS_LOG_DEBUG(this << " Adding flow of IMSI " << imsi << " and LCID " << (uint32_t)lcid);
+        const ImsiLcidPair_t p(imsi, lcid);
+        m_flows.push_back(p);
+        m_flowRnti.push_back(0);
+        m_ulStats.AddFlow();
+        m_dlStats.AddFlow();
+        auto pos = std::lower_bound(m_sortedFlows.begin(),
+                                    m_sortedFlows.end(),
+                                    p,
+                                    [this](uint32_t index, const ImsiLcidPair_t& pair) {
+                                        return m_flows[index] < pair;
+                                    });
+        m_sortedFlows.insert(pos, it->second);
+    }
+    return it->second;
+}
+
+bool
+NrBearerStatsCalculator::FindFlowIndex(uint64_t imsi, uint8_t lcid, uint32_t& index) const
+{
+    auto it = m_flowIndex.find(GetFlowKey(imsi, lcid));
+    if (it == m_flowIndex.end())
+    {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
 void
 NrBearerStatsCalculator::UlTxPdu(uint16_t cellId,
                                  uint64_t imsi,
@@ -130,13 +236,13 @@ NrBearerStatsCalculator::UlTxPdu(uint16_t cellId,
 {
     NS_LOG_FUNCTION(this);
 
-    ImsiLcidPair_t p(imsi, lcid);
     if (Simulator::Now() >= m_startTime)
     {
-        m_ulCellId[p] = cellId;
-        m_flowId[p] = LteFlowId_t(rnti, lcid);
-        m_ulTxPackets[p]++;
-        m_ulTxData[p] += packetSize;
+        const auto index = GetFlowIndex(imsi, lcid);
+        m_ulStats.m_cellId[index] = cellId;
+        m_flowRnti[index] = rnti;
+        m_ulStats.m_txPackets[index]++;
+        m_ulStats.m_txData[index] += packetSize;
     }
     m_pendingOutput = true;
 }
@@ -150,13 +256,13 @@ NrBearerStatsCalculator::DlTxPdu(uint16_t cellId,
 {
     NS_LOG_FUNCTION(this);
 
-    ImsiLcidPair_t p(imsi, lcid);
     if (Simulator::Now() >= m_startTime)
     {
-        m_dlCellId[p] = cellId;
-        m_flowId[p] = LteFlowId_t(rnti, lcid);
-        m_dlTxPackets[p]++;
-        m_dlTxData[p] += packetSize;
+        const auto index = GetFlowIndex(imsi, lcid);
+        m_dlStats.m_cellId[index] = cellId;
+        m_flowRnti[index] = rnti;
+        m_dlStats.m_txPackets[index]++;
+        m_dlStats.m_txData[index] += packetSize;
     }
     m_pendingOutput = true;
 }
@@ -171,23 +277,14 @@ NrBearerStatsCalculator::UlRxPdu(uint16_t cellId,
 {
     NS_LOG_FUNCTION(this);
 
-    ImsiLcidPair_t p(imsi, lcid);
     if (Simulator::Now() >= m_startTime)
     {
-        m_ulCellId[p] = cellId;
-        m_ulRxPackets[p]++;
-        m_ulRxData[p] += packetSize;
-
-        Uint64StatsMap::iterator it = m_ulDelay.find(p);
-        if (it == m_ulDelay.end())
-        {
-            NS_LOG_DEBUG(this << " Creating UL stats calculators for IMSI " << p.m_imsi
-                              << " and LCID " << (uint32_t)p.m_lcId);
-            m_ulDelay[p] = CreateObject<MinMaxAvgTotalCalculator<uint64_t>>();
-            m_ulPduSize[p] = CreateObject<MinMaxAvgTotalCalculator<uint32_t>>();
-        }
-        m_ulDelay[p]->Update(delay);
-        m_ulPduSize[p]->Update(packetSize);
+        const auto index = GetFlowIndex(imsi, lcid);
+        m_ulStats.m_cellId[index] = cellId;
+        m_ulStats.m_rxPackets[index]++;
+        m_ulStats.m_rxData[index] += packetSize;
+        m_ulStats.m_delay[index].Update(delay);
+        m_ulStats.m_pduSize[index].Update(packetSize);
     }
     m_pendingOutput = true;
 }
@@ -202,23 +299,14 @@ NrBearerStatsCalculator::DlRxPdu(uint16_t cellId,
 {
     NS_LOG_FUNCTION(this);
 
-    ImsiLcidPair_t p(imsi, lcid);
     if (Simulator::Now() >= m_startTime)
     {
-        m_dlCellId[p] = cellId;
-        m_dlRxPackets[p]++;
-        m_dlRxData[p] += packetSize;
-
-        Uint64StatsMap::iterator it = m_dlDelay.find(p);
-        if (it == m_dlDelay.end())
-        {
-            NS_LOG_DEBUG(this << " Creating DL stats calculators for IMSI " << p.m_imsi
-                              << " and LCID " << (uint32_t)p.m_lcId);
-            m_dlDelay[p] = CreateObject<MinMaxAvgTotalCalculator<uint64_t>>();
-            m_dlPduSize[p] = CreateObject<MinMaxAvgTotalCalculator<uint32_t>>();
-        }
-        m_dlDelay[p]->Update(delay);
-        m_dlPduSize[p]->Update(packetSize);
+        const auto index = GetFlowIndex(imsi, lcid);
+        m_dlStats.m_cellId[index] = cellId;
+        m_dlStats.m_rxPackets[index]++;
+        m_dlStats.m_rxData[index] += packetSize;
+        m_dlStats.m_delay[index].Update(delay);
+        m_dlStats.m_pduSize[index].Update(packetSize);
     }
     m_pendingOutput = true;
 }
@@ -230,145 +318,92 @@ NrBearerStatsCalculator::ShowResults()
     NS_LOG_INFO("Write bearer stats to " << GetUlOutputFilename().c_str() << " and in "
                                          << GetDlOutputFilename().c_str());
 
-    std::ofstream ulOutFile;
-    std::ofstream dlOutFile;
-
+    // The files are kept open between the epochs, so that they are written in the background
+    // by NrTraceIoService
     if (m_firstWrite)
     {
-        ulOutFile.open(GetUlOutputFilename().c_str());
-        if (!ulOutFile.is_open())
+        m_ulOutFile.open(GetUlOutputFilename().c_str());
+        if (!m_ulOutFile.is_open())
         {
             NS_LOG_ERROR("Can't open file " << GetUlOutputFilename().c_str());
             return;
         }
 
-        dlOutFile.open(GetDlOutputFilename().c_str());
-        if (!dlOutFile.is_open())
+        m_dlOutFile.open(GetDlOutputFilename().c_str());
+        if (!m_dlOutFile.is_open())
         {
             NS_LOG_ERROR("Can't open file " << GetDlOutputFilename().c_str());
             return;
         }
         m_firstWrite = false;
-        ulOutFile
+        m_ulOutFile
             << "% start(s)\tend(s)\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
-        ulOutFile << "delay(s)\tstdDev(s)\tmin(s)\tmax(s)\t";
-        ulOutFile << "PduSize\tstdDev\tmin\tmax";
-        ulOutFile << std::endl;
-        dlOutFile
+        m_ulOutFile << "delay(s)\tstdDev(s)\tmin(s)\tmax(s)\t";
+        m_ulOutFile << "PduSize\tstdDev\tmin\tmax";
+        m_ulOutFile << std::endl;
+        m_dlOutFile
             << "% start(s)\tend(s)\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
-        dlOutFile << "delay(s)\tstdDev(s)\tmin(s)\tmax(s)\t";
-        dlOutFile << "PduSize\tstdDev\tmin\tmax";
-        dlOutFile << std::endl;
+        m_dlOutFile << "delay(s)\tstdDev(s)\tmin(s)\tmax(s)\t";
+        m_dlOutFile << "PduSize\tstdDev\tmin\tmax";
+        m_dlOutFile << std::endl;
     }
-    else
+    else if (!m_ulOutFile.is_open() || !m_dlOutFile.is_open())
     {
-        ulOutFile.open(GetUlOutputFilename().c_str(), std::ios_base::app);
-        if (!ulOutFile.is_open())
-        {
-            NS_LOG_ERROR("Can't open file " << GetUlOutputFilename().c_str());
-            return;
-        }
-
-        dlOutFile.open(GetDlOutputFilename().c_str(), std::ios_base::app);
-        if (!dlOutFile.is_open())
-        {
-            NS_LOG_ERROR("Can't open file " << GetDlOutputFilename().c_str());
-            return;
-        }
+        NS_LOG_ERROR("The output files are not open");
+        return;
     }
 
-    WriteUlResults(ulOutFile);
-    WriteDlResults(dlOutFile);
+    WriteUlResults(m_ulOutFile);
+    WriteDlResults(m_dlOutFile);
     m_pendingOutput = false;
 }
 
 void
-NrBearerStatsCalculator::WriteUlResults(std::ofstream& outFile)
+NrBearerStatsCalculator::WriteUlResults(NrTraceOfstream& outFile)
 {
     NS_LOG_FUNCTION(this);
-
-    // Get the unique IMSI / LCID list
-
-    std::vector<ImsiLcidPair_t> pairVector;
-    for (auto& m_ulTxPacket : m_ulTxPackets)
-    {
-        if (find(pairVector.begin(), pairVector.end(), m_ulTxPacket.first) == pairVector.end())
-        {
-            pairVector.push_back(m_ulTxPacket.first);
-        }
-    }
-
-    Time endTime = m_startTime + m_epochDuration;
-    for (auto p : pairVector)
-    {
-        outFile << m_startTime.GetSeconds() << "\t";
-        outFile << endTime.GetSeconds() << "\t";
-        outFile << GetUlCellId(p.m_imsi, p.m_lcId) << "\t";
-        outFile << p.m_imsi << "\t";
-        outFile << m_flowId[p].m_rnti << "\t";
-        outFile << (uint32_t)m_flowId[p].m_lcId << "\t";
-        outFile << GetUlTxPackets(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetUlTxData(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetUlRxPackets(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetUlRxData(p.m_imsi, p.m_lcId) << "\t";
-        std::vector<double> stats = GetUlDelayStats(p.m_imsi, p.m_lcId);
-        for (double& stat : stats)
-        {
-            outFile << stat * 1e-9 << "\t";
-        }
-        stats = GetUlPduSizeStats(p.m_imsi, p.m_lcId);
-        for (double& stat : stats)
-        {
-            outFile << stat << "\t";
-        }
-        outFile << std::endl;
-    }
-
-    outFile.close();
+    WriteResults(outFile, m_ulStats);
 }
 
 void
-NrBearerStatsCalculator::WriteDlResults(std::ofstream& outFile)
+NrBearerStatsCalculator::WriteDlResults(NrTraceOfstream& outFile)
 {
     NS_LOG_FUNCTION(this);
+    WriteResults(outFile, m_dlStats);
+}
 
-    // Get the unique IMSI list
-    std::vector<ImsiLcidPair_t> pairVector;
-    for (auto& m_dlTxPacket : m_dlTxPackets)
+void
+NrBearerStatsCalculator::WriteResults(NrTraceOfstream& outFile, const DirectionStats& stats)
+{
+    // The flows with TX PDUs in the epoch, in (IMSI, LCID) order
+    Time endTime = m_startTime + m_epochDuration;
+    for (auto index : m_sortedFlows)
     {
-        if (find(pairVector.begin(), pairVector.end(), m_dlTxPacket.first) == pairVector.end())
+        if (stats.m_txPackets[index] == 0)
         {
-            pairVector.push_back(m_dlTxPacket.first);
+            continue;
         }
-    }
-
-    Time endTime = m_startTime + m_epochDuration;
-    for (auto p : pairVector)
-    {
+        const auto& p = m_flows[index];
         outFile << m_startTime.GetSeconds() << "\t";
         outFile << endTime.GetSeconds() << "\t";
-        outFile << GetDlCellId(p.m_imsi, p.m_lcId) << "\t";
+        outFile << stats.m_cellId[index] << "\t";
         outFile << p.m_imsi << "\t";
-        outFile << m_flowId[p].m_rnti << "\t";
-        outFile << (uint32_t)m_flowId[p].m_lcId << "\t";
-        outFile << GetDlTxPackets(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetDlTxData(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetDlRxPackets(p.m_imsi, p.m_lcId) << "\t";
-        outFile << GetDlRxData(p.m_imsi, p.m_lcId) << "\t";
-        std::vector<double> stats = GetDlDelayStats(p.m_imsi, p.m_lcId);
-        for (double& stat : stats)
+        outFile << m_flowRnti[index] << "\t";
+        outFile << (uint32_t)p.m_lcId << "\t";
+        outFile << stats.m_txPackets[index] << "\t";
+        outFile << stats.m_txData[index] << "\t";
+        outFile << stats.m_rxPackets[index] << "\t";
+        outFile << stats.m_rxData[index] << "\t";
+        for (double stat : stats.m_delay[index].GetStats())
         {
             outFile << stat * 1e-9 << "\t";
         }
-        stats = GetDlPduSizeStats(p.m_imsi, p.m_lcId);
-        for (double& stat : stats)
+        for (double stat : stats.m_pduSize[index].GetStats())
         {
             outFile << stat << "\t";
         }
         outFile << std::endl;
     }
-
-    outFile.close();
 }
 
 void
@@ -376,19 +411,9 @@ NrBearerStatsCalculator::ResetResults()
 {
     NS_LOG_FUNCTION(this);
 
-    m_ulTxPackets.erase(m_ulTxPackets.begin(), m_ulTxPackets.end());
-    m_ulRxPackets.erase(m_ulRxPackets.begin(), m_ulRxPackets.end());
-    m_ulRxData.erase(m_ulRxData.begin(), m_ulRxData.end());
-    m_ulTxData.erase(m_ulTxData.begin(), m_ulTxData.end());
-    m_ulDelay.erase(m_ulDelay.begin(), m_ulDelay.end());
-    m_ulPduSize.erase(m_ulPduSize.begin(), m_ulPduSize.end());
-
-    m_dlTxPackets.erase(m_dlTxPackets.begin(), m_dlTxPackets.end());
-    m_dlRxPackets.erase(m_dlRxPackets.begin(), m_dlRxPackets.end());
-    m_dlRxData.erase(m_dlRxData.begin(), m_dlRxData.end());
-    m_dlTxData.erase(m_dlTxData.begin(), m_dlTxData.end());
-    m_dlDelay.erase(m_dlDelay.begin(), m_dlDelay.end());
-    m_dlPduSize.erase(m_dlPduSize.begin(), m_dlPduSize.end());
+    // The flows, their RNTI and their CellIds are kept between the epochs
+    m_ulStats.ResetEpoch();
+    m_dlStats.ResetEpoch();
 }
 
 void
@@ -417,196 +442,154 @@ uint32_t
 NrBearerStatsCalculator::GetUlTxPackets(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulTxPackets[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_ulStats.m_txPackets[index] : 0;
 }
 
 uint32_t
 NrBearerStatsCalculator::GetUlRxPackets(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulRxPackets[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_ulStats.m_rxPackets[index] : 0;
 }
 
 uint64_t
 NrBearerStatsCalculator::GetUlTxData(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulTxData[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_ulStats.m_txData[index] : 0;
 }
 
 uint64_t
 NrBearerStatsCalculator::GetUlRxData(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulRxData[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_ulStats.m_rxData[index] : 0;
 }
 
 double
 NrBearerStatsCalculator::GetUlDelay(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    Uint64StatsMap::iterator it = m_ulDelay.find(p);
-    if (it == m_ulDelay.end())
+    uint32_t index;
+    if (!FindFlowIndex(imsi, lcid, index) || m_ulStats.m_delay[index].m_count == 0)
     {
         NS_LOG_ERROR("UL delay for " << imsi << " - " << (uint16_t)lcid << " not found");
         return 0;
     }
-    return m_ulDelay[p]->getMean();
+    return m_ulStats.m_delay[index].m_mean;
 }
 
 std::vector<double>
 NrBearerStatsCalculator::GetUlDelayStats(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    std::vector<double> stats;
-    Uint64StatsMap::iterator it = m_ulDelay.find(p);
-    if (it == m_ulDelay.end())
+    uint32_t index;
+    if (!FindFlowIndex(imsi, lcid, index))
     {
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        return stats;
+        return StreamingStats().GetStats();
     }
-    stats.push_back(m_ulDelay[p]->getMean());
-    stats.push_back(m_ulDelay[p]->getStddev());
-    stats.push_back(m_ulDelay[p]->getMin());
-    stats.push_back(m_ulDelay[p]->getMax());
-    return stats;
+    return m_ulStats.m_delay[index].GetStats();
 }
 
 std::vector<double>
 NrBearerStatsCalculator::GetUlPduSizeStats(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    std::vector<double> stats;
-    Uint32StatsMap::iterator it = m_ulPduSize.find(p);
-    if (it == m_ulPduSize.end())
+    uint32_t index;
+    if (!FindFlowIndex(imsi, lcid, index))
     {
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        return stats;
+        return StreamingStats().GetStats();
     }
-    stats.push_back(m_ulPduSize[p]->getMean());
-    stats.push_back(m_ulPduSize[p]->getStddev());
-    stats.push_back(m_ulPduSize[p]->getMin());
-    stats.push_back(m_ulPduSize[p]->getMax());
-    return stats;
+    return m_ulStats.m_pduSize[index].GetStats();
 }
 
 uint32_t
 NrBearerStatsCalculator::GetDlTxPackets(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlTxPackets[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_dlStats.m_txPackets[index] : 0;
 }
 
 uint32_t
 NrBearerStatsCalculator::GetDlRxPackets(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlRxPackets[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_dlStats.m_rxPackets[index] : 0;
 }
 
 uint64_t
 NrBearerStatsCalculator::GetDlTxData(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlTxData[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_dlStats.m_txData[index] : 0;
 }
 
 uint64_t
 NrBearerStatsCalculator::GetDlRxData(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlRxData[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_dlStats.m_rxData[index] : 0;
 }
 
 uint32_t
 NrBearerStatsCalculator::GetUlCellId(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_ulCellId[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_ulStats.m_cellId[index] : 0;
 }
 
 uint32_t
 NrBearerStatsCalculator::GetDlCellId(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    return m_dlCellId[p];
+    uint32_t index;
+    return FindFlowIndex(imsi, lcid, index) ? m_dlStats.m_cellId[index] : 0;
 }
 
 double
 NrBearerStatsCalculator::GetDlDelay(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    Uint64StatsMap::iterator it = m_dlDelay.find(p);
-    if (it == m_dlDelay.end())
+    uint32_t index;
+    if (!FindFlowIndex(imsi, lcid, index) || m_dlStats.m_delay[index].m_count == 0)
     {
         NS_LOG_ERROR("DL delay for " << imsi << " not found");
         return 0;
     }
-    return m_dlDelay[p]->getMean();
+    return m_dlStats.m_delay[index].m_mean;
 }
 
 std::vector<double>
 NrBearerStatsCalculator::GetDlDelayStats(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    std::vector<double> stats;
-    Uint64StatsMap::iterator it = m_dlDelay.find(p);
-    if (it == m_dlDelay.end())
+    uint32_t index;
+    if (!FindFlowIndex(imsi, lcid, index))
     {
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        return stats;
+        return StreamingStats().GetStats();
     }
-    stats.push_back(m_dlDelay[p]->getMean());
-    stats.push_back(m_dlDelay[p]->getStddev());
-    stats.push_back(m_dlDelay[p]->getMin());
-    stats.push_back(m_dlDelay[p]->getMax());
-    return stats;
+    return m_dlStats.m_delay[index].GetStats();
 }
 
 std::vector<double>
 NrBearerStatsCalculator::GetDlPduSizeStats(uint64_t imsi, uint8_t lcid)
 {
     NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
-    ImsiLcidPair_t p(imsi, lcid);
-    std::vector<double> stats;
-    Uint32StatsMap::iterator it = m_dlPduSize.find(p);
-    if (it == m_dlPduSize.end())
+    uint32_t index;
+    if (!FindFlowIndex(imsi, lcid, index))
     {
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        stats.push_back(0.0);
-        return stats;
+        return StreamingStats().GetStats();
     }
-    stats.push_back(m_dlPduSize[p]->getMean());
-    stats.push_back(m_dlPduSize[p]->getStddev());
-    stats.push_back(m_dlPduSize[p]->getMin());
-    stats.push_back(m_dlPduSize[p]->getMax());
-    return stats;
+    return m_dlStats.m_pduSize[index].GetStats();
 }
 
 std::string
@@ -9,30 +9,19 @@
 #define NR_RADIO_BEARER_STATS_CALCULATOR_H_
 
 #include "nr-bearer-stats-simple.h"
+#include "nr-trace-io-service.h"
 
-#include "ns3/basic-data-calculators.h"
 #include "ns3/lte-common.h"
 #include "ns3/object.h"
 #include "ns3/uinteger.h"
 
 #include <fstream>
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
-/// Container: (IMSI, LCID) pair, uint32_t
-typedef std::map<ImsiLcidPair_t, uint32_t> Uint32Map;
-/// Container: (IMSI, LCID) pair, uint64_t
-typedef std::map<ImsiLcidPair_t, uint64_t> Uint64Map;
-/// Container: (IMSI, LCID) pair, uint32_t calculator
-typedef std::map<ImsiLcidPair_t, Ptr<MinMaxAvgTotalCalculator<uint32_t>>> Uint32StatsMap;
-/// Container: (IMSI, LCID) pair, uint64_t calculator
-typedef std::map<ImsiLcidPair_t, Ptr<MinMaxAvgTotalCalculator<uint64_t>>> Uint64StatsMap;
-/// Container: (IMSI, LCID) pair, double
-typedef std::map<ImsiLcidPair_t, double> DoubleMap;
-/// Container: (IMSI, LCID) pair, LteFlowId_t
-typedef std::map<ImsiLcidPair_t, LteFlowId_t> FlowIdMap;
 
 /**
  * \ingroup utils
@@ -52,6 +41,9 @@ typedef std::map<ImsiLcidPair_t, LteFlowId_t> FlowIdMap;
  *   - Average, min, max and standard deviation of PDU delay (delay is
  *     calculated from the generation of the PDU to its reception)
  *   - Average, min, max and standard deviation of PDU size
+ *
+ * Each (IMSI, LCID) pair gets a dense index the first time it is seen, and the statistics of
+ * the flows are stored in arrays indexed by it, so that a PDU costs a single lookup.
  */
 
 class NrBearerStatsCalculator : public NrBearerStatsBase
@@ -278,21 +270,19 @@ class NrBearerStatsCalculator : public NrBearerStatsBase
      * Called after each epoch to write collected
      * statistics to output files. During first call
      * it opens output files and write columns descriptions.
-     * During next calls it opens output files in append mode.
+     * The output files are kept open until the calculator is disposed.
      */
     void ShowResults();
     /**
-     * Writes collected statistics to UL output file and
-     * closes UL output file.
+     * Writes collected statistics to UL output file.
      * @param outFile ofstream for UL statistics
      */
-    void WriteUlResults(std::ofstream& outFile);
+    void WriteUlResults(NrTraceOfstream& outFile);
     /**
-     * Writes collected statistics to DL output file and
-     * closes DL output file.
+     * Writes collected statistics to DL output file.
      * @param outFile ofstream for DL statistics
      */
-    void WriteDlResults(std::ofstream& outFile);
+    void WriteDlResults(NrTraceOfstream& outFile);
     /**
      * Erases collected statistics
      */
@@ -309,22 +299,88 @@ class NrBearerStatsCalculator : public NrBearerStatsBase
      */
     void EndEpoch();
 
-    EventId m_endEpochEvent;    //!< Event id for next end epoch event
-    FlowIdMap m_flowId;         //!< List of FlowIds, ie. (RNTI, LCID) by (IMSI, LCID) pair
-    Uint32Map m_dlCellId;       //!< List of DL CellIds by (IMSI, LCID) pair
-    Uint32Map m_dlTxPackets;    //!< Number of DL TX Packets by (IMSI, LCID) pair
-    Uint32Map m_dlRxPackets;    //!< Number of DL RX Packets by (IMSI, LCID) pair
-    Uint64Map m_dlTxData;       //!< Amount of DL TX Data by (IMSI, LCID) pair
-    Uint64Map m_dlRxData;       //!< Amount of DL RX Data by (IMSI, LCID) pair
-    Uint64StatsMap m_dlDelay;   //!< DL delay by (IMSI, LCID) pair
-    Uint32StatsMap m_dlPduSize; //!< DL PDU Size by (IMSI, LCID) pair
-    Uint32Map m_ulCellId;       //!< List of UL CellIds by (IMSI, LCID) pair
-    Uint32Map m_ulTxPackets;    //!< Number of UL TX Packets by (IMSI, LCID) pair
-    Uint32Map m_ulRxPackets;    //!< Number of UL RX Packets by (IMSI, LCID) pair
-    Uint64Map m_ulTxData;       //!< Amount of UL TX Data by (IMSI, LCID) pair
-    Uint64Map m_ulRxData;       //!< Amount of UL RX Data by (IMSI, LCID) pair
-    Uint64StatsMap m_ulDelay;   //!< UL delay by (IMSI, LCID) pair
-    Uint32StatsMap m_ulPduSize; //!< UL PDU Size by (IMSI, LCID) pair
+    /**
+     * \brief Streaming statistics of a set of values: mean, standard deviation, min and max.
+     *
+     * They are computed with the same running mean and variance as MinMaxAvgTotalCalculator
+     * (Knuth, TAOCP vol. 2), and give the same results, without allocating an object per flow.
+     */
+    struct StreamingStats
+    {
+        uint32_t m_count{0}; //!< Number of values
+        double m_min{0.0};   //!< Minimum value
+        double m_max{0.0};   //!< Maximum value
+        double m_mean{0.0};  //!< Running mean
+        double m_s{0.0};     //!< Running sum of the squared deviations from the mean
+
+        /**
+         * \brief Add a value
+         * \param value the value
+         */
+        void Update(double value);
+
+        /**
+         * \brief Get the statistics
+         * \return the mean, standard deviation, min and max, or zeros if there are no values
+         */
+        std::vector<double> GetStats() const;
+    };
+
+    /**
+     * \brief The statistics of the flows in a direction, as arrays indexed by flow
+     */
+    struct DirectionStats
+    {
+        std::vector<uint32_t> m_cellId; //!< CellId of the last PDU, kept between epochs
+        std::vector<uint32_t> m_txPackets; //!< Number of TX packets in the epoch
+        std::vector<uint32_t> m_rxPackets; //!< Number of RX packets in the epoch
+        std::vector<uint64_t> m_txData; //!< Amount of TX data in the epoch
+        std::vector<uint64_t> m_rxData; //!< Amount of RX data in the epoch
+        std::vector<StreamingStats> m_delay; //!< Delay of the RX PDUs in the epoch
+        std::vector<StreamingStats> m_pduSize; //!< Size of the RX PDUs in the epoch
+
+        /**
+         * \brief Add a flow
+         */
+        void AddFlow();
+
+        /**
+         * \brief Reset the statistics of the epoch of all the flows (not the CellIds)
+         */
+        void ResetEpoch();
+    };
+
+    /**
+     * \brief Get the index of a flow, and add it the first time it is seen
+     * \param imsi the IMSI
+     * \param lcid the LCID
+     * \return the index of the flow
+     */
+    uint32_t GetFlowIndex(uint64_t imsi, uint8_t lcid);
+
+    /**
+     * \brief Find the index of a flow
+     * \param imsi the IMSI
+     * \param lcid the LCID
+     * \param index the index of the flow, if it was found
+     * \return true if the flow was found
+     */
+    bool FindFlowIndex(uint64_t imsi, uint8_t lcid, uint32_t& index) const;
+
+    /**
+     * \brief Write the statistics of the epoch of a direction
+     * \param outFile the output file
+     * \param stats the statistics of the direction
+     */
+    void WriteResults(NrTraceOfstream& outFile, const DirectionStats& stats);
+
+    EventId m_endEpochEvent; //!< Event id for next end epoch event
+    std::unordered_map<uint64_t, uint32_t> m_flowIndex; //!< Index of the flows by (IMSI, LCID)
+    std::vector<ImsiLcidPair_t> m_flows; //!< (IMSI, LCID) pair of the flows, by index
+    std::vector<uint16_t> m_flowRnti;    //!< RNTI of the last TX PDU of the flows, by index
+    std::vector<uint32_t> m_sortedFlows; //!< Indexes of the flows, sorted by (IMSI, LCID)
+    DirectionStats m_dlStats;            //!< DL statistics of the flows
+    DirectionStats m_ulStats;            //!< UL statistics of the flows
     /**
      * Start time of the on going epoch
      */
@@ -361,8 +417,8 @@ class NrBearerStatsCalculator : public NrBearerStatsBase
      * Name of the file where the uplink PDCP statistics will be saved
      */
     std::string m_ulPdcpOutputFilename;
-    std::ofstream m_dlOutFile;
-    std::ofstream m_ulOutFile;
+    NrTraceOfstream m_dlOutFile; //!< The DL output file, open after the first write
+    NrTraceOfstream m_ulOutFile; //!< The UL output file, open after the first write
 };
 
 } // namespace ns3
@@ -0,0 +1,257 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-binary-trace.h"
+
+#include <ns3/log.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrBinaryTrace");
+
+/// The magic string at the beginning of the binary trace files
+static constexpr char NR_BINARY_TRACE_MAGIC[8] = {'N', 'R', 'B', 'T', 'R', 'A', 'C', 'E'};
+
+/// The version of the format of the binary trace files
+static constexpr uint32_t NR_BINARY_TRACE_VERSION = 1;
+
+void
+NrSinrTraceRecord::WriteTextHeader(std::ostream& os,
+                                   [[maybe_unused]] const NrSinrTraceRecord& first)
+{
+    os << "Time"
+       << "\t"
+       << "CellId"
+       << "\t"
+       << "RNTI"
+       << "\t"
+       << "BWPId"
+       << "\t"
+       << "SINR(dB)"
+       << "\n";
+}
+
+void
+NrSinrTraceRecord::WriteText(std::ostream& os) const
+{
+    os << m_time << "\t" << m_cellId << "\t" << m_rnti << "\t" << m_bwpId << "\t"
+       << 10 * log10(m_sinr) << "\n";
+}
+
+void
+NrRxPacketTraceRecord::WriteTextHeader(std::ostream& os, const NrRxPacketTraceRecord& first)
+{
+    os << "Time"
+       << "\t"
+       << "direction"
+       << "\t"
+       << "frame"
+       << "\t"
+       << "subF"
+       << "\t"
+       << "slot"
+       << "\t"
+       << "1stSym"
+       << "\t"
+       << "nSymbol"
+       << "\t"
+       << "cellId"
+       << "\t"
+       << "bwpId"
+       << "\t"
+       << "rnti"
+       << "\t"
+       << "tbSize"
+       << "\t"
+       << "mcs"
+       << "\t"
+       << "rank"
+       << "\t"
+       << "rv"
+       << "\t"
+       << "SINR(dB)"
+       << "\t";
+    if (!first.m_isUplink)
+    {
+        os << "CQI"
+           << "\t";
+    }
+    os << "corrupt"
+       << "\t"
+       << "TBler"
+       << "\n";
+}
+
+void
+NrRxPacketTraceRecord::WriteText(std::ostream& os) const
+{
+    // The rows keep the layout of the original text trace: the DL rows repeat the RNTI, and
+    // the UL rows have no separator between the BWP ID and the RNTI
+    os << m_time << "\t" << (m_isUplink ? "UL" : "DL") << "\t" << m_frameNum << "\t"
+       << (unsigned)m_subframeNum << "\t" << (unsigned)m_slotNum << "\t" << (unsigned)m_symStart
+       << "\t" << (unsigned)m_numSym << "\t" << m_cellId << "\t" << (unsigned)m_bwpId;
+    if (m_isUplink)
+    {
+        os << m_rnti;
+    }
+    else
+    {
+        os << "\t" << m_rnti << "\t" << m_rnti;
+    }
+    os << "\t" << m_tbSize << "\t" << (unsigned)m_mcs << "\t" << (unsigned)m_rank << "\t"
+       << (unsigned)m_rv << "\t" << 10 * log10(m_sinr) << "\t" << (unsigned)m_corrupt << "\t"
+       << m_tbler << "\t"
+       << "\n";
+}
+
+void
+NrMacSchedulingTraceRecord::WriteTextHeader(
+    std::ostream& os,
+    [[maybe_unused]] const NrMacSchedulingTraceRecord& first)
+{
+    os << "% "
+          "time(s)"
+          "\tcellId\tbwpId\tIMSI\tRNTI\tframe\tsframe\tslot\tsymStart\tnumSym\thar"
+          "qId\tndi\trv\tmcs\ttbSize";
+    os << "\n";
+}
+
+void
+NrMacSchedulingTraceRecord::WriteText(std::ostream& os) const
+{
+    os << m_time << "\t";
+    os << (uint32_t)m_cellId << "\t";
+    os << (uint32_t)m_bwpId << "\t";
+    os << m_imsi << "\t";
+    os << m_rnti << "\t";
+    os << m_frameNum << "\t";
+    os << (uint32_t)m_subframeNum << "\t";
+    os << m_slotNum << "\t";
+    os << (uint32_t)m_symStart << "\t";
+    os << (uint32_t)m_numSym << "\t";
+    os << (uint32_t)m_harqId << "\t";
+    os << (uint32_t)m_ndi << "\t";
+    os << (uint32_t)m_rv << "\t";
+    os << (uint32_t)m_mcs << "\t";
+    os << m_tbSize << "\n";
+}
+
+NrBinaryTraceWriter::NrBinaryTraceWriter(const std::string& filename,
+                                         NrBinaryTraceRecordType type,
+                                         size_t recordSize,
+                                         size_t bufferSize)
+    : m_filename(filename),
+      m_type(type),
+      m_recordSize(recordSize),
+      m_buffer(std::max(bufferSize, recordSize))
+{
+    NS_LOG_FUNCTION(this << filename << static_cast<uint32_t>(type) << recordSize);
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        NS_FATAL_ERROR("Could not open tracefile " << filename);
+    }
+
+    NrBinaryTraceHeader header{};
+    std::memcpy(header.m_magic, NR_BINARY_TRACE_MAGIC, sizeof(header.m_magic));
+    header.m_version = NR_BINARY_TRACE_VERSION;
+    header.m_recordType = static_cast<uint32_t>(type);
+    header.m_recordSize = static_cast<uint32_t>(recordSize);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+NrBinaryTraceWriter::~NrBinaryTraceWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Flush();
+    m_file.close();
+}
+
+void
+NrBinaryTraceWriter::Flush()
+{
+    NS_LOG_FUNCTION(this << m_used);
+    m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+    m_file.flush();
+    m_used = 0;
+}
+
+NrBinaryTraceHeader
+NrBinaryTraceReader::ReadHeader(std::istream& is, const std::string& filename)
+{
+    NrBinaryTraceHeader header{};
+    is.read(reinterpret_cast<char*>(&header), sizeof(header));
+    NS_ABORT_MSG_IF(!is ||
+                        std::memcmp(header.m_magic,
+                                    NR_BINARY_TRACE_MAGIC,
+                                    sizeof(header.m_magic)) != 0,
+                    filename << " is not a binary trace file");
+    NS_ABORT_MSG_IF(header.m_version != NR_BINARY_TRACE_VERSION,
+                    "Unsupported version " << header.m_version << " of " << filename);
+    return header;
+}
+
+/**
+ * \brief Convert the records of a binary trace file to text, one at a time
+ * \param is the input stream, positioned after the header
+ * \param header the header of the file
+ * \param filename the name of the file, for the error messages
+ * \param os the output stream of the text trace
+ */
+template <typename Record>
+static void
+ConvertRecordsToText(std::istream& is,
+                     const NrBinaryTraceHeader& header,
+                     const std::string& filename,
+                     std::ostream& os)
+{
+    NS_ABORT_MSG_IF(header.m_recordSize != sizeof(Record),
+                    "Wrong record size " << header.m_recordSize << " in " << filename);
+    Record record{};
+    bool first = true;
+    while (is.read(reinterpret_cast<char*>(&record), sizeof(Record)))
+    {
+        if (first)
+        {
+            Record::WriteTextHeader(os, record);
+            first = false;
+        }
+        record.WriteText(os);
+    }
+    if (first)
+    {
+        // No records: the header only
+        Record::WriteTextHeader(os, Record{});
+    }
+}
+
+void
+NrBinaryTraceReader::ConvertToText(const std::string& filename, std::ostream& os)
+{
+    NS_LOG_FUNCTION(filename);
+    std::ifstream is(filename, std::ios::binary);
+    NS_ABORT_MSG_IF(!is.is_open(), "Could not open " << filename);
+    auto header = ReadHeader(is, filename);
+
+    switch (static_cast<NrBinaryTraceRecordType>(header.m_recordType))
+    {
+    case NrBinaryTraceRecordType::SINR:
+        ConvertRecordsToText<NrSinrTraceRecord>(is, header, filename, os);
+        break;
+    case NrBinaryTraceRecordType::RX_PACKET:
+        ConvertRecordsToText<NrRxPacketTraceRecord>(is, header, filename, os);
+        break;
+    case NrBinaryTraceRecordType::MAC_SCHEDULING:
+        ConvertRecordsToText<NrMacSchedulingTraceRecord>(is, header, filename, os);
+        break;
+    default:
+        NS_FATAL_ERROR("Unknown record type " << header.m_recordType << " in " << filename);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,293 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_BINARY_TRACE_H
+#define NR_BINARY_TRACE_H
+
+#include "nr-trace-io-service.h"
+
+#include <ns3/abort.h>
+#include <ns3/assert.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr
+ * \brief The format of the files written by the NR trace sinks
+ */
+enum class NrTraceFormat : uint8_t
+{
+    TEXT,   //!< Tab-separated text, one row per record
+    BINARY, //!< Fixed-width binary records, see NrBinaryTraceWriter
+};
+
+/**
+ * \ingroup nr
+ * \brief The types of the binary trace records
+ *
+ * The value is stored in the header of the binary trace files, so the values of the
+ * existing types must not change.
+ */
+enum class NrBinaryTraceRecordType : uint32_t
+{
+    SINR = 1,           //!< NrSinrTraceRecord
+    RX_PACKET = 2,      //!< NrRxPacketTraceRecord
+    MAC_SCHEDULING = 3, //!< NrMacSchedulingTraceRecord
+};
+
+/**
+ * \ingroup nr
+ * \brief Record of the DlDataSinr and DlCtrlSinr traces of NrPhyRxTrace
+ */
+struct NrSinrTraceRecord
+{
+    static constexpr NrBinaryTraceRecordType TYPE = NrBinaryTraceRecordType::SINR; //!< Type
+
+    double m_time;       //!< Time (s)
+    double m_sinr;       //!< Average SINR (linear)
+    uint16_t m_cellId;   //!< Cell ID
+    uint16_t m_rnti;     //!< RNTI
+    uint16_t m_bwpId;    //!< BWP ID
+    uint16_t m_reserved; //!< Padding, always 0
+
+    /**
+     * \brief Write the header of the text trace
+     * \param os the output stream
+     * \param first the first record of the trace
+     */
+    static void WriteTextHeader(std::ostream& os, const NrSinrTraceRecord& first);
+
+    /**
+     * \brief Write the record as a row of the text trace
+     * \param os the output stream
+     */
+    void WriteText(std::ostream& os) const;
+};
+
+/**
+ * \ingroup nr
+ * \brief Record of the RxPacketTrace trace of NrPhyRxTrace, for both directions
+ */
+struct NrRxPacketTraceRecord
+{
+    static constexpr NrBinaryTraceRecordType TYPE = NrBinaryTraceRecordType::RX_PACKET; //!< Type
+
+    double m_time;         //!< Time (s)
+    double m_sinr;         //!< Average SINR (linear)
+    double m_tbler;        //!< TBLER
+    uint64_t m_cellId;     //!< Cell ID
+    uint32_t m_frameNum;   //!< Frame number
+    uint32_t m_tbSize;     //!< TB size
+    uint16_t m_rnti;       //!< RNTI
+    uint16_t m_slotNum;    //!< Slot number
+    uint16_t m_bwpId;      //!< BWP ID
+    uint8_t m_subframeNum; //!< Subframe number
+    uint8_t m_symStart;    //!< First symbol
+    uint8_t m_numSym;      //!< Number of symbols
+    uint8_t m_mcs;         //!< MCS
+    uint8_t m_rank;        //!< Rank
+    uint8_t m_rv;          //!< Redundancy version
+    uint8_t m_corrupt;     //!< Whether the TB is corrupted
+    uint8_t m_isUplink;    //!< Whether the TB was received by the gNB
+    uint16_t m_reserved;   //!< Padding, always 0
+
+    /**
+     * \brief Write the header of the text trace, which depends on the direction of the first
+     * record of the trace
+     * \param os the output stream
+     * \param first the first record of the trace
+     */
+    static void WriteTextHeader(std::ostream& os, const NrRxPacketTraceRecord& first);
+
+    /**
+     * \brief Write the record as a row of the text trace
+     * \param os the output stream
+     */
+    void WriteText(std::ostream& os) const;
+};
+
+/**
+ * \ingroup nr
+ * \brief Record of the DL and UL traces of NrMacSchedulingStats
+ */
+struct NrMacSchedulingTraceRecord
+{
+    static constexpr NrBinaryTraceRecordType TYPE =
+        NrBinaryTraceRecordType::MAC_SCHEDULING; //!< Type
+
+    double m_time;         //!< Time (s)
+    uint64_t m_imsi;       //!< IMSI
+    uint32_t m_tbSize;     //!< TB size
+    uint16_t m_cellId;     //!< Cell ID
+    uint16_t m_rnti;       //!< RNTI
+    uint16_t m_frameNum;   //!< Frame number
+    uint16_t m_slotNum;    //!< Slot number
+    uint8_t m_bwpId;       //!< BWP ID
+    uint8_t m_subframeNum; //!< Subframe number
+    uint8_t m_symStart;    //!< First symbol
+    uint8_t m_numSym;      //!< Number of symbols
+    uint8_t m_harqId;      //!< HARQ process ID
+    uint8_t m_ndi;         //!< New data indicator
+    uint8_t m_rv;          //!< Redundancy version
+    uint8_t m_mcs;         //!< MCS
+    uint32_t m_reserved;   //!< Padding, always 0
+
+    /**
+     * \brief Write the header of the text trace
+     * \param os the output stream
+     * \param first the first record of the trace
+     */
+    static void WriteTextHeader(std::ostream& os, const NrMacSchedulingTraceRecord& first);
+
+    /**
+     * \brief Write the record as a row of the text trace
+     * \param os the output stream
+     */
+    void WriteText(std::ostream& os) const;
+};
+
+/**
+ * \ingroup nr
+ * \brief Header of a binary trace file
+ */
+struct NrBinaryTraceHeader
+{
+    char m_magic[8];       //!< The characters "NRBTRACE"
+    uint32_t m_version;    //!< The version of the format
+    uint32_t m_recordType; //!< The NrBinaryTraceRecordType of the records
+    uint32_t m_recordSize; //!< The size of a record, in bytes
+    uint32_t m_reserved;   //!< Padding, always 0
+};
+
+/**
+ * \ingroup nr
+ * \brief Writer of a binary trace file
+ *
+ * A binary trace file is a NrBinaryTraceHeader followed by the records, which are
+ * fixed-width structs written in the byte order of the host. The records are copied into a
+ * large buffer, which is written to the file only when it is full, and when the writer is
+ * destroyed. No text formatting and no conversion to dB is done while the simulation runs:
+ * NrBinaryTraceReader::ConvertToText converts a file back to the text trace that the sink
+ * writes in NrTraceFormat::TEXT.
+ *
+ * Since the records have a fixed width, the files compress well with general-purpose tools
+ * (e.g., zstd) after the simulation.
+ */
+class NrBinaryTraceWriter
+{
+  public:
+    /// Default size of the buffer (bytes)
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+    /**
+     * \brief Open a binary trace file, and write its header
+     * \param filename the name of the file
+     * \param type the type of the records
+     * \param recordSize the size of a record
+     * \param bufferSize the size of the buffer
+     */
+    NrBinaryTraceWriter(const std::string& filename,
+                        NrBinaryTraceRecordType type,
+                        size_t recordSize,
+                        size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    /**
+     * \brief Write the buffered records, and close the file
+     */
+    ~NrBinaryTraceWriter();
+
+    NrBinaryTraceWriter(const NrBinaryTraceWriter&) = delete;
+    NrBinaryTraceWriter& operator=(const NrBinaryTraceWriter&) = delete;
+
+    /**
+     * \brief Append a record
+     * \param record the record, of the type the file was opened for
+     */
+    template <typename Record>
+    void Write(const Record& record)
+    {
+        static_assert(std::is_trivially_copyable_v<Record>, "Records must be trivially copyable");
+        NS_ASSERT_MSG(Record::TYPE == m_type && sizeof(Record) == m_recordSize,
+                      "Wrong record type for " << m_filename);
+        if (m_used + sizeof(Record) > m_buffer.size())
+        {
+            Flush();
+        }
+        std::memcpy(m_buffer.data() + m_used, &record, sizeof(Record));
+        m_used += sizeof(Record);
+    }
+
+    /**
+     * \brief Write the buffered records to the file
+     */
+    void Flush();
+
+  private:
+    std::string m_filename;         //!< The name of the file
+    NrTraceOfstream m_file;         //!< The file
+    NrBinaryTraceRecordType m_type; //!< The type of the records
+    size_t m_recordSize;            //!< The size of a record
+    std::vector<char> m_buffer;     //!< The buffer
+    size_t m_used{0};               //!< The number of bytes used in the buffer
+};
+
+/**
+ * \ingroup nr
+ * \brief Reader of the files written by NrBinaryTraceWriter
+ */
+class NrBinaryTraceReader
+{
+  public:
+    /**
+     * \brief Read the header of a binary trace file, and check it
+     * \param is the input stream, positioned at the beginning of the file
+     * \param filename the name of the file, for the error messages
+     * \return the header
+     */
+    static NrBinaryTraceHeader ReadHeader(std::istream& is, const std::string& filename);
+
+    /**
+     * \brief Read all the records of a binary trace file
+     * \param filename the name of the file
+     * \return the records
+     */
+    template <typename Record>
+    static std::vector<Record> ReadRecords(const std::string& filename)
+    {
+        std::ifstream is(filename, std::ios::binary);
+        NS_ABORT_MSG_IF(!is.is_open(), "Could not open " << filename);
+        auto header = ReadHeader(is, filename);
+        NS_ABORT_MSG_IF(header.m_recordType != static_cast<uint32_t>(Record::TYPE) ||
+                            header.m_recordSize != sizeof(Record),
+                        "Wrong record type in " << filename);
+        std::vector<Record> records;
+        Record record;
+        while (is.read(reinterpret_cast<char*>(&record), sizeof(Record)))
+        {
+            records.push_back(record);
+        }
+        return records;
+    }
+
+    /**
+     * \brief Convert a binary trace file to the text trace that the sink writes in
+     * NrTraceFormat::TEXT
+     * \param filename the name of the binary trace file
+     * \param os the output stream of the text trace
+     */
+    static void ConvertToText(const std::string& filename, std::ostream& os);
+};
+
+} // namespace ns3
+
+#endif // NR_BINARY_TRACE_H
@@ -7,8 +7,10 @@
 #include "nr-helper.h"
 
 #include "nr-bearer-stats-calculator.h"
+#include "nr-kpi-aggregator.h"
 #include "nr-mac-rx-trace.h"
 #include "nr-phy-rx-trace.h"
+#include "nr-spatial-index.h"
 
 #include <ns3/bandwidth-part-gnb.h>
 #include <ns3/bandwidth-part-ue.h>
@@ -28,6 +30,7 @@
 #include <ns3/lte-ue-rrc.h>
 #include <ns3/multi-model-spectrum-channel.h>
 #include <ns3/names.h>
+#include <ns3/nr-cell-partition-executor.h>
 #include <ns3/nr-ch-access-manager.h>
 #include <ns3/nr-gnb-mac.h>
 #include <ns3/nr-gnb-net-device.h>
@@ -39,14 +42,18 @@
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/nr-ue-phy.h>
 #include <ns3/pointer.h>
+#include <ns3/propagation-loss-model.h>
 #include <ns3/three-gpp-channel-model.h>
 #include <ns3/three-gpp-propagation-loss-model.h>
 #include <ns3/three-gpp-spectrum-propagation-loss-model.h>
 #include <ns3/three-gpp-v2v-channel-condition-model.h>
 #include <ns3/three-gpp-v2v-propagation-loss-model.h>
+#include <ns3/uinteger.h>
 #include <ns3/uniform-planar-array.h>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3
 {
@@ -91,6 +98,7 @@ NrHelper::NrHelper()
 
     m_phyStats = CreateObject<NrPhyRxTrace>();
     m_macSchedStats = CreateObject<NrMacSchedulingStats>();
+    m_kpiAggregator = CreateObject<NrKpiAggregator>();
 }
 
 NrHelper::~NrHelper()
@@ -123,7 +131,28 @@ NrHelper::GetTypeId()
                                           "Enable Hybrid ARQ",
                                           BooleanValue(true),
                                           MakeBooleanAccessor(&NrHelper::m_harqEnabled),
-                                          MakeBooleanChecker());
+                                          MakeBooleanChecker())
+                            .AddAttribute("CsiRsPeriodicity",
+                                          "Periodicity (in slots) of the CSI-RS occasions of the "
+                                          "gNBs, in which the UEs measure the DL CQI. If 0, the "
+                                          "UEs measure it on all the DL data of the cell.",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(&NrHelper::m_csiRsPeriodicity),
+                                          MakeUintegerChecker<uint16_t>())
+                            .AddAttribute("EnableCellPartitions",
+                                          "Group each gNB with its UEs in a partition, and run "
+                                          "the schedulers of the partitions in parallel, with a "
+                                          "NrCellPartitionExecutor shared by all the gNBs",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&NrHelper::m_enableCellPartitions),
+                                          MakeBooleanChecker())
+                            .AddAttribute("CellPartitionThreads",
+                                          "Number of threads of the cell partitions, or 0 to use "
+                                          "one per hardware thread. The results do not depend on "
+                                          "the number of threads.",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(&NrHelper::m_cellPartitionThreads),
+                                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
@@ -590,15 +619,35 @@ NrHelper::CreateUePhy(const Ptr<Node>& n,
         pDataMimo->AddCallback(MakeCallback(&NrSpectrumPhy::UpdateMimoSinrPerceived, channelPhy));
         channelPhy->AddDataMimoChunkProcessor(pDataMimo);
     }
-    if (bwp->m_3gppChannel && m_enableMimoFeedback)
+    if (m_csiRsPeriodicity == 0)
     {
-        // Report DL CQI, PMI, RI (channel quality, MIMO precoding matrix and rank indicators)
-        pDataMimo->AddCallback(MakeCallback(&NrUePhy::GenerateDlCqiReportMimo, phy));
+        if (bwp->m_3gppChannel && m_enableMimoFeedback)
+        {
+            // Report DL CQI, PMI, RI (channel quality, MIMO precoding matrix and rank indicators)
+            pDataMimo->AddCallback(MakeCallback(&NrUePhy::GenerateDlCqiReportMimo, phy));
+        }
+        else
+        {
+            // SISO CQI feedback
+            pData->AddCallback(MakeCallback(&NrUePhy::GenerateDlCqiReport, phy));
+        }
     }
     else
     {
-        // SISO CQI feedback
-        pData->AddCallback(MakeCallback(&NrUePhy::GenerateDlCqiReport, phy));
+        // The UE measures the CQI only on its CSI-RS, and receives only its own DL data
+        channelPhy->EnableCsiRs();
+        if (bwp->m_3gppChannel && m_enableMimoFeedback)
+        {
+            auto pCsiRsMimo = Create<NrMimoChunkProcessor>();
+            pCsiRsMimo->AddCallback(MakeCallback(&NrUePhy::GenerateCsiRsCqiReportMimo, phy));
+            channelPhy->AddCsiRsMimoChunkProcessor(pCsiRsMimo);
+        }
+        else
+        {
+            Ptr<LteChunkProcessor> pCsiRs = Create<LteChunkProcessor>();
+            pCsiRs->AddCallback(MakeCallback(&NrUePhy::GenerateCsiRsCqiReport, phy));
+            channelPhy->AddCsiRsSinrChunkProcessor(pCsiRs);
+        }
     }
 
     Ptr<LteChunkProcessor> pRs = Create<LteChunkProcessor>();
@@ -771,6 +820,7 @@ NrHelper::CreateGnbPhy(const Ptr<Node>& n,
     NS_LOG_FUNCTION(this);
 
     Ptr<NrGnbPhy> phy = m_gnbPhyFactory.Create<NrGnbPhy>();
+    phy->SetCsiRsPeriodicity(m_csiRsPeriodicity);
 
     DoubleValue frequency;
     phy->InstallCentralFrequency(bwp->m_centralFrequency);
@@ -915,6 +965,18 @@ NrHelper::InstallSingleGnbDevice(
         auto sched = CreateGnbSched();
         cc->SetNrMacScheduler(sched);
 
+        if (m_enableCellPartitions)
+        {
+            if (m_cellPartitionExecutor == nullptr)
+            {
+                m_cellPartitionExecutor = CreateObject<NrCellPartitionExecutor>();
+                m_cellPartitionExecutor->SetNumThreads(m_cellPartitionThreads);
+            }
+            // All the BWPs of the gNB are in the same partition
+            phy->SetCellPartitionExecutor(m_cellPartitionExecutor, cellId);
+            mac->SetCellPartitionExecutor(m_cellPartitionExecutor, cellId);
+        }
+
         if (bwpId == 0)
         {
             cc->SetAsPrimary(true);
@@ -1057,34 +1119,72 @@ void
 NrHelper::AttachToClosestEnb(NetDeviceContainer ueDevices, NetDeviceContainer enbDevices)
 {
     NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(enbDevices.GetN() > 0, "empty enb device container");
 
+    NrSpatialIndex enbIndex(GetPositions(enbDevices));
     for (NetDeviceContainer::Iterator i = ueDevices.Begin(); i != ueDevices.End(); i++)
     {
-        AttachToClosestEnb(*i, enbDevices);
+        Vector uepos = (*i)->GetNode()->GetObject<MobilityModel>()->GetPosition();
+        AttachToEnb(*i, enbDevices.Get(enbIndex.FindNearest(uepos)));
     }
 }
 
 void
-NrHelper::AttachToClosestEnb(Ptr<NetDevice> ueDevice, NetDeviceContainer enbDevices)
+NrHelper::AttachToMaxRsrpEnb(NetDeviceContainer ueDevices,
+                             NetDeviceContainer enbDevices,
+                             uint32_t numCandidates)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << numCandidates);
     NS_ASSERT_MSG(enbDevices.GetN() > 0, "empty enb device container");
-    Vector uepos = ueDevice->GetNode()->GetObject<MobilityModel>()->GetPosition();
-    double minDistance = std::numeric_limits<double>::infinity();
-    Ptr<NetDevice> closestEnbDevice;
-    for (NetDeviceContainer::Iterator i = enbDevices.Begin(); i != enbDevices.End(); ++i)
+    if (numCandidates == 0)
+    {
+        numCandidates = enbDevices.GetN();
+    }
+
+    NrSpatialIndex enbIndex(GetPositions(enbDevices));
+    for (NetDeviceContainer::Iterator i = ueDevices.Begin(); i != ueDevices.End(); i++)
     {
-        Vector enbpos = (*i)->GetNode()->GetObject<MobilityModel>()->GetPosition();
-        double distance = CalculateDistance(uepos, enbpos);
-        if (distance < minDistance)
+        Ptr<MobilityModel> ueMob = (*i)->GetNode()->GetObject<MobilityModel>();
+        double maxRsrp = -std::numeric_limits<double>::infinity();
+        size_t bestEnb = enbDevices.GetN();
+        for (auto enb : enbIndex.FindNearest(ueMob->GetPosition(), numCandidates))
         {
-            minDistance = distance;
-            closestEnbDevice = *i;
+            Ptr<NrGnbPhy> phy = GetGnbPhy(enbDevices.Get(enb), 0);
+            Ptr<PropagationLossModel> lossModel =
+                phy->GetSpectrumPhy()->GetSpectrumChannel()->GetPropagationLossModel();
+            NS_ABORT_MSG_IF(lossModel == nullptr,
+                            "The spectrum channel of the GNB has no propagation loss model");
+
+            // Power of one RE of the first BWP, in dBm
+            double rsrp = phy->GetTxPower() - 10 * std::log10(12 * phy->GetRbNum());
+            rsrp = lossModel->CalcRxPower(
+                rsrp,
+                enbDevices.Get(enb)->GetNode()->GetObject<MobilityModel>(),
+                ueMob);
+            // The candidates are sorted by distance: ties go to the closest GNB
+            if (rsrp > maxRsrp)
+            {
+                maxRsrp = rsrp;
+                bestEnb = enb;
+            }
         }
+        NS_ASSERT(bestEnb < enbDevices.GetN());
+        NS_LOG_INFO("UE " << (*i)->GetNode()->GetId() << " attached to GNB " << bestEnb
+                          << " with RSRP " << maxRsrp << " dBm");
+        AttachToEnb(*i, enbDevices.Get(bestEnb));
     }
-    NS_ASSERT(closestEnbDevice);
+}
 
-    AttachToEnb(ueDevice, closestEnbDevice);
+std::vector<Vector>
+NrHelper::GetPositions(const NetDeviceContainer& devices)
+{
+    std::vector<Vector> positions;
+    positions.reserve(devices.GetN());
+    for (NetDeviceContainer::Iterator i = devices.Begin(); i != devices.End(); ++i)
+    {
+        positions.push_back((*i)->GetNode()->GetObject<MobilityModel>()->GetPosition());
+    }
+    return positions;
 }
 
 void
@@ -1793,6 +1893,32 @@ NrHelper::EnableUlMacSchedTraces()
         MakeBoundCallback(&NrMacSchedulingStats::UlSchedulingCallback, m_macSchedStats));
 }
 
+void
+NrHelper::EnableKpiAggregation()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    Config::Connect("/NodeList/*/DeviceList/*/ComponentCarrierMapUe/*/NrUePhy/DlDataSinr",
+                    MakeBoundCallback(&NrKpiAggregator::DlDataSinrCallback, m_kpiAggregator));
+    Config::Connect(
+        "/NodeList/*/DeviceList/*/ComponentCarrierMapUe/*/NrUePhy/SpectrumPhy/RxPacketTraceUe",
+        MakeBoundCallback(&NrKpiAggregator::RxPacketTraceUeCallback, m_kpiAggregator));
+    Config::Connect(
+        "/NodeList/*/DeviceList/*/BandwidthPartMap/*/NrGnbPhy/SpectrumPhy/RxPacketTraceEnb",
+        MakeBoundCallback(&NrKpiAggregator::RxPacketTraceGnbCallback, m_kpiAggregator));
+    Config::Connect(
+        "/NodeList/*/DeviceList/*/BandwidthPartMap/*/NrGnbMac/DlScheduling",
+        MakeBoundCallback(&NrKpiAggregator::DlSchedulingCallback, m_kpiAggregator));
+    Config::Connect(
+        "/NodeList/*/DeviceList/*/BandwidthPartMap/*/NrGnbMac/UlScheduling",
+        MakeBoundCallback(&NrKpiAggregator::UlSchedulingCallback, m_kpiAggregator));
+}
+
+Ptr<NrKpiAggregator>
+NrHelper::GetKpiAggregator()
+{
+    return m_kpiAggregator;
+}
+
 void
 NrHelper::EnablePathlossTraces()
 {
@@ -1915,7 +2041,7 @@ NrHelper::SetupMimoPmi(const NrHelper::MimoPmiParams& mp)
     SetPmSearchAttribute("RankLimit", UintegerValue(mp.rankLimit));
     SetPmSearchAttribute("SubbandSize", UintegerValue(mp.subbandSize));
     SetPmSearchAttribute("DownsamplingTechnique", StringValue(mp.downsamplingTechnique));
-    if (searchTypeId == NrPmSearchFull::GetTypeId())
+    if (searchTypeId.IsChildOf(NrPmSearchFull::GetTypeId()))
     {
         SetPmSearchAttribute("NrPmSearchFull::CodebookType",
                              TypeIdValue(TypeId::LookupByName(mp.fullSearchCb)));
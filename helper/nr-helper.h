@@ -18,6 +18,9 @@
 #include <ns3/nr-control-messages.h>
 #include <ns3/nr-spectrum-phy.h>
 #include <ns3/object-factory.h>
+#include <ns3/vector.h>
+
+#include <vector>
 
 namespace ns3
 {
@@ -30,6 +33,7 @@ class NrGnbMac;
 class EpcHelper;
 class EpcTft;
 class NrBearerStatsCalculator;
+class NrKpiAggregator;
 class NrMacRxTrace;
 class NrPhyRxTrace;
 class ComponentCarrierEnb;
@@ -40,6 +44,7 @@ class NrUeNetDevice;
 class NrUeMac;
 class BwpManagerGnb;
 class BwpManagerUe;
+class NrCellPartitionExecutor;
 
 /**
  * \ingroup helper
@@ -297,6 +302,21 @@ class NrHelper : public Object
      * \param enbDevices GNB devices from which the algorithm has to select the closest
      */
     void AttachToClosestEnb(NetDeviceContainer ueDevices, NetDeviceContainer enbDevices);
+    /**
+     * \brief Attach each UE specified to the GNB with the highest RSRP
+     *
+     * The RSRP is the transmission power of the first BWP of the GNB, divided among the REs
+     * of the BWP, minus the loss of the propagation loss model of its spectrum channel. The
+     * antenna and beamforming gains and the fast fading are not included.
+     *
+     * \param ueDevices UE devices to attach
+     * \param enbDevices GNB devices from which the algorithm has to select the best
+     * \param numCandidates the number of closest GNBs among which the best is selected for
+     * each UE, or 0 to evaluate all of them
+     */
+    void AttachToMaxRsrpEnb(NetDeviceContainer ueDevices,
+                            NetDeviceContainer enbDevices,
+                            uint32_t numCandidates = 0);
     /**
      * \brief Attach a UE to a particular GNB
      * \param ueDevice the UE device
@@ -819,6 +839,24 @@ class NrHelper : public Object
      */
     void EnablePathlossTraces();
 
+    /**
+     * \brief Enable the aggregation of the PHY and MAC KPIs (BLER, SINR, MCS, throughput and
+     * scheduling, per cell, BWP and RNTI) in memory, written as a summary per epoch
+     *
+     * It can be used instead of the DL data PHY, UL PHY and MAC scheduling traces, which write
+     * a row per TB.
+     *
+     * \see NrKpiAggregator
+     */
+    void EnableKpiAggregation();
+
+    /**
+     * \brief Get the KPI aggregator
+     *
+     * \return The NrKpiAggregator object to configure the summaries
+     */
+    Ptr<NrKpiAggregator> GetKpiAggregator();
+
     /*
      * \brief Enable DL CTRL pathloss trace from a serving cell (this trace connects
      * to NrSpectrumPhy trace, which is implementation wise different from
@@ -896,8 +934,13 @@ class NrHelper : public Object
     void SetupMimoPmi(const MimoPmiParams& mp);
 
   private:
-    bool m_enableMimoFeedback{false}; ///< Let UE compute MIMO feedback with PMI and RI
-    ObjectFactory m_pmSearchFactory;  ///< Factory for precoding matrix search algorithm
+    bool m_enableMimoFeedback{false};   ///< Let UE compute MIMO feedback with PMI and RI
+    ObjectFactory m_pmSearchFactory;    ///< Factory for precoding matrix search algorithm
+    uint16_t m_csiRsPeriodicity{0};     ///< Periodicity of the CSI-RS (slots), 0 if disabled
+    bool m_enableCellPartitions{false}; ///< Run the schedulers of the gNBs in parallel
+    uint32_t m_cellPartitionThreads{0}; ///< Number of threads of the cell partitions
+    /// Executor of the cell partitions, shared by all the gNBs
+    Ptr<NrCellPartitionExecutor> m_cellPartitionExecutor;
 
     /**
      * Assign a fixed random variable stream number to the channel and propagation
@@ -949,7 +992,12 @@ class NrHelper : public Object
     Ptr<NetDevice> InstallSingleGnbDevice(
         const Ptr<Node>& n,
         const std::vector<std::reference_wrapper<BandwidthPartInfoPtr>> allBwps);
-    void AttachToClosestEnb(Ptr<NetDevice> ueDevice, NetDeviceContainer enbDevices);
+    /**
+     * \brief Get the positions of the nodes of some devices
+     * \param devices the devices
+     * \return the positions, in the order of the devices
+     */
+    static std::vector<Vector> GetPositions(const NetDeviceContainer& devices);
 
     ObjectFactory m_gnbNetDeviceFactory;            //!< NetDevice factory for gnb
     ObjectFactory m_ueNetDeviceFactory;             //!< NetDevice factory for ue
@@ -1000,6 +1048,7 @@ class NrHelper : public Object
     //!< has assigned streams in order to avoid double
     //!< assignments
     Ptr<NrMacSchedulingStats> m_macSchedStats; //!<< Pointer to NrMacStatsCalculator
+    Ptr<NrKpiAggregator> m_kpiAggregator;      //!< Pointer to the KPI aggregator
 };
 
 } // namespace ns3
@@ -0,0 +1,377 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-kpi-aggregator.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrKpiAggregator");
+
+NS_OBJECT_ENSURE_REGISTERED(NrKpiAggregator);
+
+void
+NrKpiHistogram::Add(double valueDb)
+{
+    if (std::isnan(valueDb))
+    {
+        return;
+    }
+    auto pos = (valueDb - MIN_DB) / BIN_WIDTH_DB;
+    size_t bin = 0;
+    if (pos >= static_cast<double>(NUM_BINS))
+    {
+        bin = NUM_BINS - 1;
+    }
+    else if (pos > 0)
+    {
+        bin = static_cast<size_t>(pos);
+    }
+    m_bins[bin]++;
+    if (m_count == 0)
+    {
+        m_min = valueDb;
+        m_max = valueDb;
+    }
+    m_min = std::min(m_min, valueDb);
+    m_max = std::max(m_max, valueDb);
+    m_sum += valueDb;
+    m_count++;
+}
+
+uint32_t
+NrKpiHistogram::GetCount() const
+{
+    return m_count;
+}
+
+double
+NrKpiHistogram::GetMean() const
+{
+    return m_count > 0 ? m_sum / m_count : std::numeric_limits<double>::quiet_NaN();
+}
+
+double
+NrKpiHistogram::GetQuantile(double q) const
+{
+    NS_ASSERT_MSG(q >= 0.0 && q <= 1.0, "Invalid quantile " << q);
+    if (m_count == 0)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    // The extremes are exact, also outside of the range of the bins
+    if (q == 0.0)
+    {
+        return m_min;
+    }
+    if (q == 1.0)
+    {
+        return m_max;
+    }
+    auto target = q * m_count;
+    double cumulative = 0.0;
+    for (size_t i = 0; i < NUM_BINS; i++)
+    {
+        if (m_bins[i] > 0 && cumulative + m_bins[i] >= target)
+        {
+            auto fraction = (target - cumulative) / m_bins[i];
+            auto value = MIN_DB + (i + fraction) * BIN_WIDTH_DB;
+            return std::clamp(value, m_min, m_max);
+        }
+        cumulative += m_bins[i];
+    }
+    return m_max;
+}
+
+void
+NrKpiHistogram::Reset()
+{
+    *this = NrKpiHistogram{};
+}
+
+NrKpiAggregator::NrKpiAggregator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrKpiAggregator::~NrKpiAggregator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+NrKpiAggregator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrKpiAggregator")
+            .SetParent<NrStatsCalculator>()
+            .SetGroupName("nr")
+            .AddConstructor<NrKpiAggregator>()
+            .AddAttribute("EpochDuration",
+                          "Duration of the epochs. A summary is written at the end of each one.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&NrKpiAggregator::m_epochDuration),
+                          MakeTimeChecker(TimeStep(1)))
+            .AddAttribute("DlOutputFilename",
+                          "Name of the file where the downlink summaries will be saved.",
+                          StringValue("NrDlKpiSummary.txt"),
+                          MakeStringAccessor(&NrKpiAggregator::SetDlOutputFilename),
+                          MakeStringChecker())
+            .AddAttribute("UlOutputFilename",
+                          "Name of the file where the uplink summaries will be saved.",
+                          StringValue("NrUlKpiSummary.txt"),
+                          MakeStringAccessor(&NrKpiAggregator::SetUlOutputFilename),
+                          MakeStringChecker());
+    return tid;
+}
+
+void
+NrKpiAggregator::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    EndEpoch();
+    m_dlOutFile.close();
+    m_ulOutFile.close();
+    NrStatsCalculator::DoDispose();
+}
+
+void
+NrKpiAggregator::DlDataSinr(uint16_t cellId, uint16_t rnti, double avgSinr, uint16_t bwpId)
+{
+    NS_LOG_FUNCTION(this << cellId << rnti << avgSinr << bwpId);
+    GetKpis(cellId, bwpId, rnti, false).m_dataSinr.Add(10 * std::log10(avgSinr));
+}
+
+void
+NrKpiAggregator::RxPacket(const NrRxPacketTraceRecord& record)
+{
+    NS_LOG_FUNCTION(this << record.m_cellId << record.m_rnti);
+    auto& kpis = GetKpis(static_cast<uint16_t>(record.m_cellId),
+                         record.m_bwpId,
+                         record.m_rnti,
+                         record.m_isUplink);
+    kpis.m_numTbs++;
+    if (record.m_corrupt)
+    {
+        kpis.m_numCorruptTbs++;
+    }
+    else
+    {
+        kpis.m_rxBytes += record.m_tbSize;
+    }
+    kpis.m_tblerSum += record.m_tbler;
+    kpis.m_tbSinr.Add(10 * std::log10(record.m_sinr));
+    if (record.m_mcs < kpis.m_mcs.size())
+    {
+        kpis.m_mcs[record.m_mcs]++;
+    }
+}
+
+void
+NrKpiAggregator::Scheduling(uint16_t cellId,
+                            const NrSchedulingCallbackInfo& traceInfo,
+                            bool isUplink)
+{
+    NS_LOG_FUNCTION(this << cellId << traceInfo.m_rnti << isUplink);
+    auto& kpis = GetKpis(cellId, traceInfo.m_bwpId, traceInfo.m_rnti, isUplink);
+    kpis.m_numScheduledTbs++;
+    kpis.m_scheduledBytes += traceInfo.m_tbSize;
+    if (traceInfo.m_rv != 0)
+    {
+        kpis.m_numRetx++;
+    }
+}
+
+void
+NrKpiAggregator::DlDataSinrCallback(Ptr<NrKpiAggregator> aggregator,
+                                    [[maybe_unused]] std::string path,
+                                    uint16_t cellId,
+                                    uint16_t rnti,
+                                    double avgSinr,
+                                    uint16_t bwpId)
+{
+    aggregator->DlDataSinr(cellId, rnti, avgSinr, bwpId);
+}
+
+/**
+ * \brief Create the record of a received TB, with the fields used by NrKpiAggregator
+ * \param params the parameters of the received TB
+ * \param isUplink whether the TB was received by the gNB
+ * \return the record
+ */
+static NrRxPacketTraceRecord
+CreateKpiRecord(const RxPacketTraceParams& params, bool isUplink)
+{
+    NrRxPacketTraceRecord record{};
+    record.m_sinr = params.m_sinr;
+    record.m_tbler = params.m_tbler;
+    record.m_cellId = params.m_cellId;
+    record.m_tbSize = params.m_tbSize;
+    record.m_rnti = params.m_rnti;
+    record.m_bwpId = params.m_bwpId;
+    record.m_mcs = params.m_mcs;
+    record.m_corrupt = params.m_corrupt;
+    record.m_isUplink = isUplink;
+    return record;
+}
+
+void
+NrKpiAggregator::RxPacketTraceUeCallback(Ptr<NrKpiAggregator> aggregator,
+                                         [[maybe_unused]] std::string path,
+                                         RxPacketTraceParams params)
+{
+    aggregator->RxPacket(CreateKpiRecord(params, false));
+}
+
+void
+NrKpiAggregator::RxPacketTraceGnbCallback(Ptr<NrKpiAggregator> aggregator,
+                                          [[maybe_unused]] std::string path,
+                                          RxPacketTraceParams params)
+{
+    aggregator->RxPacket(CreateKpiRecord(params, true));
+}
+
+uint16_t
+NrKpiAggregator::GetGnbMacCellId(const std::string& path)
+{
+    // The cell ID depends only on the gNB device
+    std::string pathGnb = path.substr(0, path.find("/BandwidthPartMap"));
+    if (ExistsCellIdPath(pathGnb))
+    {
+        return GetCellIdPath(pathGnb);
+    }
+    auto cellId = FindCellIdFromGnbRlcPath(pathGnb);
+    SetCellIdPath(pathGnb, cellId);
+    return cellId;
+}
+
+void
+NrKpiAggregator::DlSchedulingCallback(Ptr<NrKpiAggregator> aggregator,
+                                      std::string path,
+                                      NrSchedulingCallbackInfo traceInfo)
+{
+    aggregator->Scheduling(aggregator->GetGnbMacCellId(path), traceInfo, false);
+}
+
+void
+NrKpiAggregator::UlSchedulingCallback(Ptr<NrKpiAggregator> aggregator,
+                                      std::string path,
+                                      NrSchedulingCallbackInfo traceInfo)
+{
+    aggregator->Scheduling(aggregator->GetGnbMacCellId(path), traceInfo, true);
+}
+
+NrKpiAggregator::Kpis&
+NrKpiAggregator::GetKpis(uint16_t cellId, uint16_t bwpId, uint16_t rnti, bool isUplink)
+{
+    if (!m_endEpochEvent.IsPending())
+    {
+        // Start the epoch that contains the current time. The next one is started by the next
+        // sample, so that the epochs do not keep the simulation running.
+        auto now = Simulator::Now();
+        auto epoch = m_epochDuration.GetTimeStep();
+        m_epochStart = TimeStep((now.GetTimeStep() / epoch) * epoch);
+        m_endEpochEvent = Simulator::Schedule(m_epochStart + m_epochDuration - now,
+                                              &NrKpiAggregator::EndEpoch,
+                                              this);
+        if (!m_destroyScheduled)
+        {
+            m_destroyScheduled = true;
+            Simulator::ScheduleDestroy(&NrKpiAggregator::EndLastEpoch, Ptr<NrKpiAggregator>(this));
+        }
+    }
+    auto key = (static_cast<uint64_t>(cellId) << 32) | (static_cast<uint64_t>(bwpId) << 16) |
+               static_cast<uint64_t>(rnti);
+    return (isUplink ? m_ulKpis : m_dlKpis)[key];
+}
+
+void
+NrKpiAggregator::EndEpoch()
+{
+    NS_LOG_FUNCTION(this);
+    m_endEpochEvent.Cancel();
+    auto end = std::min(Simulator::Now(), m_epochStart + m_epochDuration);
+    WriteSummaries(m_dlOutFile, GetDlOutputFilename(), m_dlKpis, m_epochStart, end);
+    WriteSummaries(m_ulOutFile, GetUlOutputFilename(), m_ulKpis, m_epochStart, end);
+    m_dlKpis.clear();
+    m_ulKpis.clear();
+}
+
+void
+NrKpiAggregator::EndLastEpoch()
+{
+    NS_LOG_FUNCTION(this);
+    m_destroyScheduled = false;
+    EndEpoch();
+    // The simulation is over: close the files, so that they are complete even if the trace
+    // files were flushed before
+    m_dlOutFile.close();
+    m_ulOutFile.close();
+}
+
+void
+NrKpiAggregator::WriteSummaries(NrTraceOfstream& os,
+                                const std::string& filename,
+                                const std::map<uint64_t, Kpis>& kpis,
+                                Time start,
+                                Time end)
+{
+    if (kpis.empty())
+    {
+        return;
+    }
+    if (!os.is_open())
+    {
+        os.open(filename);
+        if (!os.is_open())
+        {
+            NS_LOG_ERROR("Can't open file " << filename);
+            return;
+        }
+        os << "% start(s)\tend(s)\tCellId\tBwpId\tRNTI\tnTbs\tnCorruptTbs\tBLER\tavgTBler\t"
+              "rxBytes\tthroughput(Mbps)\tsinrMean(dB)\tsinrP5(dB)\tsinrP50(dB)\tsinrP95(dB)\t"
+              "dataSinrMean(dB)\tdataSinrP5(dB)\tdataSinrP50(dB)\tdataSinrP95(dB)\t"
+              "nSchedTbs\tschedBytes\tnRetx\tmcs:nTbs\n";
+    }
+
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    const auto duration = (end - start).GetSeconds();
+    for (const auto& [key, k] : kpis)
+    {
+        os << start.GetSeconds() << "\t" << end.GetSeconds() << "\t" << (key >> 32) << "\t"
+           << ((key >> 16) & 0xFFFF) << "\t" << (key & 0xFFFF) << "\t";
+        os << k.m_numTbs << "\t" << k.m_numCorruptTbs << "\t"
+           << (k.m_numTbs > 0 ? static_cast<double>(k.m_numCorruptTbs) / k.m_numTbs : nan)
+           << "\t" << (k.m_numTbs > 0 ? k.m_tblerSum / k.m_numTbs : nan) << "\t";
+        os << k.m_rxBytes << "\t" << (duration > 0 ? k.m_rxBytes * 8 / duration / 1e6 : nan)
+           << "\t";
+        for (const auto* sinr : {&k.m_tbSinr, &k.m_dataSinr})
+        {
+            os << sinr->GetMean() << "\t" << sinr->GetQuantile(0.05) << "\t"
+               << sinr->GetQuantile(0.5) << "\t" << sinr->GetQuantile(0.95) << "\t";
+        }
+        os << k.m_numScheduledTbs << "\t" << k.m_scheduledBytes << "\t" << k.m_numRetx << "\t";
+        // Sparse MCS histogram, e.g. "5:10,7:3"
+        bool first = true;
+        for (size_t mcs = 0; mcs < k.m_mcs.size(); mcs++)
+        {
+            if (k.m_mcs[mcs] > 0)
+            {
+                os << (first ? "" : ",") << mcs << ":" << k.m_mcs[mcs];
+                first = false;
+            }
+        }
+        os << (first ? "-" : "") << "\n";
+    }
+}
+
+} // namespace ns3
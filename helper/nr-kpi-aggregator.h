@@ -0,0 +1,268 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_KPI_AGGREGATOR_H
+#define NR_KPI_AGGREGATOR_H
+
+#include "nr-binary-trace.h"
+#include "nr-stats-calculator.h"
+#include "nr-trace-io-service.h"
+
+#include <ns3/event-id.h>
+#include <ns3/nr-phy-mac-common.h>
+#include <ns3/nstime.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr
+ * \brief Streaming histogram of a KPI in dB, with a fixed memory
+ *
+ * The values are counted in bins of BIN_WIDTH_DB dB between MIN_DB and MAX_DB; the values
+ * outside of the range are counted in the first and last bins. The mean, minimum and maximum
+ * are exact, and the quantiles are interpolated linearly inside their bin.
+ */
+class NrKpiHistogram
+{
+  public:
+    static constexpr double MIN_DB = -20.0;     //!< Lower edge of the first bin (dB)
+    static constexpr double MAX_DB = 50.0;      //!< Upper edge of the last bin (dB)
+    static constexpr double BIN_WIDTH_DB = 0.5; //!< Width of the bins (dB)
+    /// Number of bins
+    static constexpr size_t NUM_BINS = static_cast<size_t>((MAX_DB - MIN_DB) / BIN_WIDTH_DB);
+
+    /**
+     * \brief Add a value
+     * \param valueDb the value (dB)
+     */
+    void Add(double valueDb);
+
+    /**
+     * \brief Get the number of values
+     * \return the number of values
+     */
+    uint32_t GetCount() const;
+
+    /**
+     * \brief Get the mean of the values
+     * \return the mean (dB), or NaN if there are no values
+     */
+    double GetMean() const;
+
+    /**
+     * \brief Get a quantile of the values
+     * \param q the quantile, in [0, 1]
+     * \return the quantile (dB), or NaN if there are no values
+     */
+    double GetQuantile(double q) const;
+
+    /**
+     * \brief Remove all the values
+     */
+    void Reset();
+
+  private:
+    std::array<uint32_t, NUM_BINS> m_bins{}; //!< The number of values in each bin
+    uint32_t m_count{0};                     //!< The number of values
+    double m_sum{0.0};                       //!< The sum of the values (dB)
+    double m_min{0.0};                       //!< The minimum value (dB)
+    double m_max{0.0};                       //!< The maximum value (dB)
+};
+
+/**
+ * \ingroup nr
+ * \brief Trace sink that aggregates the PHY and MAC KPIs in memory, and writes only a summary
+ * per epoch
+ *
+ * The sink is connected to the same trace sources as NrPhyRxTrace (DlDataSinr and the
+ * RxPacketTrace of UEs and gNBs) and as NrMacSchedulingStats (DlScheduling and UlScheduling).
+ * Instead of a row per TB, it keeps, for each (cell, BWP, RNTI) and direction, counters and
+ * fixed-size histograms: the number of TBs and of corrupted TBs, the received bytes, the
+ * histograms of the SINR of the TBs and of the DL data SINR, the histogram of the MCS, and the
+ * number of scheduled TBs, bytes and retransmissions.
+ *
+ * At the end of each epoch, like NrBearerStatsCalculator, a row per (cell, BWP, RNTI) is
+ * written to the DL and UL output files, and the statistics are reset. The epochs are aligned
+ * to multiples of EpochDuration, and the last (partial) epoch is written at
+ * Simulator::Destroy, when the files are closed. An epoch without samples writes no rows.
+ */
+class NrKpiAggregator : public NrStatsCalculator
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrKpiAggregator();
+
+    /**
+     * \brief Destructor
+     */
+    ~NrKpiAggregator() override;
+
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Add the DL data SINR of a UE
+     * \param cellId the cell ID
+     * \param rnti the RNTI of the UE
+     * \param avgSinr the average SINR (linear)
+     * \param bwpId the BWP ID
+     */
+    void DlDataSinr(uint16_t cellId, uint16_t rnti, double avgSinr, uint16_t bwpId);
+
+    /**
+     * \brief Add a received TB
+     * \param record the TB, in the format of the RxPacketTrace of NrPhyRxTrace
+     */
+    void RxPacket(const NrRxPacketTraceRecord& record);
+
+    /**
+     * \brief Add a scheduled TB
+     * \param cellId the cell ID
+     * \param traceInfo the scheduling information
+     * \param isUplink whether the TB is an UL one
+     */
+    void Scheduling(uint16_t cellId, const NrSchedulingCallbackInfo& traceInfo, bool isUplink);
+
+    /**
+     * \brief Trace sink for the DlDataSinr trace source of NrUePhy
+     * \param aggregator the aggregator
+     * \param path the trace source path
+     * \param cellId the cell ID
+     * \param rnti the RNTI of the UE
+     * \param avgSinr the average SINR (linear)
+     * \param bwpId the BWP ID
+     */
+    static void DlDataSinrCallback(Ptr<NrKpiAggregator> aggregator,
+                                   std::string path,
+                                   uint16_t cellId,
+                                   uint16_t rnti,
+                                   double avgSinr,
+                                   uint16_t bwpId);
+
+    /**
+     * \brief Trace sink for the RxPacketTraceUe trace source of NrSpectrumPhy
+     * \param aggregator the aggregator
+     * \param path the trace source path
+     * \param params the parameters of the received TB
+     */
+    static void RxPacketTraceUeCallback(Ptr<NrKpiAggregator> aggregator,
+                                        std::string path,
+                                        RxPacketTraceParams params);
+
+    /**
+     * \brief Trace sink for the RxPacketTraceEnb trace source of NrSpectrumPhy
+     * \param aggregator the aggregator
+     * \param path the trace source path
+     * \param params the parameters of the received TB
+     */
+    static void RxPacketTraceGnbCallback(Ptr<NrKpiAggregator> aggregator,
+                                         std::string path,
+                                         RxPacketTraceParams params);
+
+    /**
+     * \brief Trace sink for the DlScheduling trace source of NrGnbMac
+     * \param aggregator the aggregator
+     * \param path the trace source path
+     * \param traceInfo the scheduling information
+     */
+    static void DlSchedulingCallback(Ptr<NrKpiAggregator> aggregator,
+                                     std::string path,
+                                     NrSchedulingCallbackInfo traceInfo);
+
+    /**
+     * \brief Trace sink for the UlScheduling trace source of NrGnbMac
+     * \param aggregator the aggregator
+     * \param path the trace source path
+     * \param traceInfo the scheduling information
+     */
+    static void UlSchedulingCallback(Ptr<NrKpiAggregator> aggregator,
+                                     std::string path,
+                                     NrSchedulingCallbackInfo traceInfo);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief The KPIs of a (cell, BWP, RNTI) in a direction, during an epoch
+     */
+    struct Kpis
+    {
+        uint32_t m_numTbs{0};             //!< Number of received TBs
+        uint32_t m_numCorruptTbs{0};      //!< Number of corrupted TBs
+        uint64_t m_rxBytes{0};            //!< Bytes of the TBs received without errors
+        double m_tblerSum{0.0};           //!< Sum of the TBLER of the TBs
+        NrKpiHistogram m_tbSinr;          //!< SINR of the received TBs
+        NrKpiHistogram m_dataSinr;        //!< DL data SINR reported by the UE
+        std::array<uint32_t, 32> m_mcs{}; //!< Number of received TBs per MCS
+        uint32_t m_numScheduledTbs{0};    //!< Number of scheduled TBs
+        uint64_t m_scheduledBytes{0};     //!< Bytes of the scheduled TBs
+        uint32_t m_numRetx{0};            //!< Number of scheduled retransmissions
+    };
+
+    /**
+     * \brief Get the KPIs of a (cell, BWP, RNTI) in a direction, starting the epoch if needed
+     * \param cellId the cell ID
+     * \param bwpId the BWP ID
+     * \param rnti the RNTI
+     * \param isUplink whether the direction is UL
+     * \return the KPIs
+     */
+    Kpis& GetKpis(uint16_t cellId, uint16_t bwpId, uint16_t rnti, bool isUplink);
+
+    /**
+     * \brief Get the cell ID of the gNB of a NrGnbMac trace source, cached by gNB path
+     * \param path the trace source path
+     * \return the cell ID
+     */
+    uint16_t GetGnbMacCellId(const std::string& path);
+
+    /**
+     * \brief Write the summaries of the epoch, and reset the KPIs
+     */
+    void EndEpoch();
+
+    /**
+     * \brief Write the summaries of the last epoch, and close the files, at Simulator::Destroy
+     */
+    void EndLastEpoch();
+
+    /**
+     * \brief Write the summaries of a direction
+     * \param os the output file
+     * \param filename the name of the output file
+     * \param kpis the KPIs of the direction
+     * \param start the start of the epoch
+     * \param end the end of the epoch
+     */
+    static void WriteSummaries(NrTraceOfstream& os,
+                               const std::string& filename,
+                               const std::map<uint64_t, Kpis>& kpis,
+                               Time start,
+                               Time end);
+
+    Time m_epochDuration;              //!< Duration of the epochs
+    Time m_epochStart;                 //!< Start of the current epoch
+    EventId m_endEpochEvent;           //!< The end of the current epoch
+    bool m_destroyScheduled{false};    //!< Whether the last epoch is written at Destroy
+    std::map<uint64_t, Kpis> m_dlKpis; //!< DL KPIs, by (cell, BWP, RNTI)
+    std::map<uint64_t, Kpis> m_ulKpis; //!< UL KPIs, by (cell, BWP, RNTI)
+    NrTraceOfstream m_dlOutFile;       //!< DL output file, open after the first epoch
+    NrTraceOfstream m_ulOutFile;       //!< UL output file, open after the first epoch
+};
+
+} // namespace ns3
+
+#endif // NR_KPI_AGGREGATOR_H
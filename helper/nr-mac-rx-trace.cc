@@ -18,14 +18,14 @@ NS_LOG_COMPONENT_DEFINE("NrMacRxTrace");
 
 NS_OBJECT_ENSURE_REGISTERED(NrMacRxTrace);
 
-std::ofstream NrMacRxTrace::m_rxedGnbMacCtrlMsgsFile;
+NrTraceOfstream NrMacRxTrace::m_rxedGnbMacCtrlMsgsFile;
 std::string NrMacRxTrace::m_rxedGnbMacCtrlMsgsFileName;
-std::ofstream NrMacRxTrace::m_txedGnbMacCtrlMsgsFile;
+NrTraceOfstream NrMacRxTrace::m_txedGnbMacCtrlMsgsFile;
 std::string NrMacRxTrace::m_txedGnbMacCtrlMsgsFileName;
 
-std::ofstream NrMacRxTrace::m_rxedUeMacCtrlMsgsFile;
+NrTraceOfstream NrMacRxTrace::m_rxedUeMacCtrlMsgsFile;
 std::string NrMacRxTrace::m_rxedUeMacCtrlMsgsFileName;
-std::ofstream NrMacRxTrace::m_txedUeMacCtrlMsgsFile;
+NrTraceOfstream NrMacRxTrace::m_txedUeMacCtrlMsgsFile;
 std::string NrMacRxTrace::m_txedUeMacCtrlMsgsFileName;
 
 NrMacRxTrace::NrMacRxTrace()
@@ -7,6 +7,8 @@
 #ifndef SRC_NR_HELPER_NR_MAC_RX_TRACE_H_
 #define SRC_NR_HELPER_NR_MAC_RX_TRACE_H_
 
+#include "nr-trace-io-service.h"
+
 #include <ns3/nr-control-messages.h>
 #include <ns3/nr-phy-mac-common.h>
 #include <ns3/object.h>
@@ -105,14 +107,14 @@ class NrMacRxTrace : public Object
                                           Ptr<const NrControlMessage> msg);
 
   private:
-    static std::ofstream m_rxedGnbMacCtrlMsgsFile;
+    static NrTraceOfstream m_rxedGnbMacCtrlMsgsFile;
     static std::string m_rxedGnbMacCtrlMsgsFileName;
-    static std::ofstream m_txedGnbMacCtrlMsgsFile;
+    static NrTraceOfstream m_txedGnbMacCtrlMsgsFile;
     static std::string m_txedGnbMacCtrlMsgsFileName;
 
-    static std::ofstream m_rxedUeMacCtrlMsgsFile;
+    static NrTraceOfstream m_rxedUeMacCtrlMsgsFile;
     static std::string m_rxedUeMacCtrlMsgsFileName;
-    static std::ofstream m_txedUeMacCtrlMsgsFile;
+    static NrTraceOfstream m_txedUeMacCtrlMsgsFile;
     static std::string m_txedUeMacCtrlMsgsFileName;
 };
 
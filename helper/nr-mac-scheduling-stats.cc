@@ -7,6 +7,7 @@
 #include "nr-mac-scheduling-stats.h"
 
 #include "ns3/string.h"
+#include <ns3/enum.h>
 #include <ns3/log.h>
 #include <ns3/simulator.h>
 
@@ -27,6 +28,8 @@ NrMacSchedulingStats::NrMacSchedulingStats()
 NrMacSchedulingStats::~NrMacSchedulingStats()
 {
     NS_LOG_FUNCTION(this);
+    m_dlBinaryFile.reset();
+    m_ulBinaryFile.reset();
     if (outDlFile.is_open())
     {
         outDlFile.close();
@@ -54,7 +57,17 @@ NrMacSchedulingStats::GetTypeId()
                           "Name of the file where the uplink results will be saved.",
                           StringValue("NrUlMacStats.txt"),
                           MakeStringAccessor(&NrMacSchedulingStats::SetUlOutputFilename),
-                          MakeStringChecker());
+                          MakeStringChecker())
+            .AddAttribute("TraceFormat",
+                          "Format of the output files. The BINARY files can be converted to the "
+                          "TEXT ones with NrBinaryTraceReader::ConvertToText.",
+                          EnumValue(NrTraceFormat::TEXT),
+                          MakeEnumAccessor<NrTraceFormat>(&NrMacSchedulingStats::SetTraceFormat,
+                                                          &NrMacSchedulingStats::GetTraceFormat),
+                          MakeEnumChecker(NrTraceFormat::TEXT,
+                                          "TEXT",
+                                          NrTraceFormat::BINARY,
+                                          "BINARY"));
     return tid;
 }
 
@@ -66,17 +79,22 @@ NrMacSchedulingStats::SetUlOutputFilename(std::string outputFilename)
     {
         outUlFile.close();
     }
+    m_ulBinaryFile.reset();
+    if (m_traceFormat == NrTraceFormat::BINARY)
+    {
+        m_ulBinaryFile =
+            std::make_unique<NrBinaryTraceWriter>(GetUlOutputFilename(),
+                                                  NrMacSchedulingTraceRecord::TYPE,
+                                                  sizeof(NrMacSchedulingTraceRecord));
+        return;
+    }
     outUlFile.open(GetUlOutputFilename().c_str());
     if (!outUlFile.is_open())
     {
         NS_LOG_ERROR("Can't open file " << GetUlOutputFilename().c_str());
         return;
     }
-    outUlFile << "% "
-                 "time(s)"
-                 "\tcellId\tbwpId\tIMSI\tRNTI\tframe\tsframe\tslot\tsymStart\tnumSym\thar"
-                 "qId\tndi\trv\tmcs\ttbSize";
-    outUlFile << std::endl;
+    NrMacSchedulingTraceRecord::WriteTextHeader(outUlFile, NrMacSchedulingTraceRecord{});
 }
 
 std::string
@@ -93,17 +111,22 @@ NrMacSchedulingStats::SetDlOutputFilename(std::string outputFilename)
     {
         outDlFile.close();
     }
+    m_dlBinaryFile.reset();
+    if (m_traceFormat == NrTraceFormat::BINARY)
+    {
+        m_dlBinaryFile =
+            std::make_unique<NrBinaryTraceWriter>(GetDlOutputFilename(),
+                                                  NrMacSchedulingTraceRecord::TYPE,
+                                                  sizeof(NrMacSchedulingTraceRecord));
+        return;
+    }
     outDlFile.open(GetDlOutputFilename().c_str());
     if (!outDlFile.is_open())
     {
         NS_LOG_ERROR("Can't open file " << GetDlOutputFilename().c_str());
         return;
     }
-    outDlFile << "% "
-                 "time(s)"
-                 "\tcellId\tbwpId\tIMSI\tRNTI\tframe\tsframe\tslot\tsymStart\tnumSym\thar"
-                 "qId\tndi\trv\tmcs\ttbSize";
-    outDlFile << std::endl;
+    NrMacSchedulingTraceRecord::WriteTextHeader(outDlFile, NrMacSchedulingTraceRecord{});
 }
 
 std::string
@@ -112,6 +135,53 @@ NrMacSchedulingStats::GetDlOutputFilename()
     return NrStatsCalculator::GetDlOutputFilename();
 }
 
+void
+NrMacSchedulingStats::SetTraceFormat(NrTraceFormat format)
+{
+    NS_LOG_FUNCTION(this);
+    m_traceFormat = format;
+    // Reopen the files in the new format
+    SetDlOutputFilename(GetDlOutputFilename());
+    SetUlOutputFilename(GetUlOutputFilename());
+}
+
+NrTraceFormat
+NrMacSchedulingStats::GetTraceFormat() const
+{
+    return m_traceFormat;
+}
+
+/**
+ * \brief Create the record of a scheduled TB
+ * \param cellId Cell ID of the gNB
+ * \param imsi IMSI of the scheduled UE
+ * \param traceInfo the scheduling information
+ * \return the record
+ */
+static NrMacSchedulingTraceRecord
+CreateMacSchedulingTraceRecord(uint16_t cellId,
+                               uint64_t imsi,
+                               const NrSchedulingCallbackInfo& traceInfo)
+{
+    NrMacSchedulingTraceRecord record{};
+    record.m_time = Simulator::Now().GetSeconds();
+    record.m_imsi = imsi;
+    record.m_tbSize = traceInfo.m_tbSize;
+    record.m_cellId = cellId;
+    record.m_rnti = traceInfo.m_rnti;
+    record.m_frameNum = traceInfo.m_frameNum;
+    record.m_slotNum = traceInfo.m_slotNum;
+    record.m_bwpId = traceInfo.m_bwpId;
+    record.m_subframeNum = traceInfo.m_subframeNum;
+    record.m_symStart = traceInfo.m_symStart;
+    record.m_numSym = traceInfo.m_numSym;
+    record.m_harqId = traceInfo.m_harqId;
+    record.m_ndi = traceInfo.m_ndi;
+    record.m_rv = traceInfo.m_rv;
+    record.m_mcs = traceInfo.m_mcs;
+    return record;
+}
+
 void
 NrMacSchedulingStats::DlScheduling(uint16_t cellId,
                                    uint64_t imsi,
@@ -121,21 +191,15 @@ NrMacSchedulingStats::DlScheduling(uint16_t cellId,
                          << traceInfo.m_rnti << (uint32_t)traceInfo.m_mcs << traceInfo.m_tbSize);
     NS_LOG_INFO("Write DL Mac Stats in " << GetDlOutputFilename().c_str());
 
-    outDlFile << Simulator::Now().GetSeconds() << "\t";
-    outDlFile << (uint32_t)cellId << "\t";
-    outDlFile << (uint32_t)traceInfo.m_bwpId << "\t";
-    outDlFile << imsi << "\t";
-    outDlFile << traceInfo.m_rnti << "\t";
-    outDlFile << traceInfo.m_frameNum << "\t";
-    outDlFile << (uint32_t)traceInfo.m_subframeNum << "\t";
-    outDlFile << traceInfo.m_slotNum << "\t";
-    outDlFile << (uint32_t)traceInfo.m_symStart << "\t";
-    outDlFile << (uint32_t)traceInfo.m_numSym << "\t";
-    outDlFile << (uint32_t)traceInfo.m_harqId << "\t";
-    outDlFile << (uint32_t)traceInfo.m_ndi << "\t";
-    outDlFile << (uint32_t)traceInfo.m_rv << "\t";
-    outDlFile << (uint32_t)traceInfo.m_mcs << "\t";
-    outDlFile << traceInfo.m_tbSize << std::endl;
+    auto record = CreateMacSchedulingTraceRecord(cellId, imsi, traceInfo);
+    if (m_dlBinaryFile)
+    {
+        m_dlBinaryFile->Write(record);
+    }
+    else
+    {
+        record.WriteText(outDlFile);
+    }
 }
 
 void
@@ -147,21 +211,15 @@ NrMacSchedulingStats::UlScheduling(uint16_t cellId,
                          << traceInfo.m_rnti << (uint32_t)traceInfo.m_mcs << traceInfo.m_tbSize);
     NS_LOG_INFO("Write UL Mac Stats in " << GetUlOutputFilename().c_str());
 
-    outUlFile << Simulator::Now().GetSeconds() << "\t";
-    outUlFile << (uint32_t)cellId << "\t";
-    outUlFile << (uint32_t)traceInfo.m_bwpId << "\t";
-    outUlFile << imsi << "\t";
-    outUlFile << traceInfo.m_rnti << "\t";
-    outUlFile << traceInfo.m_frameNum << "\t";
-    outUlFile << (uint32_t)traceInfo.m_subframeNum << "\t";
-    outUlFile << traceInfo.m_slotNum << "\t";
-    outUlFile << (uint32_t)traceInfo.m_symStart << "\t";
-    outUlFile << (uint32_t)traceInfo.m_numSym << "\t";
-    outUlFile << (uint32_t)traceInfo.m_harqId << "\t";
-    outUlFile << (uint32_t)traceInfo.m_ndi << "\t";
-    outUlFile << (uint32_t)traceInfo.m_rv << "\t";
-    outUlFile << (uint32_t)traceInfo.m_mcs << "\t";
-    outUlFile << traceInfo.m_tbSize << std::endl;
+    auto record = CreateMacSchedulingTraceRecord(cellId, imsi, traceInfo);
+    if (m_ulBinaryFile)
+    {
+        m_ulBinaryFile->Write(record);
+    }
+    else
+    {
+        record.WriteText(outUlFile);
+    }
 }
 
 void
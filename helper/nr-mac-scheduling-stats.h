@@ -7,13 +7,16 @@
 #ifndef NR_MAC_SCHEDULING_STATS_H_
 #define NR_MAC_SCHEDULING_STATS_H_
 
+#include "nr-binary-trace.h"
 #include "nr-stats-calculator.h"
+#include "nr-trace-io-service.h"
 
 #include "ns3/nr-gnb-mac.h"
 #include "ns3/nstime.h"
 #include "ns3/uinteger.h"
 
 #include <fstream>
+#include <memory>
 #include <string>
 
 namespace ns3
@@ -80,6 +83,19 @@ class NrMacSchedulingStats : public NrStatsCalculator
      */
     std::string GetDlOutputFilename();
 
+    /**
+     * Set the format of the output files, and reopen them.
+     *
+     * \param format the format
+     */
+    void SetTraceFormat(NrTraceFormat format);
+
+    /**
+     * Get the format of the output files.
+     * \return the format
+     */
+    NrTraceFormat GetTraceFormat() const;
+
     /**
      * Notifies the stats calculator that an downlink scheduling has occurred.
      * \param cellId Cell ID of the attached gNb
@@ -127,13 +143,17 @@ class NrMacSchedulingStats : public NrStatsCalculator
      * is changed, columns description are added. Then
      * next lines are appended to file.
      */
-    std::ofstream outDlFile;
+    NrTraceOfstream outDlFile;
     /**
      * UL MAC statistics file stream. When the filename
      * is changed, columns description are added. Then
      * next lines are appended to file.
      */
-    std::ofstream outUlFile;
+    NrTraceOfstream outUlFile;
+
+    NrTraceFormat m_traceFormat{NrTraceFormat::TEXT}; //!< The format of the output files
+    std::unique_ptr<NrBinaryTraceWriter> m_dlBinaryFile; //!< DL binary file, in BINARY format
+    std::unique_ptr<NrBinaryTraceWriter> m_ulBinaryFile; //!< UL binary file, in BINARY format
 };
 
 } // namespace ns3
@@ -7,6 +7,7 @@
 
 #include "nr-phy-rx-trace.h"
 
+#include <ns3/enum.h>
 #include <ns3/log.h>
 #include <ns3/nr-gnb-net-device.h>
 #include <ns3/nr-ue-net-device.h>
@@ -23,45 +24,116 @@ NS_LOG_COMPONENT_DEFINE("NrPhyRxTrace");
 
 NS_OBJECT_ENSURE_REGISTERED(NrPhyRxTrace);
 
-std::ofstream NrPhyRxTrace::m_dlDataSinrFile;
+NrTraceOfstream NrPhyRxTrace::m_dlDataSinrFile;
 std::string NrPhyRxTrace::m_dlDataSinrFileName;
+std::unique_ptr<NrBinaryTraceWriter> NrPhyRxTrace::m_dlDataSinrBinaryFile;
 
-std::ofstream NrPhyRxTrace::m_dlCtrlSinrFile;
+NrTraceOfstream NrPhyRxTrace::m_dlCtrlSinrFile;
 std::string NrPhyRxTrace::m_dlCtrlSinrFileName;
+std::unique_ptr<NrBinaryTraceWriter> NrPhyRxTrace::m_dlCtrlSinrBinaryFile;
 
-std::ofstream NrPhyRxTrace::m_rxPacketTraceFile;
+NrTraceOfstream NrPhyRxTrace::m_rxPacketTraceFile;
 std::string NrPhyRxTrace::m_rxPacketTraceFilename;
+std::unique_ptr<NrBinaryTraceWriter> NrPhyRxTrace::m_rxPacketTraceBinaryFile;
 std::string NrPhyRxTrace::m_simTag;
 std::string NrPhyRxTrace::m_resultsFolder;
+NrTraceFormat NrPhyRxTrace::m_traceFormat = NrTraceFormat::TEXT;
 
-std::ofstream NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsFile;
+NrTraceOfstream NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsFile;
 std::string NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsFileName;
-std::ofstream NrPhyRxTrace::m_txedGnbPhyCtrlMsgsFile;
+NrTraceOfstream NrPhyRxTrace::m_txedGnbPhyCtrlMsgsFile;
 std::string NrPhyRxTrace::m_txedGnbPhyCtrlMsgsFileName;
 
-std::ofstream NrPhyRxTrace::m_rxedUePhyCtrlMsgsFile;
+NrTraceOfstream NrPhyRxTrace::m_rxedUePhyCtrlMsgsFile;
 std::string NrPhyRxTrace::m_rxedUePhyCtrlMsgsFileName;
-std::ofstream NrPhyRxTrace::m_txedUePhyCtrlMsgsFile;
+NrTraceOfstream NrPhyRxTrace::m_txedUePhyCtrlMsgsFile;
 std::string NrPhyRxTrace::m_txedUePhyCtrlMsgsFileName;
-std::ofstream NrPhyRxTrace::m_rxedUePhyDlDciFile;
+NrTraceOfstream NrPhyRxTrace::m_rxedUePhyDlDciFile;
 std::string NrPhyRxTrace::m_rxedUePhyDlDciFileName;
 
-std::ofstream NrPhyRxTrace::m_dlPathlossFile;
+NrTraceOfstream NrPhyRxTrace::m_dlPathlossFile;
 std::string NrPhyRxTrace::m_dlPathlossFileName;
-std::ofstream NrPhyRxTrace::m_ulPathlossFile;
+NrTraceOfstream NrPhyRxTrace::m_ulPathlossFile;
 std::string NrPhyRxTrace::m_ulPathlossFileName;
 
-std::ofstream NrPhyRxTrace::m_dlCtrlPathlossFile;
+NrTraceOfstream NrPhyRxTrace::m_dlCtrlPathlossFile;
 std::string NrPhyRxTrace::m_dlCtrlPathlossFileName;
-std::ofstream NrPhyRxTrace::m_dlDataPathlossFile;
+NrTraceOfstream NrPhyRxTrace::m_dlDataPathlossFile;
 std::string NrPhyRxTrace::m_dlDataPathlossFileName;
 
+template <typename Record>
+void
+NrPhyRxTrace::WriteTraceRecord(const Record& record,
+                               const std::string& prefix,
+                               NrTraceOfstream& textFile,
+                               std::string& fileName,
+                               std::unique_ptr<NrBinaryTraceWriter>& binaryFile)
+{
+    if (m_traceFormat == NrTraceFormat::BINARY)
+    {
+        if (!binaryFile)
+        {
+            fileName = prefix + ".bin";
+            binaryFile =
+                std::make_unique<NrBinaryTraceWriter>(fileName, Record::TYPE, sizeof(Record));
+        }
+        binaryFile->Write(record);
+        return;
+    }
+
+    if (!textFile.is_open())
+    {
+        fileName = prefix + ".txt";
+        textFile.open(fileName.c_str());
+        if (!textFile.is_open())
+        {
+            NS_FATAL_ERROR("Could not open tracefile");
+        }
+        Record::WriteTextHeader(textFile, record);
+    }
+    record.WriteText(textFile);
+}
+
+/**
+ * \brief Create the record of the RxPacketTrace trace
+ * \param params the parameters of the received TB
+ * \param isUplink whether the TB was received by the gNB
+ * \return the record
+ */
+static NrRxPacketTraceRecord
+CreateRxPacketTraceRecord(const RxPacketTraceParams& params, bool isUplink)
+{
+    NrRxPacketTraceRecord record{};
+    record.m_time = Simulator::Now().GetNanoSeconds() / (double)1e9;
+    record.m_sinr = params.m_sinr;
+    record.m_tbler = params.m_tbler;
+    record.m_cellId = params.m_cellId;
+    record.m_frameNum = params.m_frameNum;
+    record.m_tbSize = params.m_tbSize;
+    record.m_rnti = params.m_rnti;
+    record.m_slotNum = params.m_slotNum;
+    record.m_bwpId = params.m_bwpId;
+    record.m_subframeNum = params.m_subframeNum;
+    record.m_symStart = params.m_symStart;
+    record.m_numSym = params.m_numSym;
+    record.m_mcs = params.m_mcs;
+    record.m_rank = params.m_rank;
+    record.m_rv = params.m_rv;
+    record.m_corrupt = params.m_corrupt;
+    record.m_isUplink = isUplink;
+    return record;
+}
+
 NrPhyRxTrace::NrPhyRxTrace()
 {
 }
 
 NrPhyRxTrace::~NrPhyRxTrace()
 {
+    m_dlDataSinrBinaryFile.reset();
+    m_dlCtrlSinrBinaryFile.reset();
+    m_rxPacketTraceBinaryFile.reset();
+
     if (m_dlDataSinrFile.is_open())
     {
         m_dlDataSinrFile.close();
@@ -136,7 +208,18 @@ NrPhyRxTrace::GetTypeId()
                 "in order to distinguish them, for example: RxPacketTrace-${SimTag}.out. ",
                 StringValue(""),
                 MakeStringAccessor(&NrPhyRxTrace::SetSimTag),
-                MakeStringChecker());
+                MakeStringChecker())
+            .AddAttribute("TraceFormat",
+                          "Format of the DlDataSinr, DlCtrlSinr and RxPacketTrace files. The "
+                          "BINARY files (*.bin) can be converted to the TEXT ones (*.txt) with "
+                          "NrBinaryTraceReader::ConvertToText.",
+                          EnumValue(NrTraceFormat::TEXT),
+                          MakeEnumAccessor<NrTraceFormat>(&NrPhyRxTrace::SetTraceFormat,
+                                                          &NrPhyRxTrace::GetTraceFormat),
+                          MakeEnumChecker(NrTraceFormat::TEXT,
+                                          "TEXT",
+                                          NrTraceFormat::BINARY,
+                                          "BINARY"));
     return tid;
 }
 
@@ -152,6 +235,18 @@ NrPhyRxTrace::SetResultsFolder(const std::string& resultsFolder)
     m_resultsFolder = resultsFolder;
 }
 
+void
+NrPhyRxTrace::SetTraceFormat(NrTraceFormat format)
+{
+    m_traceFormat = format;
+}
+
+NrTraceFormat
+NrPhyRxTrace::GetTraceFormat() const
+{
+    return m_traceFormat;
+}
+
 void
 NrPhyRxTrace::DlDataSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
                                  [[maybe_unused]] std::string path,
@@ -162,31 +257,17 @@ NrPhyRxTrace::DlDataSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
 {
     NS_LOG_INFO("UE" << rnti << "of " << cellId << " over bwp ID " << bwpId
                      << "->Generate RsrpSinrTrace");
-    if (!m_dlDataSinrFile.is_open())
-    {
-        std::ostringstream oss;
-        oss << m_resultsFolder << "DlDataSinr" << m_simTag.c_str() << ".txt";
-        m_dlDataSinrFileName = oss.str();
-        m_dlDataSinrFile.open(m_dlDataSinrFileName.c_str());
-
-        m_dlDataSinrFile << "Time"
-                         << "\t"
-                         << "CellId"
-                         << "\t"
-                         << "RNTI"
-                         << "\t"
-                         << "BWPId"
-                         << "\t"
-                         << "SINR(dB)" << std::endl;
-
-        if (!m_dlDataSinrFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-
-    m_dlDataSinrFile << Simulator::Now().GetSeconds() << "\t" << cellId << "\t" << rnti << "\t"
-                     << bwpId << "\t" << 10 * log10(avgSinr) << std::endl;
+    NrSinrTraceRecord record{};
+    record.m_time = Simulator::Now().GetSeconds();
+    record.m_sinr = avgSinr;
+    record.m_cellId = cellId;
+    record.m_rnti = rnti;
+    record.m_bwpId = bwpId;
+    WriteTraceRecord(record,
+                     m_resultsFolder + "DlDataSinr" + m_simTag,
+                     m_dlDataSinrFile,
+                     m_dlDataSinrFileName,
+                     m_dlDataSinrBinaryFile);
 }
 
 void
@@ -199,32 +280,17 @@ NrPhyRxTrace::DlCtrlSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
 {
     NS_LOG_INFO("UE" << rnti << "of " << cellId << " over bwp ID " << bwpId
                      << "->Generate DlCtrlSinrTrace");
-
-    if (!m_dlCtrlSinrFile.is_open())
-    {
-        std::ostringstream oss;
-        oss << m_resultsFolder << "DlCtrlSinr" << m_simTag.c_str() << ".txt";
-        m_dlCtrlSinrFileName = oss.str();
-        m_dlCtrlSinrFile.open(m_dlCtrlSinrFileName.c_str());
-
-        m_dlCtrlSinrFile << "Time"
-                         << "\t"
-                         << "CellId"
-                         << "\t"
-                         << "RNTI"
-                         << "\t"
-                         << "BWPId"
-                         << "\t"
-                         << "SINR(dB)" << std::endl;
-
-        if (!m_dlCtrlSinrFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-
-    m_dlCtrlSinrFile << Simulator::Now().GetSeconds() << "\t" << cellId << "\t" << rnti << "\t"
-                     << bwpId << "\t" << 10 * log10(avgSinr) << std::endl;
+    NrSinrTraceRecord record{};
+    record.m_time = Simulator::Now().GetSeconds();
+    record.m_sinr = avgSinr;
+    record.m_cellId = cellId;
+    record.m_rnti = rnti;
+    record.m_bwpId = bwpId;
+    WriteTraceRecord(record,
+                     m_resultsFolder + "DlCtrlSinr" + m_simTag,
+                     m_dlCtrlSinrFile,
+                     m_dlCtrlSinrFileName,
+                     m_dlCtrlSinrBinaryFile);
 }
 
 void
@@ -803,65 +869,11 @@ NrPhyRxTrace::RxPacketTraceUeCallback(Ptr<NrPhyRxTrace> phyStats,
                                       std::string path,
                                       RxPacketTraceParams params)
 {
-    if (!m_rxPacketTraceFile.is_open())
-    {
-        std::ostringstream oss;
-        oss << m_resultsFolder << "RxPacketTrace" << m_simTag.c_str() << ".txt";
-        m_rxPacketTraceFilename = oss.str();
-        m_rxPacketTraceFile.open(m_rxPacketTraceFilename.c_str());
-
-        m_rxPacketTraceFile << "Time"
-                            << "\t"
-                            << "direction"
-                            << "\t"
-                            << "frame"
-                            << "\t"
-                            << "subF"
-                            << "\t"
-                            << "slot"
-                            << "\t"
-                            << "1stSym"
-                            << "\t"
-                            << "nSymbol"
-                            << "\t"
-                            << "cellId"
-                            << "\t"
-                            << "bwpId"
-                            << "\t"
-                            << "rnti"
-                            << "\t"
-                            << "tbSize"
-                            << "\t"
-                            << "mcs"
-                            << "\t"
-                            << "rank"
-                            << "\t"
-                            << "rv"
-                            << "\t"
-                            << "SINR(dB)"
-                            << "\t"
-                            << "CQI"
-                            << "\t"
-                            << "corrupt"
-                            << "\t"
-                            << "TBler" << std::endl;
-
-        if (!m_rxPacketTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-
-    m_rxPacketTraceFile << Simulator::Now().GetNanoSeconds() / (double)1e9 << "\t"
-                        << "DL"
-                        << "\t" << params.m_frameNum << "\t" << (unsigned)params.m_subframeNum
-                        << "\t" << (unsigned)params.m_slotNum << "\t" << (unsigned)params.m_symStart
-                        << "\t" << (unsigned)params.m_numSym << "\t" << params.m_cellId << "\t"
-                        << (unsigned)params.m_bwpId << "\t" << params.m_rnti << "\t"
-                        << params.m_rnti << "\t" << params.m_tbSize << "\t"
-                        << (unsigned)params.m_mcs << "\t" << (unsigned)params.m_rank << "\t"
-                        << (unsigned)params.m_rv << "\t" << 10 * log10(params.m_sinr) << "\t"
-                        << params.m_corrupt << "\t" << params.m_tbler << "\t" << std::endl;
+    WriteTraceRecord(CreateRxPacketTraceRecord(params, false),
+                     m_resultsFolder + "RxPacketTrace" + m_simTag,
+                     m_rxPacketTraceFile,
+                     m_rxPacketTraceFilename,
+                     m_rxPacketTraceBinaryFile);
 
     if (params.m_corrupt)
     {
@@ -881,61 +893,11 @@ NrPhyRxTrace::RxPacketTraceEnbCallback(Ptr<NrPhyRxTrace> phyStats,
                                        std::string path,
                                        RxPacketTraceParams params)
 {
-    if (!m_rxPacketTraceFile.is_open())
-    {
-        std::ostringstream oss;
-        oss << m_resultsFolder << "RxPacketTrace" << m_simTag.c_str() << ".txt";
-        m_rxPacketTraceFilename = oss.str();
-        m_rxPacketTraceFile.open(m_rxPacketTraceFilename.c_str());
-
-        m_rxPacketTraceFile << "Time"
-                            << "\t"
-                            << "direction"
-                            << "\t"
-                            << "frame"
-                            << "\t"
-                            << "subF"
-                            << "\t"
-                            << "slot"
-                            << "\t"
-                            << "1stSym"
-                            << "\t"
-                            << "nSymbol"
-                            << "\t"
-                            << "cellId"
-                            << "\t"
-                            << "bwpId"
-                            << "\t"
-                            << "rnti"
-                            << "\t"
-                            << "tbSize"
-                            << "\t"
-                            << "mcs"
-                            << "\t"
-                            << "rank"
-                            << "\t"
-                            << "rv"
-                            << "\t"
-                            << "SINR(dB)"
-                            << "\t"
-                            << "corrupt"
-                            << "\t"
-                            << "TBler" << std::endl;
-
-        if (!m_rxPacketTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-    m_rxPacketTraceFile << Simulator::Now().GetNanoSeconds() / (double)1e9 << "\t"
-                        << "UL"
-                        << "\t" << params.m_frameNum << "\t" << (unsigned)params.m_subframeNum
-                        << "\t" << (unsigned)params.m_slotNum << "\t" << (unsigned)params.m_symStart
-                        << "\t" << (unsigned)params.m_numSym << "\t" << params.m_cellId << "\t"
-                        << (unsigned)params.m_bwpId << params.m_rnti << "\t" << params.m_tbSize
-                        << "\t" << (unsigned)params.m_mcs << "\t" << (unsigned)params.m_rank << "\t"
-                        << (unsigned)params.m_rv << "\t" << 10 * log10(params.m_sinr) << "\t"
-                        << params.m_corrupt << "\t" << params.m_tbler << "\t" << std::endl;
+    WriteTraceRecord(CreateRxPacketTraceRecord(params, true),
+                     m_resultsFolder + "RxPacketTrace" + m_simTag,
+                     m_rxPacketTraceFile,
+                     m_rxPacketTraceFilename,
+                     m_rxPacketTraceBinaryFile);
 
     if (params.m_corrupt)
     {
@@ -8,6 +8,9 @@
 #ifndef SRC_NR_HELPER_NR_PHY_RX_TRACE_H_
 #define SRC_NR_HELPER_NR_PHY_RX_TRACE_H_
 
+#include "nr-binary-trace.h"
+#include "nr-trace-io-service.h"
+
 #include <ns3/nr-control-messages.h>
 #include <ns3/nr-phy-mac-common.h>
 #include <ns3/nr-spectrum-phy.h>
@@ -17,6 +20,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
 
 namespace ns3
 {
@@ -41,6 +45,18 @@ class NrPhyRxTrace : public Object
      */
     void SetResultsFolder(const std::string& resultsFolder);
 
+    /**
+     * \brief Set the format of the DlDataSinr, DlCtrlSinr and RxPacketTrace files
+     * \param format the format
+     */
+    void SetTraceFormat(NrTraceFormat format);
+
+    /**
+     * \brief Get the format of the DlDataSinr, DlCtrlSinr and RxPacketTrace files
+     * \return the format
+     */
+    NrTraceFormat GetTraceFormat() const;
+
     /**
      * \brief Trace sink for DL Average SINR of DATA (in dB).
      * \param [in] phyStats NrPhyRxTrace object
@@ -262,6 +278,22 @@ class NrPhyRxTrace : public Object
                                      uint8_t cqi);
 
   private:
+    /**
+     * \brief Write a record to a trace, in the format of the TraceFormat attribute. The file is
+     * opened when the first record is written.
+     * \param record the record
+     * \param prefix the name of the file, without the extension
+     * \param textFile the text file of the trace
+     * \param fileName the name of the file of the trace
+     * \param binaryFile the binary file of the trace
+     */
+    template <typename Record>
+    static void WriteTraceRecord(const Record& record,
+                                 const std::string& prefix,
+                                 NrTraceOfstream& textFile,
+                                 std::string& fileName,
+                                 std::unique_ptr<NrBinaryTraceWriter>& binaryFile);
+
     void ReportInterferenceTrace(uint64_t imsi, SpectrumValue& sinr);
     void ReportPowerTrace(uint64_t imsi, SpectrumValue& power);
     void ReportPacketCountUe(UePhyPacketCountParameter param);
@@ -290,35 +322,39 @@ class NrPhyRxTrace : public Object
 
     static std::string m_simTag;        //!< The `SimTag` attribute.
     static std::string m_resultsFolder; //!< The results folder path
+    static NrTraceFormat m_traceFormat; //!< The `TraceFormat` attribute
 
-    static std::ofstream m_dlDataSinrFile;
+    static NrTraceOfstream m_dlDataSinrFile;
     static std::string m_dlDataSinrFileName;
+    static std::unique_ptr<NrBinaryTraceWriter> m_dlDataSinrBinaryFile;
 
-    static std::ofstream m_dlCtrlSinrFile;
+    static NrTraceOfstream m_dlCtrlSinrFile;
     static std::string m_dlCtrlSinrFileName;
+    static std::unique_ptr<NrBinaryTraceWriter> m_dlCtrlSinrBinaryFile;
 
-    static std::ofstream m_rxPacketTraceFile;
+    static NrTraceOfstream m_rxPacketTraceFile;
     static std::string m_rxPacketTraceFilename;
+    static std::unique_ptr<NrBinaryTraceWriter> m_rxPacketTraceBinaryFile;
 
-    static std::ofstream m_rxedGnbPhyCtrlMsgsFile;
+    static NrTraceOfstream m_rxedGnbPhyCtrlMsgsFile;
     static std::string m_rxedGnbPhyCtrlMsgsFileName;
-    static std::ofstream m_txedGnbPhyCtrlMsgsFile;
+    static NrTraceOfstream m_txedGnbPhyCtrlMsgsFile;
     static std::string m_txedGnbPhyCtrlMsgsFileName;
 
-    static std::ofstream m_rxedUePhyCtrlMsgsFile;
+    static NrTraceOfstream m_rxedUePhyCtrlMsgsFile;
     static std::string m_rxedUePhyCtrlMsgsFileName;
-    static std::ofstream m_txedUePhyCtrlMsgsFile;
+    static NrTraceOfstream m_txedUePhyCtrlMsgsFile;
     static std::string m_txedUePhyCtrlMsgsFileName;
-    static std::ofstream m_rxedUePhyDlDciFile;
+    static NrTraceOfstream m_rxedUePhyDlDciFile;
     static std::string m_rxedUePhyDlDciFileName;
-    static std::ofstream m_dlPathlossFile;
+    static NrTraceOfstream m_dlPathlossFile;
     static std::string m_dlPathlossFileName;
-    static std::ofstream m_ulPathlossFile;
+    static NrTraceOfstream m_ulPathlossFile;
     static std::string m_ulPathlossFileName;
 
-    static std::ofstream m_dlCtrlPathlossFile;
+    static NrTraceOfstream m_dlCtrlPathlossFile;
     static std::string m_dlCtrlPathlossFileName;
-    static std::ofstream m_dlDataPathlossFile;
+    static NrTraceOfstream m_dlDataPathlossFile;
     static std::string m_dlDataPathlossFileName;
 };
 
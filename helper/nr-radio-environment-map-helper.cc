@@ -10,6 +10,7 @@
 
 #include <ns3/abort.h>
 #include <ns3/beamforming-vector.h>
+#include <ns3/boolean.h>
 #include <ns3/buildings-module.h>
 #include <ns3/config.h>
 #include <ns3/double.h>
@@ -21,13 +22,21 @@
 #include <ns3/nr-spectrum-phy.h>
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/pointer.h>
+#include <ns3/rng-seed-manager.h>
 #include <ns3/simulator.h>
 #include <ns3/spectrum-converter.h>
 #include <ns3/string.h>
 #include <ns3/uinteger.h>
+#include <ns3/uniform-planar-array.h>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <limits>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <type_traits>
 
 namespace ns3
 {
@@ -36,6 +45,27 @@ NS_LOG_COMPONENT_DEFINE("NrRadioEnvironmentMapHelper");
 
 NS_OBJECT_ENSURE_REGISTERED(NrRadioEnvironmentMapHelper);
 
+/// First random variable stream of the temporal propagation models. The streams
+/// below it are left to the streams assigned by the user to the scenario.
+static constexpr int64_t REM_FIRST_STREAM = int64_t(1) << 40;
+
+/**
+ * \brief Adds a value to a FNV-1a hash
+ * \param value the value
+ * \param hash the hash to update
+ */
+template <class T>
+static void
+HashValue(const T& value, uint64_t& hash)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only the bytes of the value are hashed");
+    auto bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+}
+
 NrRadioEnvironmentMapHelper::NrRadioEnvironmentMapHelper()
 {
     NS_LOG_FUNCTION(this);
@@ -49,6 +79,7 @@ void
 NrRadioEnvironmentMapHelper::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_remWorkers.clear();
 }
 
 TypeId
@@ -153,7 +184,30 @@ NrRadioEnvironmentMapHelper::GetTypeId()
                 "depends on RRC message timing.",
                 TimeValue(MilliSeconds(100)),
                 MakeTimeAccessor(&NrRadioEnvironmentMapHelper::SetInstallationDelay),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("NumThreads",
+                          "Number of threads that compute the REM points, or 0 to use one "
+                          "per hardware thread. The map does not depend on the number of "
+                          "threads. Only one thread is used if there are buildings.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::SetNumThreads,
+                                               &NrRadioEnvironmentMapHelper::GetNumThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TileSize",
+                          "Number of points of each side of the square tiles in which the map "
+                          "is computed and written to a binary raster (nr-rem-${SimTag}.rem), "
+                          "or 0 to compute the whole map and write it as text.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::SetTileSize,
+                                               &NrRadioEnvironmentMapHelper::GetTileSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ResumeTiles",
+                          "Whether a tiled map resumes the raster of an interrupted map with "
+                          "the same parameters, computing only the tiles that it is missing.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrRadioEnvironmentMapHelper::SetResumeTiles,
+                                              &NrRadioEnvironmentMapHelper::GetResumeTiles),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -223,6 +277,24 @@ NrRadioEnvironmentMapHelper::SetInstallationDelay(const Time& installationDelay)
     m_installationDelay = installationDelay;
 }
 
+void
+NrRadioEnvironmentMapHelper::SetNumThreads(uint32_t numThreads)
+{
+    m_numThreads = numThreads;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetTileSize(uint32_t tileSize)
+{
+    m_tileSize = tileSize;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetResumeTiles(bool resumeTiles)
+{
+    m_resumeTiles = resumeTiles;
+}
+
 NrRadioEnvironmentMapHelper::RemMode
 NrRadioEnvironmentMapHelper::GetRemMode() const
 {
@@ -271,6 +343,24 @@ NrRadioEnvironmentMapHelper::GetZ() const
     return m_z;
 }
 
+uint32_t
+NrRadioEnvironmentMapHelper::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
+uint32_t
+NrRadioEnvironmentMapHelper::GetTileSize() const
+{
+    return m_tileSize;
+}
+
+bool
+NrRadioEnvironmentMapHelper::GetResumeTiles() const
+{
+    return m_resumeTiles;
+}
+
 double
 NrRadioEnvironmentMapHelper::DbmToW(double dBm) const
 {
@@ -314,9 +404,6 @@ NrRadioEnvironmentMapHelper::ConfigureRrd(const Ptr<NetDevice>& rrdDevice)
 
     m_rrd.antenna = m_deviceToAntenna.find(rrdDevice)->second;
 
-    m_noisePsd = NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(m_rrdPhy->GetNoiseFigure(),
-                                                                        m_rrd.spectrumModel);
-
     ConfigurePropagationModelsFactories(
         m_rrdPhy); // we can call only once configuration of prop.models
 }
@@ -597,24 +684,25 @@ NrRadioEnvironmentMapHelper::DelayedInstall(const NetDeviceContainer& rtdNetDev,
 
     ConfigureRrd(rrdDevice);
     ConfigureRtdList(rtdNetDev);
-    CreateListOfRemPoints();
-    if (m_remMode == COVERAGE_AREA)
-    {
-        CalcCoverageAreaRemMap();
-    }
-    else if (m_remMode == BEAM_SHAPE)
+    ConfigureRemGrid();
+    CreateRemWorkers();
+    if (m_tileSize == 0)
     {
-        CalcBeamShapeRemMap();
-    }
-    else if (m_remMode == UE_COVERAGE)
-    {
-        CalcUeCoverageRemMap();
+        CreateListOfRemPoints(0, m_numX, 0, m_numY);
+        StartProgressReport(m_rem.size());
+        CalcRemPoints();
+        PrintRemToFile();
     }
     else
     {
-        NS_FATAL_ERROR("Unknown REM mode");
+        CalcTiledRem();
     }
-    PrintRemToFile();
+    m_remWorkers.clear();
+
+    auto remEndTime = std::chrono::system_clock::now();
+    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
+    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
+                << remElapsedSeconds.count() / 60 << " minutes.");
 
     std::ostringstream ossGnbs;
     ossGnbs << "nr-rem-" << m_simTag.c_str() << "-gnbs.txt";
@@ -625,12 +713,10 @@ NrRadioEnvironmentMapHelper::DelayedInstall(const NetDeviceContainer& rtdNetDev,
 }
 
 void
-NrRadioEnvironmentMapHelper::CreateListOfRemPoints()
+NrRadioEnvironmentMapHelper::ConfigureRemGrid()
 {
     NS_LOG_FUNCTION(this);
 
-    // Create the list of the REM Points
-
     m_xStep = (m_xMax - m_xMin) / (m_xRes);
     m_yStep = (m_yMax - m_yMin) / (m_yRes);
 
@@ -638,12 +724,29 @@ NrRadioEnvironmentMapHelper::CreateListOfRemPoints()
     NS_ASSERT_MSG(m_yMax > m_yMin, "yMax must be higher than yMin");
     NS_ASSERT_MSG(m_xRes != 0 || m_yRes != 0, "Resolution must be higher than 0");
 
+    // The points go from the min to the max coordinates, both included
+    m_numX = static_cast<uint32_t>(m_xRes) + 1;
+    m_numY = static_cast<uint32_t>(m_yRes) + 1;
+
     NS_LOG_INFO("m_xStep: " << m_xStep << " m_yStep: " << m_yStep);
+}
 
-    for (double x = m_xMin; x < m_xMax + 0.5 * m_xStep; x += m_xStep)
+void
+NrRadioEnvironmentMapHelper::CreateListOfRemPoints(uint32_t xBegin,
+                                                   uint32_t xEnd,
+                                                   uint32_t yBegin,
+                                                   uint32_t yEnd)
+{
+    NS_LOG_FUNCTION(this << xBegin << xEnd << yBegin << yEnd);
+
+    // Create the list of the REM Points
+
+    for (uint32_t xIndex = xBegin; xIndex < xEnd; xIndex++)
     {
-        for (double y = m_yMin; y < m_yMax + 0.5 * m_yStep; y += m_yStep)
+        double x = m_xMin + xIndex * m_xStep;
+        for (uint32_t yIndex = yBegin; yIndex < yEnd; yIndex++)
         {
+            double y = m_yMin + yIndex * m_yStep;
             // In case a REM Point is in the same position as a rtd, ignore this point
             bool isPositionRtd = false;
             for (auto& itRtd : m_remDev)
@@ -661,6 +764,8 @@ NrRadioEnvironmentMapHelper::CreateListOfRemPoints()
                 remPoint.pos.x = x;
                 remPoint.pos.y = y;
                 remPoint.pos.z = m_z;
+                remPoint.xIndex = xIndex;
+                remPoint.yIndex = yIndex;
 
                 m_rem.push_back(remPoint);
             }
@@ -690,17 +795,19 @@ NrRadioEnvironmentMapHelper::ConfigureDirectPathBfv(RemDevice& device,
     device.antenna->SetBeamformingVector(CreateDirectPathBfv(device.mob, otherDevice.mob, antenna));
 }
 
-Ptr<SpectrumValue>
-NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const
+Ptr<const SpectrumValue>
+NrRadioEnvironmentMapHelper::GetTxPsd(RemDevice& device,
+                                      const Ptr<const SpectrumModel>& rxSpectrumModel) const
 {
-    PropagationModels tempPropModels = CreateTemporalPropagationModels();
-
-    std::vector<int> activeRbs;
-    for (size_t rbId = 0; rbId < device.spectrumModel->GetNumBands(); rbId++)
+    auto it = device.txPsds.find(rxSpectrumModel->GetUid());
+    if (it != device.txPsds.end())
     {
-        activeRbs.push_back(rbId);
+        return it->second;
     }
 
+    std::vector<int> activeRbs(device.spectrumModel->GetNumBands());
+    std::iota(activeRbs.begin(), activeRbs.end(), 0);
+
     Ptr<const SpectrumValue> txPsd = NrSpectrumValueHelper::CreateTxPowerSpectralDensity(
         device.txPower,
         activeRbs,
@@ -710,57 +817,92 @@ NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherD
     // check if RTD has the same spectrum model as RRD
     // if they have do nothing, if they dont, then convert txPsd of RTD device so to be according to
     // spectrum model of RRD
-
-    Ptr<const SpectrumValue> convertedTxPsd;
-    if (device.spectrumModel->GetUid() == otherDevice.spectrumModel->GetUid())
+    if (device.spectrumModel->GetUid() == rxSpectrumModel->GetUid())
     {
         NS_LOG_LOGIC("no spectrum conversion needed");
-        convertedTxPsd = txPsd;
     }
     else
     {
         NS_LOG_LOGIC("Converting TXPSD of RTD device " << device.spectrumModel->GetUid() << " --> "
-                                                       << otherDevice.spectrumModel->GetUid());
+                                                       << rxSpectrumModel->GetUid());
 
-        SpectrumConverter converter(device.spectrumModel, otherDevice.spectrumModel);
-        convertedTxPsd = converter.Convert(txPsd);
+        SpectrumConverter converter(device.spectrumModel, rxSpectrumModel);
+        txPsd = converter.Convert(txPsd);
     }
 
-    // Copy TX PSD to RX PSD, they are now equal rxPsd == txPsd
-    Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
-    rxParams->psd = convertedTxPsd->Copy();
+    device.txPsds.emplace(rxSpectrumModel->GetUid(), txPsd);
+    return txPsd;
+}
+
+NrRadioEnvironmentMapHelper::RemLink
+NrRadioEnvironmentMapHelper::CreateRemLink(RemWorker& worker,
+                                           RemDevice& device,
+                                           RemDevice& otherDevice) const
+{
+    RemLink link;
+    {
+        // The creation of ns-3 objects is not thread safe
+        std::lock_guard<std::mutex> lock(m_mutex);
+        link.propModels = CreateTemporalPropagationModels();
+        worker.nextStream += AssignStreams(link.propModels, worker.nextStream);
+    }
+
+    Ptr<const SpectrumValue> txPsd = GetTxPsd(device, otherDevice.spectrumModel);
+
     double pathLossDb =
-        tempPropModels.remPropagationLossModelCopy->CalcRxPower(0, device.mob, otherDevice.mob);
+        link.propModels.remPropagationLossModelCopy->CalcRxPower(0, device.mob, otherDevice.mob);
     double pathGainLinear = DbToRatio(pathLossDb);
 
-    NS_LOG_DEBUG("Tx power in dBm:" << WToDbm(Integral(*convertedTxPsd)));
+    NS_LOG_DEBUG("Tx power in dBm:" << WToDbm(Integral(*txPsd)));
     NS_LOG_DEBUG("PathlosDb:" << pathLossDb);
 
     // Apply now calculated pathloss to rxPsd, now rxPsd < txPsd because we had some losses
-    *(rxParams->psd) *= pathGainLinear;
+    link.rxPsd = txPsd->Copy();
+    *(link.rxPsd) *= pathGainLinear;
 
-    NS_LOG_DEBUG("RX power in dBm after pathloss:" << WToDbm(Integral(*(rxParams->psd))));
+    NS_LOG_DEBUG("RX power in dBm after pathloss:" << WToDbm(Integral(*(link.rxPsd))));
 
-    // Now we call spectrum model, which in this keys add a beamforming gain
+    return link;
+}
+
+Ptr<SpectrumValue>
+NrRadioEnvironmentMapHelper::CalcRxPsdValue(const RemLink& link,
+                                            RemDevice& device,
+                                            RemDevice& otherDevice) const
+{
+    Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
+    rxParams->psd = link.rxPsd->Copy();
+
+    // Now we call spectrum model, which in this keys add a beamforming gain. The channel
+    // realization of the link is reused, only the beamforming gain is computed again when the
+    // beams change.
     rxParams =
-        tempPropModels.remSpectrumLossModelCopy->DoCalcRxPowerSpectralDensity(rxParams,
-                                                                              device.mob,
-                                                                              otherDevice.mob,
-                                                                              device.antenna,
-                                                                              otherDevice.antenna);
+        link.propModels.remSpectrumLossModelCopy->DoCalcRxPowerSpectralDensity(rxParams,
+                                                                               device.mob,
+                                                                               otherDevice.mob,
+                                                                               device.antenna,
+                                                                               otherDevice.antenna);
 
     NS_LOG_DEBUG("RX power in dBm after fading: " << WToDbm(Integral(*(rxParams->psd))));
 
     return rxParams->psd;
 }
 
+Ptr<SpectrumValue>
+NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemWorker& worker,
+                                            RemDevice& device,
+                                            RemDevice& otherDevice) const
+{
+    return CalcRxPsdValue(CreateRemLink(worker, device, otherDevice), device, otherDevice);
+}
+
 Ptr<SpectrumValue>
 NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<Ptr<SpectrumValue>>& values) const
 {
     // TODO add this abort, if necessary add include for abort.h
     NS_ABORT_MSG_IF(values.empty(), "Must provide a list of values.");
 
-    Ptr<SpectrumValue> maxValue = Create<SpectrumValue>(m_rrd.spectrumModel);
+    Ptr<SpectrumValue> maxValue = Create<SpectrumValue>(values.front()->GetSpectrumModel());
     *maxValue = **(values.begin());
 
     for (const auto& value : values)
@@ -775,35 +917,37 @@ NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<Ptr<SpectrumValue>>& va
 
 double
 NrRadioEnvironmentMapHelper::CalculateMaxSnr(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+    const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+    const Ptr<SpectrumValue>& noisePsd) const
 {
     Ptr<SpectrumValue> maxSnr = GetMaxValue(receivedPowerList);
-    SpectrumValue snr = (*maxSnr) / (*m_noisePsd);
+    SpectrumValue snr = (*maxSnr) / (*noisePsd);
     return RatioToDb(Sum(snr) / snr.GetSpectrumModel()->GetNumBands());
 }
 
 double
-NrRadioEnvironmentMapHelper::CalculateSnr(const Ptr<SpectrumValue>& usefulSignal) const
+NrRadioEnvironmentMapHelper::CalculateSnr(const Ptr<SpectrumValue>& usefulSignal,
+                                          const Ptr<SpectrumValue>& noisePsd) const
 {
-    SpectrumValue snr = (*usefulSignal) / (*m_noisePsd);
+    SpectrumValue snr = (*usefulSignal) / (*noisePsd);
 
     return RatioToDb(Sum(snr) / snr.GetSpectrumModel()->GetNumBands());
 }
 
 double
-NrRadioEnvironmentMapHelper::CalculateSinr(
-    const Ptr<SpectrumValue>& usefulSignal,
-    const std::list<Ptr<SpectrumValue>>& interferenceSignals) const
+NrRadioEnvironmentMapHelper::CalculateSinr(const Ptr<SpectrumValue>& usefulSignal,
+                                           const std::list<Ptr<SpectrumValue>>& interferenceSignals,
+                                           const Ptr<SpectrumValue>& noisePsd) const
 {
     Ptr<SpectrumValue> interferencePsd = nullptr;
 
     if (interferenceSignals.empty())
     {
-        return CalculateSnr(usefulSignal);
+        return CalculateSnr(usefulSignal, noisePsd);
     }
     else
     {
-        interferencePsd = Create<SpectrumValue>(m_rrd.spectrumModel);
+        interferencePsd = Create<SpectrumValue>(usefulSignal->GetSpectrumModel());
     }
 
     // sum all interfering signals
@@ -813,7 +957,7 @@ NrRadioEnvironmentMapHelper::CalculateSinr(
     }
     // calculate sinr
 
-    SpectrumValue sinr = (*usefulSignal) / (*interferencePsd + *m_noisePsd);
+    SpectrumValue sinr = (*usefulSignal) / (*interferencePsd + *noisePsd);
 
     // calculate average sinr over RBs, convert it from linear to dB units, and return it
     return RatioToDb(Sum(sinr) / sinr.GetSpectrumModel()->GetNumBands());
@@ -834,7 +978,7 @@ NrRadioEnvironmentMapHelper::CalculateSir(
     }
     else
     {
-        interferencePsd = Create<SpectrumValue>(m_rrd.spectrumModel);
+        interferencePsd = Create<SpectrumValue>(usefulSignal->GetSpectrumModel());
     }
 
     // sum all interfering signals
@@ -852,7 +996,8 @@ NrRadioEnvironmentMapHelper::CalculateSir(
 
 double
 NrRadioEnvironmentMapHelper::CalculateMaxSinr(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+    const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+    const Ptr<SpectrumValue>& noisePsd) const
 {
     // we calculate sinr considering for each RTD as if it would be TX device, and the rest of RTDs
     // interferers
@@ -873,7 +1018,7 @@ NrRadioEnvironmentMapHelper::CalculateMaxSinr(
 
         interferenceSignals.insert(interferenceSignals.end(), ++tempit, receivedPowerList.end());
         NS_ASSERT(interferenceSignals.size() == receivedPowerList.size() - 1);
-        sinrList.push_back(CalculateSinr(*it, interferenceSignals));
+        sinrList.push_back(CalculateSinr(*it, interferenceSignals, noisePsd));
     }
     return GetMaxValue(sinrList);
 }
@@ -910,72 +1055,58 @@ void
 NrRadioEnvironmentMapHelper::CalcBeamShapeRemMap()
 {
     NS_LOG_FUNCTION(this);
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint);
+}
 
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
-
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
+void
+NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint(RemWorker& worker, RemPoint& remPoint)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    double sumSir = 0.0;
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
+    worker.rrd.mob->SetPosition(remPoint.pos);
+
+    Ptr<MobilityBuildingInfo> buildingInfo = worker.rrd.mob->GetObject<MobilityBuildingInfo>();
+    buildingInfo->MakeConsistent(worker.rrd.mob);
+    NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        double sumSir = 0.0;
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
-        m_rrd.mob->SetPosition(itRemPoint->pos);
+        std::list<Ptr<SpectrumValue>>
+            receivedPowerList; // RTD node id, rxPsd of the signal coming from that node
 
-        Ptr<MobilityBuildingInfo> buildingInfo = m_rrd.mob->GetObject<MobilityBuildingInfo>();
-        buildingInfo->MakeConsistent(m_rrd.mob);
-        NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
-
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+        for (auto& itRtd : worker.rtds)
         {
-            std::list<Ptr<SpectrumValue>>
-                receivedPowerList; // RTD node id, rxPsd of the signal coming from that node
-
-            for (auto& itRtd : m_remDev)
-            {
-                // calculate received power from the current RTD device
-                receivedPowerList.push_back(CalcRxPsdValue(itRtd, m_rrd));
-            } // end for std::list<RemDev>::iterator  (RTDs)
-
-            sumSnr += CalculateMaxSnr(receivedPowerList);
-            sumSinr += CalculateMaxSinr(receivedPowerList);
-            sumSir += CalculateMaxSir(receivedPowerList);
-
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
-
-            receivedPowerList.clear();
-        } // end for m_numOfIterationsToAverage  (Average)
+            // calculate received power from the current RTD device
+            receivedPowerList.push_back(CalcRxPsdValue(worker, itRtd, worker.rrd));
+        } // end for std::list<RemDev>::iterator  (RTDs)
 
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+        sumSnr += CalculateMaxSnr(receivedPowerList, worker.noisePsd);
+        sumSinr += CalculateMaxSinr(receivedPowerList, worker.noisePsd);
+        sumSir += CalculateMaxSir(receivedPowerList);
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+        // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+        // Iteration (linear)
+        rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
 
-        NS_LOG_INFO("Avg snr value saved:" << itRemPoint->avgSnrDb);
-        NS_LOG_INFO("Avg sinr value saved:" << itRemPoint->avgSinrDb);
-        NS_LOG_INFO("Avg ipsd value saved (dBm):" << itRemPoint->avRxPowerDbm);
+        receivedPowerList.clear();
+    } // end for m_numOfIterationsToAverage  (Average)
 
-        if (++remPointCounter == remSizeNextReport)
-        {
-            PrintProgressReport(&remSizeNextReport);
-        }
+    // Sum the rxPower for all the Iterations (linear)
+    double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+    NS_LOG_INFO("Avg snr value saved:" << remPoint.avgSnrDb);
+    NS_LOG_INFO("Avg sinr value saved:" << remPoint.avgSinrDb);
+    NS_LOG_INFO("Avg ipsd value saved (dBm):" << remPoint.avRxPowerDbm);
 }
 
 double
@@ -1002,7 +1133,7 @@ NrRadioEnvironmentMapHelper::CalculateAggregatedIpsd(
     const std::list<Ptr<SpectrumValue>>& receivedSignals)
 {
     Ptr<SpectrumValue> sumRxPowers = nullptr;
-    sumRxPowers = Create<SpectrumValue>(m_rrd.spectrumModel);
+    sumRxPowers = Create<SpectrumValue>(receivedSignals.front()->GetSpectrumModel());
 
     // sum the received power of all the rtds
     for (auto rxPowersIt : receivedSignals)
@@ -1035,151 +1166,148 @@ void
 NrRadioEnvironmentMapHelper::CalcCoverageAreaRemMap()
 {
     NS_LOG_FUNCTION(this);
-    uint16_t calcRxPsdCounter = 0;
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcCoverageAreaRemPoint);
+}
 
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
+void
+NrRadioEnvironmentMapHelper::CalcCoverageAreaRemPoint(RemWorker& worker, RemPoint& remPoint)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    worker.rrd.mob->SetPosition(remPoint.pos);
+
+    // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
+    // worst-case scenario
+    for (auto& itRtd : worker.rtds)
+    {
+        ConfigureDirectPathBfv(itRtd, worker.rrd, itRtd.antenna);
+    }
+
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint->pos);
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+
+        std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
+                                                  // rxPowers per remPoint (linear)
 
-        // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
-        // worst-case scenario
-        for (auto& itRtd : m_remDev)
+        // The pathloss and the channel realization of each RTD do not depend on the beam of
+        // the RRD, so they are computed once per iteration
+        std::vector<RemLink> links;
+        links.reserve(worker.rtds.size());
+        for (auto& itRtd : worker.rtds)
         {
-            ConfigureDirectPathBfv(itRtd, m_rrd, itRtd.antenna);
+            links.push_back(CreateRemLink(worker, itRtd, worker.rrd));
         }
 
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
-
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+        // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
+        // many beam configurations at RemPoint as many RTDs
+        for (std::list<RemDevice>::iterator itRtdBeam = worker.rtds.begin();
+             itRtdBeam != worker.rtds.end();
+             ++itRtdBeam)
         {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+            // configure RRD beam toward RTD
+            ConfigureDirectPathBfv(worker.rrd, *itRtdBeam, worker.rrd.antenna);
 
-            std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
-                                                      // rxPowers per remPoint (linear)
+            std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
+            Ptr<SpectrumValue> usefulSignalRxPsd;
 
-            // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
-            // many beam configurations at RemPoint as many RTDs
-            for (std::list<RemDevice>::iterator itRtdBeam = m_remDev.begin();
-                 itRtdBeam != m_remDev.end();
-                 ++itRtdBeam)
+            // For this configuration of beam at RRD, we need to calculate RX PSD,
+            // and in order to be able to calculate SINR for that beam,
+            // we need to calculate received PSD for each RTD using this beam at RRD
+            auto itLink = links.begin();
+            for (auto& itRtdCalc : worker.rtds)
             {
-                // configure RRD beam toward RTD
-                ConfigureDirectPathBfv(m_rrd, *itRtdBeam, m_rrd.antenna);
-
-                // Calculate the received power from this RTD for this RemPoint
-                Ptr<SpectrumValue> receivedPowerFromRtd = CalcRxPsdValue(*itRtdBeam, m_rrd);
-                // and put it to the list of the received powers for this RemPoint (to sum all
-                // later)
-                rxPsdsList.push_back(receivedPowerFromRtd);
-
-                NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
-                                           << " is Rxed in RemPoint with Rx Power in W: "
-                                           << (Integral(*receivedPowerFromRtd)));
-                NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*receivedPowerFromRtd)));
-
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
-
-                // For this configuration of beam at RRD, we need to calculate RX PSD,
-                // and in order to be able to calculate SINR for that beam,
-                // we need to calculate received PSD for each RTD using this beam at RRD
-                for (auto& itRtdCalc : m_remDev)
-                {
-                    // increase counter de calcRXPsd calls
-                    calcRxPsdCounter++;
-                    // calculate received power from the current RTD device
-                    Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(itRtdCalc, m_rrd);
+                // calculate received power from the current RTD device
+                Ptr<SpectrumValue> receivedPower =
+                    CalcRxPsdValue(*itLink++, itRtdCalc, worker.rrd);
 
-                    // is this received power useful signal (from RTD for which I configured my
-                    // beam) or is interference signal
+                // is this received power useful signal (from RTD for which I configured my
+                // beam) or is interference signal
 
-                    if (itRtdBeam->dev->GetNode()->GetId() == itRtdCalc.dev->GetNode()->GetId())
-                    {
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
-                    }
-                    else
+                if (itRtdBeam->dev->GetNode()->GetId() == itRtdCalc.dev->GetNode()->GetId())
+                {
+                    if (usefulSignalRxPsd != nullptr)
                     {
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                        NS_FATAL_ERROR("Already assigned usefulSignal!");
                     }
+                    usefulSignalRxPsd = receivedPower;
+                }
+                else
+                {
+                    interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                }
 
-                } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
-
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
+            } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
 
-                NS_LOG_INFO("Done:" << (double)calcRxPsdCounter /
-                                           (m_rem.size() * m_numOfIterationsToAverage *
-                                            m_remDev.size() * m_remDev.size()) *
-                                           100
-                                    << " %."); // how many times will be called CalcRxPsdValues
+            // The received power from this RTD for this RemPoint is put to the list of the
+            // received powers for this RemPoint (to sum all later)
+            rxPsdsList.push_back(usefulSignalRxPsd);
 
-            } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
+            NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
+                                       << " is Rxed in RemPoint with Rx Power in W: "
+                                       << (Integral(*usefulSignalRxPsd)));
+            NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*usefulSignalRxPsd)));
 
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+            sinrsPerBeam.push_back(
+                CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds, worker.noisePsd));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd, worker.noisePsd));
 
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
+        } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
 
-        } // end for m_numOfIterationsToAverage  (Average)
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
 
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+        // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+        // Iteration (linear)
+        rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+    } // end for m_numOfIterationsToAverage  (Average)
 
-        if (++remPointCounter == remSizeNextReport)
-        {
-            PrintProgressReport(&remSizeNextReport);
-        }
+    // Sum the rxPower for all the Iterations (linear)
+    double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
 
-        NS_LOG_DEBUG("itRemPoint->avRxPowerDb  in dB: " << itRemPoint->avRxPowerDbm);
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    NS_LOG_DEBUG("itRemPoint->avRxPowerDb  in dB: " << remPoint.avRxPowerDbm);
+}
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+void
+NrRadioEnvironmentMapHelper::StartProgressReport(uint64_t numRemPoints)
+{
+    m_numRemPointsToCompute = numRemPoints;
+    m_remPointCounter = 0;
+    m_remSizeNextReport = numRemPoints / 100;
 }
 
 void
-NrRadioEnvironmentMapHelper::PrintProgressReport(uint32_t* remSizeNextReport)
+NrRadioEnvironmentMapHelper::PrintProgressReport(uint64_t* remSizeNextReport)
 {
     auto remTimeUpToNow = std::chrono::system_clock::now();
     std::chrono::duration<double> remElapsedSecondsUpToNow = remTimeUpToNow - m_remStartTime;
     double minutesUpToNow = ((double)remElapsedSecondsUpToNow.count()) / 60;
-    double minutesLeftEstimated =
-        ((double)(minutesUpToNow) / *remSizeNextReport) * ((m_rem.size() - *remSizeNextReport));
-    std::cout << "\n REM done:" << ceil(((double)*remSizeNextReport / m_rem.size()) * 100) << " %."
+    double minutesLeftEstimated = ((double)(minutesUpToNow) / *remSizeNextReport) *
+                                  ((m_numRemPointsToCompute - *remSizeNextReport));
+    std::cout << "\n REM done:"
+              << ceil(((double)*remSizeNextReport / m_numRemPointsToCompute) * 100) << " %."
               << " Minutes up to now: " << minutesUpToNow
               << ". Minutes left estimated:" << minutesLeftEstimated
               << "."; // how many times will be called CalcRxPsdValues
     // we want progress report for 1%, 10%, 20%, 30%, and so on
-    if (*remSizeNextReport < m_rem.size() / 10)
+    if (*remSizeNextReport < m_numRemPointsToCompute / 10)
     {
-        *remSizeNextReport = m_rem.size() / 10;
+        *remSizeNextReport = m_numRemPointsToCompute / 10;
     }
     else
     {
-        *remSizeNextReport += m_rem.size() / 10;
+        *remSizeNextReport += m_numRemPointsToCompute / 10;
     }
 }
 
@@ -1187,86 +1315,386 @@ void
 NrRadioEnvironmentMapHelper::CalcUeCoverageRemMap()
 {
     NS_LOG_FUNCTION(this);
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcUeCoverageRemPoint);
+}
 
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+void
+NrRadioEnvironmentMapHelper::CalcUeCoverageRemPoint(RemWorker& worker, RemPoint& remPoint)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    worker.rrd.mob->SetPosition(remPoint.pos);
 
-    for (auto& itRemPoint : m_rem)
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint.pos);
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+        //"Associate" UE (RemPoint) with this RTD
+        for (auto& itRtdAssociated : worker.rtds)
         {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+            // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
+            ConfigureDirectPathBfv(worker.rrd, itRtdAssociated, worker.rrd.antenna);
+            // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
+            ConfigureDirectPathBfv(itRtdAssociated, worker.rrd, itRtdAssociated.antenna);
+
+            std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
+            Ptr<SpectrumValue> usefulSignalRxPsd;
 
-            //"Associate" UE (RemPoint) with this RTD
-            for (auto& itRtdAssociated : m_remDev)
+            for (auto& itRtdInterferer : worker.rtds)
             {
-                // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
-                ConfigureDirectPathBfv(m_rrd, itRtdAssociated, m_rrd.antenna);
-                // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
-                ConfigureDirectPathBfv(itRtdAssociated, m_rrd, itRtdAssociated.antenna);
+                if (itRtdAssociated.dev->GetNode()->GetId() !=
+                    itRtdInterferer.dev->GetNode()->GetId())
+                {
+                    // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
+                    ConfigureDirectPathBfv(itRtdInterferer,
+                                           itRtdAssociated,
+                                           itRtdInterferer.antenna);
 
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
+                    // calculate received power (interference) from the current RTD device
+                    Ptr<SpectrumValue> receivedPower =
+                        CalcRxPsdValue(worker, itRtdInterferer, itRtdAssociated);
 
-                for (auto& itRtdInterferer : m_remDev)
+                    interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                }
+                else
                 {
-                    if (itRtdAssociated.dev->GetNode()->GetId() !=
-                        itRtdInterferer.dev->GetNode()->GetId())
+                    // calculate received power (useful Signal) from the current RRD device
+                    Ptr<SpectrumValue> receivedPower =
+                        CalcRxPsdValue(worker, worker.rrd, itRtdAssociated);
+                    if (usefulSignalRxPsd != nullptr)
                     {
-                        // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
-                        ConfigureDirectPathBfv(itRtdInterferer,
-                                               itRtdAssociated,
-                                               itRtdInterferer.antenna);
+                        NS_FATAL_ERROR("Already assigned usefulSignal!");
+                    }
+                    usefulSignalRxPsd = receivedPower;
+                }
 
-                        // calculate received power (interference) from the current RTD device
-                        Ptr<SpectrumValue> receivedPower =
-                            CalcRxPsdValue(itRtdInterferer, itRtdAssociated);
+            } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
 
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
-                    }
-                    else
-                    {
-                        // calculate received power (useful Signal) from the current RRD device
-                        Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(m_rrd, itRtdAssociated);
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
-                    }
+            sinrsPerBeam.push_back(
+                CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds, worker.noisePsd));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd, worker.noisePsd));
 
-                } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
+        } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
 
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
 
-            } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
+    } // end for m_numOfIterationsToAverage  (Average)
 
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+}
 
-        } // end for m_numOfIterationsToAverage  (Average)
+void
+NrRadioEnvironmentMapHelper::CalcRemPoints()
+{
+    if (m_remMode == COVERAGE_AREA)
+    {
+        CalcCoverageAreaRemMap();
+    }
+    else if (m_remMode == BEAM_SHAPE)
+    {
+        CalcBeamShapeRemMap();
+    }
+    else if (m_remMode == UE_COVERAGE)
+    {
+        CalcUeCoverageRemMap();
+    }
+    else
+    {
+        NS_FATAL_ERROR("Unknown REM mode");
+    }
+}
 
-        itRemPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+uint64_t
+NrRadioEnvironmentMapHelper::GetScenarioHash() const
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    HashValue(RngSeedManager::GetSeed(), hash);
+    HashValue(RngSeedManager::GetRun(), hash);
+    HashRemDevice(m_rrd, hash);
+    HashValue(m_remDev.size(), hash);
+    for (const auto& rtd : m_remDev)
+    {
+        HashRemDevice(rtd, hash);
+    }
+    return hash;
+}
 
-        if (++remPointCounter == remSizeNextReport)
+void
+NrRadioEnvironmentMapHelper::HashRemDevice(const RemDevice& device, uint64_t& hash) const
+{
+    Vector position = device.mob->GetPosition();
+    HashValue(position.x, hash);
+    HashValue(position.y, hash);
+    HashValue(position.z, hash);
+    HashValue(device.txPower, hash);
+    HashValue(device.bandwidth, hash);
+    HashValue(device.frequency, hash);
+    HashValue(device.numerology, hash);
+    if (device.spectrumModel)
+    {
+        HashValue(device.spectrumModel->GetNumBands(), hash);
+        for (auto band = device.spectrumModel->Begin(); band != device.spectrumModel->End();
+             ++band)
         {
-            PrintProgressReport(&remSizeNextReport);
+            HashValue(band->fc, hash);
         }
+    }
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    if (!device.antenna)
+    {
+        return;
+    }
+    // The locations of the elements depend on their number and spacing
+    HashValue(device.antenna->GetNumElems(), hash);
+    for (size_t i = 0; i < device.antenna->GetNumElems(); i++)
+    {
+        Vector location = device.antenna->GetElementLocation(i);
+        HashValue(location.x, hash);
+        HashValue(location.y, hash);
+        HashValue(location.z, hash);
+    }
+    DoubleValue angle;
+    device.antenna->GetAttribute("BearingAngle", angle);
+    HashValue(angle.Get(), hash);
+    device.antenna->GetAttribute("DowntiltAngle", angle);
+    HashValue(angle.Get(), hash);
+    PointerValue antennaElement;
+    device.antenna->GetAttribute("AntennaElement", antennaElement);
+    std::ostringstream element;
+    element << ConfigureObjectFactory(antennaElement.Get<AntennaModel>());
+    for (char c : element.str())
+    {
+        HashValue(c, hash);
+    }
+    const auto& beam = device.antenna->GetBeamformingVector();
+    HashValue(beam.GetSize(), hash);
+    for (size_t i = 0; i < beam.GetSize(); i++)
+    {
+        HashValue(beam[i], hash);
+    }
+}
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+void
+NrRadioEnvironmentMapHelper::CalcTiledRem()
+{
+    NS_LOG_FUNCTION(this);
+
+    NrRemRasterHeader header{};
+    header.m_numX = m_numX;
+    header.m_numY = m_numY;
+    header.m_tileSize = m_tileSize;
+    header.m_remMode = m_remMode;
+    header.m_numIterations = m_numOfIterationsToAverage;
+    header.m_xMin = m_xMin;
+    header.m_yMin = m_yMin;
+    header.m_xStep = m_xStep;
+    header.m_yStep = m_yStep;
+    header.m_z = m_z;
+    header.m_scenario = GetScenarioHash();
+
+    std::ostringstream oss;
+    oss << "nr-rem-" << m_simTag.c_str() << ".rem";
+    std::string outputFile = oss.str();
+    if (!m_remRaster.Open(outputFile, header, m_resumeTiles))
+    {
+        NS_FATAL_ERROR("Can't open file " << outputFile
+                                          << (m_resumeTiles ? ", or resume it with this map" : ""));
+    }
+
+    std::vector<uint32_t> tiles;
+    uint64_t numRemPoints = 0;
+    uint32_t xBegin;
+    uint32_t xEnd;
+    uint32_t yBegin;
+    uint32_t yEnd;
+    for (uint32_t tile = 0; tile < m_remRaster.GetNumTiles(); tile++)
+    {
+        if (!m_remRaster.IsTileDone(tile))
+        {
+            m_remRaster.GetTileBounds(tile, xBegin, xEnd, yBegin, yEnd);
+            numRemPoints += static_cast<uint64_t>(xEnd - xBegin) * (yEnd - yBegin);
+            tiles.push_back(tile);
+        }
+    }
+    NS_LOG_INFO("Computing " << tiles.size() << " of the " << m_remRaster.GetNumTiles()
+                             << " tiles of the REM");
+    StartProgressReport(numRemPoints);
+
+    for (uint32_t tile : tiles)
+    {
+        m_remRaster.GetTileBounds(tile, xBegin, xEnd, yBegin, yEnd);
+        CreateListOfRemPoints(xBegin, xEnd, yBegin, yEnd);
+        CalcRemPoints();
+
+        // The points that are not in the list (at the position of a RTD) are NaN
+        size_t width = xEnd - xBegin;
+        size_t planeSize = width * (yEnd - yBegin);
+        std::vector<float> values(NrRemRaster::NUM_PLANES * planeSize,
+                                  std::numeric_limits<float>::quiet_NaN());
+        for (const auto& remPoint : m_rem)
+        {
+            size_t i = (remPoint.yIndex - yBegin) * width + (remPoint.xIndex - xBegin);
+            values[NrRemRaster::SNR * planeSize + i] = remPoint.avgSnrDb;
+            values[NrRemRaster::SINR * planeSize + i] = remPoint.avgSinrDb;
+            values[NrRemRaster::IPSD * planeSize + i] = remPoint.avRxPowerDbm;
+            values[NrRemRaster::SIR * planeSize + i] = remPoint.avgSirDb;
+        }
+        m_remRaster.WriteTile(tile, values);
+        m_rem.clear();
+    }
+    m_remRaster.Close();
+
+    CreateCustomGnuplotFile();
+    Finalize();
+}
+
+void
+NrRadioEnvironmentMapHelper::CreateRemWorkers()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t numThreads = m_numThreads;
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    if (numThreads > 1 && BuildingList::GetNBuildings() > 0)
+    {
+        // The buildings are referenced by the mobility models of all the threads, and the
+        // reference counts of the ns-3 objects are not thread safe
+        NS_LOG_WARN("The REM of a scenario with buildings is computed by a single thread");
+        numThreads = 1;
+    }
+    uint64_t numGridPoints = static_cast<uint64_t>(m_numX) * m_numY;
+    numThreads = static_cast<uint32_t>(std::min<uint64_t>(numThreads, numGridPoints));
+
+    // Each point of the grid has its own range of random variable streams, large enough for
+    // the REM mode with the most links per point (UeCoverage), so that the value of a point
+    // does not depend on the other points computed, nor on the tiles
+    int64_t streamsPerLink = AssignStreams(CreateTemporalPropagationModels(), 0);
+    m_streamsPerRemPoint = streamsPerLink * m_numOfIterationsToAverage *
+                           static_cast<int64_t>(m_remDev.size() * m_remDev.size());
+
+    // The workers are created here, because the creation of ns-3 objects is not thread safe
+    m_remWorkers = std::vector<RemWorker>(numThreads);
+    for (auto& worker : m_remWorkers)
+    {
+        ConfigureRemWorker(worker);
+    }
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcRemMap(CalcRemPointFn calcRemPoint)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(!m_remWorkers.empty(), "The REM workers have not been created");
+
+    std::vector<RemPoint*> remPoints;
+    remPoints.reserve(m_rem.size());
+    for (auto& remPoint : m_rem)
+    {
+        remPoints.push_back(&remPoint);
+    }
+    size_t numThreads = std::min(m_remWorkers.size(), std::max<size_t>(remPoints.size(), 1));
+
+    std::atomic<size_t> nextRemPoint{0};
+    auto runWorker = [this, calcRemPoint, &remPoints, &nextRemPoint](RemWorker& worker) {
+        for (size_t i = nextRemPoint++; i < remPoints.size(); i = nextRemPoint++)
+        {
+            RemPoint& remPoint = *remPoints[i];
+            int64_t gridIndex = static_cast<int64_t>(remPoint.xIndex) * m_numY + remPoint.yIndex;
+            int64_t firstStream = REM_FIRST_STREAM + gridIndex * m_streamsPerRemPoint;
+            worker.nextStream = firstStream;
+            (this->*calcRemPoint)(worker, remPoint);
+            NS_ASSERT_MSG(worker.nextStream <= firstStream + m_streamsPerRemPoint,
+                          "The REM point used more random variable streams than reserved");
+            CountRemPoint();
+        }
+    };
+
+    NS_LOG_INFO("Computing " << remPoints.size() << " REM points with " << numThreads
+                             << " threads");
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < numThreads; t++)
+    {
+        threads.emplace_back(runWorker, std::ref(m_remWorkers[t]));
+    }
+    // The calling thread is the first worker
+    runWorker(m_remWorkers[0]);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void
+NrRadioEnvironmentMapHelper::ConfigureRemWorker(RemWorker& worker) const
+{
+    NS_LOG_FUNCTION(this);
+    std::map<Ptr<const SpectrumModel>, Ptr<const SpectrumModel>> spectrumModels;
+    CopyRemDevice(m_rrd, worker.rrd, spectrumModels);
+    for (const auto& rtd : m_remDev)
+    {
+        worker.rtds.emplace_back();
+        CopyRemDevice(rtd, worker.rtds.back(), spectrumModels);
+    }
+    worker.noisePsd =
+        NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(m_rrdPhy->GetNoiseFigure(),
+                                                               worker.rrd.spectrumModel);
+}
+
+void
+NrRadioEnvironmentMapHelper::CopyRemDevice(
+    const RemDevice& device,
+    RemDevice& copy,
+    std::map<Ptr<const SpectrumModel>, Ptr<const SpectrumModel>>& spectrumModels) const
+{
+    copy.mob->SetPosition(device.mob->GetPosition());
+    Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo>();
+    copy.mob->AggregateObject(buildingInfo);
+    copy.txPower = device.txPower;
+    copy.bandwidth = device.bandwidth;
+    copy.frequency = device.frequency;
+    copy.numerology = device.numerology;
+
+    // The copy of a spectrum model keeps its UID, and the devices that share a spectrum
+    // model share its copy, because the operations between SpectrumValues require it
+    auto it = spectrumModels.find(device.spectrumModel);
+    if (it == spectrumModels.end())
+    {
+        it = spectrumModels
+                 .emplace(device.spectrumModel, Create<SpectrumModel>(*device.spectrumModel))
+                 .first;
+    }
+    copy.spectrumModel = it->second;
+
+    // The copy of an antenna array gets its own antenna element, with the attributes of the
+    // original one, so that the copies can be used by different threads
+    PointerValue antennaElement;
+    device.antenna->GetAttribute("AntennaElement", antennaElement);
+    ObjectFactory antennaElementFactory =
+        ConfigureObjectFactory(antennaElement.Get<AntennaModel>());
+    copy.antenna = Copy(device.antenna);
+    copy.antenna->SetAttribute("AntennaElement",
+                               PointerValue(antennaElementFactory.Create<AntennaModel>()));
+    if (device.antenna->GetBeamformingVector().GetSize() != 0)
+    {
+        copy.antenna->SetBeamformingVector(device.antenna->GetBeamformingVector());
+    }
+}
+
+void
+NrRadioEnvironmentMapHelper::CountRemPoint()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (++m_remPointCounter == m_remSizeNextReport)
+    {
+        PrintProgressReport(&m_remSizeNextReport);
+    }
 }
 
 NrRadioEnvironmentMapHelper::PropagationModels
@@ -1299,6 +1727,22 @@ NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels() const
     return propModels;
 }
 
+int64_t
+NrRadioEnvironmentMapHelper::AssignStreams(const PropagationModels& propModels,
+                                           int64_t stream) const
+{
+    int64_t currentStream = stream;
+    currentStream += propModels.remPropagationLossModelCopy->AssignStreams(currentStream);
+    currentStream +=
+        propModels.remPropagationLossModelCopy->GetChannelConditionModel()->AssignStreams(
+            currentStream);
+    if (propModels.remSpectrumLossModelCopy)
+    {
+        currentStream += propModels.remSpectrumLossModelCopy->AssignStreams(currentStream);
+    }
+    return currentStream - stream;
+}
+
 void
 NrRadioEnvironmentMapHelper::PrintGnuplottableGnbListToFile(const std::string& filename)
 {
@@ -1421,6 +1865,23 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
         return;
     }
 
+    // The tiled maps are plotted from the planes of the raster
+    auto plotSource = [this](uint32_t column, NrRemRaster::Plane plane) {
+        std::ostringstream source;
+        if (m_tileSize == 0)
+        {
+            source << "\"nr-rem-" << m_simTag << ".out\" using ($1):($2):($" << column << ")";
+        }
+        else
+        {
+            source << "\"nr-rem-" << m_simTag << ".rem\" binary skip="
+                   << m_remRaster.GetPlaneOffset(plane) << " array=(" << m_numX << "," << m_numY
+                   << ") dx=" << m_xStep << " dy=" << m_yStep << " origin=(" << m_xMin << ","
+                   << m_yMin << ") format=\"%float32\"";
+        }
+        return source.str();
+    };
+
     outFile << "set xlabel \"x-coordinate (m)\"" << std::endl;
     outFile << "set ylabel \"y-coordinate (m)\"" << std::endl;
     outFile << "set cblabel \"SNR (dB)\"" << std::endl;
@@ -1438,8 +1899,7 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
     outFile << "set xlabel font \"Helvetica,17\"" << std::endl;
     outFile << "set ylabel font \"Helvetica,17\"" << std::endl;
     outFile << "set cblabel font \"Helvetica,17\"" << std::endl;
-    outFile << "plot \"nr-rem-" << m_simTag << ".out\" using ($1):($2):($4) with image"
-            << std::endl;
+    outFile << "plot " << plotSource(4, NrRemRaster::SNR) << " with image" << std::endl;
 
     outFile << "set xlabel \"x-coordinate (m)\"" << std::endl;
     outFile << "set ylabel \"y-coordinate (m)\"" << std::endl;
@@ -1458,8 +1918,7 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
     outFile << "set xlabel font \"Helvetica,17\"" << std::endl;
     outFile << "set ylabel font \"Helvetica,17\"" << std::endl;
     outFile << "set cblabel font \"Helvetica,17\"" << std::endl;
-    outFile << "plot \"nr-rem-" << m_simTag << ".out\" using ($1):($2):($5) with image"
-            << std::endl;
+    outFile << "plot " << plotSource(5, NrRemRaster::SINR) << " with image" << std::endl;
 
     outFile << "set xlabel \"x-coordinate (m)\"" << std::endl;
     outFile << "set ylabel \"y-coordinate (m)\"" << std::endl;
@@ -1478,8 +1937,7 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
     outFile << "set xlabel font \"Helvetica,17\"" << std::endl;
     outFile << "set ylabel font \"Helvetica,17\"" << std::endl;
     outFile << "set cblabel font \"Helvetica,17\"" << std::endl;
-    outFile << "plot \"nr-rem-" << m_simTag << ".out\" using ($1):($2):($6) with image"
-            << std::endl;
+    outFile << "plot " << plotSource(6, NrRemRaster::IPSD) << " with image" << std::endl;
 
     outFile << "set xlabel \"x-coordinate (m)\"" << std::endl;
     outFile << "set ylabel \"y-coordinate (m)\"" << std::endl;
@@ -1498,8 +1956,7 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
     outFile << "set xlabel font \"Helvetica,17\"" << std::endl;
     outFile << "set ylabel font \"Helvetica,17\"" << std::endl;
     outFile << "set cblabel font \"Helvetica,17\"" << std::endl;
-    outFile << "plot \"nr-rem-" << m_simTag << ".out\" using ($1):($2):($7) with image"
-            << std::endl;
+    outFile << "plot " << plotSource(7, NrRemRaster::SIR) << " with image" << std::endl;
 
     outFile.close();
 }
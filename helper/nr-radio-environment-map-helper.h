@@ -7,6 +7,8 @@
 #ifndef NR_RADIO_ENVIRONMENT_MAP_HELPER_H
 #define NR_RADIO_ENVIRONMENT_MAP_HELPER_H
 
+#include "nr-rem-raster.h"
+
 #include "ns3/net-device-container.h"
 #include "ns3/nr-gnb-phy.h"
 #include "ns3/nr-ue-phy.h"
@@ -18,6 +20,7 @@
 
 #include <chrono>
 #include <fstream>
+#include <mutex>
 
 namespace ns3
 {
@@ -29,6 +32,7 @@ class MobilityModel;
 class MobilityHelper;
 class ChannelConditionModel;
 class UniformPlanarArray;
+class NrRemThreadsTestCase;
 
 /**
  * \brief Generate a radio environment map
@@ -61,6 +65,19 @@ class UniformPlanarArray;
  * N iterations (specified by the user) in order to consider the randomness of
  * the channel
  *
+ * The REM points can be computed by several threads (see the NumThreads
+ * attribute). Each thread works on its own copies of the RRD and RTDs
+ * (mobility, antenna array and spectrum model), and the random variables of
+ * the channels of each REM point use streams that depend only on the index of
+ * the point, so that the map does not depend on the number of threads.
+ *
+ * Large maps can be computed by tiles (see the TileSize attribute): the points
+ * of a tile are computed, written to a binary raster (NrRemRaster, in the
+ * nr-rem-${SimTag}.rem file) and released before the next tile, so the memory
+ * does not grow with the size of the map. The raster marks the written tiles,
+ * and with the ResumeTiles attribute an interrupted map can be resumed, computing
+ * only the tiles that are missing. The values do not depend on the tiles.
+ *
  * For the CoverageArea REM generation the user can include the following code
  * in the desired example script:
  *
@@ -92,6 +109,8 @@ nr-rem-SimTag-plot-rem.gnuplot \endcode
 class NrRadioEnvironmentMapHelper : public Object
 {
   public:
+    friend NrRemThreadsTestCase;
+
     enum RemMode
     {
         BEAM_SHAPE,
@@ -185,6 +204,24 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void SetInstallationDelay(const Time& installationDelay);
 
+    /**
+     * \brief Sets the number of threads that compute the REM points
+     * \param numThreads The number of threads, or 0 to use one per hardware thread
+     */
+    void SetNumThreads(uint32_t numThreads);
+
+    /**
+     * \brief Sets the number of points of each side of the tiles of the map
+     * \param tileSize The number of points, or 0 to compute the map at once
+     */
+    void SetTileSize(uint32_t tileSize);
+
+    /**
+     * \brief Sets whether a tiled map resumes an existing raster
+     * \param resumeTiles Whether only the tiles missing from the raster are computed
+     */
+    void SetResumeTiles(bool resumeTiles);
+
     /**
      * \brief Get the type of REM Map to be generated
      * \return The type of the map (BeamShape/CoverageArea/UeCoverage)
@@ -228,6 +265,24 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     double GetZ() const;
 
+    /**
+     * \brief Gets the number of threads that compute the REM points
+     * \return The number of threads, or 0 if there is one per hardware thread
+     */
+    uint32_t GetNumThreads() const;
+
+    /**
+     * \brief Gets the number of points of each side of the tiles of the map
+     * \return The number of points, or 0 if the map is computed at once
+     */
+    uint32_t GetTileSize() const;
+
+    /**
+     * \brief Gets whether a tiled map resumes an existing raster
+     * \return Whether only the tiles missing from the raster are computed
+     */
+    bool GetResumeTiles() const;
+
     /**
      * \brief Convert from Watts to dBm.
      * \param w the power in Watts
@@ -278,6 +333,8 @@ class NrRadioEnvironmentMapHelper : public Object
     struct RemPoint
     {
         Vector pos{0, 0, 0};
+        uint32_t xIndex{0}; ///< Index of the point along the x axis of the grid
+        uint32_t yIndex{0}; ///< Index of the point along the y axis of the grid
         double avgSnrDb{0};
         double avgSinrDb{0};
         double avgSirDb{0};
@@ -299,6 +356,8 @@ class NrRadioEnvironmentMapHelper : public Object
         double frequency{0};
         uint16_t numerology{0};
         Ptr<const SpectrumModel> spectrumModel{};
+        /// TX PSDs, by UID of the spectrum model of the receiving device
+        std::map<SpectrumModelUid_t, Ptr<const SpectrumValue>> txPsds;
 
         RemDevice()
         {
@@ -325,10 +384,50 @@ class NrRadioEnvironmentMapHelper : public Object
     };
 
     /**
-     * \brief This method creates the list of Rem Points (coordinates) based on
-     * the min/max coprdinates and the resolution defined by the user
+     * \brief The part of the received PSD of a link that does not depend on the
+     * beams of the devices: the temporal propagation models, which keep the
+     * channel realization of the link, and the PSD after the pathloss
      */
-    void CreateListOfRemPoints();
+    struct RemLink
+    {
+        PropagationModels propModels; //!< Temporal propagation models of the link
+        Ptr<SpectrumValue> rxPsd;     //!< Received PSD after the pathloss
+    };
+
+    /**
+     * \brief The copies of the RRD and of the RTDs used by a thread of the REM
+     * computation, so that the threads do not share the ns-3 objects that they
+     * modify or reference while computing the REM points
+     */
+    struct RemWorker
+    {
+        RemDevice rrd;               //!< Copy of the RRD
+        std::list<RemDevice> rtds;   //!< Copies of the RTDs
+        Ptr<SpectrumValue> noisePsd; //!< Noise PSD, in the spectrum model of the RRD copy
+        int64_t nextStream{0};       //!< Next stream of the temporal propagation models
+    };
+
+    /**
+     * \brief Pointer to the function that computes a REM point with a RemWorker
+     */
+    typedef void (NrRadioEnvironmentMapHelper::*CalcRemPointFn)(RemWorker& worker,
+                                                                RemPoint& remPoint);
+
+    /**
+     * \brief Computes the grid of the map from the min/max coordinates and the
+     * resolution defined by the user
+     */
+    void ConfigureRemGrid();
+
+    /**
+     * \brief This method creates the list of Rem Points (coordinates) of a
+     * rectangle of the grid, as half-open ranges of indexes
+     * \param xBegin The first x index
+     * \param xEnd The x index after the last one
+     * \param yBegin The first y index
+     * \param yEnd The y index after the last one
+     */
+    void CreateListOfRemPoints(uint32_t xBegin, uint32_t xEnd, uint32_t yBegin, uint32_t yEnd);
 
     /**
      * \brief Configures the REM Receiving Device (RRD)
@@ -383,17 +482,147 @@ class NrRadioEnvironmentMapHelper : public Object
     void CalcUeCoverageRemMap();
 
     /**
-     * \brief This method calculates the PSD
+     * \brief Computes the list of REM points with the function of the REM mode
+     */
+    void CalcRemPoints();
+
+    /**
+     * \brief Computes the map tile by tile, writing each tile to the raster
+     * before computing the next one, and skipping the tiles already written
+     * if the raster is resumed
+     */
+    void CalcTiledRem();
+
+    /**
+     * \brief Computes a hash of the parameters of the scenario that the header of the
+     * raster does not store: the positions, antennas and beams of the RTDs and of the RRD,
+     * their frequency and power, and the seed and run of the RNG
+     * \return the hash, to check that a resumed raster belongs to the same scenario
+     */
+    uint64_t GetScenarioHash() const;
+
+    /**
+     * \brief Adds a REM device to the hash of the scenario
+     * \param device the device
+     * \param hash the hash to update
+     */
+    void HashRemDevice(const RemDevice& device, uint64_t& hash) const;
+
+    /**
+     * \brief Creates the RemWorker of each of the NumThreads threads, and
+     * reserves the random variable streams of each REM point
+     */
+    void CreateRemWorkers();
+
+    /**
+     * \brief Computes all the REM points of the list with the pool of threads,
+     * each one with its own RemWorker. The points are assigned to the threads
+     * dynamically, one at a time.
+     * \param calcRemPoint The function that computes a REM point
+     */
+    void CalcRemMap(CalcRemPointFn calcRemPoint);
+
+    /**
+     * \brief Computes a REM point of a BeamShape map
+     * \param worker The copies of the devices used by the calling thread
+     * \param remPoint The REM point
+     */
+    void CalcBeamShapeRemPoint(RemWorker& worker, RemPoint& remPoint);
+
+    /**
+     * \brief Computes a REM point of a CoverageArea map
+     * \param worker The copies of the devices used by the calling thread
+     * \param remPoint The REM point
+     */
+    void CalcCoverageAreaRemPoint(RemWorker& worker, RemPoint& remPoint);
+
+    /**
+     * \brief Computes a REM point of a UeCoverage map
+     * \param worker The copies of the devices used by the calling thread
+     * \param remPoint The REM point
+     */
+    void CalcUeCoverageRemPoint(RemWorker& worker, RemPoint& remPoint);
+
+    /**
+     * \brief Creates the copies of the RRD and of the RTDs of a thread. It must be
+     * called by the main thread, because it creates ns-3 objects.
+     * \param worker The worker to configure
+     */
+    void ConfigureRemWorker(RemWorker& worker) const;
+
+    /**
+     * \brief Copies a REM device into the device of a RemWorker, with its own
+     * mobility, antenna array (and element) and spectrum model
+     * \param device The device to copy
+     * \param copy The copy, which already has its own node and mobility model
+     * \param spectrumModels The copies of the spectrum models of the worker, by original
+     */
+    void CopyRemDevice(
+        const RemDevice& device,
+        RemDevice& copy,
+        std::map<Ptr<const SpectrumModel>, Ptr<const SpectrumModel>>& spectrumModels) const;
+
+    /**
+     * \brief Counts a computed REM point, and prints the progress report if needed.
+     * It can be called by any thread.
+     */
+    void CountRemPoint();
+
+    /**
+     * \brief Gets the TX PSD of a device over all its RBs, converted to the
+     * spectrum model of the receiving device. It is computed once per device
+     * and receiving spectrum model.
+     * \param device The transmitting device
+     * \param rxSpectrumModel The spectrum model of the receiving device
+     * \return The TX PSD
+     */
+    Ptr<const SpectrumValue> GetTxPsd(RemDevice& device,
+                                      const Ptr<const SpectrumModel>& rxSpectrumModel) const;
+
+    /**
+     * \brief Creates a link between two devices, with new temporal propagation
+     * models (and channel realization), and computes the pathloss
+     * \param worker The copies of the devices used by the calling thread, which
+     * provides the random variable streams of the temporal propagation models
+     * \param device The transmitting device
+     * \param otherDevice The receiving device
+     * \return The link
+     */
+    RemLink CreateRemLink(RemWorker& worker, RemDevice& device, RemDevice& otherDevice) const;
+
+    /**
+     * \brief This method calculates the PSD of a link, with the current beams of
+     * the devices. Only the beamforming gain is computed, the channel
+     * realization of the link is reused.
+     * \param link The link between the devices
+     * \param device The transmitting device
+     * \param otherDevice The receiving device
+     * \return The PSD (spectrumValue)
+     */
+    Ptr<SpectrumValue> CalcRxPsdValue(const RemLink& link,
+                                      RemDevice& device,
+                                      RemDevice& otherDevice) const;
+
+    /**
+     * \brief This method calculates the PSD over a new link
+     * \param worker The copies of the devices used by the calling thread, which
+     * provides the random variable streams of the temporal propagation models
+     * \param device The transmitting device
+     * \param otherDevice The receiving device
      * \return The PSD (spectrumValue)
      */
-    Ptr<SpectrumValue> CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const;
+    Ptr<SpectrumValue> CalcRxPsdValue(RemWorker& worker,
+                                      RemDevice& device,
+                                      RemDevice& otherDevice) const;
 
     /**
      * \brief This function calculates the SNR.
      * \param usefulSignal The useful Signal
+     * \param noisePsd The noise PSD
      * \return The snr
      */
-    double CalculateSnr(const Ptr<SpectrumValue>& usefulSignal) const;
+    double CalculateSnr(const Ptr<SpectrumValue>& usefulSignal,
+                        const Ptr<SpectrumValue>& noisePsd) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
@@ -407,17 +636,21 @@ class NrRadioEnvironmentMapHelper : public Object
      * \brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
      * \param values The list of spectrumValues for which we want to find the max
+     * \param noisePsd The noise PSD
      * \return The max value (snr)
      */
-    double CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+                           const Ptr<SpectrumValue>& noisePsd) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
      * \param values The list of spectrumValues for which we want to find the max
+     * \param noisePsd The noise PSD
      * \return The max value (sinr)
      */
-    double CalculateMaxSinr(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSinr(const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+                            const Ptr<SpectrumValue>& noisePsd) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
@@ -432,10 +665,12 @@ class NrRadioEnvironmentMapHelper : public Object
      * values (such as PSD).
      * \param usefulSignal The spectrumValue considered as useful signal
      * \param interferenceSignals The list of spectrumValues considered as interference
+     * \param noisePsd The noise PSD
      * \return The max value (sinr)
      */
     double CalculateSinr(const Ptr<SpectrumValue>& usefulSignal,
-                         const std::list<Ptr<SpectrumValue>>& interferenceSignals) const;
+                         const std::list<Ptr<SpectrumValue>>& interferenceSignals,
+                         const Ptr<SpectrumValue>& noisePsd) const;
 
     /**
      * \brief This function calculates the SIR for a given space of frequency-dependent
@@ -486,10 +721,25 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     PropagationModels CreateTemporalPropagationModels() const;
 
+    /**
+     * \brief Assigns fixed random variable streams to the temporal propagation
+     * models (and to their channel condition model)
+     * \param propModels The temporal propagation models
+     * \param stream The first stream
+     * \return The number of streams assigned
+     */
+    int64_t AssignStreams(const PropagationModels& propModels, int64_t stream) const;
+
+    /**
+     * \brief Starts the progress report of the computation of the map
+     * \param numRemPoints The number of REM points to compute
+     */
+    void StartProgressReport(uint64_t numRemPoints);
+
     /**
      * \brief Prints REM generation progress report
      */
-    void PrintProgressReport(uint32_t* remSizeNextReport);
+    void PrintProgressReport(uint64_t* remSizeNextReport);
 
     /**
      * \brief Prints the position of the RTDs.
@@ -556,9 +806,14 @@ class NrRadioEnvironmentMapHelper : public Object
     uint16_t m_yRes{0}; ///< The `YRes` attribute.
     double m_yStep{0};  ///< Distance along Y axis between adjacent listening points.
     double m_z{0};      ///< The `Z` attribute.
+    uint32_t m_numX{0}; ///< Number of points of the grid along the X axis.
+    uint32_t m_numY{0}; ///< Number of points of the grid along the Y axis.
 
     uint16_t m_numOfIterationsToAverage{1};
     Time m_installationDelay{Seconds(0)};
+    uint32_t m_numThreads{1};  ///< The `NumThreads` attribute.
+    uint32_t m_tileSize{0};    ///< The `TileSize` attribute.
+    bool m_resumeTiles{false}; ///< The `ResumeTiles` attribute.
 
     RemDevice m_rrd;
 
@@ -572,7 +827,14 @@ class NrRadioEnvironmentMapHelper : public Object
     ObjectFactory m_channelConditionModelFactory;
     ObjectFactory m_matrixBasedChannelModelFactory;
 
-    Ptr<SpectrumValue> m_noisePsd; // noise figure PSD that will be used for calculations
+    std::vector<RemWorker> m_remWorkers; ///< The copies of the devices of each thread
+    int64_t m_streamsPerRemPoint{0};     ///< Random variable streams reserved for each REM point
+    uint64_t m_numRemPointsToCompute{0}; ///< Number of REM points of the progress report
+    uint64_t m_remPointCounter{0};       ///< Number of REM points computed
+    uint64_t m_remSizeNextReport{0};     ///< Number of REM points of the next progress report
+    NrRemRaster m_remRaster;             ///< The raster of a tiled map
+    /// Serializes the creation of ns-3 objects and the progress report of the REM threads
+    mutable std::mutex m_mutex;
 
     std::string m_simTag; ///< The `SimTag` attribute.
 
@@ -0,0 +1,234 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-rem-raster.h"
+
+#include <ns3/assert.h>
+#include <ns3/log.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrRemRaster");
+
+/// The magic string at the beginning of the REM raster files
+static constexpr char NR_REM_RASTER_MAGIC[8] = {'N', 'R', 'R', 'E', 'M', 'R', 'A', 'S'};
+
+/// The version of the format of the REM raster files
+static constexpr uint32_t NR_REM_RASTER_VERSION = 2;
+
+static_assert(sizeof(NrRemRasterHeader) == 88, "NrRemRasterHeader must not have padding");
+
+NrRemRaster::~NrRemRaster()
+{
+    Close();
+}
+
+bool
+NrRemRaster::Open(const std::string& filename, const NrRemRasterHeader& header, bool resume)
+{
+    NS_LOG_FUNCTION(this << filename << resume);
+    NS_ASSERT_MSG(!m_file.is_open(), "The raster is already open");
+    NS_ASSERT_MSG(header.m_numX > 0 && header.m_numY > 0 && header.m_tileSize > 0,
+                  "The raster and its tiles cannot be empty");
+
+    m_header = header;
+    std::memcpy(m_header.m_magic, NR_REM_RASTER_MAGIC, sizeof(m_header.m_magic));
+    m_header.m_version = NR_REM_RASTER_VERSION;
+    m_header.m_numPlanes = NUM_PLANES;
+    m_header.m_reserved = 0;
+    ComputeLayout();
+
+    if (resume)
+    {
+        m_file.open(filename, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        if (m_file.is_open())
+        {
+            NrRemRasterHeader existing;
+            m_file.read(reinterpret_cast<char*>(&existing), sizeof(existing));
+            if (m_file && existing.m_scenario != m_header.m_scenario)
+            {
+                NS_LOG_WARN(filename << " is a raster of another scenario, it cannot be resumed");
+                m_file.close();
+                return false;
+            }
+            if (!m_file || std::memcmp(&existing, &m_header, sizeof(existing)) != 0)
+            {
+                NS_LOG_WARN(filename << " is not a raster of the same map, it cannot be resumed");
+                m_file.close();
+                return false;
+            }
+            m_file.read(reinterpret_cast<char*>(m_tileDone.data()),
+                        static_cast<std::streamsize>(m_tileDone.size()));
+            if (!m_file)
+            {
+                m_file.close();
+                return false;
+            }
+            NS_LOG_INFO("Resuming " << filename);
+            return true;
+        }
+    }
+
+    m_file.open(filename,
+                std::ios_base::in | std::ios_base::out | std::ios_base::binary |
+                    std::ios_base::trunc);
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+    m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    m_file.write(reinterpret_cast<const char*>(m_tileDone.data()),
+                 static_cast<std::streamsize>(m_tileDone.size()));
+    // The planes are allocated by writing their last byte, the file system does not need to
+    // write the rest until the tiles are written
+    m_file.seekp(static_cast<std::streamoff>(GetPlaneOffset(NUM_PLANES) - 1));
+    m_file.put(0);
+    m_file.flush();
+    return static_cast<bool>(m_file);
+}
+
+bool
+NrRemRaster::OpenForReading(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    NS_ASSERT_MSG(!m_file.is_open(), "The raster is already open");
+    m_file.open(filename, std::ios_base::in | std::ios_base::binary);
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+    m_file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header));
+    if (!m_file ||
+        std::memcmp(m_header.m_magic, NR_REM_RASTER_MAGIC, sizeof(m_header.m_magic)) != 0 ||
+        m_header.m_version != NR_REM_RASTER_VERSION || m_header.m_numPlanes != NUM_PLANES ||
+        m_header.m_tileSize == 0)
+    {
+        m_file.close();
+        return false;
+    }
+    ComputeLayout();
+    m_file.read(reinterpret_cast<char*>(m_tileDone.data()),
+                static_cast<std::streamsize>(m_tileDone.size()));
+    if (!m_file)
+    {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void
+NrRemRaster::Close()
+{
+    if (m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+const NrRemRasterHeader&
+NrRemRaster::GetHeader() const
+{
+    return m_header;
+}
+
+uint32_t
+NrRemRaster::GetNumTiles() const
+{
+    return static_cast<uint32_t>(m_tileDone.size());
+}
+
+void
+NrRemRaster::GetTileBounds(uint32_t tile,
+                           uint32_t& xBegin,
+                           uint32_t& xEnd,
+                           uint32_t& yBegin,
+                           uint32_t& yEnd) const
+{
+    NS_ASSERT_MSG(tile < GetNumTiles(), "Tile " << tile << " out of range");
+    xBegin = (tile % m_numTilesX) * m_header.m_tileSize;
+    yBegin = (tile / m_numTilesX) * m_header.m_tileSize;
+    xEnd = std::min(xBegin + m_header.m_tileSize, m_header.m_numX);
+    yEnd = std::min(yBegin + m_header.m_tileSize, m_header.m_numY);
+}
+
+bool
+NrRemRaster::IsTileDone(uint32_t tile) const
+{
+    NS_ASSERT_MSG(tile < GetNumTiles(), "Tile " << tile << " out of range");
+    return m_tileDone[tile] != 0;
+}
+
+void
+NrRemRaster::WriteTile(uint32_t tile, const std::vector<float>& values)
+{
+    NS_LOG_FUNCTION(this << tile);
+    NS_ASSERT_MSG(m_file.is_open(), "The raster is not open");
+    uint32_t xBegin;
+    uint32_t xEnd;
+    uint32_t yBegin;
+    uint32_t yEnd;
+    GetTileBounds(tile, xBegin, xEnd, yBegin, yEnd);
+    const size_t width = xEnd - xBegin;
+    const size_t height = yEnd - yBegin;
+    NS_ASSERT_MSG(values.size() == NUM_PLANES * width * height,
+                  "Wrong number of values for tile " << tile);
+
+    const float* row = values.data();
+    for (uint32_t plane = 0; plane < NUM_PLANES; plane++)
+    {
+        for (uint32_t y = yBegin; y < yEnd; y++)
+        {
+            uint64_t offset = GetPlaneOffset(static_cast<Plane>(plane)) +
+                              (static_cast<uint64_t>(y) * m_header.m_numX + xBegin) * sizeof(float);
+            m_file.seekp(static_cast<std::streamoff>(offset));
+            m_file.write(reinterpret_cast<const char*>(row),
+                         static_cast<std::streamsize>(width * sizeof(float)));
+            row += width;
+        }
+    }
+    // The tile is marked only when its values are in the file
+    m_file.flush();
+    m_tileDone[tile] = 1;
+    m_file.seekp(static_cast<std::streamoff>(sizeof(m_header) + tile));
+    m_file.put(1);
+    m_file.flush();
+    NS_ABORT_MSG_IF(!m_file, "Could not write tile " << tile << " of the REM raster");
+}
+
+float
+NrRemRaster::ReadValue(Plane plane, uint32_t x, uint32_t y)
+{
+    NS_ASSERT_MSG(m_file.is_open(), "The raster is not open");
+    NS_ASSERT_MSG(x < m_header.m_numX && y < m_header.m_numY, "Point out of range");
+    float value;
+    uint64_t offset =
+        GetPlaneOffset(plane) + (static_cast<uint64_t>(y) * m_header.m_numX + x) * sizeof(float);
+    m_file.seekg(static_cast<std::streamoff>(offset));
+    m_file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    NS_ABORT_MSG_IF(!m_file, "Could not read the REM raster");
+    return value;
+}
+
+uint64_t
+NrRemRaster::GetPlaneOffset(Plane plane) const
+{
+    return m_planesOffset + static_cast<uint64_t>(plane) * m_header.m_numX * m_header.m_numY *
+                                sizeof(float);
+}
+
+void
+NrRemRaster::ComputeLayout()
+{
+    m_numTilesX = (m_header.m_numX + m_header.m_tileSize - 1) / m_header.m_tileSize;
+    uint32_t numTilesY = (m_header.m_numY + m_header.m_tileSize - 1) / m_header.m_tileSize;
+    m_tileDone.assign(static_cast<size_t>(m_numTilesX) * numTilesY, 0);
+    m_planesOffset = sizeof(m_header) + (m_tileDone.size() + 7) / 8 * 8;
+}
+
+} // namespace ns3
@@ -0,0 +1,179 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_REM_RASTER_H
+#define NR_REM_RASTER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr
+ * \brief Header of a binary REM raster file
+ *
+ * Besides the grid, it stores the parameters of the map that change its values, which must
+ * be the same to resume a map. The parameters of the scenario (the positions, antennas and beams
+ * of the devices, the frequency, the RNG seed and run) are too many to be stored, so only a hash
+ * of them is.
+ */
+struct NrRemRasterHeader
+{
+    char m_magic[8];          //!< The characters "NRREMRAS"
+    uint32_t m_version;       //!< The version of the format
+    uint32_t m_numPlanes;     //!< The number of planes (NrRemRaster::NUM_PLANES)
+    uint32_t m_numX;          //!< The number of points along the x axis
+    uint32_t m_numY;          //!< The number of points along the y axis
+    uint32_t m_tileSize;      //!< The number of points of each side of the tiles
+    uint32_t m_remMode;       //!< The NrRadioEnvironmentMapHelper::RemMode of the map
+    uint32_t m_numIterations; //!< The number of iterations to average
+    uint32_t m_reserved;      //!< Padding, always 0
+    double m_xMin;            //!< The x coordinate of the first point (m)
+    double m_yMin;            //!< The y coordinate of the first point (m)
+    double m_xStep;           //!< The distance between the points along the x axis (m)
+    double m_yStep;           //!< The distance between the points along the y axis (m)
+    double m_z;               //!< The z coordinate of the points (m)
+    uint64_t m_scenario;      //!< Hash of the parameters of the scenario
+};
+
+/**
+ * \ingroup nr
+ * \brief Binary raster of a REM, written tile by tile
+ *
+ * The file is a NrRemRasterHeader, followed by a byte per tile that is 1 when the tile has
+ * been written, padded to a multiple of 8 bytes, and by NUM_PLANES planes of numX * numY
+ * float32 values (the x index varies fastest), in the byte order of the host. The points
+ * that were not computed (e.g., at the position of a RTD) are NaN.
+ *
+ * The tiles are squares of tileSize x tileSize points (smaller on the last row and column),
+ * numbered by rows. A tile is marked as written only after its values have been flushed to
+ * the file, so the file is a checkpoint: if the computation is interrupted, the file can be
+ * opened again with resume set, and only the tiles that are not marked need to be computed.
+ *
+ * The planes can be plotted directly with gnuplot, e.g.:
+ * \code{.unparsed}
+$ plot "file" binary skip=<GetPlaneOffset(plane)> array=(numX,numY) format="%float32" with image
+   \endcode
+ */
+class NrRemRaster
+{
+  public:
+    /**
+     * \brief The planes of the raster, in the order of the columns of the text REM
+     */
+    enum Plane : uint32_t
+    {
+        SNR = 0,       //!< Average SNR (dB)
+        SINR = 1,      //!< Average SINR (dB)
+        IPSD = 2,      //!< Average received power (dBm)
+        SIR = 3,       //!< Average SIR (dB)
+        NUM_PLANES = 4 //!< Number of planes
+    };
+
+    /**
+     * \brief Destructor, which closes the file
+     */
+    ~NrRemRaster();
+
+    /**
+     * \brief Open a raster to write it. The magic, the version and the number of planes of
+     * the header are set by this method.
+     * \param filename the name of the file
+     * \param header the header of the map
+     * \param resume whether an existing file with the same header is kept, with its
+     * written tiles, instead of being overwritten
+     * \return false if the file cannot be opened, or if it cannot be resumed because it is
+     * not a raster with the same header
+     */
+    bool Open(const std::string& filename, const NrRemRasterHeader& header, bool resume);
+
+    /**
+     * \brief Open an existing raster to read it
+     * \param filename the name of the file
+     * \return false if the file cannot be opened, or if it is not a raster
+     */
+    bool OpenForReading(const std::string& filename);
+
+    /**
+     * \brief Close the file
+     */
+    void Close();
+
+    /**
+     * \brief Get the header of the raster
+     * \return the header
+     */
+    const NrRemRasterHeader& GetHeader() const;
+
+    /**
+     * \brief Get the number of tiles
+     * \return the number of tiles
+     */
+    uint32_t GetNumTiles() const;
+
+    /**
+     * \brief Get the points of a tile, as half-open ranges of indexes
+     * \param tile the tile
+     * \param xBegin the first x index of the tile
+     * \param xEnd the x index after the last one of the tile
+     * \param yBegin the first y index of the tile
+     * \param yEnd the y index after the last one of the tile
+     */
+    void GetTileBounds(uint32_t tile,
+                       uint32_t& xBegin,
+                       uint32_t& xEnd,
+                       uint32_t& yBegin,
+                       uint32_t& yEnd) const;
+
+    /**
+     * \brief Get whether a tile has been written
+     * \param tile the tile
+     * \return true if the tile has been written
+     */
+    bool IsTileDone(uint32_t tile) const;
+
+    /**
+     * \brief Write the values of a tile, and mark it as written
+     * \param tile the tile
+     * \param values the values of the tile: for each plane, the rows of the tile (the x index
+     * varies fastest)
+     */
+    void WriteTile(uint32_t tile, const std::vector<float>& values);
+
+    /**
+     * \brief Read a value
+     * \param plane the plane
+     * \param x the x index of the point
+     * \param y the y index of the point
+     * \return the value
+     */
+    float ReadValue(Plane plane, uint32_t x, uint32_t y);
+
+    /**
+     * \brief Get the offset of a plane in the file
+     * \param plane the plane
+     * \return the offset (bytes)
+     */
+    uint64_t GetPlaneOffset(Plane plane) const;
+
+  private:
+    /**
+     * \brief Compute the layout of the file from the header
+     */
+    void ComputeLayout();
+
+    std::fstream m_file;             //!< The file
+    NrRemRasterHeader m_header{};    //!< The header
+    uint32_t m_numTilesX{0};         //!< The number of tiles along the x axis
+    std::vector<uint8_t> m_tileDone; //!< Whether each tile has been written
+    uint64_t m_planesOffset{0};      //!< The offset of the first plane (bytes)
+};
+
+} // namespace ns3
+
+#endif // NR_REM_RASTER_H
@@ -0,0 +1,231 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-spatial-index.h"
+
+#include <ns3/abort.h>
+#include <ns3/assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace ns3
+{
+
+NrSpatialIndex::NrSpatialIndex(const std::vector<Vector>& points, bool horizontal)
+    : m_points(points),
+      m_horizontal(horizontal)
+{
+    NS_ABORT_MSG_IF(points.size() >= std::numeric_limits<uint32_t>::max(), "Too many points");
+    if (points.empty())
+    {
+        return;
+    }
+
+    double maxX = points.front().x;
+    double maxY = points.front().y;
+    m_minX = maxX;
+    m_minY = maxY;
+    for (const auto& point : points)
+    {
+        m_minX = std::min(m_minX, point.x);
+        m_minY = std::min(m_minY, point.y);
+        maxX = std::max(maxX, point.x);
+        maxY = std::max(maxY, point.y);
+    }
+
+    // About two points per bucket. A side of the deployment of length 0 (e.g., points on a
+    // line) counts as the average distance between the points along the other side.
+    const auto n = static_cast<double>(points.size());
+    const double extent = std::max(maxX - m_minX, maxY - m_minY);
+    if (extent > 0.0)
+    {
+        const double area =
+            std::max(maxX - m_minX, extent / n) * std::max(maxY - m_minY, extent / n);
+        m_bucketSize = std::sqrt(2.0 * area / n);
+    }
+    m_numX = static_cast<int64_t>((maxX - m_minX) / m_bucketSize) + 1;
+    m_numY = static_cast<int64_t>((maxY - m_minY) / m_bucketSize) + 1;
+
+    // Counting sort of the points by bucket, which keeps them sorted by index in each bucket
+    std::vector<uint32_t> bucketOfPoint(points.size());
+    m_bucketStart.assign(m_numX * m_numY + 1, 0);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        int64_t x;
+        int64_t y;
+        GetBucket(points[i], x, y);
+        bucketOfPoint[i] = static_cast<uint32_t>(y * m_numX + x);
+        m_bucketStart[bucketOfPoint[i] + 1]++;
+    }
+    for (size_t b = 1; b < m_bucketStart.size(); b++)
+    {
+        m_bucketStart[b] += m_bucketStart[b - 1];
+    }
+    m_bucketPoints.resize(points.size());
+    std::vector<uint32_t> next(m_bucketStart.begin(), m_bucketStart.end() - 1);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        m_bucketPoints[next[bucketOfPoint[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+size_t
+NrSpatialIndex::GetN() const
+{
+    return m_points.size();
+}
+
+const Vector&
+NrSpatialIndex::GetPoint(size_t i) const
+{
+    return m_points.at(i);
+}
+
+double
+NrSpatialIndex::GetDistance(const Vector& a, const Vector& b) const
+{
+    if (m_horizontal)
+    {
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+    return CalculateDistance(a, b);
+}
+
+void
+NrSpatialIndex::GetBucket(const Vector& position, int64_t& x, int64_t& y) const
+{
+    const double fx = std::floor((position.x - m_minX) / m_bucketSize);
+    const double fy = std::floor((position.y - m_minY) / m_bucketSize);
+    x = static_cast<int64_t>(std::clamp(fx, 0.0, static_cast<double>(m_numX - 1)));
+    y = static_cast<int64_t>(std::clamp(fy, 0.0, static_cast<double>(m_numY - 1)));
+}
+
+size_t
+NrSpatialIndex::FindNearest(const Vector& position) const
+{
+    NS_ABORT_MSG_IF(m_points.empty(), "No points in the spatial index");
+    return FindNearest(position, 1).front();
+}
+
+std::vector<size_t>
+NrSpatialIndex::FindNearest(const Vector& position, size_t k) const
+{
+    // The k closest points found so far, sorted by distance and index
+    std::vector<std::pair<double, size_t>> best;
+    k = std::min(k, m_points.size());
+    if (k == 0)
+    {
+        return {};
+    }
+    best.reserve(k + 1);
+
+    auto visitBucket = [this, &position, &best, k](int64_t x, int64_t y) {
+        const auto bucket = y * m_numX + x;
+        for (auto e = m_bucketStart[bucket]; e < m_bucketStart[bucket + 1]; e++)
+        {
+            const size_t i = m_bucketPoints[e];
+            const std::pair<double, size_t> candidate{GetDistance(position, m_points[i]), i};
+            if (best.size() == k && !(candidate < best.back()))
+            {
+                continue;
+            }
+            best.insert(std::upper_bound(best.begin(), best.end(), candidate), candidate);
+            if (best.size() > k)
+            {
+                best.pop_back();
+            }
+        }
+    };
+
+    int64_t cx;
+    int64_t cy;
+    GetBucket(position, cx, cy);
+    const double inf = std::numeric_limits<double>::infinity();
+    for (int64_t r = 0;; r++)
+    {
+        // The buckets at Chebyshev distance r from (cx, cy)
+        for (int64_t y = std::max(cy - r, int64_t{0}); y <= std::min(cy + r, m_numY - 1); y++)
+        {
+            if (y == cy - r || y == cy + r)
+            {
+                for (int64_t x = std::max(cx - r, int64_t{0}); x <= std::min(cx + r, m_numX - 1);
+                     x++)
+                {
+                    visitBucket(x, y);
+                }
+                continue;
+            }
+            if (cx - r >= 0)
+            {
+                visitBucket(cx - r, y);
+            }
+            if (cx + r < m_numX)
+            {
+                visitBucket(cx + r, y);
+            }
+        }
+
+        // Lower bound of the distance of the points outside of the visited buckets: the
+        // distance to the closest side of the block that has buckets beyond it
+        const double left = cx - r > 0 ? position.x - (m_minX + (cx - r) * m_bucketSize) : inf;
+        const double right =
+            cx + r < m_numX - 1 ? (m_minX + (cx + r + 1) * m_bucketSize) - position.x : inf;
+        const double bottom = cy - r > 0 ? position.y - (m_minY + (cy - r) * m_bucketSize) : inf;
+        const double top =
+            cy + r < m_numY - 1 ? (m_minY + (cy + r + 1) * m_bucketSize) - position.y : inf;
+        const double bound = std::min({left, right, bottom, top});
+        if (bound == inf || (best.size() == k && best.back().first < bound))
+        {
+            break;
+        }
+    }
+
+    std::vector<size_t> ret;
+    ret.reserve(best.size());
+    for (const auto& [distance, i] : best)
+    {
+        ret.push_back(i);
+    }
+    return ret;
+}
+
+std::vector<size_t>
+NrSpatialIndex::FindWithinDistance(const Vector& position, double distance) const
+{
+    std::vector<size_t> ret;
+    if (m_points.empty() || distance < 0.0)
+    {
+        return ret;
+    }
+    int64_t minX;
+    int64_t minY;
+    int64_t maxX;
+    int64_t maxY;
+    GetBucket(Vector(position.x - distance, position.y - distance, position.z), minX, minY);
+    GetBucket(Vector(position.x + distance, position.y + distance, position.z), maxX, maxY);
+    for (int64_t y = minY; y <= maxY; y++)
+    {
+        for (int64_t x = minX; x <= maxX; x++)
+        {
+            const auto bucket = y * m_numX + x;
+            for (auto e = m_bucketStart[bucket]; e < m_bucketStart[bucket + 1]; e++)
+            {
+                const size_t i = m_bucketPoints[e];
+                if (GetDistance(position, m_points[i]) <= distance)
+                {
+                    ret.push_back(i);
+                }
+            }
+        }
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+} // namespace ns3
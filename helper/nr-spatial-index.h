@@ -0,0 +1,111 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_SPATIAL_INDEX_H
+#define NR_SPATIAL_INDEX_H
+
+#include <ns3/vector.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup helper
+ * \brief Spatial index of a set of points (e.g., the positions of the sites or of the gNBs),
+ * for nearest-neighbor and range queries
+ *
+ * The points are stored in a uniform grid of buckets on the xy-plane, with about two points
+ * per bucket. A query visits the buckets in rings around the bucket of the queried position,
+ * and stops when the buckets not visited yet cannot contain a closer point, so its cost does
+ * not depend on the number of points for evenly spread deployments.
+ *
+ * The distances are the 3D distances, or the distances on the xy-plane if the index is
+ * horizontal. The results are the same as those of a linear scan: among the points at the same
+ * distance, the one with the lowest index is returned first.
+ */
+class NrSpatialIndex
+{
+  public:
+    /**
+     * \brief Constructor of an empty index
+     */
+    NrSpatialIndex() = default;
+
+    /**
+     * \brief Build the index of a set of points
+     * \param points the points
+     * \param horizontal whether the distances are computed on the xy-plane only
+     */
+    explicit NrSpatialIndex(const std::vector<Vector>& points, bool horizontal = false);
+
+    /**
+     * \brief Get the number of points
+     * \return the number of points
+     */
+    size_t GetN() const;
+
+    /**
+     * \brief Get a point
+     * \param i the index of the point
+     * \return the point
+     */
+    const Vector& GetPoint(size_t i) const;
+
+    /**
+     * \brief Get the distance between two positions, as computed by the index
+     * \param a the first position
+     * \param b the second position
+     * \return the 3D distance, or the distance on the xy-plane if the index is horizontal
+     */
+    double GetDistance(const Vector& a, const Vector& b) const;
+
+    /**
+     * \brief Find the point closest to a position. The index must not be empty.
+     * \param position the position
+     * \return the index of the closest point
+     */
+    size_t FindNearest(const Vector& position) const;
+
+    /**
+     * \brief Find the k points closest to a position
+     * \param position the position
+     * \param k the number of points
+     * \return the indexes of the min(k, GetN ()) closest points, sorted by distance
+     */
+    std::vector<size_t> FindNearest(const Vector& position, size_t k) const;
+
+    /**
+     * \brief Find the points within a distance of a position
+     * \param position the position
+     * \param distance the distance
+     * \return the indexes of the points at a distance lower than or equal to distance, sorted
+     */
+    std::vector<size_t> FindWithinDistance(const Vector& position, double distance) const;
+
+  private:
+    /**
+     * \brief Get the bucket of a position, clamped to the grid
+     * \param position the position
+     * \param x the x index of the bucket
+     * \param y the y index of the bucket
+     */
+    void GetBucket(const Vector& position, int64_t& x, int64_t& y) const;
+
+    std::vector<Vector> m_points;         //!< The points
+    bool m_horizontal{false};             //!< Whether the distances are on the xy-plane
+    double m_minX{0.0};                   //!< The x coordinate of the grid origin
+    double m_minY{0.0};                   //!< The y coordinate of the grid origin
+    double m_bucketSize{1.0};             //!< The side of the buckets
+    int64_t m_numX{0};                    //!< The number of buckets along the x axis
+    int64_t m_numY{0};                    //!< The number of buckets along the y axis
+    std::vector<uint32_t> m_bucketStart;  //!< First entry of each bucket in m_bucketPoints
+    std::vector<uint32_t> m_bucketPoints; //!< The points of the buckets, by bucket and index
+};
+
+} // namespace ns3
+
+#endif // NR_SPATIAL_INDEX_H
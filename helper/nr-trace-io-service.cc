@@ -0,0 +1,440 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-trace-io-service.h"
+
+#include <ns3/boolean.h>
+#include <ns3/global-value.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrTraceIoService");
+
+/// Whether the NR trace files are written by the writer thread of NrTraceIoService
+static GlobalValue g_nrAsyncTraceIo("NrAsyncTraceIo",
+                                    "Whether the NR trace files are written by a background "
+                                    "thread. Read when a file is opened.",
+                                    BooleanValue(true),
+                                    MakeBooleanChecker());
+
+/// Size of the ring buffer of each NR trace file written by NrTraceIoService
+static GlobalValue g_nrTraceIoBufferSize("NrTraceIoBufferSize",
+                                         "Size (bytes) of the ring buffer of each NR trace file "
+                                         "written by the background thread. When it is full, "
+                                         "the simulation waits for the background thread.",
+                                         UintegerValue(1 << 20),
+                                         MakeUintegerChecker<uint32_t>(1));
+
+/// Period after which the writer thread writes the pending rows, if it was not notified
+static constexpr std::chrono::milliseconds WRITER_PERIOD{5};
+
+/// Maximum time the simulator thread waits for the writer thread when a ring buffer is full
+static constexpr std::chrono::milliseconds BACKPRESSURE_WAIT{1};
+
+NrTraceIoService&
+NrTraceIoService::Get()
+{
+    // Never destroyed: the trace files can be static objects, which are closed when the
+    // static objects are destroyed at exit
+    static auto service = new NrTraceIoService();
+    return *service;
+}
+
+bool
+NrTraceIoService::IsEnabled()
+{
+    BooleanValue enabled;
+    g_nrAsyncTraceIo.GetValue(enabled);
+    return enabled.Get();
+}
+
+size_t
+NrTraceIoService::GetBufferSize()
+{
+    UintegerValue size;
+    g_nrTraceIoBufferSize.GetValue(size);
+    return size.Get();
+}
+
+void
+NrTraceIoService::Register(NrAsyncTraceBuffer* buffer)
+{
+    NS_LOG_FUNCTION(this << buffer);
+    bool scheduleFlush = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.push_back(buffer);
+        if (!m_thread.joinable())
+        {
+            NS_LOG_INFO("Starting the writer thread");
+            m_stop = false;
+            m_thread = std::thread(&NrTraceIoService::Run, this);
+        }
+        scheduleFlush = !m_flushScheduled;
+        m_flushScheduled = true;
+    }
+    if (scheduleFlush)
+    {
+        Simulator::ScheduleDestroy(&NrTraceIoService::FlushAll);
+    }
+}
+
+void
+NrTraceIoService::Unregister(NrAsyncTraceBuffer* buffer)
+{
+    NS_LOG_FUNCTION(this << buffer);
+    bool stop = false;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        AcquireBuffers(lock);
+        m_buffers.erase(std::remove(m_buffers.begin(), m_buffers.end(), buffer),
+                        m_buffers.end());
+        stop = m_buffers.empty();
+        m_stop = stop;
+        m_busy = false;
+    }
+    m_progressCv.notify_all();
+    if (stop)
+    {
+        NS_LOG_INFO("Stopping the writer thread");
+        m_writerCv.notify_one();
+        m_thread.join();
+    }
+}
+
+void
+NrTraceIoService::Notify()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeUp = true;
+    }
+    m_writerCv.notify_one();
+}
+
+void
+NrTraceIoService::WaitForProgress()
+{
+    NS_LOG_LOGIC("A ring buffer is full, waiting for the writer thread");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wakeUp = true;
+    m_writerCv.notify_one();
+    m_progressCv.wait_for(lock, BACKPRESSURE_WAIT);
+}
+
+void
+NrTraceIoService::FlushAll()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    auto& service = Get();
+    std::vector<NrAsyncTraceBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(service.m_mutex);
+        service.m_flushScheduled = false;
+        buffers = service.m_buffers;
+    }
+    // The put areas belong to the simulator thread, which is the calling one
+    for (auto buffer : buffers)
+    {
+        buffer->pubsync();
+    }
+    {
+        std::unique_lock<std::mutex> lock(service.m_mutex);
+        service.AcquireBuffers(lock);
+    }
+    for (auto buffer : buffers)
+    {
+        buffer->Drain();
+    }
+    {
+        std::lock_guard<std::mutex> lock(service.m_mutex);
+        service.m_busy = false;
+    }
+    service.m_progressCv.notify_all();
+}
+
+void
+NrTraceIoService::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_writerCv.wait_for(lock, WRITER_PERIOD, [this] { return m_wakeUp || m_stop; });
+        if (m_stop)
+        {
+            return;
+        }
+        m_wakeUp = false;
+        if (m_busy)
+        {
+            // The simulator thread is writing the buffers
+            continue;
+        }
+        m_busy = true;
+        auto buffers = m_buffers;
+        lock.unlock();
+        for (auto buffer : buffers)
+        {
+            buffer->Drain();
+        }
+        lock.lock();
+        m_busy = false;
+        m_progressCv.notify_all();
+    }
+}
+
+void
+NrTraceIoService::AcquireBuffers(std::unique_lock<std::mutex>& lock)
+{
+    m_progressCv.wait(lock, [this] { return !m_busy; });
+    m_busy = true;
+}
+
+NrAsyncTraceBuffer::NrAsyncTraceBuffer(size_t capacity)
+    : m_putArea(PUT_AREA_SIZE),
+      m_ring(capacity)
+{
+    NS_ASSERT_MSG(capacity > 0, "The ring buffer cannot be empty");
+}
+
+NrAsyncTraceBuffer::~NrAsyncTraceBuffer()
+{
+    Close();
+}
+
+bool
+NrAsyncTraceBuffer::Open(const std::string& filename, std::ios_base::openmode mode)
+{
+    NS_LOG_FUNCTION(this << filename);
+    NS_ASSERT_MSG(!IsOpen(), "The buffer is already open");
+    // The file is opened on the calling thread, so that the errors are reported immediately
+    if (!m_file.open(filename, mode | std::ios_base::out))
+    {
+        return false;
+    }
+    m_head = 0;
+    m_tail = 0;
+    setp(m_putArea.data(), m_putArea.data() + m_putArea.size());
+    NrTraceIoService::Get().Register(this);
+    m_registered = true;
+    return true;
+}
+
+bool
+NrAsyncTraceBuffer::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+void
+NrAsyncTraceBuffer::Close()
+{
+    if (!IsOpen())
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    PushPutArea();
+    setp(nullptr, nullptr);
+    if (m_registered)
+    {
+        NrTraceIoService::Get().Unregister(this);
+        m_registered = false;
+    }
+    // The writer thread does not access the buffer anymore
+    Drain();
+    m_file.close();
+}
+
+size_t
+NrAsyncTraceBuffer::Drain()
+{
+    auto tail = m_tail.load(std::memory_order_relaxed);
+    auto head = m_head.load(std::memory_order_acquire);
+    auto n = static_cast<size_t>(head - tail);
+    if (n == 0)
+    {
+        return 0;
+    }
+    auto start = static_cast<size_t>(tail % m_ring.size());
+    auto first = std::min(n, m_ring.size() - start);
+    m_file.sputn(m_ring.data() + start, static_cast<std::streamsize>(first));
+    if (n > first)
+    {
+        m_file.sputn(m_ring.data(), static_cast<std::streamsize>(n - first));
+    }
+    m_file.pubsync();
+    m_tail.store(head, std::memory_order_release);
+    return n;
+}
+
+NrAsyncTraceBuffer::int_type
+NrAsyncTraceBuffer::overflow(int_type ch)
+{
+    if (!IsOpen())
+    {
+        return traits_type::eof();
+    }
+    PushPutArea();
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize
+NrAsyncTraceBuffer::xsputn(const char* s, std::streamsize n)
+{
+    if (!IsOpen())
+    {
+        return 0;
+    }
+    if (n <= epptr() - pptr())
+    {
+        std::memcpy(pptr(), s, static_cast<size_t>(n));
+        pbump(static_cast<int>(n));
+        return n;
+    }
+    PushPutArea();
+    if (static_cast<size_t>(n) >= m_putArea.size())
+    {
+        Push(s, static_cast<size_t>(n));
+    }
+    else
+    {
+        std::memcpy(pptr(), s, static_cast<size_t>(n));
+        pbump(static_cast<int>(n));
+    }
+    return n;
+}
+
+int
+NrAsyncTraceBuffer::sync()
+{
+    if (IsOpen())
+    {
+        PushPutArea();
+    }
+    return 0;
+}
+
+void
+NrAsyncTraceBuffer::Push(const char* data, size_t n)
+{
+    const auto capacity = m_ring.size();
+    while (n > 0)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        auto tail = m_tail.load(std::memory_order_acquire);
+        auto used = static_cast<size_t>(head - tail);
+        if (used == capacity)
+        {
+            // Backpressure: the rows are never dropped
+            NrTraceIoService::Get().WaitForProgress();
+            continue;
+        }
+        auto count = std::min(n, capacity - used);
+        auto start = static_cast<size_t>(head % capacity);
+        auto first = std::min(count, capacity - start);
+        std::memcpy(m_ring.data() + start, data, first);
+        std::memcpy(m_ring.data(), data + first, count - first);
+        m_head.store(head + count, std::memory_order_release);
+
+        // Wake up the writer thread when the ring buffer becomes half full, instead of
+        // waiting for its period
+        if (used < capacity / 2 && used + count >= capacity / 2)
+        {
+            NrTraceIoService::Get().Notify();
+        }
+        data += count;
+        n -= count;
+    }
+}
+
+void
+NrAsyncTraceBuffer::PushPutArea()
+{
+    Push(pbase(), static_cast<size_t>(pptr() - pbase()));
+    setp(m_putArea.data(), m_putArea.data() + m_putArea.size());
+}
+
+NrTraceOfstream::NrTraceOfstream()
+    : std::ostream(nullptr)
+{
+}
+
+NrTraceOfstream::NrTraceOfstream(const std::string& filename, std::ios_base::openmode mode)
+    : NrTraceOfstream()
+{
+    open(filename, mode);
+}
+
+NrTraceOfstream::~NrTraceOfstream()
+{
+    close();
+}
+
+void
+NrTraceOfstream::open(const std::string& filename, std::ios_base::openmode mode)
+{
+    if (is_open())
+    {
+        setstate(std::ios_base::failbit);
+        return;
+    }
+    if (NrTraceIoService::IsEnabled())
+    {
+        m_asyncBuf = std::make_unique<NrAsyncTraceBuffer>(NrTraceIoService::GetBufferSize());
+        if (m_asyncBuf->Open(filename, mode))
+        {
+            rdbuf(m_asyncBuf.get());
+            return;
+        }
+        m_asyncBuf.reset();
+    }
+    else if (m_fileBuf.open(filename, mode | std::ios_base::out))
+    {
+        rdbuf(&m_fileBuf);
+        return;
+    }
+    rdbuf(nullptr);
+    setstate(std::ios_base::failbit);
+}
+
+bool
+NrTraceOfstream::is_open() const
+{
+    return (m_asyncBuf && m_asyncBuf->IsOpen()) || m_fileBuf.is_open();
+}
+
+void
+NrTraceOfstream::close()
+{
+    if (m_asyncBuf)
+    {
+        m_asyncBuf->Close();
+        m_asyncBuf.reset();
+    }
+    else if (m_fileBuf.is_open())
+    {
+        m_fileBuf.close();
+    }
+    else
+    {
+        return;
+    }
+    rdbuf(nullptr);
+}
+
+} // namespace ns3
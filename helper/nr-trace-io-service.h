@@ -0,0 +1,254 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_TRACE_IO_SERVICE_H
+#define NR_TRACE_IO_SERVICE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+class NrAsyncTraceBuffer;
+
+/**
+ * \ingroup nr
+ * \brief The service that writes the NR trace files in the background
+ *
+ * The trace sinks write their rows into a NrTraceOfstream, which copies them into the
+ * NrAsyncTraceBuffer of the file: a bounded single-producer single-consumer ring buffer. The
+ * producer is the simulator thread, and the consumer is the writer thread of this service,
+ * which is the only one that writes to the disk while the simulation runs. The simulator
+ * thread waits for the writer thread only when a ring buffer is full (backpressure), so no
+ * row is lost, and the memory used is bounded by the size of the ring buffers.
+ *
+ * At Simulator::Destroy, and when a file is closed, the pending rows are written and the
+ * files are flushed on the calling thread. The writer thread runs only while there are open
+ * files.
+ *
+ * The service is enabled by the global value NrAsyncTraceIo, and the size of the ring buffers
+ * is set by the global value NrTraceIoBufferSize. Both are read when a file is opened.
+ */
+class NrTraceIoService
+{
+  public:
+    /**
+     * \brief Get the service
+     * \return the service
+     */
+    static NrTraceIoService& Get();
+
+    /**
+     * \brief Whether the files opened from now on are written in the background
+     * \return the value of the global value NrAsyncTraceIo
+     */
+    static bool IsEnabled();
+
+    /**
+     * \brief Get the size of the ring buffer of the files opened from now on
+     * \return the value of the global value NrTraceIoBufferSize (bytes)
+     */
+    static size_t GetBufferSize();
+
+    /**
+     * \brief Start writing a buffer in the background, starting the writer thread if needed
+     * \param buffer the buffer
+     */
+    void Register(NrAsyncTraceBuffer* buffer);
+
+    /**
+     * \brief Stop writing a buffer in the background, and stop the writer thread if it was the
+     * last one. When this method returns, the writer thread does not access the buffer anymore.
+     * \param buffer the buffer
+     */
+    void Unregister(NrAsyncTraceBuffer* buffer);
+
+    /**
+     * \brief Wake up the writer thread
+     */
+    void Notify();
+
+    /**
+     * \brief Wait until the writer thread is not writing, or until a timeout, whatever comes
+     * first. Called by the simulator thread when a ring buffer is full.
+     */
+    void WaitForProgress();
+
+    /**
+     * \brief Write the pending rows of all the buffers, and flush the files, on the calling
+     * thread (the simulator thread). Scheduled at Simulator::Destroy.
+     */
+    static void FlushAll();
+
+  private:
+    NrTraceIoService() = default;
+
+    /**
+     * \brief The loop of the writer thread
+     */
+    void Run();
+
+    /**
+     * \brief Wait until the writer thread is not writing, and prevent it from writing
+     * \param lock the lock of m_mutex, held
+     */
+    void AcquireBuffers(std::unique_lock<std::mutex>& lock);
+
+    std::mutex m_mutex;                         //!< Protects the members below
+    std::condition_variable m_writerCv;         //!< Wakes up the writer thread
+    std::condition_variable m_progressCv;       //!< Notified when the writer thread stops writing
+    std::vector<NrAsyncTraceBuffer*> m_buffers; //!< The buffers written in the background
+    std::thread m_thread;                       //!< The writer thread
+    bool m_busy{false};                         //!< Whether the buffers are being written
+    bool m_wakeUp{false};                       //!< Whether the writer thread was notified
+    bool m_stop{false};                         //!< Whether the writer thread must stop
+    bool m_flushScheduled{false};               //!< Whether FlushAll is scheduled at Destroy
+};
+
+/**
+ * \ingroup nr
+ * \brief Stream buffer of a trace file written by NrTraceIoService
+ *
+ * The characters are first collected in a small put area, which is copied into the ring
+ * buffer when it is full and when the stream is flushed (e.g., by std::endl). The ring buffer
+ * is written to the file by the writer thread.
+ */
+class NrAsyncTraceBuffer : public std::streambuf
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param capacity the size of the ring buffer (bytes)
+     */
+    explicit NrAsyncTraceBuffer(size_t capacity);
+
+    /**
+     * \brief Close the file
+     */
+    ~NrAsyncTraceBuffer() override;
+
+    NrAsyncTraceBuffer(const NrAsyncTraceBuffer&) = delete;
+    NrAsyncTraceBuffer& operator=(const NrAsyncTraceBuffer&) = delete;
+
+    /**
+     * \brief Open the file, and register the buffer in NrTraceIoService
+     * \param filename the name of the file
+     * \param mode the open mode
+     * \return whether the file was opened
+     */
+    bool Open(const std::string& filename, std::ios_base::openmode mode);
+
+    /**
+     * \brief Whether the file is open
+     * \return true if the file is open
+     */
+    bool IsOpen() const;
+
+    /**
+     * \brief Write the pending characters, and close the file
+     */
+    void Close();
+
+    /**
+     * \brief Write the characters of the ring buffer to the file, and flush it. Called by the
+     * thread that has acquired the buffers from NrTraceIoService.
+     * \return the number of characters written
+     */
+    size_t Drain();
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+    int sync() override;
+
+  private:
+    /**
+     * \brief Copy characters into the ring buffer, waiting for the writer thread while it is
+     * full
+     * \param data the characters
+     * \param n the number of characters
+     */
+    void Push(const char* data, size_t n);
+
+    /**
+     * \brief Copy the put area into the ring buffer, and empty it
+     */
+    void PushPutArea();
+
+    /// Size of the put area (bytes)
+    static constexpr size_t PUT_AREA_SIZE = 4096;
+
+    std::vector<char> m_putArea;     //!< The put area
+    std::vector<char> m_ring;        //!< The ring buffer
+    std::atomic<uint64_t> m_head{0}; //!< Number of characters pushed (written by the producer)
+    std::atomic<uint64_t> m_tail{0}; //!< Number of characters drained (written by the consumer)
+    std::filebuf m_file;             //!< The file
+    bool m_registered{false};        //!< Whether the buffer is registered in NrTraceIoService
+};
+
+/**
+ * \ingroup nr
+ * \brief Output file stream of the NR traces
+ *
+ * It has the same interface as the subset of std::ofstream used by the trace sinks. When
+ * NrTraceIoService is enabled, the file is written in the background through a
+ * NrAsyncTraceBuffer. Otherwise, it is written directly, like std::ofstream.
+ */
+class NrTraceOfstream : public std::ostream
+{
+  public:
+    /**
+     * \brief Create a stream, without opening a file
+     */
+    NrTraceOfstream();
+
+    /**
+     * \brief Create a stream, and open a file
+     * \param filename the name of the file
+     * \param mode the open mode
+     */
+    explicit NrTraceOfstream(const std::string& filename,
+                             std::ios_base::openmode mode = std::ios_base::out);
+
+    /**
+     * \brief Close the file
+     */
+    ~NrTraceOfstream() override;
+
+    /**
+     * \brief Open a file. On failure, the failbit is set.
+     * \param filename the name of the file
+     * \param mode the open mode
+     */
+    void open(const std::string& filename, std::ios_base::openmode mode = std::ios_base::out);
+
+    /**
+     * \brief Whether a file is open
+     * \return true if a file is open
+     */
+    bool is_open() const;
+
+    /**
+     * \brief Write the pending characters, and close the file
+     */
+    void close();
+
+  private:
+    std::filebuf m_fileBuf;                         //!< The file, when written directly
+    std::unique_ptr<NrAsyncTraceBuffer> m_asyncBuf; //!< The file, when written in the background
+};
+
+} // namespace ns3
+
+#endif // NR_TRACE_IO_SERVICE_H
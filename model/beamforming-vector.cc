@@ -6,9 +6,13 @@
 
 #include "beamforming-vector.h"
 
+#include <ns3/abort.h>
 #include <ns3/angles.h>
 #include <ns3/uinteger.h>
 
+#include <map>
+#include <mutex>
+
 namespace ns3
 {
 
@@ -151,4 +155,80 @@ CreateDirectPathBfv(const Ptr<MobilityModel>& a,
     return antennaWeights;
 }
 
+Ptr<const CellScanCodebook>
+GetCellScanCodebook(const Ptr<const UniformPlanarArray>& antenna,
+                    double beamSearchAngleStep,
+                    bool integerElevation)
+{
+    NS_ABORT_MSG_IF(beamSearchAngleStep <= 0, "The beam search angle step must be positive");
+
+    UintegerValue uintValueNumRows;
+    antenna->GetAttribute("NumRows", uintValueNumRows);
+    auto numRows = static_cast<uint16_t>(uintValueNumRows.Get());
+
+    // The configuration of the antenna that the steering vectors depend on
+    std::vector<double> key{static_cast<double>(numRows),
+                            static_cast<double>(antenna->GetVElemsPerPort() *
+                                                antenna->GetHElemsPerPort()),
+                            beamSearchAngleStep,
+                            integerElevation ? 1.0 : 0.0};
+    for (uint64_t ind = 0; ind < antenna->GetNumElems(); ind++)
+    {
+        Vector loc = antenna->GetElementLocation(ind);
+        key.insert(key.end(), {loc.x, loc.y, loc.z});
+    }
+
+    static std::mutex cacheMutex;
+    static std::map<std::vector<double>, Ptr<const CellScanCodebook>> cache;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(key);
+    if (it != cache.end())
+    {
+        return it->second;
+    }
+
+    auto codebook = Create<CellScanCodebook>();
+    double elevation = 60;
+    while (elevation < 121)
+    {
+        for (uint16_t sector = 0; sector <= numRows; sector++)
+        {
+            codebook->beamIds.emplace_back(sector, elevation);
+            codebook->bfvs.push_back(CreateDirectionalBfv(antenna, sector, elevation));
+        }
+        elevation = elevation + beamSearchAngleStep;
+        if (integerElevation)
+        {
+            elevation = static_cast<uint16_t>(elevation);
+        }
+    }
+
+    auto numElems = antenna->GetNumElems();
+    codebook->bfvMatrix = ComplexMatrixArray(numElems, codebook->bfvs.size());
+    for (size_t beam = 0; beam < codebook->bfvs.size(); beam++)
+    {
+        for (size_t ind = 0; ind < numElems; ind++)
+        {
+            codebook->bfvMatrix(ind, beam) = codebook->bfvs[beam][ind];
+        }
+    }
+
+    cache.emplace(std::move(key), codebook);
+    return codebook;
+}
+
+ComplexMatrixArray
+ComputeLongTermComponents(const ComplexMatrixArray& channel,
+                          const CellScanCodebook& sCodebook,
+                          const CellScanCodebook& uCodebook)
+{
+    NS_ABORT_MSG_IF(channel.GetNumRows() != uCodebook.bfvMatrix.GetNumRows() ||
+                        channel.GetNumCols() != sCodebook.bfvMatrix.GetNumRows(),
+                    "The codebooks do not match the dimensions of the channel matrix");
+
+    // For each cluster c: U^T * H(c) * S, where U and S have the beamforming vectors as columns
+    return channel.MultiplyByLeftAndRightMatrix(uCodebook.bfvMatrix.Transpose(),
+                                                sCodebook.bfvMatrix);
+}
+
 } // namespace ns3
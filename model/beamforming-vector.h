@@ -10,8 +10,11 @@
 #include "beam-id.h"
 
 #include <ns3/mobility-model.h>
+#include <ns3/simple-ref-count.h>
 #include <ns3/uniform-planar-array.h>
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -74,6 +77,53 @@ PhasedArrayModel::ComplexVector CreateDirectPathBfv(const Ptr<MobilityModel>& a,
                                                     const Ptr<MobilityModel>& b,
                                                     const Ptr<const UniformPlanarArray>& antenna);
 
+/**
+ * \ingroup utils
+ * \brief The beams evaluated by the cell scan methods for an antenna configuration
+ *
+ * The beams are, in this order, the sectors from 0 to NumRows (included) of each
+ * elevation from 60 to 120 degrees, and their beamforming vectors are the ones created
+ * by CreateDirectionalBfv.
+ *
+ * \see GetCellScanCodebook
+ */
+struct CellScanCodebook : public SimpleRefCount<CellScanCodebook>
+{
+    std::vector<BeamId> beamIds;                       //!< The sector and elevation of each beam
+    std::vector<PhasedArrayModel::ComplexVector> bfvs; //!< The beamforming vector of each beam
+    ComplexMatrixArray bfvMatrix; //!< The beamforming vectors as columns (numElems x numBeams)
+};
+
+/**
+ * \brief Get the cell scan codebook of an antenna
+ * \ingroup utils
+ *
+ * The steering vectors depend only on the configuration of the antenna (number of rows,
+ * element locations, and elements per port), so the codebooks are cached per configuration,
+ * and shared by all the antennas (and devices) with the same configuration.
+ *
+ * \param antenna Antenna array of the codebook
+ * \param beamSearchAngleStep the elevation step (degrees)
+ * \param integerElevation whether the elevation is truncated to an integer at each step
+ * \return the codebook
+ */
+Ptr<const CellScanCodebook> GetCellScanCodebook(const Ptr<const UniformPlanarArray>& antenna,
+                                                double beamSearchAngleStep,
+                                                bool integerElevation);
+
+/**
+ * \brief Compute the long term component of a channel for all the pairs of beams of two
+ * codebooks, i.e., uW^T * H(c) * sW for each cluster c, as a single batched product
+ * \ingroup utils
+ * \param channel the channel matrix H (dims: uAntenna x sAntenna x numClusters)
+ * \param sCodebook the codebook of the s-node of the channel matrix
+ * \param uCodebook the codebook of the u-node of the channel matrix
+ * \return the long term components (dims: uBeams x sBeams x numClusters)
+ */
+ComplexMatrixArray ComputeLongTermComponents(const ComplexMatrixArray& channel,
+                                             const CellScanCodebook& sCodebook,
+                                             const CellScanCodebook& uCodebook);
+
 } // namespace ns3
 
 #endif /* SRC_NR_MODEL_BEAMFORMING_VECTOR_H_ */
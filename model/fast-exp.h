@@ -5,7 +5,13 @@
 #ifndef FAST_EXP_H
 #define FAST_EXP_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
 
 /*
 These functions return an approximation of exp(x) with a relative error <0.173%.
@@ -25,15 +31,11 @@ IEEE Signal Processing Magazine 39(4):130 - 137 (2022).
 inline double
 exp21d(double x)
 {
-    if (x < -708.0)
-    {
-        return 0;
-    }
-    if (x > 709.0)
-    {
-        return std::numeric_limits<double>::infinity();
-    }
-    int64_t z = x * 0x00171547652B82FE + 0x3FF0000000000000;
+    // The saturation is written as a selection rather than as an early return,
+    // so that loops calling this function can be vectorized by the compiler.
+    // The argument is clamped to keep the integer conversion below defined.
+    double xc = std::min(std::max(x, -708.0), 709.0);
+    int64_t z = xc * 0x00171547652B82FE + 0x3FF0000000000000;
 
     union {
         int64_t i;
@@ -49,10 +51,12 @@ exp21d(double x)
     zif = d2 * d3;
     zii.i |= zif;
     double y = zii.f;
+    y = (x < -708.0) ? 0.0 : y;
+    y = (x > 709.0) ? std::numeric_limits<double>::infinity() : y;
     return y;
 }
 
-[[maybe_unused]] bool
+[[maybe_unused]] inline bool
 testExp21dPower(double power)
 {
     double ref = std::exp(power);
@@ -69,7 +73,7 @@ testExp21dPower(double power)
     return true;
 }
 
-[[maybe_unused]] void
+[[maybe_unused]] inline void
 testExp21d()
 {
     bool pass = true;
@@ -8,10 +8,12 @@
 
 #include "nr-spectrum-phy.h"
 
+#include <ns3/boolean.h>
 #include <ns3/double.h>
 #include <ns3/multi-model-spectrum-channel.h>
 #include <ns3/node.h>
 #include <ns3/nr-spectrum-value-helper.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
 #include <ns3/uinteger.h>
 #include <ns3/uniform-planar-array.h>
 
@@ -46,7 +48,16 @@ CellScanBeamforming::GetTypeId()
                           DoubleValue(30),
                           MakeDoubleAccessor(&CellScanBeamforming::SetBeamSearchAngleStep,
                                              &CellScanBeamforming::GetBeamSearchAngleStep),
-                          MakeDoubleChecker<double>());
+                          MakeDoubleChecker<double>())
+            .AddAttribute("BatchedBeamSearch",
+                          "If true, the beam pairs are compared with the long term component of "
+                          "the channel (sum over the clusters of |uW^T * H * sW|^2), which is "
+                          "computed for all the pairs at once from the channel matrix. If false, "
+                          "the received PSD of each pair is computed. It needs a "
+                          "ThreeGppSpectrumPropagationLossModel.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CellScanBeamforming::m_batchedBeamSearch),
+                          MakeBooleanChecker());
 
     return tid;
 }
@@ -86,107 +97,134 @@ CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrum
     NS_ASSERT_MSG(gnbThreeGppSpectrumPropModel == ueThreeGppSpectrumPropModel,
                   "Devices should be connected on the same spectrum channel");
 
-    std::vector<int> activeRbs;
-    for (size_t rbId = 0; rbId < gnbSpectrumPhy->GetRxSpectrumModel()->GetNumBands(); rbId++)
+    Ptr<UniformPlanarArray> gnbAntenna =
+        gnbSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
+    Ptr<UniformPlanarArray> ueAntenna =
+        ueSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
+    NS_ASSERT(gnbAntenna->GetNumElems() && ueAntenna->GetNumElems());
+
+    // The UE elevation is truncated to an integer at each step of the search
+    Ptr<const CellScanCodebook> txCodebook =
+        GetCellScanCodebook(gnbAntenna, m_beamSearchAngleStep, false);
+    Ptr<const CellScanCodebook> rxCodebook =
+        GetCellScanCodebook(ueAntenna, m_beamSearchAngleStep, true);
+    size_t numTxBeams = txCodebook->bfvs.size();
+    size_t numRxBeams = rxCodebook->bfvs.size();
+
+    // The metric of each pair of beams, at index txBeam * numRxBeams + rxBeam
+    std::vector<double> metrics(numTxBeams * numRxBeams);
+    if (m_batchedBeamSearch)
     {
-        activeRbs.push_back(rbId);
+        Ptr<const ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+            DynamicCast<const ThreeGppSpectrumPropagationLossModel>(gnbThreeGppSpectrumPropModel);
+        NS_ABORT_MSG_IF(threeGppSplm == nullptr,
+                        "The batched beam search needs a ThreeGppSpectrumPropagationLossModel");
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix =
+            threeGppSplm->GetChannelModel()->GetChannel(gnbSpectrumPhy->GetMobility(),
+                                                        ueSpectrumPhy->GetMobility(),
+                                                        gnbAntenna,
+                                                        ueAntenna);
+
+        // The gNB is the s-node of the channel matrix, unless it was generated the other way
+        bool reverse = channelMatrix->IsReverse(gnbAntenna->GetId(), ueAntenna->GetId());
+        ComplexMatrixArray longTerm =
+            reverse ? ComputeLongTermComponents(channelMatrix->m_channel, *rxCodebook, *txCodebook)
+                    : ComputeLongTermComponents(channelMatrix->m_channel, *txCodebook, *rxCodebook);
+        for (size_t txBeam = 0; txBeam < numTxBeams; txBeam++)
+        {
+            for (size_t rxBeam = 0; rxBeam < numRxBeams; rxBeam++)
+            {
+                double metric = 0;
+                for (size_t cluster = 0; cluster < longTerm.GetNumPages(); cluster++)
+                {
+                    metric += std::norm(reverse ? longTerm(txBeam, rxBeam, cluster)
+                                                : longTerm(rxBeam, txBeam, cluster));
+                }
+                metrics[txBeam * numRxBeams + rxBeam] = metric;
+            }
+        }
     }
+    else
+    {
+        std::vector<int> activeRbs;
+        for (size_t rbId = 0; rbId < gnbSpectrumPhy->GetRxSpectrumModel()->GetNumBands(); rbId++)
+        {
+            activeRbs.push_back(rbId);
+        }
 
-    Ptr<const SpectrumValue> fakePsd = NrSpectrumValueHelper::CreateTxPowerSpectralDensity(
-        0.0,
-        activeRbs,
-        gnbSpectrumPhy->GetRxSpectrumModel(),
-        NrSpectrumValueHelper::UNIFORM_POWER_ALLOCATION_BW);
-    Ptr<SpectrumSignalParameters> fakeParams = Create<SpectrumSignalParameters>();
-    fakeParams->psd = fakePsd->Copy();
+        Ptr<const SpectrumValue> fakePsd = NrSpectrumValueHelper::CreateTxPowerSpectralDensity(
+            0.0,
+            activeRbs,
+            gnbSpectrumPhy->GetRxSpectrumModel(),
+            NrSpectrumValueHelper::UNIFORM_POWER_ALLOCATION_BW);
+        Ptr<SpectrumSignalParameters> fakeParams = Create<SpectrumSignalParameters>();
+        fakeParams->psd = fakePsd->Copy();
+
+        for (size_t txBeam = 0; txBeam < numTxBeams; txBeam++)
+        {
+            gnbAntenna->SetBeamformingVector(txCodebook->bfvs[txBeam]);
+            for (size_t rxBeam = 0; rxBeam < numRxBeams; rxBeam++)
+            {
+                ueAntenna->SetBeamformingVector(rxCodebook->bfvs[rxBeam]);
+
+                Ptr<SpectrumSignalParameters> rxParams =
+                    gnbThreeGppSpectrumPropModel->CalcRxPowerSpectralDensity(
+                        fakeParams,
+                        gnbSpectrumPhy->GetMobility(),
+                        ueSpectrumPhy->GetMobility(),
+                        gnbAntenna,
+                        ueAntenna);
+
+                size_t nbands = rxParams->psd->GetSpectrumModel()->GetNumBands();
+                metrics[txBeam * numRxBeams + rxBeam] = Sum(*(rxParams->psd)) / nbands;
+            }
+        }
+    }
 
     double max = 0;
     double maxTxTheta = 0;
     double maxRxTheta = 0;
     uint16_t maxTxSector = 0;
     uint16_t maxRxSector = 0;
-    PhasedArrayModel::ComplexVector maxTxW;
-    PhasedArrayModel::ComplexVector maxRxW;
+    PhasedArrayModel::ComplexVector maxTxW = txCodebook->bfvs.front();
+    PhasedArrayModel::ComplexVector maxRxW = rxCodebook->bfvs.front();
 
     UintegerValue uintValue;
-    gnbSpectrumPhy->GetAntenna()->GetAttribute("NumRows", uintValue);
+    gnbAntenna->GetAttribute("NumRows", uintValue);
     uint32_t txNumRows = static_cast<uint32_t>(uintValue.Get());
-    ueSpectrumPhy->GetAntenna()->GetAttribute("NumRows", uintValue);
+    ueAntenna->GetAttribute("NumRows", uintValue);
     uint32_t rxNumRows = static_cast<uint32_t>(uintValue.Get());
 
-    NS_ASSERT(gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetNumElems() &&
-              ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetNumElems());
-
-    uint16_t numRowsTx = static_cast<uint16_t>(txNumRows);
-    uint16_t numRowsRx = static_cast<uint16_t>(rxNumRows);
-    for (double txTheta = 60; txTheta < 121; txTheta = txTheta + m_beamSearchAngleStep)
+    for (size_t txBeam = 0; txBeam < numTxBeams; txBeam++)
     {
-        for (uint16_t txSector = 0; txSector <= numRowsTx; txSector++)
+        const BeamId& txBeamId = txCodebook->beamIds[txBeam];
+        for (size_t rxBeam = 0; rxBeam < numRxBeams; rxBeam++)
         {
-            NS_ASSERT(txSector < UINT16_MAX);
-
-            gnbSpectrumPhy->GetBeamManager()->SetSector(txSector, txTheta);
-            PhasedArrayModel::ComplexVector txW =
-                gnbSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
+            const BeamId& rxBeamId = rxCodebook->beamIds[rxBeam];
+            double power = metrics[txBeam * numRxBeams + rxBeam];
 
-            if (maxTxW.GetSize() == 0)
-            {
-                maxTxW = txW; // initialize maxTxW
-            }
+            NS_LOG_LOGIC(" Rx power: "
+                         << power << "txTheta " << txBeamId.GetElevation() << " rxTheta "
+                         << rxBeamId.GetElevation() << " tx sector "
+                         << (M_PI * static_cast<double>(txBeamId.GetSector()) /
+                                 static_cast<double>(txNumRows) -
+                             0.5 * M_PI) /
+                                M_PI * 180
+                         << " rx sector "
+                         << (M_PI * static_cast<double>(rxBeamId.GetSector()) /
+                                 static_cast<double>(rxNumRows) -
+                             0.5 * M_PI) /
+                                M_PI * 180);
 
-            for (double rxTheta = 60; rxTheta < 121;
-                 rxTheta = static_cast<uint16_t>(rxTheta + m_beamSearchAngleStep))
+            if (max < power)
             {
-                for (uint16_t rxSector = 0; rxSector <= numRowsRx; rxSector++)
-                {
-                    NS_ASSERT(rxSector < UINT16_MAX);
-
-                    ueSpectrumPhy->GetBeamManager()->SetSector(rxSector, rxTheta);
-                    PhasedArrayModel::ComplexVector rxW =
-                        ueSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-                    if (maxRxW.GetSize() == 0)
-                    {
-                        maxRxW = rxW; // initialize maxRxW
-                    }
-
-                    NS_ABORT_MSG_IF(txW.GetSize() == 0 || rxW.GetSize() == 0,
-                                    "Beamforming vectors must be initialized in order to calculate "
-                                    "the long term matrix.");
-
-                    Ptr<SpectrumSignalParameters> rxParams =
-                        gnbThreeGppSpectrumPropModel->CalcRxPowerSpectralDensity(
-                            fakeParams,
-                            gnbSpectrumPhy->GetMobility(),
-                            ueSpectrumPhy->GetMobility(),
-                            gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
-                            ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>());
-
-                    size_t nbands = rxParams->psd->GetSpectrumModel()->GetNumBands();
-                    double power = Sum(*(rxParams->psd)) / nbands;
-
-                    NS_LOG_LOGIC(
-                        " Rx power: "
-                        << power << "txTheta " << txTheta << " rxTheta " << rxTheta << " tx sector "
-                        << (M_PI * static_cast<double>(txSector) / static_cast<double>(txNumRows) -
-                            0.5 * M_PI) /
-                               M_PI * 180
-                        << " rx sector "
-                        << (M_PI * static_cast<double>(rxSector) / static_cast<double>(rxNumRows) -
-                            0.5 * M_PI) /
-                               M_PI * 180);
-
-                    if (max < power)
-                    {
-                        max = power;
-                        maxTxSector = txSector;
-                        maxRxSector = rxSector;
-                        maxTxTheta = txTheta;
-                        maxRxTheta = rxTheta;
-                        maxTxW = txW;
-                        maxRxW = rxW;
-                    }
-                }
+                max = power;
+                maxTxSector = txBeamId.GetSector();
+                maxRxSector = rxBeamId.GetSector();
+                maxTxTheta = txBeamId.GetElevation();
+                maxRxTheta = rxBeamId.GetElevation();
+                maxTxW = txCodebook->bfvs[txBeam];
+                maxRxW = rxCodebook->bfvs[rxBeam];
             }
         }
     }
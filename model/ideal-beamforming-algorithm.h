@@ -53,6 +53,12 @@ class IdealBeamformingAlgorithm : public Object
 /**
  * \ingroup gnb-phy
  * \brief The CellScanBeamforming class
+ *
+ * The beams of the gNB and of the UE are taken from their cell scan codebooks
+ * (see GetCellScanCodebook), which are shared by all the devices with the same antenna
+ * configuration. By default, each pair of beams is evaluated with the received PSD of a fake
+ * signal. With the BatchedBeamSearch attribute, the pairs are instead compared with the long
+ * term component of the channel, computed for all of them with a single batched product.
  */
 class CellScanBeamforming : public IdealBeamformingAlgorithm
 {
@@ -96,6 +102,7 @@ class CellScanBeamforming : public IdealBeamformingAlgorithm
 
   private:
     double m_beamSearchAngleStep{30}; //!< the beam search angle step attribute
+    bool m_batchedBeamSearch{false};  //!< compare the beams with the long term component
 };
 
 /**
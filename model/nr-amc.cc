@@ -231,30 +231,17 @@ NrAmc::CreateCqiFeedbackWbTdma(const SpectrumValue& sinr, uint8_t& mcs) const
             rbId += 1;
         }
 
-        mcs = 0;
-        Ptr<NrErrorModelOutput> output;
-        while (mcs <= m_errorModel->GetMaxMcs())
-        {
-            uint8_t rank = 1; // This function is SISO only
-            auto tbSize = CalculateTbSize(mcs, rank, rbMap.size());
-            output = m_errorModel->GetTbDecodificationStats(sinr,
-                                                            rbMap,
-                                                            tbSize,
-                                                            mcs,
-                                                            NrErrorModel::NrErrorModelHistory());
-            if (output->m_tbler > 0.1)
-            {
-                break;
-            }
-            mcs++;
-        }
+        uint8_t rank = 1; // This function is SISO only
+        auto rbNum = static_cast<uint32_t>(rbMap.size());
+        auto maxMcs = m_errorModel->GetMaxMcsForTargetTbler(
+            sinr,
+            rbMap,
+            [this, rank, rbNum](uint8_t mcs) { return CalculateTbSize(mcs, rank, rbNum); },
+            m_targetTbler);
 
-        if (mcs > 0)
-        {
-            mcs--;
-        }
+        mcs = maxMcs > 0 ? static_cast<uint8_t>(maxMcs) : 0;
 
-        if ((output->m_tbler > 0.1) && (mcs == 0))
+        if (maxMcs <= 0)
         {
             cqi = 0;
         }
@@ -391,25 +378,31 @@ NrAmc::GetMaxMcsParams(const NrSinrMatrix& sinrMat, size_t subbandSize) const
 uint8_t
 NrAmc::GetMaxMcsForErrorModel(const NrSinrMatrix& sinrMat) const
 {
-    auto mcs = uint8_t{0};
-    while (mcs <= m_errorModel->GetMaxMcs())
+    auto rank = sinrMat.GetRank();
+
+    // Create the RB map (indices of used RBs, i.e., indices of RBs where SINR is non-zero)
+    std::vector<int> rbMap{}; // TODO: change type of rbMap from int to size_t
+    int nRbs = static_cast<int>(sinrMat.GetNumRbs());
+    for (int rbIdx = 0; rbIdx < nRbs; rbIdx++)
     {
-        auto tbler = CalcTblerForMimoMatrix(mcs, sinrMat);
-        // TODO: Change target TBLER from default 0.1 when using MCS table 3
-        if (tbler > 0.1)
+        if (sinrMat(0, rbIdx) != 0.0)
         {
-            break;
+            rbMap.push_back(rbIdx);
         }
-        // The current configuration produces a sufficiently low TBLER, try next value
-        mcs++;
-    }
-    if (mcs > 0)
-    {
-        // The loop exited because the MCS exceeded max MCS or because of high TBLER. Reduce MCS
-        mcs--;
     }
 
-    return mcs;
+    // Vectorize the SINR matrix once, and use it to probe all the MCS
+    auto vectorizedSinr = m_errorModel->CreateVectorizedSpecVal(sinrMat);
+    auto vectorizedMap = m_errorModel->CreateVectorizedRbMap(rbMap, rank);
+    // TODO: Change target TBLER from default 0.1 when using MCS table 3
+    auto maxMcs = m_errorModel->GetMaxMcsForTargetTbler(
+        vectorizedSinr,
+        vectorizedMap,
+        [this, &sinrMat](uint8_t mcs) { return CalcTbSizeForMimoMatrix(mcs, sinrMat); },
+        m_targetTbler);
+
+    // If even MCS 0 produces a high TBLER, use the lowest MCS anyway
+    return maxMcs > 0 ? static_cast<uint8_t>(maxMcs) : 0;
 }
 
 uint8_t
@@ -439,37 +432,6 @@ NrAmc::GetWbCqiFromMcs(uint8_t mcs) const
     return cqi;
 }
 
-double
-NrAmc::CalcTblerForMimoMatrix(uint8_t mcs, const NrSinrMatrix& sinrMat) const
-{
-    auto dummyRnti = uint16_t{0};
-    auto duration = Time{1.0}; // Use an arbitrary non-zero time as the chunk duration
-    auto mimoChunk = MimoSinrChunk{sinrMat, dummyRnti, duration};
-    auto mimoChunks = std::vector<MimoSinrChunk>{mimoChunk};
-    auto rank = sinrMat.GetRank();
-
-    // Create the RB map (indices of used RBs, i.e., indices of RBs where SINR is non-zero)
-    std::vector<int> rbMap{}; // TODO: change type of rbMap from int to size_t
-    int nRbs = static_cast<int>(sinrMat.GetNumRbs());
-    for (int rbIdx = 0; rbIdx < nRbs; rbIdx++)
-    {
-        if (sinrMat(0, rbIdx) != 0.0)
-        {
-            rbMap.push_back(rbIdx);
-        }
-    }
-
-    auto tbSize = CalcTbSizeForMimoMatrix(mcs, sinrMat);
-    auto dummyHistory = NrErrorModel::NrErrorModelHistory{}; // Create empty HARQ history
-    auto outputOfEm = m_errorModel->GetTbDecodificationStatsMimo(mimoChunks,
-                                                                 rbMap,
-                                                                 tbSize,
-                                                                 mcs,
-                                                                 rank,
-                                                                 dummyHistory);
-    return outputOfEm->m_tbler;
-}
-
 uint32_t
 NrAmc::CalcTbSizeForMimoMatrix(uint8_t mcs, const NrSinrMatrix& sinrMat) const
 {
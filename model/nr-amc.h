@@ -228,12 +228,6 @@ class NrAmc : public Object
     /// \return the TB size
     uint32_t CalcTbSizeForMimoMatrix(uint8_t mcs, const NrSinrMatrix& sinrMat) const;
 
-    /// \brief Compute the TBLER for this channel and MCS, using the NR error model
-    /// \param mcs the MCS
-    /// \param sinrMat the MIMO SINR matrix (rank * nRbs)
-    /// \return the TBLER
-    double CalcTblerForMimoMatrix(uint8_t mcs, const NrSinrMatrix& sinrMat) const;
-
     /**
      * \brief Get the requested BER in assigning MCS (Shannon-bound model)
      * \return BER
@@ -247,6 +241,7 @@ class NrAmc : public Object
     uint8_t m_numRefScPerRb{1};                    //!< number of reference subcarriers per RB
     NrErrorModel::Mode m_emMode{NrErrorModel::DL}; //!< Error model mode
     static const unsigned int m_crcLen = 24 / 8;   //!< CRC length (in bytes)
+    static constexpr double m_targetTbler = 0.1;   //!< TBLER target of the MCS selection
 };
 
 } // end namespace ns3
@@ -0,0 +1,231 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-cell-partition-executor.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrCellPartitionExecutor");
+
+NS_OBJECT_ENSURE_REGISTERED(NrCellPartitionExecutor);
+
+TypeId
+NrCellPartitionExecutor::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrCellPartitionExecutor")
+            .SetParent<Object>()
+            .AddConstructor<NrCellPartitionExecutor>()
+            .AddAttribute("NumThreads",
+                          "Number of threads that run the work of the cells in parallel, "
+                          "including the simulator thread, or 0 to use one per hardware thread. "
+                          "The results do not depend on the number of threads.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&NrCellPartitionExecutor::SetNumThreads,
+                                               &NrCellPartitionExecutor::GetNumThreads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+NrCellPartitionExecutor::NrCellPartitionExecutor()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrCellPartitionExecutor::~NrCellPartitionExecutor()
+{
+    NS_LOG_FUNCTION(this);
+    StopWorkers();
+}
+
+void
+NrCellPartitionExecutor::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_flushEvent.Cancel();
+    m_work.clear();
+    StopWorkers();
+    Object::DoDispose();
+}
+
+void
+NrCellPartitionExecutor::SetNumThreads(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    // The workers are started again, with the new number of threads, at the next time step
+    StopWorkers();
+    m_numThreads = numThreads;
+}
+
+uint32_t
+NrCellPartitionExecutor::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
+void
+NrCellPartitionExecutor::Submit(uint32_t partition,
+                                std::function<void()> parallelWork,
+                                std::function<void()> sequentialWork)
+{
+    NS_LOG_FUNCTION(this << partition);
+    auto& work = m_work[partition];
+    if (parallelWork)
+    {
+        work.m_parallel.emplace_back(std::move(parallelWork));
+    }
+    if (sequentialWork)
+    {
+        work.m_sequential.emplace_back(std::move(sequentialWork));
+    }
+    if (!m_flushEvent.IsPending())
+    {
+        m_flushEvent = Simulator::ScheduleNow(&NrCellPartitionExecutor::Flush, this);
+    }
+}
+
+void
+NrCellPartitionExecutor::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    // The sequential parts may submit work again: it runs in another flush of the time step
+    std::vector<Work> work;
+    work.reserve(m_work.size());
+    for (auto& [partition, partitionWork] : m_work)
+    {
+        work.emplace_back(std::move(partitionWork));
+    }
+    m_work.clear();
+
+    NS_LOG_LOGIC("Running the work of " << work.size() << " partitions");
+    RunParallel(work.size(), [&work](size_t i) {
+        for (const auto& parallelWork : work[i].m_parallel)
+        {
+            parallelWork();
+        }
+    });
+
+    for (const auto& partitionWork : work)
+    {
+        for (const auto& sequentialWork : partitionWork.m_sequential)
+        {
+            sequentialWork();
+        }
+    }
+}
+
+void
+NrCellPartitionExecutor::RunParallel(size_t numJobs, const std::function<void(size_t)>& job)
+{
+    if (numJobs > 1)
+    {
+        StartWorkers();
+    }
+    if (numJobs <= 1 || m_workers.empty())
+    {
+        for (size_t i = 0; i < numJobs; i++)
+        {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = job;
+        m_numJobs = numJobs;
+        m_nextJob = 0;
+        m_busyWorkers = m_workers.size();
+        m_round++;
+    }
+    m_startCv.notify_all();
+
+    // The simulator thread is one of the workers
+    RunJobs();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this]() { return m_busyWorkers == 0; });
+    m_job = nullptr;
+}
+
+void
+NrCellPartitionExecutor::RunJobs()
+{
+    for (size_t i = m_nextJob++; i < m_numJobs; i = m_nextJob++)
+    {
+        m_job(i);
+    }
+}
+
+void
+NrCellPartitionExecutor::RunWorker()
+{
+    uint64_t round = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_startCv.wait(lock, [this, round]() { return m_stop || m_round != round; });
+        if (m_stop)
+        {
+            return;
+        }
+        round = m_round;
+        lock.unlock();
+        RunJobs();
+        lock.lock();
+        if (--m_busyWorkers == 0)
+        {
+            m_doneCv.notify_one();
+        }
+    }
+}
+
+void
+NrCellPartitionExecutor::StartWorkers()
+{
+    if (!m_workers.empty())
+    {
+        return;
+    }
+    uint32_t numThreads = m_numThreads;
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    NS_LOG_INFO("Starting " << numThreads - 1 << " worker threads");
+    m_stop = false;
+    m_round = 0;
+    for (uint32_t t = 1; t < numThreads; t++)
+    {
+        m_workers.emplace_back(&NrCellPartitionExecutor::RunWorker, this);
+    }
+}
+
+void
+NrCellPartitionExecutor::StopWorkers()
+{
+    if (m_workers.empty())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCv.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+} // namespace ns3
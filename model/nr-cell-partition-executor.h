@@ -0,0 +1,155 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_CELL_PARTITION_EXECUTOR_H
+#define NR_CELL_PARTITION_EXECUTOR_H
+
+#include <ns3/event-id.h>
+#include <ns3/object.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr
+ * \brief Executor of the per-slot work of the cells, with the cells as partitions that run in
+ * parallel
+ *
+ * The cells interact only through the spectrum channel, and the decisions that the scheduler
+ * of a cell takes in a slot reach the air only L1L2CtrlLatency slots later. So, the
+ * schedulers of all the cells that start a slot at the same time can run concurrently, with a
+ * conservative lookahead of one slot.
+ *
+ * The work of a partition (a gNB, identified by its cell ID) is submitted in two parts:
+ * - a parallel part, that may touch only the state of the partition (e.g., its schedulers),
+ * and that runs in one of the threads of the executor;
+ * - a sequential part, that may touch anything (e.g., RLC, traces, PHY queues, events), and
+ * that runs on the simulator thread.
+ *
+ * The work submitted during a time step is run by an event scheduled with
+ * Simulator::ScheduleNow when the first work is submitted, i.e., after the events of the time
+ * step that were already scheduled (such as the start of the slot of all the gNBs). First,
+ * the parallel parts of all the partitions run, the partitions in parallel and the parts of a
+ * partition in the order they were submitted. Then, the sequential parts run on the simulator
+ * thread, ordered by partition ID and then by submission order.
+ *
+ * Each partition runs in a single thread, and the sequential parts do not depend on the
+ * thread that ran the parallel ones: the results are the same for any number of threads,
+ * including one.
+ */
+class NrCellPartitionExecutor : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Constructor
+     */
+    NrCellPartitionExecutor();
+
+    /**
+     * \brief Destructor, which stops the threads
+     */
+    ~NrCellPartitionExecutor() override;
+
+    /**
+     * \brief Set the number of threads that run the parallel parts
+     * \param numThreads the number of threads, including the simulator thread, or 0 to use one
+     * per hardware thread
+     */
+    void SetNumThreads(uint32_t numThreads);
+
+    /**
+     * \brief Get the number of threads that run the parallel parts
+     * \return the number of threads, or 0 if it is one per hardware thread
+     */
+    uint32_t GetNumThreads() const;
+
+    /**
+     * \brief Submit the work of a partition for the current time step
+     * \param partition the ID of the partition
+     * \param parallelWork the part that touches only the state of the partition, or nullptr
+     * \param sequentialWork the part that runs on the simulator thread after the parallel
+     * parts of all the partitions, or nullptr
+     */
+    void Submit(uint32_t partition,
+                std::function<void()> parallelWork,
+                std::function<void()> sequentialWork);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief The work of a partition in the current time step
+     */
+    struct Work
+    {
+        std::vector<std::function<void()>> m_parallel;   //!< The parallel parts
+        std::vector<std::function<void()>> m_sequential; //!< The sequential parts
+    };
+
+    /**
+     * \brief Run the work submitted during the time step
+     */
+    void Flush();
+
+    /**
+     * \brief Run a job for each index in [0, numJobs), with the threads of the executor
+     * \param numJobs the number of jobs
+     * \param job the job
+     */
+    void RunParallel(size_t numJobs, const std::function<void(size_t)>& job);
+
+    /**
+     * \brief Run the jobs not taken yet by the other threads
+     */
+    void RunJobs();
+
+    /**
+     * \brief The loop of the worker threads
+     */
+    void RunWorker();
+
+    /**
+     * \brief Start the worker threads, if they are not running
+     */
+    void StartWorkers();
+
+    /**
+     * \brief Stop the worker threads
+     */
+    void StopWorkers();
+
+    uint32_t m_numThreads{1};           //!< The number of threads (0: one per hardware thread)
+    std::map<uint32_t, Work> m_work;    //!< The work of the time step, by partition
+    EventId m_flushEvent;               //!< The event that runs the work of the time step
+    std::vector<std::thread> m_workers; //!< The worker threads
+    std::mutex m_mutex;                 //!< Protects the members below
+    std::condition_variable m_startCv;  //!< Wakes up the workers
+    std::condition_variable m_doneCv;   //!< Notified when the last worker is done
+    uint64_t m_round{0};                //!< Incremented at each call of RunParallel
+    size_t m_busyWorkers{0};            //!< The number of workers running jobs
+    bool m_stop{false};                 //!< Whether the workers must stop
+    std::function<void(size_t)> m_job;  //!< The job of the current round
+    size_t m_numJobs{0};                //!< The number of jobs of the current round
+    std::atomic<size_t> m_nextJob{0};   //!< The next job to take in the current round
+};
+
+} // namespace ns3
+
+#endif // NR_CELL_PARTITION_EXECUTOR_H
@@ -0,0 +1,104 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-eesm-bler-table.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+
+namespace ns3
+{
+
+NrEesmBlerTable::NrEesmBlerTable(const NrEesmErrorModel::SimulatedBlerFromSINR& table)
+{
+    NS_ABORT_MSG_IF(table.empty(), "Empty SINR-BLER table");
+    m_mcsCount = static_cast<uint32_t>(table.front().size());
+
+    for (const auto& bg : table)
+    {
+        NS_ABORT_MSG_IF(bg.size() != m_mcsCount,
+                        "All the base graphs must have the same number of MCS");
+        for (const auto& mcs : bg)
+        {
+            NS_ABORT_MSG_IF(mcs.empty(), "Each MCS must have at least one CB size simulated");
+            m_curveOffset.push_back(static_cast<uint32_t>(m_cbSize.size()));
+            for (const auto& [cbSize, curve] : mcs)
+            {
+                const auto& sinrDb = std::get<0>(curve);
+                const auto& bler = std::get<1>(curve);
+                NS_ABORT_MSG_IF(sinrDb.empty() || sinrDb.size() != bler.size(),
+                                "Malformed SINR-BLER curve for CB size " << cbSize);
+                m_cbSize.push_back(cbSize);
+                m_pointOffset.push_back(static_cast<uint32_t>(m_sinrDb.size()));
+                m_sinrDb.insert(m_sinrDb.end(), sinrDb.begin(), sinrDb.end());
+                m_bler.insert(m_bler.end(), bler.begin(), bler.end());
+            }
+        }
+    }
+    m_curveOffset.push_back(static_cast<uint32_t>(m_cbSize.size()));
+    m_pointOffset.push_back(static_cast<uint32_t>(m_sinrDb.size()));
+}
+
+uint32_t
+NrEesmBlerTable::GetCurveIndex(uint8_t bgType, uint8_t mcs, uint32_t cbSizeBit) const
+{
+    NS_ASSERT(mcs < m_mcsCount);
+    const uint32_t idx = bgType * m_mcsCount + mcs;
+    NS_ASSERT(idx + 1 < m_curveOffset.size());
+
+    // Find the largest simulated CB size that is lower or equal to cbSizeBit.
+    // If all of them are bigger, the first one is used.
+    const uint32_t* base = m_cbSize.data() + m_curveOffset[idx];
+    uint32_t len = m_curveOffset[idx + 1] - m_curveOffset[idx];
+    while (len > 1)
+    {
+        const uint32_t half = len / 2;
+        base = (base[half] <= cbSizeBit) ? base + half : base;
+        len -= half;
+    }
+    return static_cast<uint32_t>(base - m_cbSize.data());
+}
+
+double
+NrEesmBlerTable::GetBler(uint32_t curve, double sinrDb) const
+{
+    NS_ASSERT(curve + 1 < m_pointOffset.size());
+    const double* first = m_sinrDb.data() + m_pointOffset[curve];
+    uint32_t len = m_pointOffset[curve + 1] - m_pointOffset[curve];
+
+    if (sinrDb < first[0])
+    {
+        return 1.0;
+    }
+    if (sinrDb > first[len - 1])
+    {
+        return 0.0;
+    }
+
+    // Find the largest simulated SINR that is lower or equal to sinrDb
+    const double* base = first;
+    while (len > 1)
+    {
+        const uint32_t half = len / 2;
+        base = (base[half] <= sinrDb) ? base + half : base;
+        len -= half;
+    }
+    return m_bler[m_pointOffset[curve] + (base - first)];
+}
+
+double
+NrEesmBlerTable::GetMinSinrDb(uint32_t curve) const
+{
+    NS_ASSERT(curve + 1 < m_pointOffset.size());
+    return m_sinrDb[m_pointOffset[curve]];
+}
+
+double
+NrEesmBlerTable::GetMaxSinrDb(uint32_t curve) const
+{
+    NS_ASSERT(curve + 1 < m_pointOffset.size());
+    return m_sinrDb[m_pointOffset[curve + 1] - 1];
+}
+
+} // namespace ns3
@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_EESM_BLER_TABLE_H
+#define NR_EESM_BLER_TABLE_H
+
+#include "nr-eesm-error-model.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup error-models
+ * \brief Compiled (flattened) version of a NrEesmErrorModel::SimulatedBlerFromSINR table
+ *
+ * The SINR-BLER tables of NR (NrEesmT1, NrEesmT2) are stored as nested
+ * vectors of maps, indexed by LDPC base graph, MCS and code block size. Looking
+ * up a BLER value in such structure requires several bound-checked accesses and
+ * a map lookup, and it is done for every TB decoded and for every MCS probed
+ * by the AMC.
+ *
+ * This class converts the table, once, in a flat structure-of-arrays layout:
+ * all the code block sizes of a (BG, MCS) pair are stored contiguously, and
+ * all the SINR and BLER points of a curve are stored contiguously as well.
+ * The lookup is then a pair of branch-free binary searches over
+ * contiguous memory.
+ *
+ * The lookup returns exactly the same values of the original table: the curve
+ * used is the one with the largest simulated CB size that is lower or equal to
+ * the requested one (or the smallest one, if none), and the BLER is the one of
+ * the largest simulated SINR that is lower or equal to the requested one
+ * (1.0 below the curve, 0.0 above it).
+ */
+class NrEesmBlerTable
+{
+  public:
+    /**
+     * \brief NrEesmBlerTable constructor (deleted)
+     */
+    NrEesmBlerTable() = delete;
+
+    /**
+     * \brief Build the compiled version of a SINR-BLER table
+     * \param table the table to compile
+     */
+    NrEesmBlerTable(const NrEesmErrorModel::SimulatedBlerFromSINR& table);
+
+    /**
+     * \brief Get the index of the curve to use for a CB
+     * \param bgType the LDPC base graph type (0 for BG1, 1 for BG2)
+     * \param mcs the MCS
+     * \param cbSizeBit the size of the CB in bits
+     * \return the index of the curve, to be used in GetBler()
+     */
+    uint32_t GetCurveIndex(uint8_t bgType, uint8_t mcs, uint32_t cbSizeBit) const;
+
+    /**
+     * \brief Get the BLER of a curve for a given SINR
+     * \param curve the index of the curve, as returned by GetCurveIndex()
+     * \param sinrDb the SINR in dB
+     * \return the BLER of the curve
+     */
+    double GetBler(uint32_t curve, double sinrDb) const;
+
+    /**
+     * \brief Get the BLER for a given BG type, MCS, CB size and SINR
+     * \param bgType the LDPC base graph type (0 for BG1, 1 for BG2)
+     * \param mcs the MCS
+     * \param cbSizeBit the size of the CB in bits
+     * \param sinrDb the SINR in dB
+     * \return the BLER
+     */
+    double GetBler(uint8_t bgType, uint8_t mcs, uint32_t cbSizeBit, double sinrDb) const
+    {
+        return GetBler(GetCurveIndex(bgType, mcs, cbSizeBit), sinrDb);
+    }
+
+    /**
+     * \brief Get the lowest simulated SINR of a curve
+     * \param curve the index of the curve
+     * \return the SINR (dB) below which the BLER of the curve is 1.0
+     */
+    double GetMinSinrDb(uint32_t curve) const;
+
+    /**
+     * \brief Get the highest simulated SINR of a curve
+     * \param curve the index of the curve
+     * \return the SINR (dB) above which the BLER of the curve is 0.0
+     */
+    double GetMaxSinrDb(uint32_t curve) const;
+
+    /**
+     * \return the number of MCS per base graph in the table
+     */
+    uint32_t GetMcsCount() const
+    {
+        return m_mcsCount;
+    }
+
+  private:
+    uint32_t m_mcsCount{0};               //!< Number of MCS per base graph
+    std::vector<uint32_t> m_curveOffset;  //!< For each (BG, MCS), the first curve (size+1)
+    std::vector<uint32_t> m_cbSize;       //!< For each curve, its simulated CB size
+    std::vector<uint32_t> m_pointOffset;  //!< For each curve, its first point (size+1)
+    std::vector<double> m_sinrDb;         //!< SINR (dB) of all the points of all the curves
+    std::vector<double> m_bler;           //!< BLER of all the points of all the curves
+};
+
+} // namespace ns3
+
+#endif // NR_EESM_BLER_TABLE_H
@@ -48,6 +48,12 @@ NrEesmCcT1::GetSimulatedBlerFromSINR() const
     return m_t1.m_simulatedBlerFromSINR;
 }
 
+const NrEesmBlerTable*
+NrEesmCcT1::GetCompiledBlerFromSINR() const
+{
+    return m_t1.m_compiledBlerFromSINR;
+}
+
 const std::vector<uint8_t>*
 NrEesmCcT1::GetMcsMTable() const
 {
@@ -48,6 +48,12 @@ NrEesmCcT2::GetSimulatedBlerFromSINR() const
     return m_t2.m_simulatedBlerFromSINR;
 }
 
+const NrEesmBlerTable*
+NrEesmCcT2::GetCompiledBlerFromSINR() const
+{
+    return m_t2.m_compiledBlerFromSINR;
+}
+
 const std::vector<uint8_t>*
 NrEesmCcT2::GetMcsMTable() const
 {
@@ -41,6 +41,7 @@ class NrEesmCcT2 : public NrEesmCc
     const std::vector<double>* GetBetaTable() const override;
     const std::vector<double>* GetMcsEcrTable() const override;
     const SimulatedBlerFromSINR* GetSimulatedBlerFromSINR() const override;
+    const NrEesmBlerTable* GetCompiledBlerFromSINR() const override;
     const std::vector<uint8_t>* GetMcsMTable() const override;
     const std::vector<double>* GetSpectralEfficiencyForMcs() const override;
     const std::vector<double>* GetSpectralEfficiencyForCqi() const override;
@@ -8,6 +8,10 @@
 
 #include <ns3/log.h>
 
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
 namespace ns3
 {
 
@@ -43,35 +47,17 @@ NrEesmCc::ComputeSINR(const SpectrumValue& sinr,
     // HARQ CHASE COMBINING: update SINReff, but not ECR after retx
     // repetition of coded bits
 
-    // make a vector of history that contains the last tx (but without modifying
+    // combine the history with the last tx (but without modifying
     // sinrHistory, as it will be modified by the caller when it will be the time)
-    Ptr<NrEesmErrorModelOutput> last = Create<NrEesmErrorModelOutput>(0.0);
-    last->m_map = map;
-    last->m_sinr = sinr;
-
-    NrErrorModel::NrErrorModelHistory total = sinrHistory;
-    total.emplace_back(last);
-
-    // evaluate SINR_eff over "total", as per Chase Combining
 
     NS_ASSERT(sinr.GetSpectrumModel()->GetNumBands() == sinr.GetValuesN());
 
-    SpectrumValue sinr_sum(sinr.GetSpectrumModel());
-    uint32_t historySize = static_cast<uint32_t>(total.size());
-    uint32_t maxRBUsed = 0;
-    for (uint32_t i = 0; i < historySize; ++i)
-    {
-        Ptr<NrEesmErrorModelOutput> output = DynamicCast<NrEesmErrorModelOutput>(total.at(i));
-        maxRBUsed = std::max(maxRBUsed, static_cast<uint32_t>(output->m_map.size()));
-    }
-
-    std::vector<int> map_sum;
-    map_sum.reserve(maxRBUsed);
-
-    for (uint32_t i = 0; i < maxRBUsed; ++i)
+    uint32_t maxRBUsed = static_cast<uint32_t>(map.size());
+    for (const auto& element : sinrHistory)
     {
-        sinr_sum[i] = 0;
-        map_sum.push_back(static_cast<int>(i));
+        Ptr<NrEesmErrorModelOutput> output = DynamicCast<NrEesmErrorModelOutput>(element);
+        NS_ASSERT(output != nullptr);
+        maxRBUsed = std::max(maxRBUsed, static_cast<uint32_t>(output->m_sinrRb.size()));
     }
 
     /* combine at the bit level. Example:
@@ -87,30 +73,55 @@ NrEesmCc::ComputeSINR(const SpectrumValue& sinr,
      * SINR_SUM = [16 27 16 17 26 18]
      *
      * (the value at SINR_SUM[0] is SINR{1}[2] + SINR{2}[0] + SINR{3}[0])
+     *
+     * The history stores, for each tx, only the SINR of its RBs in the order
+     * of its map (e.g., [10 20 10] for the first tx).
      */
-    for (uint32_t i = 0; i < historySize; ++i)
+    m_sinrSum.assign(maxRBUsed, 0.0);
+    for (const auto& element : sinrHistory)
     {
-        Ptr<NrEesmErrorModelOutput> output = DynamicCast<NrEesmErrorModelOutput>(total.at(i));
-        uint32_t size = output->m_map.size();
+        Ptr<NrEesmErrorModelOutput> output = DynamicCast<NrEesmErrorModelOutput>(element);
+        uint32_t size = output->m_sinrRb.size();
         for (uint32_t j = 0; j < maxRBUsed; ++j)
         {
-            sinr_sum[j] += output->m_sinr[output->m_map[j % size]];
+            m_sinrSum[j] += output->m_sinrRb[j % size];
         }
     }
+    uint32_t size = map.size();
+    for (uint32_t j = 0; j < maxRBUsed; ++j)
+    {
+        m_sinrSum[j] += sinr.ValuesAt(map[j % size]);
+    }
 
     NS_LOG_INFO("\tHISTORY:");
-    for (const auto& element : total)
+    for (const auto& element : sinrHistory)
     {
         Ptr<NrEesmErrorModelOutput> output = DynamicCast<NrEesmErrorModelOutput>(element);
-        NS_LOG_INFO("\tMAP:" << PrintMap(output->m_map));
-        NS_LOG_INFO("\tSINR: " << output->m_sinr);
+        NS_LOG_INFO("\tSINR of the RBs: " << PrintSinr(output->m_sinrRb));
     }
+    NS_LOG_INFO("\tMAP:" << PrintMap(map));
+    NS_LOG_INFO("\tSINR: " << sinr);
+
+    NS_LOG_INFO("SINR_SUM: " << PrintSinr(m_sinrSum));
+
+    // compute effective SINR with the combined SINR of the maxRBUsed RBs, as
+    // SinrEff () with a = 0 and b = maxRBUsed
+    double SINR = -GetBetaTable()->at(mcs) * log(SinrExp(m_sinrSum, mcs) / maxRBUsed);
+    NS_LOG_INFO(" Effective SINR = " << SINR);
+    return SINR;
+}
 
-    NS_LOG_INFO("MAP_SUM: " << PrintMap(map_sum));
-    NS_LOG_INFO("SINR_SUM: " << sinr_sum);
+std::string
+NrEesmCc::PrintSinr(const std::vector<double>& sinrRb) const
+{
+    std::stringstream ss;
+
+    for (const auto& v : sinrRb)
+    {
+        ss << v << ", ";
+    }
 
-    // compute effective SINR with the sinr_sum vector and map_sum RB map
-    return SinrEff(sinr_sum, map_sum, mcs, 0.0, map_sum.size());
+    return ss.str();
 }
 
 double
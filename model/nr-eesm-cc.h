@@ -73,6 +73,16 @@ class NrEesmCc : public NrEesmErrorModel
      * \return The equivalent MCS after retransmissions
      */
     double GetMcsEq(uint8_t mcsTx) const override;
+
+  private:
+    /**
+     * \brief function to print the SINR of the RBs of a transmission
+     * \param sinrRb the SINR of the RBs
+     * \return a string that contains the SINR values in a readable way
+     */
+    std::string PrintSinr(const std::vector<double>& sinrRb) const;
+
+    mutable std::vector<double> m_sinrSum; //!< Scratch vector of the combined SINR of the RBs
 };
 
 } // namespace ns3
@@ -7,7 +7,8 @@
 
 #include "nr-eesm-error-model.h"
 
-#include "fast-exp.h"
+#include "nr-eesm-bler-table.h"
+#include "nr-l2sm-kernels.h"
 #include "nr-phy-mac-common.h"
 
 #include "ns3/enum.h"
@@ -15,6 +16,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 
 namespace ns3
 {
@@ -32,10 +34,115 @@ static const std::vector<uint16_t> LiftingSizeTableBG = {
 
 std::vector<std::string> NrEesmErrorModel::m_bgTypeName = {"BG1", "BG2"};
 
+/**
+ * \brief Pool of the NrEesmErrorModelOutput not in use
+ *
+ * Each thread has its own pool. The pool keeps at most MAX_SIZE outputs; the
+ * outputs released when the pool is full (or after it has been destroyed, at
+ * the thread exit) are deleted.
+ */
+class NrEesmErrorModelOutputPool
+{
+  public:
+    static constexpr std::size_t MAX_SIZE = 1024; //!< Maximum number of outputs kept
+
+    /**
+     * \brief ~NrEesmErrorModelOutputPool
+     */
+    ~NrEesmErrorModelOutputPool()
+    {
+        s_destroyed = true;
+        for (auto output : m_free)
+        {
+            delete output;
+        }
+    }
+
+    /**
+     * \return the pool of the calling thread, or nullptr if it has been destroyed
+     */
+    static NrEesmErrorModelOutputPool* Get()
+    {
+        if (s_destroyed)
+        {
+            return nullptr;
+        }
+        static thread_local NrEesmErrorModelOutputPool pool;
+        return &pool;
+    }
+
+    /**
+     * \return an output of the pool, or nullptr if the pool is empty
+     */
+    NrEesmErrorModelOutput* Pop()
+    {
+        if (m_free.empty())
+        {
+            return nullptr;
+        }
+        NrEesmErrorModelOutput* output = m_free.back();
+        m_free.pop_back();
+        return output;
+    }
+
+    /**
+     * \brief Store an output in the pool
+     * \param output the output
+     * \return false if the pool is full, and the output has not been stored
+     */
+    bool Push(NrEesmErrorModelOutput* output)
+    {
+        if (m_free.size() >= MAX_SIZE)
+        {
+            return false;
+        }
+        m_free.push_back(output);
+        return true;
+    }
+
+  private:
+    static thread_local bool s_destroyed;        //!< True once the pool of the thread is destroyed
+    std::vector<NrEesmErrorModelOutput*> m_free; //!< Outputs not in use
+};
+
+thread_local bool NrEesmErrorModelOutputPool::s_destroyed = false;
+
+Ptr<NrEesmErrorModelOutput>
+NrEesmErrorModelOutput::Allocate(double tbler)
+{
+    NrEesmErrorModelOutputPool* pool = NrEesmErrorModelOutputPool::Get();
+    NrEesmErrorModelOutput* output = pool != nullptr ? pool->Pop() : nullptr;
+    if (output == nullptr)
+    {
+        return Create<NrEesmErrorModelOutput>(tbler);
+    }
+
+    // Reset the output, keeping the capacity of its vector
+    output->m_tbler = tbler;
+    output->m_sinrExp = 0.0;
+    output->m_sinrEff = 0.0;
+    output->m_sinrRb.clear();
+    output->m_infoBits = 0;
+    output->m_codeBits = 0;
+    // The reference count of a released output is 0: this Ptr takes the first reference
+    return Ptr<NrEesmErrorModelOutput>(output);
+}
+
+void
+NrEesmErrorModelOutput::Release()
+{
+    NrEesmErrorModelOutputPool* pool = NrEesmErrorModelOutputPool::Get();
+    if (pool == nullptr || !pool->Push(this))
+    {
+        delete this;
+    }
+}
+
 NrEesmErrorModel::NrEesmErrorModel()
     : NrErrorModel()
 {
     NS_LOG_FUNCTION(this);
+    NS_LOG_INFO("EESM kernels use the " << NrL2smKernels::GetIsaName() << " ISA");
 }
 
 NrEesmErrorModel::~NrEesmErrorModel()
@@ -84,15 +191,39 @@ NrEesmErrorModel::SinrExp(const SpectrumValue& sinr, const std::vector<int>& map
     NS_ABORT_MSG_IF(map.empty(),
                     " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
 
-    double SINRexp = 0.0;
+    double beta = GetBetaTable()->at(mcs);
     double SINRsum = 0.0;
+    NrL2smKernels::FillRbMask(map, sinr.GetValuesN(), m_rbMask);
+    NrL2smKernels::SinrExpSums(&(*sinr.ConstValuesBegin()),
+                               m_rbMask.data(),
+                               sinr.GetValuesN(),
+                               &beta,
+                               1,
+                               &SINRsum);
+    return SINRsum;
+}
+
+double
+NrEesmErrorModel::SinrExp(const std::vector<double>& sinrRb, uint8_t mcs) const
+{
+    NS_LOG_FUNCTION(this << (uint8_t)mcs);
+    NS_ABORT_MSG_IF(sinrRb.empty(),
+                    " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
+
     double beta = GetBetaTable()->at(mcs);
-    for (int i : map)
+    double SINRsum = 0.0;
+    // all the RBs are summed: set the first sinrRb.size () bits of the mask
+    m_rbMask.assign((sinrRb.size() + 63) / 64, ~uint64_t{0});
+    if (sinrRb.size() % 64 != 0)
     {
-        double sinrLin = sinr[i];
-        SINRexp = exp21d(-sinrLin / beta);
-        SINRsum += SINRexp;
+        m_rbMask.back() = (uint64_t{1} << (sinrRb.size() % 64)) - 1;
     }
+    NrL2smKernels::SinrExpSums(sinrRb.data(),
+                               m_rbMask.data(),
+                               sinrRb.size(),
+                               &beta,
+                               1,
+                               &SINRsum);
     return SINRsum;
 }
 
@@ -119,50 +250,15 @@ NrEesmErrorModel::MappingSinrBler(double sinr, uint8_t mcs, uint32_t cbSizeBit)
     NS_ABORT_MSG_IF(mcs > GetMaxMcs(),
                     "MCS out of range [0..27/28]: " << static_cast<uint8_t>(mcs));
 
-    // use cbSize to obtain the index of CBSIZE in the map, jointly with mcs and sinr. take the
+    // use cbSize to obtain the curve of the CBSIZE in the table, jointly with mcs. take the
     // lowest CBSIZE simulated including this CB for removing CB size quatization
     // errors. sinr is also lower-bounded.
-    double bler = 0.0;
-    double sinr_db = 10 * log10(sinr);
     GraphType bg_type = GetBaseGraphType(cbSizeBit, mcs);
 
-    // Get the index of CBSIZE in the map
     NS_LOG_INFO("For sinr " << sinr << " and mcs " << +mcs << " CbSizebit " << cbSizeBit
                             << " we got bg type " << m_bgTypeName[bg_type]);
-    const auto& cbMap = GetSimulatedBlerFromSINR()->at(bg_type).at(mcs);
-    auto cbIt = cbMap.upper_bound(cbSizeBit);
-
-    if (cbIt != cbMap.begin())
-    {
-        cbIt--;
-    }
-
-    if (sinr_db < GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).front())
-    {
-        bler = 1.0;
-    }
-    else if (sinr_db > GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).back())
-    {
-        bler = 0.0;
-    }
-    else
-    {
-        // Get the index of SINR in the vector
-        auto sinrIt =
-            std::upper_bound(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                             GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).end(),
-                             sinr_db);
-
-        if (sinrIt != GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin())
-        {
-            sinrIt--;
-        }
-
-        auto sinr_index =
-            std::distance(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                          sinrIt);
-        bler = GetBLERVectorFromSimulatedValues(bg_type, mcs, cbIt->first).at(sinr_index);
-    }
+    NS_ASSERT(GetCompiledBlerFromSINR() != nullptr);
+    double bler = GetCompiledBlerFromSINR()->GetBler(bg_type, mcs, cbSizeBit, 10 * log10(sinr));
 
     NS_LOG_LOGIC("SINR effective: " << sinr << " BLER:" << bler);
     return bler;
@@ -290,9 +386,10 @@ NrEesmErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
     NS_LOG_FUNCTION(this);
     NS_ABORT_IF(mcs > GetMaxMcs());
 
-    double tbSinr = SinrEff(sinr, map, mcs, 0, map.size()); // effective SINR for this tx
-    double SINR = tbSinr;
     double sinrExpSum = SinrExp(sinr, map, mcs); // exponential sum of SINRs for this tx
+    // effective SINR for this tx, as in SinrEff (sinr, map, mcs, 0, map.size ())
+    double tbSinr = -GetBetaTable()->at(mcs) * log(sinrExpSum / map.size());
+    double SINR = tbSinr;
 
     NS_LOG_DEBUG(" mcs " << +mcs << " TBSize in bit " << sizeBit << " history elements: "
                          << sinrHistory.size() << " SINR of the tx: " << tbSinr << std::endl
@@ -306,18 +403,6 @@ NrEesmErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
 
     NS_LOG_DEBUG(" SINR after processing all retx (if any): " << SINR << " SINR last tx" << tbSinr);
 
-    // LDPC base graph type selection (1 or 2), as per TS 38.212, using the payload (A)
-    GraphType bg_type = GetBaseGraphType(sizeBit, mcs);
-    NS_LOG_INFO("BG type selection: " << bg_type);
-
-    // code block segmentation, as per TS 38.212, using payload + TB CRC attachment (B)
-    uint32_t B = sizeBit + 24; // input to code block segmentation, in bits
-    std::pair<uint32_t, uint32_t> cbSeg = CodeBlockSegmentation(B, bg_type);
-    uint32_t K = cbSeg.first;
-    uint32_t C = cbSeg.second;
-    NS_LOG_INFO("EESMErrorModel: TBS of " << B << " bits distributed in " << C << " CBs of " << K
-                                          << " bits");
-
     uint8_t mcs_eq = mcs;
     if ((!sinrHistory.empty()) && (mcs > 0))
     {
@@ -327,24 +412,18 @@ NrEesmErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
     NS_LOG_INFO(" MCS of tx " << +mcs << " Equivalent MCS for PHY abstraction (just for HARQ-IR) "
                               << +mcs_eq);
 
-    double errorRate = 1.0;
-    if (C != 1)
-    {
-        double cbler = MappingSinrBler(SINR, mcs_eq, K);
-        errorRate = 1.0 - pow(1.0 - cbler, C);
-    }
-    else
-    {
-        errorRate = MappingSinrBler(SINR, mcs_eq, K);
-    }
+    double errorRate = CalcTbler(SINR, sizeBit, mcs, mcs_eq);
 
     NS_LOG_DEBUG("Calculated Error rate " << errorRate);
     NS_ASSERT(GetMcsEcrTable() != nullptr);
 
-    Ptr<NrEesmErrorModelOutput> ret = Create<NrEesmErrorModelOutput>(errorRate);
+    Ptr<NrEesmErrorModelOutput> ret = NrEesmErrorModelOutput::Allocate(errorRate);
     ret->m_sinrEff = SINR;
-    ret->m_sinr = sinr;
-    ret->m_map = map;
+    ret->m_sinrRb.reserve(map.size());
+    for (int rb : map)
+    {
+        ret->m_sinrRb.push_back(sinr.ValuesAt(rb));
+    }
     if (sinrHistory.empty())
     {
         ret->m_sinrExp = sinrExpSum; // it is first tx!
@@ -361,6 +440,87 @@ NrEesmErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
     return ret;
 }
 
+double
+NrEesmErrorModel::CalcTbler(double sinrEff, uint32_t sizeBit, uint8_t mcs, uint8_t mcsEq)
+{
+    // LDPC base graph type selection (1 or 2), as per TS 38.212, using the payload (A)
+    GraphType bg_type = GetBaseGraphType(sizeBit, mcs);
+    NS_LOG_INFO("BG type selection: " << bg_type);
+
+    // code block segmentation, as per TS 38.212, using payload + TB CRC attachment (B)
+    uint32_t B = sizeBit + 24; // input to code block segmentation, in bits
+    std::pair<uint32_t, uint32_t> cbSeg = CodeBlockSegmentation(B, bg_type);
+    uint32_t K = cbSeg.first;
+    uint32_t C = cbSeg.second;
+    NS_LOG_INFO("EESMErrorModel: TBS of " << B << " bits distributed in " << C << " CBs of " << K
+                                          << " bits");
+
+    double errorRate = 1.0;
+    if (C != 1)
+    {
+        double cbler = MappingSinrBler(sinrEff, mcsEq, K);
+        errorRate = 1.0 - pow(1.0 - cbler, C);
+    }
+    else
+    {
+        errorRate = MappingSinrBler(sinrEff, mcsEq, K);
+    }
+    return errorRate;
+}
+
+int16_t
+NrEesmErrorModel::GetMaxMcsForTargetTbler(const SpectrumValue& sinr,
+                                          const std::vector<int>& map,
+                                          const std::function<uint32_t(uint8_t)>& tbSizeForMcs,
+                                          double targetTbler)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(map.empty(),
+                    " Error: number of allocated RBs cannot be 0 - EESM method - MCS selection");
+
+    // The betas of the MCSs take only a few distinct values: compute the exponential sum of
+    // each distinct beta at once, instead of once per MCS
+    const std::vector<double>& betaTable = *GetBetaTable();
+    m_betas.clear();
+    m_mcsBetaIndex.resize(GetMaxMcs() + 1);
+    for (uint8_t mcs = 0; mcs <= GetMaxMcs(); mcs++)
+    {
+        auto it = std::find(m_betas.begin(), m_betas.end(), betaTable.at(mcs));
+        m_mcsBetaIndex[mcs] = static_cast<std::size_t>(std::distance(m_betas.begin(), it));
+        if (it == m_betas.end())
+        {
+            m_betas.push_back(betaTable.at(mcs));
+        }
+    }
+    m_betaSums.resize(m_betas.size());
+    NrL2smKernels::FillRbMask(map, sinr.GetValuesN(), m_rbMask);
+    NrL2smKernels::SinrExpSums(&(*sinr.ConstValuesBegin()),
+                               m_rbMask.data(),
+                               sinr.GetValuesN(),
+                               m_betas.data(),
+                               m_betas.size(),
+                               m_betaSums.data());
+
+    // The TBLER is not always non-decreasing with the MCS (e.g., where the modulation order or
+    // the LDPC base graph changes), so, as the default implementation, stop at the first MCS
+    // whose TBLER is above the target. The TBLER is computed as in GetTbBitDecodificationStats (),
+    // for a first transmission, without creating an output for each MCS.
+    for (uint8_t mcs = 0; mcs <= GetMaxMcs(); mcs++)
+    {
+        // same as SinrEff (), for a first transmission: a = 0, b = map.size ()
+        const double sinrEff =
+            -betaTable.at(mcs) * log(m_betaSums[m_mcsBetaIndex[mcs]] / map.size());
+        if (CalcTbler(sinrEff, tbSizeForMcs(mcs) * 8, mcs, mcs) > targetTbler)
+        {
+            NS_LOG_DEBUG("Max MCS for a TBLER of " << targetTbler << ": " << mcs - 1);
+            return static_cast<int16_t>(mcs) - 1;
+        }
+    }
+
+    NS_LOG_DEBUG("Max MCS for a TBLER of " << targetTbler << ": " << +GetMaxMcs());
+    return GetMaxMcs();
+}
+
 double
 NrEesmErrorModel::GetSpectralEfficiencyForCqi(uint8_t cqi)
 {
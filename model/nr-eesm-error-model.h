@@ -15,12 +15,22 @@ namespace ns3
 {
 
 class NrL2smEesmTestCase;
+class NrEesmBlerTable;
 
 /**
  * \ingroup error-models
  * \brief The NrEesmErrorModelOutput struct
  *
- * Error model output returned by the class NrEesmErrorModel.
+ * Error model output returned by the class NrEesmErrorModel. It is also the
+ * record that NrHarqPhy keeps in the HARQ history: for this reason, it stores
+ * only what HARQ-IR (the running exponential SINR sum, the code and info bits
+ * and the number of RBs) and HARQ-CC (the SINR of each allocated RB) need,
+ * and not the SINR of the whole bandwidth.
+ *
+ * The outputs returned by NrEesmErrorModel are taken from a pool, and they go
+ * back to it when the last reference is dropped, so that decoding a TB does not
+ * need any heap allocation once the pool is warm.
+ *
  * \see NrEesmErrorModel
  */
 struct NrEesmErrorModelOutput : public NrErrorModelOutput
@@ -39,12 +49,27 @@ struct NrEesmErrorModelOutput : public NrErrorModelOutput
     {
     }
 
-    double m_sinrExp{0.0};  //!< Sum of exponential SINR (needed for HARQ-IR)
-    double m_sinrEff{0.0};  //!< The effective SINR (needed just for the test)
-    SpectrumValue m_sinr;   //!< perceived SINRs in the whole bandwidth
-    std::vector<int> m_map; //!< map of the active RBs
-    uint32_t m_infoBits{0}; //!< number of info bits
-    uint32_t m_codeBits{0}; //!< number of code bits
+    /**
+     * \brief Get an output from the pool of the EESM outputs
+     *
+     * The output is created if the pool is empty.
+     *
+     * \param tbler the reference TBler
+     * \return an output, with all the fields at their default value
+     */
+    static Ptr<NrEesmErrorModelOutput> Allocate(double tbler);
+
+    double m_sinrExp{0.0};        //!< Sum of exponential SINR (needed for HARQ-IR)
+    double m_sinrEff{0.0};        //!< The effective SINR (needed just for the test)
+    std::vector<double> m_sinrRb; //!< SINR of the active RBs, in the order of the RB map
+    uint32_t m_infoBits{0};       //!< number of info bits
+    uint32_t m_codeBits{0};       //!< number of code bits
+
+  protected:
+    /**
+     * \brief Return the output to the pool (or delete it, if the pool is full)
+     */
+    void Release() override;
 };
 
 /**
@@ -121,6 +146,27 @@ class NrEesmErrorModel : public NrErrorModel
         uint8_t mcs,
         const NrErrorModelHistory& sinrHistory) override;
 
+    /**
+     * \brief Get the highest MCS whose TBLER, for a first transmission, does not
+     * exceed a target value
+     *
+     * It probes the MCS in the same order as the default implementation, since the
+     * TBLER is not always non-decreasing with the MCS, and gives the same result,
+     * but it computes only the effective SINR and the TBLER of each MCS, without
+     * creating an output object. The exponential sums of the SINR are computed
+     * once for all the distinct betas of the MCSs.
+     *
+     * \param sinr SINR vector
+     * \param map RB map
+     * \param tbSizeForMcs function that returns the transport block size (bytes) for a MCS
+     * \param targetTbler the maximum TBLER allowed
+     * \return the highest MCS that guarantees the target TBLER, or -1 if even MCS 0 does not
+     */
+    int16_t GetMaxMcsForTargetTbler(const SpectrumValue& sinr,
+                                    const std::vector<int>& map,
+                                    const std::function<uint32_t(uint8_t)>& tbSizeForMcs,
+                                    double targetTbler) override;
+
     /**
      * \brief Get the SE for a given CQI, following the CQIs in NR Table1/Table2
      * in TS38.214
@@ -207,6 +253,16 @@ class NrEesmErrorModel : public NrErrorModel
      */
     double SinrExp(const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs) const;
 
+    /**
+     * \brief compute the sum of exponential SINRs for the specified MCS, over
+     * all the values of a SINR vector (e.g., SINR values already combined by HARQ-CC)
+     *
+     * \param sinrRb the SINR of each RB to sum
+     * \param mcs the MCS of the TB
+     * \return the sum of exponential SINR
+     */
+    double SinrExp(const std::vector<double>& sinrRb, uint8_t mcs) const;
+
     /**
      * \brief Compute the effective SINR after retransmission combining
      * \param sinr SINR of the new transmission
@@ -252,6 +308,11 @@ class NrEesmErrorModel : public NrErrorModel
      * \return pointer to a table of BLER vs SINR
      */
     virtual const SimulatedBlerFromSINR* GetSimulatedBlerFromSINR() const = 0;
+    /**
+     * \return pointer to the compiled (flattened) version of the table of BLER vs SINR
+     * \see NrEesmBlerTable
+     */
+    virtual const NrEesmBlerTable* GetCompiledBlerFromSINR() const = 0;
     /**
      * \return pointer to a static vector that represents the MCS-M table
      */
@@ -267,6 +328,10 @@ class NrEesmErrorModel : public NrErrorModel
 
   private:
     static std::vector<std::string> m_bgTypeName; //!< Base graph name
+    mutable std::vector<uint64_t> m_rbMask;       //!< Scratch bitmask of the RBs of a TB
+    std::vector<double> m_betas;                  //!< Scratch distinct betas of the MCSs
+    std::vector<std::size_t> m_mcsBetaIndex;      //!< Scratch index in m_betas of each MCS
+    std::vector<double> m_betaSums;               //!< Scratch exponential sum of each beta
 
     /**
      * \brief map the effective SINR into CBLER for the specified MCS and CB size,
@@ -279,6 +344,18 @@ class NrEesmErrorModel : public NrErrorModel
      */
     double MappingSinrBler(double sinrEff, uint8_t mcs, uint32_t cbSize);
 
+    /**
+     * \brief Compute the TBLER of a transport block given its effective SINR,
+     * taking into account the LDPC base graph and the code block segmentation
+     *
+     * \param sinrEff the effective SINR of the transport block
+     * \param sizeBit transport block size in BITS
+     * \param mcs the MCS of the transmission
+     * \param mcsEq the equivalent MCS, used to select the SINR-BLER curve
+     * \return the transport block error rate
+     */
+    double CalcTbler(double sinrEff, uint32_t sizeBit, uint8_t mcs, uint8_t mcsEq);
+
     /**
      * \brief Get an output for the decodification error probability of a given
      * transport block, assuming the EESM method, NR LDPC coding and block
@@ -48,6 +48,12 @@ NrEesmIrT1::GetSimulatedBlerFromSINR() const
     return m_t1.m_simulatedBlerFromSINR;
 }
 
+const NrEesmBlerTable*
+NrEesmIrT1::GetCompiledBlerFromSINR() const
+{
+    return m_t1.m_compiledBlerFromSINR;
+}
+
 const std::vector<uint8_t>*
 NrEesmIrT1::GetMcsMTable() const
 {
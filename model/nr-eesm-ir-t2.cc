@@ -48,6 +48,12 @@ NrEesmIrT2::GetSimulatedBlerFromSINR() const
     return m_t2.m_simulatedBlerFromSINR;
 }
 
+const NrEesmBlerTable*
+NrEesmIrT2::GetCompiledBlerFromSINR() const
+{
+    return m_t2.m_compiledBlerFromSINR;
+}
+
 const std::vector<uint8_t>*
 NrEesmIrT2::GetMcsMTable() const
 {
@@ -58,7 +58,7 @@ NrEesmIr::ComputeSINR(const SpectrumValue& sinr,
                                               << " infoBits: " << sinrHistorytemp->m_infoBits);
 
         codeBitsSum += sinrHistorytemp->m_codeBits;
-        mapSumSize += sinrHistorytemp->m_map.size();
+        mapSumSize += sinrHistorytemp->m_sinrRb.size();
     }
     mapSumSize += map.size();
     codeBitsSum += sizeBit / GetMcsEcrTable()->at(mcs);
@@ -4,6 +4,8 @@
 
 #include "nr-eesm-t1.h"
 
+#include "nr-eesm-bler-table.h"
+
 namespace ns3
 {
 
@@ -17537,6 +17539,9 @@ NrEesmT1::NrEesmT1()
     m_betaTable = &BetaTable1;
     m_mcsEcrTable = &McsEcrTable1;
     m_simulatedBlerFromSINR = &BlerForSinr1;
+    // The table is compiled just once, the first time that it is needed
+    static const NrEesmBlerTable CompiledBlerForSinr1(BlerForSinr1);
+    m_compiledBlerFromSINR = &CompiledBlerForSinr1;
     m_mcsMTable = &McsMTable1;
     m_spectralEfficiencyForMcs = &SpectralEfficiencyForMcs1;
     m_spectralEfficiencyForCqi = &SpectralEfficiencyForCqi1;
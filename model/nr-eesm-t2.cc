@@ -6,6 +6,8 @@
 
 #include "nr-eesm-t2.h"
 
+#include "nr-eesm-bler-table.h"
+
 namespace ns3
 {
 
@@ -17743,6 +17745,9 @@ NrEesmT2::NrEesmT2()
     m_betaTable = &BetaTable2;
     m_mcsEcrTable = &McsEcrTable2;
     m_simulatedBlerFromSINR = &BlerForSinr2;
+    // The table is compiled just once, the first time that it is needed
+    static const NrEesmBlerTable CompiledBlerForSinr2(BlerForSinr2);
+    m_compiledBlerFromSINR = &CompiledBlerForSinr2;
     m_mcsMTable = &McsMTable2;
     m_spectralEfficiencyForMcs = &SpectralEfficiencyForMcs2;
     m_spectralEfficiencyForCqi = &SpectralEfficiencyForCqi2;
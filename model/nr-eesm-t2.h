@@ -42,6 +42,7 @@ struct NrEesmT2
     const std::vector<double>* m_mcsEcrTable{nullptr}; //!< MCS-ECR table
     const NrEesmErrorModel::SimulatedBlerFromSINR* m_simulatedBlerFromSINR{
         nullptr};                                                   //!< BLER from SINR table
+    const NrEesmBlerTable* m_compiledBlerFromSINR{nullptr};         //!< Compiled BLER table
     const std::vector<uint8_t>* m_mcsMTable{nullptr};               //!< MCS-M table
     const std::vector<double>* m_spectralEfficiencyForMcs{nullptr}; //!< Spectral-efficiency for MCS
     const std::vector<double>* m_spectralEfficiencyForCqi{nullptr}; //!< Spectral-efficiency for CQI
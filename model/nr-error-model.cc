@@ -8,6 +8,10 @@
 
 #include <ns3/log.h>
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -37,6 +41,30 @@ NrErrorModel::GetInstanceTypeId() const
     return NrErrorModel::GetTypeId();
 }
 
+int16_t
+NrErrorModel::GetMaxMcsForTargetTbler(const SpectrumValue& sinr,
+                                      const std::vector<int>& map,
+                                      const std::function<uint32_t(uint8_t)>& tbSizeForMcs,
+                                      double targetTbler)
+{
+    NS_LOG_FUNCTION(this);
+    uint8_t mcs = 0;
+    while (mcs <= GetMaxMcs())
+    {
+        auto output = GetTbDecodificationStats(sinr,
+                                               map,
+                                               tbSizeForMcs(mcs),
+                                               mcs,
+                                               NrErrorModel::NrErrorModelHistory());
+        if (output->m_tbler > targetTbler)
+        {
+            break;
+        }
+        mcs++;
+    }
+    return static_cast<int16_t>(mcs) - 1;
+}
+
 Ptr<NrErrorModelOutput>
 NrErrorModel::GetTbDecodificationStatsMimo(const std::vector<MimoSinrChunk>& sinrChunks,
                                            const std::vector<int>& map,
@@ -72,39 +100,63 @@ NrErrorModel::ComputeAvgSinrMimo(const std::vector<MimoSinrChunk>& sinrChunks)
     auto rank = sinrChunks[0].mimoSinr.GetNumRows();
     auto totDur = double{0.0};
     auto avgSinrMat = DoubleMatrixArray{rank, nRbs};
+    auto avgValues = avgSinrMat.GetPagePtr(0);
     for (const auto& chunk : sinrChunks)
     {
         const auto& sinrMat = chunk.mimoSinr;
         NS_ASSERT(sinrMat.GetNumRows() == avgSinrMat.GetNumRows());
         NS_ASSERT(sinrMat.GetNumCols() == avgSinrMat.GetNumCols());
-        avgSinrMat += sinrMat * chunk.dur.GetDouble();
-        totDur += chunk.dur.GetDouble();
+        // Accumulate in place, without the temporary matrix of sinrMat * duration
+        auto values = sinrMat.GetPagePtr(0);
+        auto dur = chunk.dur.GetDouble();
+        for (size_t i = 0; i < rank * nRbs; i++)
+        {
+            avgValues[i] += values[i] * dur;
+        }
+        totDur += dur;
     }
-    return NrSinrMatrix{avgSinrMat * (1.0 / totDur)};
+    auto invTotDur = 1.0 / totDur;
+    for (size_t i = 0; i < rank * nRbs; i++)
+    {
+        avgValues[i] *= invTotDur;
+    }
+    return NrSinrMatrix{avgSinrMat};
 }
 
-SpectrumValue
-NrErrorModel::CreateVectorizedSpecVal(const NrSinrMatrix& sinrMat)
+Ptr<const SpectrumModel>
+NrErrorModel::GetVectorizedSpectrumModel(size_t numValues)
 {
-    // Convert the 2D SINR matrix into a one-dimensional SpectrumValue
-    auto tempSinr = NrSinrMatrix{sinrMat.GetValues()};
-    auto bands = std::vector<BandInfo>(tempSinr.GetNumRows());
-    auto specModel = Create<SpectrumModel>(bands);
-    auto vectorizedSinr = SpectrumValue{specModel};
-    auto idx = size_t{0};
-    for (auto it = vectorizedSinr.ValuesBegin(); it != vectorizedSinr.ValuesEnd(); it++)
+    static std::mutex cacheMutex;
+    static std::unordered_map<size_t, Ptr<const SpectrumModel>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(numValues);
+    if (it == cache.end())
     {
-        auto& itVal = *it;
-        itVal = tempSinr[idx];
-        idx++;
+        auto bands = std::vector<BandInfo>(numValues);
+        it = cache.emplace(numValues, Create<SpectrumModel>(bands)).first;
+        NS_LOG_INFO("Created the vectorized SpectrumModel of " << numValues << " values, UID "
+                                                               << it->second->GetUid());
     }
+    return it->second;
+}
+
+SpectrumValue
+NrErrorModel::CreateVectorizedSpecVal(const NrSinrMatrix& sinrMat)
+{
+    // Convert the 2D SINR matrix into a one-dimensional SpectrumValue. The matrix is stored
+    // column-major, so its values are already in the vectorized order.
+    const auto& values = sinrMat.GetValues();
+    auto vectorizedSinr = SpectrumValue{GetVectorizedSpectrumModel(values.size())};
+    std::copy(std::begin(values), std::end(values), vectorizedSinr.ValuesBegin());
     return vectorizedSinr;
 }
 
 std::vector<int>
-NrErrorModel::CreateVectorizedRbMap(std::vector<int> map, uint8_t rank)
+NrErrorModel::CreateVectorizedRbMap(const std::vector<int>& map, uint8_t rank)
 {
     auto vectorizedMap = std::vector<int>{};
+    vectorizedMap.reserve(map.size() * rank);
     for (int iRb : map)
     {
         for (size_t layer = 0; layer < rank; layer++)
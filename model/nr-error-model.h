@@ -10,19 +10,39 @@
 #include "nr-mimo-chunk-processor.h"
 
 #include <ns3/object.h>
+#include <ns3/simple-ref-count.h>
 #include <ns3/spectrum-value.h>
 
+#include <functional>
 #include <vector>
 
 namespace ns3
 {
 
+struct NrErrorModelOutput;
+
+/**
+ * \ingroup error-models
+ * \brief Deleter of the NrErrorModelOutput, called when the last reference is dropped
+ *
+ * It lets the output decide how to release itself (e.g., to return to a pool).
+ */
+struct NrErrorModelOutputDeleter
+{
+    /**
+     * \brief Release an output
+     * \param output the output to release
+     */
+    static void Delete(NrErrorModelOutput* output);
+};
+
 /**
  * \ingroup error-models
  * \brief Store the output of an NRErrorModel
  *
  */
-struct NrErrorModelOutput : public SimpleRefCount<NrErrorModelOutput>
+struct NrErrorModelOutput
+    : public SimpleRefCount<NrErrorModelOutput, Empty, NrErrorModelOutputDeleter>
 {
     /**
      * \brief NrErrorModelOutput default constructor (deleted)
@@ -46,8 +66,28 @@ struct NrErrorModelOutput : public SimpleRefCount<NrErrorModelOutput>
     }
 
     double m_tbler{0.0}; //!< Transport Block Error Rate
+
+  protected:
+    friend NrErrorModelOutputDeleter;
+
+    /**
+     * \brief Release the output, once it is not referenced anymore
+     *
+     * By default, the output is deleted. Subclasses can override it to keep
+     * the object for a later use.
+     */
+    virtual void Release()
+    {
+        delete this;
+    }
 };
 
+inline void
+NrErrorModelOutputDeleter::Delete(NrErrorModelOutput* output)
+{
+    output->Release();
+}
+
 /**
  * \ingroup error-models
  * \brief Interface for calculating the error probability for a transport block
@@ -188,6 +228,27 @@ class NrErrorModel : public Object
      */
     virtual uint8_t GetMaxMcs() const = 0;
 
+    /**
+     * \brief Get the highest MCS whose TBLER, for a first transmission, does not
+     * exceed a target value
+     *
+     * Used by the AMC to select the MCS of a CQI report. The default implementation
+     * probes all the MCS, starting from 0, through GetTbDecodificationStats() and
+     * stops at the first one whose TBLER is above the target. Subclasses can override
+     * it with a faster implementation that does not need to create an output for
+     * every MCS probed.
+     *
+     * \param sinr SINR vector
+     * \param map RB map
+     * \param tbSizeForMcs function that returns the transport block size (bytes) for a MCS
+     * \param targetTbler the maximum TBLER allowed
+     * \return the highest MCS that guarantees the target TBLER, or -1 if even MCS 0 does not
+     */
+    virtual int16_t GetMaxMcsForTargetTbler(const SpectrumValue& sinr,
+                                            const std::vector<int>& map,
+                                            const std::function<uint32_t(uint8_t)>& tbSizeForMcs,
+                                            double targetTbler);
+
     /// \brief Get an output for the decoding error probability of a given transport block.
     /// This method is not purely virtual. If derived ErrorModel does not override, the MIMO matrix
     /// is converted to a linear SpectrumValue, and the non-MIMO method is called.
@@ -212,10 +273,19 @@ class NrErrorModel : public Object
 
     /// \brief Linearize a 2D matrix into a vector, and convert that vector to a SpectrumValue
     /// Matches layer-to-codeword mapping in TR 38.211, Table 7.3.1.3-1
+    /// The SpectrumModel of the SpectrumValue is shared by all the SpectrumValues with the same
+    /// number of values (see GetVectorizedSpectrumModel).
     /// \param sinrMat A 2D matrix of average SINR values, dimensions nMimoLayers x nRbs
     /// \return A SpectrumValue with the (nRB * nMimoLayers) SINR values
     SpectrumValue CreateVectorizedSpecVal(const NrSinrMatrix& sinrMat);
 
+    /// \brief Get the SpectrumModel of the vectorized SINR values
+    /// The models are created once per number of values, and cached for the whole simulation, so
+    /// that the vectorization does not register a new SpectrumModel for each TB.
+    /// \param numValues the number of values (nRB * nMimoLayers)
+    /// \return the SpectrumModel with numValues bands
+    static Ptr<const SpectrumModel> GetVectorizedSpectrumModel(size_t numValues);
+
     /// \brief Create an equivalent RB index map for vectorized SINR values
     /// Matches layer-to-codeword mapping in TR 38.211, Table 7.3.1.3-1
     /// If map contains index "j", the output vectorized map contains
@@ -226,7 +296,7 @@ class NrErrorModel : public Object
     /// \param rank The number of MIMO layers
     /// \return the indices corresponding to "map" when the SINR matrix is vectorized
     /// Note: result will be used in OSS function which require vector<int> type
-    std::vector<int> CreateVectorizedRbMap(std::vector<int> map, uint8_t rank);
+    std::vector<int> CreateVectorizedRbMap(const std::vector<int>& map, uint8_t rank);
 };
 
 } // namespace ns3
@@ -458,6 +458,8 @@ NrGnbMac::DoDispose()
     m_ulCqiReceived.clear();
     m_ulCeReceived.clear();
     m_miDlHarqProcessesPackets.clear();
+    m_deferredSchedConfigInd.clear();
+    m_cellPartitionExecutor = nullptr;
     delete m_macSapProvider;
     delete m_cmacSapProvider;
     delete m_macSchedSapUser;
@@ -554,6 +556,49 @@ NrGnbMac::SetCurrentSfn(const SfnSf& sfnSf)
     m_currentSlot = sfnSf;
 }
 
+void
+NrGnbMac::SetCellPartitionExecutor(const Ptr<NrCellPartitionExecutor>& executor,
+                                   uint32_t partition)
+{
+    NS_LOG_FUNCTION(this << executor << partition);
+    m_cellPartitionExecutor = executor;
+    m_cellPartition = partition;
+}
+
+void
+NrGnbMac::CallSchedTrigger(std::function<void()> trigger)
+{
+    NS_LOG_FUNCTION(this);
+    if (m_cellPartitionExecutor == nullptr)
+    {
+        trigger();
+        return;
+    }
+
+    // The scheduler touches only its own state, and can run in parallel with the schedulers of
+    // the other gNBs. What it decides is processed later, on the simulator thread.
+    m_cellPartitionExecutor->Submit(
+        m_cellPartition,
+        [this, trigger]() {
+            m_deferSchedConfigInd = true;
+            trigger();
+            m_deferSchedConfigInd = false;
+        },
+        [this]() { DoDeferredSchedConfigIndication(); });
+}
+
+void
+NrGnbMac::DoDeferredSchedConfigIndication()
+{
+    NS_LOG_FUNCTION(this);
+    auto deferred = std::move(m_deferredSchedConfigInd);
+    m_deferredSchedConfigInd.clear();
+    for (auto& ind : deferred)
+    {
+        DoSchedConfigIndication(ind);
+    }
+}
+
 void
 NrGnbMac::DoSlotDlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
 {
@@ -637,7 +682,7 @@ NrGnbMac::DoSlotDlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
         }
     }
 
-    m_macSchedSapProvider->SchedDlTriggerReq(dlParams);
+    CallSchedTrigger([this, dlParams]() { m_macSchedSapProvider->SchedDlTriggerReq(dlParams); });
 }
 
 void
@@ -705,7 +750,7 @@ NrGnbMac::DoSlotUlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
         m_ulHarqInfoReceived.clear();
     }
 
-    m_macSchedSapProvider->SchedUlTriggerReq(ulParams);
+    CallSchedTrigger([this, ulParams]() { m_macSchedSapProvider->SchedUlTriggerReq(ulParams); });
 }
 
 void
@@ -1070,6 +1115,12 @@ NrGnbMac::SendRar(const std::vector<BuildRarListElement_s>& rarList)
 void
 NrGnbMac::DoSchedConfigIndication(NrMacSchedSapUser::SchedConfigIndParameters ind)
 {
+    if (m_deferSchedConfigInd)
+    {
+        m_deferredSchedConfigInd.emplace_back(std::move(ind));
+        return;
+    }
+
     NS_ASSERT(ind.m_sfnSf.GetNumerology() == m_currentSlot.GetNumerology());
     std::sort(ind.m_slotAllocInfo.m_varTtiAllocInfo.begin(),
               ind.m_slotAllocInfo.m_varTtiAllocInfo.end());
@@ -7,6 +7,7 @@
 #ifndef NR_ENB_MAC_H
 #define NR_ENB_MAC_H
 
+#include "nr-cell-partition-executor.h"
 #include "nr-mac-pdu-info.h"
 #include "nr-mac-sched-sap.h"
 #include "nr-mac-scheduler.h"
@@ -18,6 +19,8 @@
 #include <ns3/lte-mac-sap.h>
 #include <ns3/traced-callback.h>
 
+#include <functional>
+
 namespace ns3
 {
 
@@ -140,6 +143,18 @@ class NrGnbMac : public Object
      */
     virtual void SetCurrentSfn(const SfnSf& sfn);
 
+    /**
+     * \brief Run the scheduler in a partition of a NrCellPartitionExecutor
+     * \param executor the executor, or nullptr to run the scheduler directly
+     * \param partition the partition of the gNB
+     *
+     * The scheduler runs in parallel with the schedulers of the other gNBs, and its decisions
+     * are processed by the MAC (e.g., the RLC PDUs are generated) afterwards, in the
+     * sequential part of the executor.
+     */
+    void SetCellPartitionExecutor(const Ptr<NrCellPartitionExecutor>& executor,
+                                  uint32_t partition);
+
     void SetForwardUpCallback(Callback<void, Ptr<Packet>> cb);
 
     NrGnbPhySapUser* GetPhySapUser();
@@ -285,6 +300,16 @@ class NrGnbMac : public Object
     void DoReceivePhyPdu(Ptr<Packet> p);
     void DoReceiveControlMessage(Ptr<NrControlMessage> msg);
     virtual void DoSchedConfigIndication(NrMacSchedSapUser::SchedConfigIndParameters ind);
+    /**
+     * \brief Call a trigger of the scheduler, directly or in the partition of the gNB
+     * \param trigger the function that calls the scheduler
+     */
+    void CallSchedTrigger(std::function<void()> trigger);
+    /**
+     * \brief Process the decisions of the scheduler that were deferred while it was running
+     * in the partition of the gNB
+     */
+    void DoDeferredSchedConfigIndication();
     // forwarded from LteMacSapProvider
     void DoTransmitPdu(LteMacSapProvider::TransmitPduParameters);
     void DoReportBufferStatus(LteMacSapProvider::ReportBufferStatusParameters);
@@ -388,6 +413,12 @@ class NrGnbMac : public Object
 
     SfnSf m_currentSlot;
 
+    Ptr<NrCellPartitionExecutor> m_cellPartitionExecutor; //!< The executor of the partitions
+    uint32_t m_cellPartition{0};                          //!< The partition of the gNB
+    bool m_deferSchedConfigInd{false}; //!< Whether the scheduler runs in the partition
+    /// The decisions of the scheduler, deferred while it runs in the partition
+    std::vector<NrMacSchedSapUser::SchedConfigIndParameters> m_deferredSchedConfigInd;
+
     /**
      * Trace information regarding ENB MAC Received Control Messages
      * Frame number, Subframe number, slot, VarTtti, nodeId, rnti,
@@ -58,6 +58,7 @@ NrGnbPhy::DoDispose()
 {
     NS_LOG_FUNCTION(this);
     delete m_enbCphySapProvider;
+    m_cellPartitionExecutor = nullptr;
     NrPhy::DoDispose();
 }
 
@@ -160,6 +161,14 @@ NrGnbPhy::GetTypeId()
                           StringValue("F|F|F|F|F|F|F|F|F|F|"),
                           MakeStringAccessor(&NrGnbPhy::SetPattern, &NrGnbPhy::GetPattern),
                           MakeStringChecker())
+            .AddAttribute("SkipIdleCtrlSymbols",
+                          "If true, the CTRL-only slots without messages to transmit and without "
+                          "CSI-RS do not schedule the events of their CTRL symbols, but only "
+                          "the switch to the quasi-omni beam at the first of them. The slot "
+                          "itself still starts and ends, and the MAC is still called",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrGnbPhy::m_skipIdleCtrlSymbols),
+                          MakeBooleanChecker())
             .AddTraceSource("SlotDataStats",
                             "Data statistics for the current slot: SfnSf, active UE, used RE, "
                             "used symbols, available RBs, available symbols, bwp ID, cell ID",
@@ -556,6 +565,27 @@ NrGnbPhy::SetN2Delay(uint32_t delay)
     SetTddPattern(m_tddPattern); // Update the generate/send structures
 }
 
+void
+NrGnbPhy::SetCsiRsPeriodicity(uint16_t periodicity)
+{
+    m_csiRsPeriodicity = periodicity;
+}
+
+uint16_t
+NrGnbPhy::GetCsiRsPeriodicity() const
+{
+    return m_csiRsPeriodicity;
+}
+
+void
+NrGnbPhy::SetCellPartitionExecutor(const Ptr<NrCellPartitionExecutor>& executor,
+                                   uint32_t partition)
+{
+    NS_LOG_FUNCTION(this << executor << partition);
+    m_cellPartitionExecutor = executor;
+    m_cellPartition = partition;
+}
+
 BeamId
 NrGnbPhy::GetBeamId(uint16_t rnti) const
 {
@@ -694,6 +724,20 @@ NrGnbPhy::CallMacForSlotIndication(const SfnSf& currentSlot)
     }
 }
 
+void
+NrGnbPhy::StartGrantedSlot()
+{
+    NS_LOG_FUNCTION(this);
+    CallMacForSlotIndication(m_currentSlot);
+    if (m_cellPartitionExecutor == nullptr)
+    {
+        DoStartSlot();
+        return;
+    }
+    // After the MAC has processed what its scheduler decided in the partition
+    m_cellPartitionExecutor->Submit(m_cellPartition, nullptr, [this]() { DoStartSlot(); });
+}
+
 void
 NrGnbPhy::StartSlot(const SfnSf& startSlot)
 {
@@ -703,6 +747,12 @@ NrGnbPhy::StartSlot(const SfnSf& startSlot)
     m_currentSlot = startSlot;
     m_lastSlotStart = Simulator::Now();
 
+    if (m_csiRsPeriodicity > 0 && m_currentSlot.Normalize() % m_csiRsPeriodicity == 0)
+    {
+        // Transmitted in the DL CTRL of this slot, or of the next slot that has one
+        m_csiRsPending = true;
+    }
+
     Simulator::Schedule(GetSlotPeriod(), &NrGnbPhy::EndSlot, this);
 
     // update the current slot allocation; if empty (e.g., at the beginning of simu)
@@ -744,8 +794,7 @@ NrGnbPhy::StartSlot(const SfnSf& startSlot)
     if (m_channelStatus == GRANTED)
     {
         NS_LOG_INFO("Channel granted");
-        CallMacForSlotIndication(m_currentSlot);
-        DoStartSlot();
+        StartGrantedSlot();
     }
     else
     {
@@ -779,8 +828,7 @@ NrGnbPhy::StartSlot(const SfnSf& startSlot)
                     // instantaneously
                     NS_LOG_INFO("Channel granted; asking MAC for SlotIndication for the future and "
                                 "then start the slot");
-                    CallMacForSlotIndication(m_currentSlot);
-                    DoStartSlot();
+                    StartGrantedSlot();
                     return; // Exit without calling anything else
                 }
             }
@@ -1001,9 +1049,71 @@ NrGnbPhy::DoStartSlot()
 
     PrepareRbgAllocationMap(m_currSlotAllocInfo.m_varTtiAllocInfo);
 
+    if (m_skipIdleCtrlSymbols && IsCtrlOnlySlot())
+    {
+        // Until the first CTRL symbol, the PHY of a linked bandwidth part can still route its
+        // control messages to this one: decide there if the CTRL symbols are idle
+        auto firstSymStart = m_currSlotAllocInfo.m_varTtiAllocInfo.front().m_dci->m_symStart;
+        Simulator::Schedule(GetSymbolPeriod() * firstSymStart,
+                            &NrGnbPhy::StartCtrlOnlySlot,
+                            this,
+                            m_currSlotAllocInfo.m_varTtiAllocInfo);
+        m_currSlotAllocInfo.m_varTtiAllocInfo.clear();
+        return;
+    }
+
     FillTheEvent();
 }
 
+bool
+NrGnbPhy::IsCtrlOnlySlot() const
+{
+    return std::all_of(m_currSlotAllocInfo.m_varTtiAllocInfo.begin(),
+                       m_currSlotAllocInfo.m_varTtiAllocInfo.end(),
+                       [](const VarTtiAllocInfo& allocation) {
+                           return allocation.m_dci->m_type == DciInfoElementTdma::CTRL;
+                       });
+}
+
+bool
+NrGnbPhy::IsIdleCtrl(const std::deque<VarTtiAllocInfo>& allocations) const
+{
+    if (!m_ctrlMsgs.empty())
+    {
+        return false;
+    }
+    return !m_csiRsPending ||
+           std::none_of(allocations.begin(),
+                        allocations.end(),
+                        [](const VarTtiAllocInfo& allocation) {
+                            return allocation.m_dci->m_format == DciInfoElementTdma::DL;
+                        });
+}
+
+void
+NrGnbPhy::StartCtrlOnlySlot(const std::deque<VarTtiAllocInfo>& allocations)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (IsIdleCtrl(allocations))
+    {
+        // The CTRL symbols would only switch to the quasi-omni beam; after the first of them,
+        // the beam cannot change anymore until the end of the slot
+        NS_LOG_DEBUG("Idle CTRL symbols in slot " << m_currentSlot << ", skip their events");
+        ChangeToQuasiOmniBeamformingVector();
+        return;
+    }
+
+    // The events that FillTheEvent would have scheduled, from the first CTRL symbol
+    auto firstSymStart = allocations.front().m_dci->m_symStart;
+    StartVarTti(allocations.front().m_dci);
+    for (auto it = std::next(allocations.begin()); it != allocations.end(); ++it)
+    {
+        auto varTtiStart = GetSymbolPeriod() * (it->m_dci->m_symStart - firstSymStart);
+        Simulator::Schedule(varTtiStart, &NrGnbPhy::StartVarTti, this, it->m_dci);
+    }
+}
+
 void
 NrGnbPhy::PrepareRbgAllocationMap(const std::deque<VarTtiAllocInfo>& allocations)
 {
@@ -1243,6 +1353,12 @@ NrGnbPhy::DlCtrl(const std::shared_ptr<DciInfoElementTdma>& dci)
         NS_LOG_DEBUG("No messages to send, skipping");
     }
 
+    if (m_csiRsPending)
+    {
+        SendCsiRs(varTtiPeriod - NanoSeconds(1.0));
+        m_csiRsPending = false;
+    }
+
     return varTtiPeriod;
 }
 
@@ -1543,6 +1659,40 @@ NrGnbPhy::SendCtrlChannels(const Time& varTtiPeriod)
     m_ctrlMsgs.clear();
 }
 
+void
+NrGnbPhy::SendCsiRs(const Time& varTtiPeriod)
+{
+    NS_LOG_FUNCTION(this);
+
+    // Look for the next UE that is attached, in turn
+    for (size_t i = 0; i < m_deviceMap.size(); ++i)
+    {
+        size_t index = (m_csiRsNextUe + i) % m_deviceMap.size();
+        const auto& ueDev = m_deviceMap[index];
+        uint16_t rnti = DynamicCast<NrUePhy>(ueDev->GetPhy(GetBwpId()))->GetRnti();
+        if (m_ueAttachedRnti.find(rnti) == m_ueAttachedRnti.end())
+        {
+            continue;
+        }
+        m_csiRsNextUe = index + 1;
+
+        // The DL CTRL, if any, has already been transmitted with the previous beam
+        ChangeBeamformingVector(ueDev);
+        m_lastBfChange = Simulator::Now();
+
+        std::vector<int> fullBwRb(GetRbNum());
+        for (uint32_t rb = 0; rb < fullBwRb.size(); ++rb)
+        {
+            fullBwRb[rb] = static_cast<int>(rb);
+        }
+        SetSubChannels(fullBwRb, fullBwRb.size());
+
+        NS_LOG_DEBUG("gNB TXing CSI-RS of UE " << rnti << " in slot " << m_currentSlot);
+        m_spectrumPhy->StartTxCsiRs(rnti, varTtiPeriod);
+        return;
+    }
+}
+
 bool
 NrGnbPhy::RegisterUe(uint64_t imsi, const Ptr<NrUeNetDevice>& ueDevice)
 {
@@ -8,6 +8,7 @@
 #define NR_ENB_PHY_H
 
 #include "ideal-beamforming-algorithm.h"
+#include "nr-cell-partition-executor.h"
 #include "nr-control-messages.h"
 #include "nr-harq-phy.h"
 #include "nr-phy.h"
@@ -174,6 +175,38 @@ class NrGnbPhy : public NrPhy
      */
     uint32_t GetN2Delay() const;
 
+    /**
+     * \brief Set the periodicity of the CSI-RS
+     *
+     * In the slots that are multiple of the periodicity, the gNB transmits the CSI-RS of one
+     * of its UEs (in turn) during the DL CTRL, with the beam of the UE. If the slot has no
+     * DL CTRL (e.g., an UL slot of the TDD pattern), the CSI-RS is transmitted in the next
+     * slot that has one.
+     *
+     * \param periodicity the periodicity (in slots), or 0 to not transmit the CSI-RS
+     */
+    void SetCsiRsPeriodicity(uint16_t periodicity);
+
+    /**
+     * \brief Get the periodicity of the CSI-RS
+     * \return the periodicity (in slots), or 0 if the CSI-RS is not transmitted
+     */
+    uint16_t GetCsiRsPeriodicity() const;
+
+    /**
+     * \brief Start the slots in a partition of a NrCellPartitionExecutor
+     *
+     * The slot starts in the sequential part of the executor, after the MAC has processed the
+     * decisions that its scheduler took in parallel with the schedulers of the other gNBs, so
+     * that the messages that the MAC sends to the PHY are in the same slots as without the
+     * executor.
+     *
+     * \param executor the executor, or nullptr to start the slots directly
+     * \param partition the partition of the gNB
+     */
+    void SetCellPartitionExecutor(const Ptr<NrCellPartitionExecutor>& executor,
+                                  uint32_t partition);
+
     /**
      * \brief Get the BeamId for the selected user
      * \param rnti the selected UE
@@ -497,6 +530,12 @@ class NrGnbPhy : public NrPhy
      */
     void SendCtrlChannels(const Time& varTtiPeriod);
 
+    /**
+     * \brief Transmit the CSI-RS of the next UE, with its beam
+     * \param varTtiPeriod the period of transmission
+     */
+    void SendCsiRs(const Time& varTtiPeriod);
+
     /**
      * \brief Create a list of messages that contains the DCI to send in the slot specified
      * \param sfn Slot from which take all the DCI
@@ -590,6 +629,12 @@ class NrGnbPhy : public NrPhy
      */
     void DoStartSlot();
 
+    /**
+     * \brief Call the MAC for the slot indication, and then start the slot, as we have the
+     * channel
+     */
+    void StartGrantedSlot();
+
     void GenerateAllocationStatistics(const SlotAllocInfo& allocInfo) const;
 
     // LteEnbCphySapProvider forwarded methods
@@ -712,6 +757,36 @@ class NrGnbPhy : public NrPhy
      */
     void FillTheEvent();
 
+    /**
+     * \brief Check if the current slot has only CTRL allocations
+     * \return true if all the allocations of the current slot are CTRL
+     */
+    bool IsCtrlOnlySlot() const;
+
+    /**
+     * \brief Check if the CTRL symbols of a CTRL-only slot are idle
+     *
+     * The CTRL symbols are idle when there are no control messages to transmit, and no CSI-RS
+     * in a DL CTRL. Their events would not do anything else than switching to the quasi-omni
+     * beam.
+     *
+     * \param allocations the CTRL allocations of the slot
+     * \return true if the CTRL symbols are idle
+     */
+    bool IsIdleCtrl(const std::deque<VarTtiAllocInfo>& allocations) const;
+
+    /**
+     * \brief Start the CTRL symbols of a CTRL-only slot, at the first of them
+     *
+     * The decision is taken at the first CTRL symbol, and not at the start of the slot, because
+     * the PHY of a linked bandwidth part can route its control messages to this one in between.
+     * If the CTRL symbols are idle, only switch to the quasi-omni beam; otherwise, start them as
+     * FillTheEvent would have done.
+     *
+     * \param allocations the CTRL allocations of the slot
+     */
+    void StartCtrlOnlySlot(const std::deque<VarTtiAllocInfo>& allocations);
+
   private:
     NrGnbPhySapUser* m_phySapUser{nullptr}; //!< MAC SAP user pointer, MAC is user of services of
                                             //!< PHY, implements e.g. ReceiveRachPreamble
@@ -823,6 +898,15 @@ class NrGnbPhy : public NrPhy
     bool m_isPrimary{false}; //!< Is this PHY a primary phy?
 
     Time m_lastBfChange; //!< Saves the timestamp when the beamforming vector changes.
+
+    uint16_t m_csiRsPeriodicity{0}; //!< Periodicity of the CSI-RS (slots), 0 if disabled
+    size_t m_csiRsNextUe{0};        //!< Index in m_deviceMap of the UE of the next CSI-RS
+    bool m_csiRsPending{false};     //!< A CSI-RS occasion waits for the next DL CTRL
+
+    Ptr<NrCellPartitionExecutor> m_cellPartitionExecutor; //!< The executor of the partitions
+    uint32_t m_cellPartition{0};                          //!< The partition of the gNB
+
+    bool m_skipIdleCtrlSymbols{false}; //!< Skip the events of the CTRL symbols of idle slots
 };
 
 } // namespace ns3
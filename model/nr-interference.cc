@@ -22,6 +22,7 @@ namespace ns3
 
 NrInterference::NrInterference()
     : LteInterference(),
+      m_signalCovCache(Create<NrMimoSignalCovCache>()),
       m_firstPower(0.0)
 {
     NS_LOG_FUNCTION(this);
@@ -38,8 +39,19 @@ NrInterference::DoDispose()
     NS_LOG_FUNCTION(this);
 
     m_mimoChunkProcessors.clear();
+    for (const auto& signal : m_allSignalsMimo)
+    {
+        if (m_signalCovs.erase(PeekPointer(signal)))
+        {
+            m_signalCovCache->Release(signal);
+        }
+    }
+    m_signalCovs.clear();
     m_rxSignalsMimo.clear();
     m_allSignalsMimo.clear();
+    m_rxSignalSet.clear();
+    m_outOfCellSignals.clear();
+    m_outOfCellInterfCov = NrCovMat{};
 
     LteInterference::DoDispose();
 }
@@ -165,6 +177,10 @@ NrInterference::ConditionallyEvaluateChunk()
                 // Use the UE's RNTI to distinguish multiple received signals
                 auto nrRxSignal = DynamicCast<const NrSpectrumSignalParametersDataFrame>(rxSignal);
                 uint16_t rnti = nrRxSignal ? nrRxSignal->rnti : 0;
+                if (auto csiRs = DynamicCast<const NrSpectrumSignalParametersCsiRs>(rxSignal))
+                {
+                    rnti = csiRs->rnti;
+                }
 
                 // MimoSinrChunk is used to store SINR and compute TBLER of the data transmission
                 auto sinrMatrix = ComputeSinr(outOfCellInterfCov, rxSignal);
@@ -358,8 +374,12 @@ NrInterference::StartRxMimo(Ptr<const SpectrumSignalParameters> params)
     {
         // This must be the first receive signal, clear any lingering previous signals
         m_rxSignalsMimo.clear();
+        m_rxSignalSet.clear();
     }
     m_rxSignalsMimo.push_back(params);
+    m_rxSignalSet.insert(PeekPointer(params));
+    // The signal may have been accounted as out-of-cell interference in a previous reception
+    RemoveFromOutOfCellInterfCov(params);
     for (auto& cp : m_mimoChunkProcessors)
     {
         // Clear the list of stored chunks
@@ -388,6 +408,31 @@ NrInterference::DoSubtractSignalMimo(Ptr<const SpectrumSignalParameters> params,
     }
     NS_ASSERT_MSG(m_allSignalsMimo.size() == (numSignals - 1),
                   "MIMO signal was not found for removal");
+
+    RemoveFromOutOfCellInterfCov(params);
+    if (m_signalCovs.erase(PeekPointer(params)))
+    {
+        m_signalCovCache->Release(params);
+    }
+}
+
+void
+NrInterference::RemoveFromOutOfCellInterfCov(Ptr<const SpectrumSignalParameters> signal)
+{
+    if (m_outOfCellSignals.erase(PeekPointer(signal)) == 0)
+    {
+        return;
+    }
+    if (m_outOfCellSignals.empty())
+    {
+        // Restart from an exact zero, so that the rounding errors of the subtractions do not
+        // accumulate over the simulation
+        m_outOfCellInterfCov = NrCovMat{};
+    }
+    else
+    {
+        m_outOfCellInterfCov -= GetSignalCov(signal);
+    }
 }
 
 void
@@ -397,8 +442,22 @@ NrInterference::AddMimoChunkProcessor(Ptr<NrMimoChunkProcessor> cp)
     m_mimoChunkProcessors.push_back(cp);
 }
 
+void
+NrInterference::SetSignalCovCache(Ptr<NrMimoSignalCovCache> cache)
+{
+    NS_LOG_FUNCTION(this << cache);
+    NS_ASSERT_MSG(m_signalCovs.empty(), "The cache cannot be changed while signals use it");
+    m_signalCovCache = cache;
+}
+
+Ptr<NrMimoSignalCovCache>
+NrInterference::GetSignalCovCache() const
+{
+    return m_signalCovCache;
+}
+
 NrCovMat
-NrInterference::CalcOutOfCellInterfCov() const
+NrInterference::CalcOutOfCellInterfCov()
 {
     // Extract dimensions from first receive signal. Interference signals have equal dimensions
     NS_ASSERT_MSG(!(m_rxSignalsMimo.empty()), "At least one receive signal is required");
@@ -407,27 +466,40 @@ NrInterference::CalcOutOfCellInterfCov() const
     auto nRbs = firstSignal->spectrumChannelMatrix->GetNumPages();
     auto nRxPorts = firstSignal->spectrumChannelMatrix->GetNumRows();
 
-    // Create white noise covariance matrix
-    auto allSignalsNoiseCov = NrCovMat{ComplexMatrixArray(nRxPorts, nRxPorts, nRbs)};
-    for (size_t iRb = 0; iRb < nRbs; iRb++)
+    // Add the external interference signals that are not yet part of the running covariance
+    for (const auto& intfSignal : m_allSignalsMimo)
     {
-        for (size_t iRxPort = 0; iRxPort < nRxPorts; iRxPort++)
+        if (m_rxSignalSet.count(PeekPointer(intfSignal)) ||
+            m_outOfCellSignals.count(PeekPointer(intfSignal)))
+        {
+            // This is one of the signals in the current cell, or it is already accounted
+            continue;
+        }
+        const auto& intfCov = GetSignalCov(intfSignal);
+        if (m_outOfCellSignals.empty())
         {
-            allSignalsNoiseCov(iRxPort, iRxPort, iRb) = m_noise->ValuesAt(iRb);
+            m_outOfCellInterfCov = intfCov;
         }
+        else
+        {
+            m_outOfCellInterfCov += intfCov;
+        }
+        m_outOfCellSignals.insert(PeekPointer(intfSignal));
     }
 
-    // Add all external interference signals to the covariance matrix
-    for (const auto& intfSignal : m_allSignalsMimo)
+    // Add the white noise to the interference covariance matrix
+    auto allSignalsNoiseCov = m_outOfCellSignals.empty()
+                                  ? NrCovMat{ComplexMatrixArray(nRxPorts, nRxPorts, nRbs)}
+                                  : m_outOfCellInterfCov;
+    NS_ASSERT_MSG(allSignalsNoiseCov.GetNumPages() == nRbs &&
+                      allSignalsNoiseCov.GetNumRows() == nRxPorts,
+                  "Interference signals must have the dimensions of the receive signals");
+    for (size_t iRb = 0; iRb < nRbs; iRb++)
     {
-        if (std::find(m_rxSignalsMimo.begin(), m_rxSignalsMimo.end(), intfSignal) !=
-            m_rxSignalsMimo.end())
+        for (size_t iRxPort = 0; iRxPort < nRxPorts; iRxPort++)
         {
-            // This is one of the signals in the current cell
-            continue;
+            allSignalsNoiseCov(iRxPort, iRxPort, iRb) += m_noise->ValuesAt(iRb);
         }
-
-        AddInterference(allSignalsNoiseCov, intfSignal);
     }
     return allSignalsNoiseCov;
 }
@@ -449,15 +521,37 @@ NrInterference::CalcCurrInterfCov(Ptr<const SpectrumSignalParameters> rxSignal,
                        m_allSignalsMimo.end()),
                       "RX signal already deleted from m_allSignalsMimo");
 
-        AddInterference(interfNoiseCov, otherSignal);
+        interfNoiseCov += GetSignalCov(otherSignal);
     }
     return interfNoiseCov;
 }
 
-void
-NrInterference::AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParameters> signal) const
+const NrCovMat&
+NrInterference::GetSignalCov(Ptr<const SpectrumSignalParameters> signal) const
 {
+    auto it = m_signalCovs.find(PeekPointer(signal));
+    if (it == m_signalCovs.end())
+    {
+        it = m_signalCovs.emplace(PeekPointer(signal), m_signalCovCache->Acquire(signal)).first;
+    }
+    return *(it->second);
+}
+
+Ptr<const NrCovMat>
+NrMimoSignalCovCache::Acquire(Ptr<const SpectrumSignalParameters> signal)
+{
+    auto& entry = m_entries[PeekPointer(signal)];
+    entry.numUsers++;
+    if (entry.cov)
+    {
+        return entry.cov;
+    }
+
+    NS_ASSERT_MSG(signal->spectrumChannelMatrix, "signal must have a channel matrix");
     const auto& chanSpct = *(signal->spectrumChannelMatrix);
+    auto covMat = Create<NrCovMat>(ComplexMatrixArray(chanSpct.GetNumRows(),
+                                                      chanSpct.GetNumRows(),
+                                                      chanSpct.GetNumPages()));
     if (signal->precodingMatrix)
     {
         auto& precMats = *(signal->precodingMatrix);
@@ -466,11 +560,24 @@ NrInterference::AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParame
         NS_ASSERT_MSG(precMats.GetNumPages() == chanSpct.GetNumPages(),
                       "dim mismatch " << precMats.GetNumPages() << " vs "
                                       << chanSpct.GetNumPages());
-        covMat.AddInterferenceSignal(chanSpct * precMats);
+        covMat->AddInterferenceSignal(chanSpct * precMats);
     }
     else
     {
-        covMat.AddInterferenceSignal(chanSpct);
+        covMat->AddInterferenceSignal(chanSpct);
+    }
+    entry.cov = covMat;
+    return entry.cov;
+}
+
+void
+NrMimoSignalCovCache::Release(Ptr<const SpectrumSignalParameters> signal)
+{
+    auto it = m_entries.find(PeekPointer(signal));
+    NS_ASSERT_MSG(it != m_entries.end(), "The signal has no user");
+    if (--it->second.numUsers == 0)
+    {
+        m_entries.erase(it);
     }
 }
 
@@ -478,14 +585,14 @@ NrSinrMatrix
 NrInterference::ComputeSinr(NrCovMat& outOfCellInterfCov,
                             Ptr<const SpectrumSignalParameters> rxSignal) const
 {
-    // Calculate the interference+noise (I+N) covariance matrix for this signal,
-    // including interference from other RX signals
-    auto interfNoiseCov = CalcCurrInterfCov(rxSignal, outOfCellInterfCov);
-
     // Interference whitening: normalize the signal such that interference + noise covariance matrix
-    // is the identity matrix
+    // is the identity matrix. The interference+noise (I+N) covariance matrix for this signal
+    // includes the interference from other RX signals, if any.
     const auto& chanSpct = *(rxSignal->spectrumChannelMatrix);
-    auto intfNormChanMat = interfNoiseCov.CalcIntfNormChannel(chanSpct);
+    auto intfNormChanMat =
+        (m_rxSignalsMimo.size() == 1)
+            ? outOfCellInterfCov.CalcIntfNormChannel(chanSpct)
+            : CalcCurrInterfCov(rxSignal, outOfCellInterfCov).CalcIntfNormChannel(chanSpct);
 
     // Get the precoding matrix or create a dummy precoding matrix
     ComplexMatrixArray precMat;
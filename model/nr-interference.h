@@ -7,6 +7,8 @@
 #ifndef NR_INTERFERENCE_H
 #define NR_INTERFERENCE_H
 
+#include "nr-mimo-matrices.h"
+
 #include <ns3/lte-interference.h>
 #include <ns3/nstime.h>
 #include <ns3/object.h>
@@ -15,17 +17,58 @@
 #include <ns3/traced-callback.h>
 #include <ns3/vector.h>
 
+#include <unordered_map>
+#include <unordered_set>
+
 namespace ns3
 {
 
 // Signal ID increment used in LteInterference
 static constexpr uint32_t NR_LTE_SIGNALID_INCR = 0x10000000;
 
-class NrCovMat;
-class NrSinrMatrix;
 class NrErrorModel;
 class NrMimoChunkProcessor;
 
+/**
+ * \ingroup spectrum
+ *
+ * \brief Cache of the covariance matrices of the MIMO signals perceived by a device
+ *
+ * The covariance matrix of a signal, i.e., (H * P) * (H * P)' for its channel H and its
+ * precoding P, does not change during the lifetime of the signal. The cache is shared by the
+ * NrInterference instances of a device (data, control and SRS), so that each matrix is computed
+ * once per signal. Each instance registers itself as a user of the signals it needs, and the
+ * matrix is released when the last user ends it.
+ */
+class NrMimoSignalCovCache : public SimpleRefCount<NrMimoSignalCovCache>
+{
+  public:
+    /**
+     * \brief Get the covariance matrix of a signal, computing it if it is not cached yet, and
+     * register a new user of it
+     * \param signal the signal, which must stay alive until the user releases it
+     * \return the covariance matrix of the signal
+     */
+    Ptr<const NrCovMat> Acquire(Ptr<const SpectrumSignalParameters> signal);
+
+    /**
+     * \brief Unregister a user of a signal, and erase its covariance matrix if it was the last
+     * \param signal the signal
+     */
+    void Release(Ptr<const SpectrumSignalParameters> signal);
+
+  private:
+    /// An entry of the cache
+    struct Entry
+    {
+        Ptr<const NrCovMat> cov; ///< The covariance matrix of the signal
+        uint32_t numUsers{0};    ///< The number of users of the entry
+    };
+
+    /// The entries, indexed by signal
+    std::unordered_map<const SpectrumSignalParameters*, Entry> m_entries;
+};
+
 /**
  * \ingroup spectrum
  *
@@ -120,12 +163,31 @@ class NrInterference : public LteInterference
     /// \param cp The NrMimoChunkProcessor to be added
     virtual void AddMimoChunkProcessor(Ptr<NrMimoChunkProcessor> cp);
 
+    /// \brief Set the cache of the covariance matrices of the MIMO signals, to share it with the
+    /// other NrInterference instances of the device. By default, each instance has its own.
+    /// \param cache the cache
+    void SetSignalCovCache(Ptr<NrMimoSignalCovCache> cache);
+
+    /// \return the cache of the covariance matrices of the MIMO signals
+    Ptr<NrMimoSignalCovCache> GetSignalCovCache() const;
+
   private:
     /// \brief Calculate interference-plus-noise covariance matrix for signals not in m_rxSignals
-    /// This function computes the interference signals from all out-of-cell interferers. The
-    /// intra-cell interference signals that are part of m_rxSignals are skipped.
+    /// The covariance of the out-of-cell interferers is maintained incrementally: the signals
+    /// that are not part of it yet are added, and the noise is added to a copy of it.
+    /// The intra-cell interference signals that are part of m_rxSignals are skipped.
     /// \return the interference+noise covariance matrix for out-of-cell interference
-    NrCovMat CalcOutOfCellInterfCov() const;
+    NrCovMat CalcOutOfCellInterfCov();
+
+    /// \brief Get the covariance matrix of a signal, computing it if it is not cached yet
+    /// \param signal the signal
+    /// \return the covariance matrix of the signal (channel including precoding)
+    const NrCovMat& GetSignalCov(Ptr<const SpectrumSignalParameters> signal) const;
+
+    /// \brief Remove a signal from the running covariance of the out-of-cell interference, if it
+    /// is part of it
+    /// \param signal the signal
+    void RemoveFromOutOfCellInterfCov(Ptr<const SpectrumSignalParameters> signal);
 
     /// \brief Add the remaining interference to the interference-and-noise covariance matrix
     /// This function is required for MU-MIMO UL, where the signal from a different UE within the
@@ -136,10 +198,6 @@ class NrInterference : public LteInterference
     NrCovMat CalcCurrInterfCov(Ptr<const SpectrumSignalParameters> rxSignal,
                                const NrCovMat& outOfCellInterfCov) const;
 
-    /// \brief Add the covariance of the signal to an existing covariance matrix
-    /// \param covMat the existing interference-and-noise covariance matrix
-    /// \param signal the signal to be added
-    void AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParameters> signal) const;
 
     /// \brief Compute the SINR of the current receive signal
     /// \param outOfCellInterfCov the covariance matrix of out-of-cell signals, plus noise
@@ -154,6 +212,21 @@ class NrInterference : public LteInterference
     /// Stores the params of all incoming signals intended for this receiver
     std::vector<Ptr<const SpectrumSignalParameters>> m_rxSignalsMimo;
 
+    /// The signals of m_rxSignalsMimo, for a constant-time in-cell check
+    std::unordered_set<const SpectrumSignalParameters*> m_rxSignalSet;
+
+    /// Running sum of the covariance matrices of the out-of-cell interference signals (no noise)
+    NrCovMat m_outOfCellInterfCov;
+
+    /// The signals whose covariance matrix is part of m_outOfCellInterfCov
+    std::unordered_set<const SpectrumSignalParameters*> m_outOfCellSignals;
+
+    /// The covariance matrices of the signals in m_allSignalsMimo acquired from m_signalCovCache
+    mutable std::unordered_map<const SpectrumSignalParameters*, Ptr<const NrCovMat>> m_signalCovs;
+
+    /// The cache of the covariance matrices, shared with the other instances of the device
+    Ptr<NrMimoSignalCovCache> m_signalCovCache;
+
     /// The processor instances that are notified whenever a new interference chunk is calculated
     std::list<Ptr<NrMimoChunkProcessor>> m_mimoChunkProcessors;
 
@@ -0,0 +1,191 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-l2sm-kernels.h"
+
+#include "fast-exp.h"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Build the kernels for several ISAs, and select the best one at load time. The
+// kernels are flattened, so that exp21d and the lambdas are inlined in each version.
+// Note that the vectorization of exp21d needs the 64-bit integer conversions of
+// AVX-512DQ: with AVX2, only the masking and the accumulation are vectorized.
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones) && __has_attribute(flatten)
+#define NR_L2SM_MULTIVERSION 1
+#define NR_L2SM_TARGET_CLONES                                                                      \
+    __attribute__((target_clones("arch=skylake-avx512", "arch=haswell", "default"), flatten))
+#endif
+#endif
+
+#ifndef NR_L2SM_TARGET_CLONES
+#define NR_L2SM_TARGET_CLONES
+#endif
+
+namespace ns3
+{
+
+/**
+ * \brief Number of RBs processed per block, i.e., the number of bits of a mask word
+ */
+static constexpr std::size_t L2SM_BLOCK = 64;
+
+/**
+ * \brief Number of independent accumulators
+ *
+ * It is a multiple of the number of doubles in the widest vector register, and
+ * it fixes the summation order, so that every ISA gives the same result.
+ */
+static constexpr std::size_t L2SM_LANES = 8;
+
+/**
+ * \brief Value of a uniform table for a SINR
+ * \param table the table
+ * \param sinr the SINR (linear)
+ * \return the value of the table
+ */
+static inline double
+UniformTableValue(const NrL2smKernels::UniformTable& table, double sinr)
+{
+    // The table is read for every SINR, so that the loops are vectorized: above the last
+    // abscissa, read it at the first one, and discard the value
+    double s = (sinr > table.m_axisLast) ? table.m_axisFirst : sinr;
+    double idx = std::max(0.0, std::floor((s - table.m_axisFirst) * table.m_scaling + 1));
+    NS_ASSERT_MSG(idx < table.m_size, "MI map out of data");
+    double value = table.m_values[static_cast<uint32_t>(idx)];
+    return (sinr > table.m_axisLast) ? 1.0 : value;
+}
+
+/**
+ * \brief Accumulate f(sinr) over a block of L2SM_BLOCK RBs
+ *
+ * The function is first evaluated for all the RBs of the block (this is the
+ * loop that the compiler vectorizes), and then the masked values are added to
+ * the accumulators, always in the same order.
+ *
+ * \param sinr the SINR of the L2SM_BLOCK RBs
+ * \param word the mask word of the block
+ * \param f the function to accumulate
+ * \param acc the accumulators
+ */
+template <typename F>
+static inline void
+AccumulateBlock(const double* sinr, uint64_t word, const F& f, double (&acc)[L2SM_LANES])
+{
+    double values[L2SM_BLOCK];
+    for (std::size_t l = 0; l < L2SM_BLOCK; ++l)
+    {
+        double v = f(sinr[l]);
+        values[l] = ((word >> l) & 1U) ? v : 0.0;
+    }
+    for (std::size_t k = 0; k < L2SM_BLOCK; k += L2SM_LANES)
+    {
+        for (std::size_t l = 0; l < L2SM_LANES; ++l)
+        {
+            acc[l] += values[k + l];
+        }
+    }
+}
+
+/**
+ * \brief Sum f(sinr) over the RBs set in a mask
+ * \param sinr the SINR of each RB
+ * \param rbMask the mask (the bits after the last RB must be 0)
+ * \param nRbs the number of RBs
+ * \param f the function to accumulate
+ * \return the sum
+ */
+template <typename F>
+static inline double
+MaskedSum(const double* sinr, const uint64_t* rbMask, std::size_t nRbs, const F& f)
+{
+    double acc[L2SM_LANES] = {};
+    std::size_t i = 0;
+    for (; i + L2SM_BLOCK <= nRbs; i += L2SM_BLOCK)
+    {
+        AccumulateBlock(sinr + i, rbMask[i / L2SM_BLOCK], f, acc);
+    }
+    if (i < nRbs)
+    {
+        // Last partial block: pad it with zeros, the mask discards the padding
+        double tail[L2SM_BLOCK] = {};
+        std::copy(sinr + i, sinr + nRbs, tail);
+        AccumulateBlock(tail, rbMask[i / L2SM_BLOCK], f, acc);
+    }
+
+    double sum = 0.0;
+    for (double v : acc)
+    {
+        sum += v;
+    }
+    return sum;
+}
+
+void
+NrL2smKernels::FillRbMask(const std::vector<int>& map,
+                          std::size_t nRbs,
+                          std::vector<uint64_t>& mask)
+{
+    mask.assign((nRbs + L2SM_BLOCK - 1) / L2SM_BLOCK, 0);
+    for (int rb : map)
+    {
+        NS_ASSERT(rb >= 0 && static_cast<std::size_t>(rb) < nRbs);
+        mask[rb / L2SM_BLOCK] |= uint64_t{1} << (rb % L2SM_BLOCK);
+    }
+}
+
+NR_L2SM_TARGET_CLONES void
+NrL2smKernels::SinrExpSums(const double* sinr,
+                           const uint64_t* rbMask,
+                           std::size_t nRbs,
+                           const double* betas,
+                           std::size_t nBetas,
+                           double* sums)
+{
+    for (std::size_t b = 0; b < nBetas; ++b)
+    {
+        const double beta = betas[b];
+        sums[b] = MaskedSum(sinr, rbMask, nRbs, [beta](double s) { return exp21d(-s / beta); });
+    }
+}
+
+NR_L2SM_TARGET_CLONES void
+NrL2smKernels::TableSums(const double* sinr,
+                         const uint64_t* rbMask,
+                         std::size_t nRbs,
+                         const UniformTable* tables,
+                         std::size_t nTables,
+                         double* sums)
+{
+    for (std::size_t t = 0; t < nTables; ++t)
+    {
+        const UniformTable& table = tables[t];
+        sums[t] = MaskedSum(sinr, rbMask, nRbs, [&table](double s) {
+            return UniformTableValue(table, s);
+        });
+    }
+}
+
+std::string
+NrL2smKernels::GetIsaName()
+{
+#ifdef NR_L2SM_MULTIVERSION
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return "avx512";
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return "avx2";
+    }
+#endif
+    return "default";
+}
+
+} // namespace ns3
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_L2SM_KERNELS_H
+#define NR_L2SM_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup error-models
+ * \brief Batched kernels for the link-to-system mapping of the error models
+ *
+ * The effective SINR (EESM) and the mutual information (MIESM) of a transport
+ * block are sums, over the RBs allocated to it, of a non-linear function of the
+ * SINR of each RB. These kernels compute such sums from a dense array of SINR
+ * values (one per RB, as stored in a SpectrumValue) and a bitmask of the RBs to
+ * take into account, for several betas (EESM) or modulations (MIESM) at once.
+ *
+ * The loops are written to be vectorized by the compiler. When the compiler
+ * and the platform support function multi-versioning, the kernels are built
+ * for AVX-512, AVX2 and the baseline ISA, and the best version for the CPU
+ * is picked at runtime. The accumulation order is fixed by the code, and
+ * not by the ISA in use, so the results do not depend on the CPU.
+ */
+class NrL2smKernels
+{
+  public:
+    /**
+     * \brief A look-up table with uniformly spaced abscissas, as the ones of
+     * the MI curves of NrLteMiErrorModel
+     *
+     * For a SINR s, the value is 1.0 if s is above the last abscissa, otherwise
+     * it is m_values[max(0, floor((s - m_axisFirst) * m_scaling + 1))].
+     */
+    struct UniformTable
+    {
+        const double* m_values{nullptr}; //!< Values of the table
+        uint32_t m_size{0};              //!< Number of values
+        double m_axisFirst{0.0};         //!< First abscissa
+        double m_axisLast{0.0};          //!< Last abscissa
+        double m_scaling{0.0};           //!< (m_size - 1) / (m_axisLast - m_axisFirst)
+    };
+
+    /**
+     * \brief Fill a bitmask of RBs from a list of RB indexes
+     * \param map the indexes of the RBs
+     * \param nRbs the total number of RBs
+     * \param mask the bitmask to fill (bit i%64 of word i/64 is set if RB i is in map)
+     */
+    static void FillRbMask(const std::vector<int>& map,
+                           std::size_t nRbs,
+                           std::vector<uint64_t>& mask);
+
+    /**
+     * \brief Compute, for each beta, the sum over the masked RBs of exp(-sinr/beta)
+     * \param sinr the SINR (linear) of each RB
+     * \param rbMask the bitmask of the RBs to sum
+     * \param nRbs the number of RBs in sinr
+     * \param betas the betas
+     * \param nBetas the number of betas
+     * \param sums the output sums, one per beta
+     */
+    static void SinrExpSums(const double* sinr,
+                            const uint64_t* rbMask,
+                            std::size_t nRbs,
+                            const double* betas,
+                            std::size_t nBetas,
+                            double* sums);
+
+    /**
+     * \brief Compute, for each table, the sum over the masked RBs of the
+     * value of the table for the SINR of the RB
+     * \param sinr the SINR (linear) of each RB
+     * \param rbMask the bitmask of the RBs to sum
+     * \param nRbs the number of RBs in sinr
+     * \param tables the tables (e.g., MI for QPSK, 16QAM and 64QAM)
+     * \param nTables the number of tables
+     * \param sums the output sums, one per table
+     */
+    static void TableSums(const double* sinr,
+                          const uint64_t* rbMask,
+                          std::size_t nRbs,
+                          const UniformTable* tables,
+                          std::size_t nTables,
+                          double* sums);
+
+    /**
+     * \return the name of the ISA that the kernels use on this CPU
+     */
+    static std::string GetIsaName();
+};
+
+} // namespace ns3
+
+#endif // NR_L2SM_KERNELS_H
@@ -6,6 +6,8 @@
 
 #include "nr-lte-mi-error-model.h"
 
+#include "nr-l2sm-kernels.h"
+
 #include <ns3/log.h>
 
 #include <algorithm>
@@ -925,100 +927,91 @@ NrLteMiErrorModel::GetInstanceTypeId() const
     return NrLteMiErrorModel::GetTypeId();
 }
 
+/**
+ * \brief The MI curves of QPSK, 16QAM and 64QAM, in the format of the L2SM kernels
+ */
+static const NrL2smKernels::UniformTable MiTables[] = {
+    {MI_map_qpsk,
+     MI_MAP_QPSK_SIZE,
+     MI_map_qpsk_axis[0],
+     MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1],
+     (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1] - MI_map_qpsk_axis[0])},
+    {MI_map_16qam,
+     MI_MAP_16QAM_SIZE,
+     MI_map_16qam_axis[0],
+     MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1],
+     (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1] - MI_map_16qam_axis[0])},
+    {MI_map_64qam,
+     MI_MAP_64QAM_SIZE,
+     MI_map_64qam_axis[0],
+     MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1],
+     (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1] - MI_map_64qam_axis[0])},
+};
+
+/**
+ * \brief Get the index, in MiTables, of the MI curve of a MCS
+ * \param mcs the MCS
+ * \return 0 for QPSK, 1 for 16QAM, 2 for 64QAM
+ */
+static uint8_t
+GetMiTableIndex(uint8_t mcs)
+{
+    if (mcs <= MI_QPSK_MAX_ID)
+    {
+        return 0;
+    }
+    return (mcs <= MI_16QAM_MAX_ID) ? 1 : 2;
+}
+
 double
-NrLteMiErrorModel::Mib(const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
+NrLteMiErrorModel::Mib(const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs) const
 {
     NS_LOG_FUNCTION(sinr << &map << (uint32_t)mcs);
 
-    double MI;
-    double MIsum = 0.0;
-
-    for (int i : map)
+    if (map.empty())
     {
-        double sinrLin = sinr[i];
-        if (mcs <= MI_QPSK_MAX_ID) // QPSK
-        {
-            if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1])
-            {
-                MI = 1;
-            }
-            else
-            {
-                // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-                // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                // the scaling coefficient is always the same, so we use a static const
-                // to speed up the calculation
-                static const double scalingCoeffQpsk =
-                    (MI_MAP_QPSK_SIZE - 1) /
-                    (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1] - MI_map_qpsk_axis[0]);
-                double sinrIndexDouble = (sinrLin - MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-                uint32_t sinrIndex = std::max(0.0, std::floor(sinrIndexDouble));
-                NS_ASSERT_MSG(sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-                MI = MI_map_qpsk[sinrIndex];
-            }
-        }
-        else
-        {
-            if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID) // 16-QAM
-            {
-                if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1])
-                {
-                    MI = 1;
-                }
-                else
-                {
-                    // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                    // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                    // the scaling coefficient is always the same, so we use a static const
-                    // to speed up the calculation
-                    static const double scalingCoeff16qam =
-                        (MI_MAP_16QAM_SIZE - 1) /
-                        (MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1] - MI_map_16qam_axis[0]);
-                    double sinrIndexDouble =
-                        (sinrLin - MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                    uint32_t sinrIndex = std::max(0.0, std::floor(sinrIndexDouble));
-                    NS_ASSERT_MSG(sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                    MI = MI_map_16qam[sinrIndex];
-                }
-            }
-            else // 64-QAM
-            {
-                if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1])
-                {
-                    MI = 1;
-                }
-                else
-                {
-                    // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                    // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                    // the scaling coefficient is always the same, so we use a static const
-                    // to speed up the calculation
-                    static const double scalingCoeff64qam =
-                        (MI_MAP_64QAM_SIZE - 1) /
-                        (MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1] - MI_map_64qam_axis[0]);
-                    double sinrIndexDouble =
-                        (sinrLin - MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                    uint32_t sinrIndex = std::max(0.0, std::floor(sinrIndexDouble));
-                    NS_ASSERT_MSG(sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                    MI = MI_map_64qam[sinrIndex];
-                }
-            }
-        }
-        NS_LOG_LOGIC(" RB " << i << "Minimum SNR = " << 10 * std::log10(sinrLin) << " dB, "
-                            << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
-        MIsum += MI;
+        return 0.0;
     }
+
+    NrL2smKernels::FillRbMask(map, sinr.GetValuesN(), m_rbMask);
+
+    double MIsum = 0.0;
+    NrL2smKernels::TableSums(&(*sinr.ConstValuesBegin()),
+                             m_rbMask.data(),
+                             sinr.GetValuesN(),
+                             &MiTables[GetMiTableIndex(mcs)],
+                             1,
+                             &MIsum);
+
+    double MI = MIsum / map.size();
+    NS_LOG_LOGIC(" MI = " << MI);
+    return MI;
+}
+
+void
+NrLteMiErrorModel::MibPerModulation(const SpectrumValue& sinr,
+                                    const std::vector<int>& map,
+                                    std::array<double, 3>& mib) const
+{
+    NS_LOG_FUNCTION(sinr << &map);
+
+    mib.fill(0.0);
     if (map.empty())
     {
-        MI = 0;
+        return;
     }
-    else
+
+    NrL2smKernels::FillRbMask(map, sinr.GetValuesN(), m_rbMask);
+    NrL2smKernels::TableSums(&(*sinr.ConstValuesBegin()),
+                             m_rbMask.data(),
+                             sinr.GetValuesN(),
+                             MiTables,
+                             mib.size(),
+                             mib.data());
+    for (auto& v : mib)
     {
-        MI = MIsum / map.size();
+        v /= map.size();
     }
-
-    NS_LOG_LOGIC(" MI = " << MI);
-    return MI;
 }
 
 double
@@ -1066,59 +1059,9 @@ NrLteMiErrorModel::MappingMiBler(double mib, uint8_t ecrId, uint32_t cbSize)
     return bler;
 }
 
-Ptr<NrErrorModelOutput>
-NrLteMiErrorModel::GetTbDecodificationStats(const SpectrumValue& sinr,
-                                            const std::vector<int>& map,
-                                            uint32_t size,
-                                            uint8_t mcs,
-                                            const NrErrorModel::NrErrorModelHistory& history)
-{
-    return GetTbBitDecodificationStats(sinr, map, size * 8, mcs, history);
-}
-
-Ptr<NrErrorModelOutput>
-NrLteMiErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
-                                               const std::vector<int>& map,
-                                               uint32_t size,
-                                               uint8_t mcs,
-                                               const NrErrorModel::NrErrorModelHistory& history)
+double
+NrLteMiErrorModel::TbErrorRate(double mi, double reff, uint32_t size, uint8_t mcs, bool isRetx)
 {
-    NS_LOG_FUNCTION(this);
-    NS_ABORT_MSG_IF(mcs > GetMaxMcs(), "MiErrorModel only works with MCS <= 28");
-
-    NS_LOG_DEBUG(" mcs " << static_cast<uint32_t>(mcs) << " TBSize in bit " << size);
-
-    double tbMi = Mib(sinr, map, mcs);
-    double MI = tbMi;
-    double Reff = 0.0;
-
-    if (!history.empty())
-    {
-        uint32_t codeBitsSum = 0;
-        double miSum = 0.0;
-        uint32_t infoBits = DynamicCast<NrLteMiErrorModelOutput>(history.front())
-                                ->m_infoBits; // information bits of the first TB
-
-        for (const Ptr<NrErrorModelOutput>& output : history)
-        {
-            Ptr<NrLteMiErrorModelOutput> miHistory = DynamicCast<NrLteMiErrorModelOutput>(output);
-            NS_ASSERT(miHistory != nullptr);
-
-            NS_LOG_DEBUG(" Sum MI " << miHistory->m_mi << " Ci " << miHistory->m_codeBits
-                                    << " infoBits: " << miHistory->m_infoBits);
-
-            codeBitsSum += miHistory->m_codeBits;
-            miSum += (miHistory->m_mi * miHistory->m_codeBits);
-        }
-
-        codeBitsSum += size / McsEcrTable[mcs];
-        miSum += tbMi * (size / McsEcrTable[mcs]);
-        Reff = infoBits / static_cast<double>(codeBitsSum);
-        MI = miSum / static_cast<double>(codeBitsSum);
-    }
-
-    NS_LOG_INFO(" MI " << MI << " Reff " << Reff << " HARQ " << history.size());
-
     // estimate CB size (according to sec 5.1.2 of TS 36.212)
     uint16_t Z = 6144; // max size of a codeblock (including CRC)
     uint32_t B = size;
@@ -1176,7 +1119,7 @@ NrLteMiErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
 
     double errorRate = 1.0;
     uint8_t ecrId = 0;
-    if (history.empty())
+    if (!isRetx)
     {
         // first tx -> get ECR from MCS
         ecrId = McsEcrBlerTableMapping[mcs];
@@ -1185,13 +1128,12 @@ NrLteMiErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
     }
     else
     {
-        NS_LOG_INFO("HARQ block no. " << history.size());
         // harq retx -> get closest ECR to Reff from available ones
         if (mcs <= MI_QPSK_MAX_ID)
         {
             // Modulation order 2
             uint8_t i = MI_QPSK_MAX_ID;
-            while ((BlerCurvesEcrMap[i] > Reff) && (i > 0))
+            while ((BlerCurvesEcrMap[i] > reff) && (i > 0))
             {
                 i--;
             }
@@ -1201,7 +1143,7 @@ NrLteMiErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
         {
             // Modulation order 4
             uint8_t i = MI_16QAM_MAX_ID;
-            while ((BlerCurvesEcrMap[i] > Reff) && (i > MI_QPSK_MAX_ID + 1))
+            while ((BlerCurvesEcrMap[i] > reff) && (i > MI_QPSK_MAX_ID + 1))
             {
                 i--;
             }
@@ -1211,7 +1153,7 @@ NrLteMiErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
         {
             // Modulation order 6
             uint8_t i = MI_64QAM_MAX_ID;
-            while ((BlerCurvesEcrMap[i] > Reff) && (i > MI_16QAM_MAX_ID + 1))
+            while ((BlerCurvesEcrMap[i] > reff) && (i > MI_16QAM_MAX_ID + 1))
             {
                 i--;
             }
@@ -1222,16 +1164,100 @@ NrLteMiErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
 
     if (C != 1)
     {
-        double cbler = MappingMiBler(MI, ecrId, Kplus);
+        double cbler = MappingMiBler(mi, ecrId, Kplus);
         errorRate *= pow(1.0 - cbler, Cplus);
-        cbler = MappingMiBler(MI, ecrId, Kminus);
+        cbler = MappingMiBler(mi, ecrId, Kminus);
         errorRate *= pow(1.0 - cbler, Cminus);
         errorRate = 1.0 - errorRate;
     }
     else
     {
-        errorRate = MappingMiBler(MI, ecrId, Kplus);
+        errorRate = MappingMiBler(mi, ecrId, Kplus);
+    }
+
+    return errorRate;
+}
+
+int16_t
+NrLteMiErrorModel::GetMaxMcsForTargetTbler(const SpectrumValue& sinr,
+                                           const std::vector<int>& map,
+                                           const std::function<uint32_t(uint8_t)>& tbSizeForMcs,
+                                           double targetTbler)
+{
+    NS_LOG_FUNCTION(this);
+
+    // The MI depends only on the modulation: compute it once for all of them
+    std::array<double, 3> mib;
+    MibPerModulation(sinr, map, mib);
+
+    uint8_t mcs = 0;
+    while (mcs <= GetMaxMcs())
+    {
+        double tbler =
+            TbErrorRate(mib[GetMiTableIndex(mcs)], 0.0, tbSizeForMcs(mcs) * 8, mcs, false);
+        if (tbler > targetTbler)
+        {
+            break;
+        }
+        mcs++;
     }
+    return static_cast<int16_t>(mcs) - 1;
+}
+
+Ptr<NrErrorModelOutput>
+NrLteMiErrorModel::GetTbDecodificationStats(const SpectrumValue& sinr,
+                                            const std::vector<int>& map,
+                                            uint32_t size,
+                                            uint8_t mcs,
+                                            const NrErrorModel::NrErrorModelHistory& history)
+{
+    return GetTbBitDecodificationStats(sinr, map, size * 8, mcs, history);
+}
+
+Ptr<NrErrorModelOutput>
+NrLteMiErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
+                                               const std::vector<int>& map,
+                                               uint32_t size,
+                                               uint8_t mcs,
+                                               const NrErrorModel::NrErrorModelHistory& history)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(mcs > GetMaxMcs(), "MiErrorModel only works with MCS <= 28");
+
+    NS_LOG_DEBUG(" mcs " << static_cast<uint32_t>(mcs) << " TBSize in bit " << size);
+
+    double tbMi = Mib(sinr, map, mcs);
+    double MI = tbMi;
+    double Reff = 0.0;
+
+    if (!history.empty())
+    {
+        uint32_t codeBitsSum = 0;
+        double miSum = 0.0;
+        uint32_t infoBits = DynamicCast<NrLteMiErrorModelOutput>(history.front())
+                                ->m_infoBits; // information bits of the first TB
+
+        for (const Ptr<NrErrorModelOutput>& output : history)
+        {
+            Ptr<NrLteMiErrorModelOutput> miHistory = DynamicCast<NrLteMiErrorModelOutput>(output);
+            NS_ASSERT(miHistory != nullptr);
+
+            NS_LOG_DEBUG(" Sum MI " << miHistory->m_mi << " Ci " << miHistory->m_codeBits
+                                    << " infoBits: " << miHistory->m_infoBits);
+
+            codeBitsSum += miHistory->m_codeBits;
+            miSum += (miHistory->m_mi * miHistory->m_codeBits);
+        }
+
+        codeBitsSum += size / McsEcrTable[mcs];
+        miSum += tbMi * (size / McsEcrTable[mcs]);
+        Reff = infoBits / static_cast<double>(codeBitsSum);
+        MI = miSum / static_cast<double>(codeBitsSum);
+    }
+
+    NS_LOG_INFO(" MI " << MI << " Reff " << Reff << " HARQ " << history.size());
+
+    double errorRate = TbErrorRate(MI, Reff, size, mcs, !history.empty());
 
     NS_LOG_DEBUG(" Error rate " << errorRate);
     Ptr<NrLteMiErrorModelOutput> ret = Create<NrLteMiErrorModelOutput>(errorRate);
@@ -9,6 +9,8 @@
 
 #include "nr-error-model.h"
 
+#include <array>
+
 namespace ns3
 {
 
@@ -101,6 +103,25 @@ class NrLteMiErrorModel : public NrErrorModel
                                                      uint8_t mcs,
                                                      const NrErrorModelHistory& history) override;
 
+    /**
+     * \brief Get the highest MCS whose TBLER, for a first transmission, does not
+     * exceed a target value
+     *
+     * The MI depends only on the modulation order of the MCS: it is computed
+     * once for QPSK, 16QAM and 64QAM, and then all the MCS are probed without
+     * creating any output.
+     *
+     * \param sinr SINR vector
+     * \param map RB map
+     * \param tbSizeForMcs function that returns the transport block size (bytes) for a MCS
+     * \param targetTbler the maximum TBLER allowed
+     * \return the highest MCS that guarantees the target TBLER, or -1 if even MCS 0 does not
+     */
+    int16_t GetMaxMcsForTargetTbler(const SpectrumValue& sinr,
+                                    const std::vector<int>& map,
+                                    const std::function<uint32_t(uint8_t)>& tbSizeForMcs,
+                                    double targetTbler) override;
+
     /**
      * \brief Get the SE for a given CQI, following the CQIs in LTE
      */
@@ -152,7 +173,32 @@ class NrLteMiErrorModel : public NrErrorModel
      * \param mcs the MCS of the TB
      * \return the mmib
      */
-    static double Mib(const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs);
+    double Mib(const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs) const;
+
+    /**
+     * \brief compute the mmib (mean mutual information per bit) for the
+     * QPSK, 16QAM and 64QAM modulations at once
+     *
+     * \param sinr the perceived SINRs in the whole bandwidth
+     * \param map the actives RBs for the TB
+     * \param mib the mmib of QPSK, 16QAM and 64QAM, in this order
+     */
+    void MibPerModulation(const SpectrumValue& sinr,
+                          const std::vector<int>& map,
+                          std::array<double, 3>& mib) const;
+
+    /**
+     * \brief compute the TBLER for a given mmib, taking into account the TC
+     * block segmentation as per TS 36.212 Sect. 5.1.2
+     *
+     * \param mi the mmib of the TB (after HARQ combining, if any)
+     * \param reff the effective code rate after HARQ combining (used only for retx)
+     * \param size the size of the TB (bit)
+     * \param mcs the MCS of the TB
+     * \param isRetx true if the TB is a retransmission
+     * \return the transport block error rate
+     */
+    static double TbErrorRate(double mi, double reff, uint32_t size, uint8_t mcs, bool isRetx);
 
     /**
      * \brief map the mmib (mean mutual information per bit) into CBLER for
@@ -164,6 +210,8 @@ class NrLteMiErrorModel : public NrErrorModel
      * \return the code block error rate
      */
     static double MappingMiBler(double mib, uint8_t ecrId, uint32_t cbSize);
+
+    mutable std::vector<uint64_t> m_rbMask; //!< Scratch bitmask of the RBs of a TB
 };
 
 } // namespace ns3
@@ -15,12 +15,117 @@
 #include <ns3/log.h>
 
 #include <algorithm>
+#include <numeric>
 
 namespace ns3
 {
 NS_LOG_COMPONENT_DEFINE("NrMacSchedulerOfdma");
 NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerOfdma);
 
+namespace
+{
+
+/**
+ * \brief Heap of the UEs of a beam, ordered by the priority of the scheduler
+ *
+ * The UE at the top is the one that sorting the UEs with the compare function
+ * of the scheduler would put first. Ties are broken by the position of the UE
+ * in the vector, so that the order does not depend on the heap implementation.
+ * Only the key of the UE at the top can change between two accesses, which
+ * costs O(log N) to restore the heap, instead of O(N log N) to sort the UEs.
+ */
+class NrMacSchedulerOfdmaUeHeap
+{
+  public:
+    /**
+     * \brief Compare function of the scheduler
+     */
+    using CompareFn = std::function<bool(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                                         const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)>;
+
+    /**
+     * \brief Build the heap of the UEs
+     * \param ues the UEs, which must outlive the heap
+     * \param compare the compare function of the scheduler
+     */
+    NrMacSchedulerOfdmaUeHeap(const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ues,
+                              CompareFn compare)
+        : m_ues(ues),
+          m_compare(std::move(compare)),
+          m_heap(ues.size())
+    {
+        std::iota(m_heap.begin(), m_heap.end(), 0);
+        Rebuild();
+    }
+
+    /**
+     * \return true if there are no UEs left in the heap
+     */
+    bool IsEmpty() const
+    {
+        return m_heap.empty();
+    }
+
+    /**
+     * \return the index, in the UE vector, of the UE with the highest priority
+     */
+    std::size_t Top() const
+    {
+        return m_heap.front();
+    }
+
+    /**
+     * \brief Remove the UE with the highest priority
+     */
+    void Pop()
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), LowerPriorityFn());
+        m_heap.pop_back();
+    }
+
+    /**
+     * \brief Restore the heap after a change of the priority of the UE at the top
+     */
+    void UpdateTop()
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), LowerPriorityFn());
+        std::push_heap(m_heap.begin(), m_heap.end(), LowerPriorityFn());
+    }
+
+    /**
+     * \brief Restore the heap after a change of the priority of any UE
+     */
+    void Rebuild()
+    {
+        std::make_heap(m_heap.begin(), m_heap.end(), LowerPriorityFn());
+    }
+
+  private:
+    /**
+     * \return a function that tells if the UE a has a lower priority than the UE b
+     */
+    auto LowerPriorityFn() const
+    {
+        return [this](std::size_t a, std::size_t b) {
+            if (m_compare(m_ues[b], m_ues[a]))
+            {
+                return true;
+            }
+            if (m_compare(m_ues[a], m_ues[b]))
+            {
+                return false;
+            }
+            return a > b;
+        };
+    }
+
+    const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& m_ues; //!< The UEs
+    CompareFn m_compare;                                           //!< The compare function
+    std::vector<std::size_t> m_heap; //!< The heap of the indexes of the UEs
+};
+
+} // namespace
+
 TypeId
 NrMacSchedulerOfdma::GetTypeId()
 {
@@ -182,19 +287,23 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
             BeforeDlSched(ue, FTResources(rbgAssignable * beamSym, beamSym));
         }
 
+        // The UEs are picked from a heap: only the priority of the UE that gets an RBG changes
+        // from one iteration to the next one
+        NrMacSchedulerOfdmaUeHeap ueHeap(ueVector, GetUeCompareDlFn());
+        bool notAssignedUpdated = false;
         while (resources > 0)
         {
             GetFirst GetUe;
-            std::sort(ueVector.begin(), ueVector.end(), GetUeCompareDlFn());
-            auto schedInfoIt = ueVector.begin();
 
-            // Ensure fairness: pass over UEs which already has enough resources to transmit
-            while (schedInfoIt != ueVector.end())
+            // Ensure fairness: pass over UEs which already has enough resources to transmit.
+            // Their TB size does not change anymore, so they are removed from the heap.
+            while (!ueHeap.IsEmpty())
             {
-                uint32_t bufQueueSize = schedInfoIt->second;
-                if (GetUe(*schedInfoIt)->m_dlTbSize >= std::max(bufQueueSize, 10U))
+                const auto& ue = ueVector[ueHeap.Top()];
+                uint32_t bufQueueSize = ue.second;
+                if (GetUe(ue)->m_dlTbSize >= std::max(bufQueueSize, 10U))
                 {
-                    schedInfoIt++;
+                    ueHeap.Pop();
                 }
                 else
                 {
@@ -204,34 +313,46 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
 
             // In the case that all the UE already have their requirements fulfilled,
             // then stop the beam processing and pass to the next
-            if (schedInfoIt == ueVector.end())
+            if (ueHeap.IsEmpty())
             {
                 break;
             }
+            auto& schedInfo = ueVector[ueHeap.Top()];
 
             // Assign 1 RBG for each available symbols for the beam,
             // and then update the count of available resources
-            GetUe(*schedInfoIt)->m_dlRBG += rbgAssignable;
+            GetUe(schedInfo)->m_dlRBG += rbgAssignable;
             assigned.m_rbg += rbgAssignable;
 
-            GetUe(*schedInfoIt)->m_dlSym = beamSym;
+            GetUe(schedInfo)->m_dlSym = beamSym;
             assigned.m_sym = beamSym;
 
             resources -= 1; // Resources are RBG, so they do not consider the beamSym
 
             // Update metrics
             NS_LOG_DEBUG("Assigned " << rbgAssignable << " DL RBG, spanned over " << beamSym
-                                     << " SYM, to UE " << GetUe(*schedInfoIt)->m_rnti);
-            AssignedDlResources(*schedInfoIt, FTResources(rbgAssignable, beamSym), assigned);
+                                     << " SYM, to UE " << GetUe(schedInfo)->m_rnti);
+            AssignedDlResources(schedInfo, FTResources(rbgAssignable, beamSym), assigned);
 
             // Update metrics for the unsuccessful UEs (who did not get any resource in this
-            // iteration)
-            for (auto& ue : ueVector)
+            // iteration). The metrics of a UE depend only on its own resources, which do not
+            // change when it does not get any, so they are updated only after the first
+            // assignment: afterwards, the update would give the same metrics again.
+            if (!notAssignedUpdated)
             {
-                if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                for (auto& ue : ueVector)
                 {
-                    NotAssignedDlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                    if (GetUe(ue)->m_rnti != GetUe(schedInfo)->m_rnti)
+                    {
+                        NotAssignedDlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                    }
                 }
+                notAssignedUpdated = true;
+                ueHeap.Rebuild();
+            }
+            else
+            {
+                ueHeap.UpdateTop();
             }
         }
     }
@@ -274,19 +395,23 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
             BeforeUlSched(ue, FTResources(rbgAssignable * beamSym, beamSym));
         }
 
+        // The UEs are picked from a heap: only the priority of the UE that gets an RBG changes
+        // from one iteration to the next one
+        NrMacSchedulerOfdmaUeHeap ueHeap(ueVector, GetUeCompareUlFn());
+        bool notAssignedUpdated = false;
         while (resources > 0)
         {
             GetFirst GetUe;
-            std::sort(ueVector.begin(), ueVector.end(), GetUeCompareUlFn());
-            auto schedInfoIt = ueVector.begin();
 
-            // Ensure fairness: pass over UEs which already has enough resources to transmit
-            while (schedInfoIt != ueVector.end())
+            // Ensure fairness: pass over UEs which already has enough resources to transmit.
+            // Their TB size does not change anymore, so they are removed from the heap.
+            while (!ueHeap.IsEmpty())
             {
-                uint32_t bufQueueSize = schedInfoIt->second;
-                if (GetUe(*schedInfoIt)->m_ulTbSize >= std::max(bufQueueSize, 12U))
+                const auto& ue = ueVector[ueHeap.Top()];
+                uint32_t bufQueueSize = ue.second;
+                if (GetUe(ue)->m_ulTbSize >= std::max(bufQueueSize, 12U))
                 {
-                    schedInfoIt++;
+                    ueHeap.Pop();
                 }
                 else
                 {
@@ -296,34 +421,46 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
 
             // In the case that all the UE already have their requirements fulfilled,
             // then stop the beam processing and pass to the next
-            if (schedInfoIt == ueVector.end())
+            if (ueHeap.IsEmpty())
             {
                 break;
             }
+            auto& schedInfo = ueVector[ueHeap.Top()];
 
             // Assign 1 RBG for each available symbols for the beam,
             // and then update the count of available resources
-            GetUe(*schedInfoIt)->m_ulRBG += rbgAssignable;
+            GetUe(schedInfo)->m_ulRBG += rbgAssignable;
             assigned.m_rbg += rbgAssignable;
 
-            GetUe(*schedInfoIt)->m_ulSym = beamSym;
+            GetUe(schedInfo)->m_ulSym = beamSym;
             assigned.m_sym = beamSym;
 
             resources -= 1; // Resources are RBG, so they do not consider the beamSym
 
             // Update metrics
             NS_LOG_DEBUG("Assigned " << rbgAssignable << " UL RBG, spanned over " << beamSym
-                                     << " SYM, to UE " << GetUe(*schedInfoIt)->m_rnti);
-            AssignedUlResources(*schedInfoIt, FTResources(rbgAssignable, beamSym), assigned);
+                                     << " SYM, to UE " << GetUe(schedInfo)->m_rnti);
+            AssignedUlResources(schedInfo, FTResources(rbgAssignable, beamSym), assigned);
 
             // Update metrics for the unsuccessful UEs (who did not get any resource in this
-            // iteration)
-            for (auto& ue : ueVector)
+            // iteration). The metrics of a UE depend only on its own resources, which do not
+            // change when it does not get any, so they are updated only after the first
+            // assignment: afterwards, the update would give the same metrics again.
+            if (!notAssignedUpdated)
             {
-                if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                for (auto& ue : ueVector)
                 {
-                    NotAssignedUlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                    if (GetUe(ue)->m_rnti != GetUe(schedInfo)->m_rnti)
+                    {
+                        NotAssignedUlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                    }
                 }
+                notAssignedUpdated = true;
+                ueHeap.Rebuild();
+            }
+            else
+            {
+                ueHeap.UpdateTop();
             }
         }
     }
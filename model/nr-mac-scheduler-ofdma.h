@@ -42,6 +42,14 @@ namespace ns3
  * are in the functions AssignDLRBG() and AssignULRBG().
  * The choice of the UEs to be scheduled is, however, demanded to the subclasses.
  *
+ * Inside a beam, the RBGs are assigned one at a time to the UE that comes first
+ * with the compare function of the subclass (GetUeCompareDlFn() or
+ * GetUeCompareUlFn()). The UEs are kept in a heap, in which only the UE that
+ * gets the RBG is moved, so that an RBG costs O(log N) for N UEs.
+ * NotAssignedDlResources() and NotAssignedUlResources() are called once per UE
+ * and beam, after the first assignment: the metrics they update must depend only
+ * on the resources of the UE, and on the number of symbols of the beam.
+ *
  * The DCI is created by CreateDlDci() or CreateUlDci(), which call CreateDci()
  * to perform the "hard" work.
  *
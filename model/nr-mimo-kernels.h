@@ -0,0 +1,172 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_MIMO_KERNELS_H
+#define NR_MIMO_KERNELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+
+namespace ns3
+{
+
+/// \ingroup Matrices
+/// \brief Small dense kernels shared by the MIMO matrix computations
+///
+/// Internal to the nr module: the Cholesky decomposition, the forward substitution and the
+/// products of channel and precoding matrices that NrCovMat and NrIntfNormChanMat use, with
+/// and without Eigen. The matrices are column-major, as the pages of a ComplexMatrixArray.
+///
+/// The size of the square matrices is a template parameter: either FixedDim<N>, for which the
+/// compiler unrolls the loops and the matrices fit on the stack, or size_t, for a size known
+/// only at runtime.
+class NrMimoKernels
+{
+  public:
+    /// A size known at compile time
+    template <size_t N>
+    using FixedDim = std::integral_constant<size_t, N>;
+
+    /// \brief Complex product a * b, without the checks for infinite and NaN values of the
+    /// std::complex product, which prevent inlining
+    /// \param a the first factor
+    /// \param b the second factor
+    /// \return a * b
+    static inline std::complex<double> Mul(const std::complex<double>& a,
+                                           const std::complex<double>& b)
+    {
+        return {a.real() * b.real() - a.imag() * b.imag(),
+                a.real() * b.imag() + a.imag() * b.real()};
+    }
+
+    /// \brief Complex product conj(a) * b, without the checks for infinite and NaN values
+    /// \param a the first factor, conjugated
+    /// \param b the second factor
+    /// \return conj(a) * b
+    static inline std::complex<double> MulConj(const std::complex<double>& a,
+                                               const std::complex<double>& b)
+    {
+        return {a.real() * b.real() + a.imag() * b.imag(),
+                a.real() * b.imag() - a.imag() * b.real()};
+    }
+
+    /// \brief Compute the product of a channel matrix and the columns of a precoder
+    /// \param chan the channel matrix (dim: nRx x nTx)
+    /// \param nRx the number of receive ports
+    /// \param nTx the number of transmit ports
+    /// \param prec the precoder (dim: nTx x nCols)
+    /// \param nCols the number of columns of the precoder
+    /// \param out the product chan * prec (dim: nRx x nCols)
+    static inline void ChanTimesPrec(const std::complex<double>* chan,
+                                     size_t nRx,
+                                     size_t nTx,
+                                     const std::complex<double>* prec,
+                                     size_t nCols,
+                                     std::complex<double>* out)
+    {
+        for (size_t c = 0; c < nCols; c++)
+        {
+            auto outCol = out + c * nRx;
+            std::fill(outCol, outCol + nRx, std::complex<double>{0.0, 0.0});
+            for (size_t j = 0; j < nTx; j++)
+            {
+                const auto p = prec[c * nTx + j];
+                auto chanCol = chan + j * nRx;
+                for (size_t i = 0; i < nRx; i++)
+                {
+                    outCol[i] += Mul(chanCol[i], p);
+                }
+            }
+        }
+    }
+
+    /// \brief Compute the lower triangle of I + hp' * hp
+    /// \param n the number of columns of hp
+    /// \param hp a matrix (dim: nRx x n)
+    /// \param nRx the number of rows of hp
+    /// \param gram the lower triangle of I + hp' * hp (dim: n x n)
+    template <class Dim>
+    static inline void GramPlusIdentity(Dim n,
+                                        const std::complex<double>* hp,
+                                        size_t nRx,
+                                        std::complex<double>* gram)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            for (size_t i = j; i < n; i++)
+            {
+                std::complex<double> g{i == j ? 1.0 : 0.0, 0.0};
+                for (size_t r = 0; r < nRx; r++)
+                {
+                    g += MulConj(hp[i * nRx + r], hp[j * nRx + r]);
+                }
+                gram[j * n + i] = g;
+            }
+        }
+    }
+
+    /// \brief Cholesky decomposition A = L * L' of a n x n Hermitian positive definite matrix
+    /// \param n the size of the matrix
+    /// \param a the matrix; only its lower triangle is read
+    /// \param l the lower triangle of L
+    /// \param invDiag the inverse of the diagonal elements of L
+    template <class Dim>
+    static inline void Cholesky(Dim n,
+                                const std::complex<double>* a,
+                                std::complex<double>* l,
+                                double* invDiag)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            double d = a[j * n + j].real();
+            for (size_t k = 0; k < j; k++)
+            {
+                d -= std::norm(l[k * n + j]);
+            }
+            const double ljj = std::sqrt(d);
+            l[j * n + j] = ljj;
+            invDiag[j] = 1.0 / ljj;
+            for (size_t i = j + 1; i < n; i++)
+            {
+                auto g = a[j * n + i];
+                for (size_t k = 0; k < j; k++)
+                {
+                    g -= Mul(l[k * n + i], std::conj(l[k * n + j]));
+                }
+                l[j * n + i] = g * invDiag[j];
+            }
+        }
+    }
+
+    /// \brief Solve L * x = b in place, for a n x n lower triangular matrix L
+    /// \param n the size of L
+    /// \param l the lower triangle of L
+    /// \param invDiag the inverse of the diagonal elements of L
+    /// \param x the right-hand side b, replaced by the solution x
+    template <class Dim>
+    static inline void ForwardSubstitution(Dim n,
+                                           const std::complex<double>* l,
+                                           const double* invDiag,
+                                           std::complex<double>* x)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            auto v = x[i];
+            for (size_t k = 0; k < i; k++)
+            {
+                v -= Mul(l[k * n + i], x[k]);
+            }
+            x[i] = v * invDiag[i];
+        }
+    }
+};
+
+} // namespace ns3
+
+#endif // NR_MIMO_KERNELS_H
@@ -4,10 +4,15 @@
 //
 // SPDX-License-Identifier: GPL-2.0-only
 
+#include "nr-mimo-kernels.h"
 #include "nr-mimo-matrices.h"
 
 #include <Eigen/Dense>
 
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
 namespace ns3
 {
 
@@ -16,11 +21,131 @@ using EigenMatrix = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>
 template <class T>
 using ConstEigenMatrix = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>;
 
+/// Maximum number of receive ports of the fixed-size MSE kernels, whose channel times precoder
+/// matrices are kept on the stack
+static constexpr size_t MAX_FIXED_KERNEL_RX_PORTS = 32;
+
+/// \brief Interference-normalize the channel of all the pages with N x N covariance matrices,
+/// in a single pass with fixed-size matrices on the stack.
+/// \param covMat the covariance matrices (dim: N x N x nPages)
+/// \param chanMat the channel matrices (dim: N x nTxPorts x nPages)
+/// \param res the interference-normalized channel matrices, with the dimensions of chanMat
+template <int N>
+static void
+CalcIntfNormChannelFixed(const ComplexMatrixArray& covMat,
+                         const ComplexMatrixArray& chanMat,
+                         ComplexMatrixArray& res)
+{
+    const auto nCols = chanMat.GetNumCols();
+    std::complex<double> lower[N * N];
+    std::complex<double> l[N * N];
+    double invDiag[N];
+    for (size_t iRb = 0; iRb < chanMat.GetNumPages(); iRb++)
+    {
+        // Like the Eigen selfadjointView<Upper>, read the upper triangle of the covariance
+        auto cov = covMat.GetPagePtr(iRb);
+        for (int j = 0; j < N; j++)
+        {
+            for (int i = j; i < N; i++)
+            {
+                lower[j * N + i] = std::conj(cov[i * N + j]);
+            }
+        }
+        NrMimoKernels::Cholesky(NrMimoKernels::FixedDim<N>{}, lower, l, invDiag);
+
+        auto chan = chanMat.GetPagePtr(iRb);
+        auto out = res.GetPagePtr(iRb);
+        std::copy(chan, chan + N * nCols, out);
+        for (size_t col = 0; col < nCols; col++)
+        {
+            NrMimoKernels::ForwardSubstitution(NrMimoKernels::FixedDim<N>{},
+                                               l,
+                                               invDiag,
+                                               out + col * N);
+        }
+    }
+}
+
+/// \brief Compute the MSE matrices inv(I + (H * P)' * (H * P)) of all the pages for precoders of
+/// rank N, in a single pass with fixed-size matrices on the stack.
+/// \param chanMat the interference-normalized channel matrices (dim: nRxPorts x nTxPorts x nPages)
+/// \param precMats the precoding matrices (dim: nTxPorts x N x nPages)
+/// \param res the MSE matrices (dim: N x N x nPages)
+template <int N>
+static void
+ComputeMseFixed(const ComplexMatrixArray& chanMat,
+                const ComplexMatrixArray& precMats,
+                ComplexMatrixArray& res)
+{
+    const auto nRx = chanMat.GetNumRows();
+    const auto nTx = chanMat.GetNumCols();
+    std::complex<double> chanPrec[MAX_FIXED_KERNEL_RX_PORTS * N];
+    std::complex<double> gram[N * N];
+    std::complex<double> l[N * N];
+    std::complex<double> invL[N * N];
+    double invDiag[N];
+    for (size_t iRb = 0; iRb < res.GetNumPages(); iRb++)
+    {
+        // chanPrec = H * P, and the lower triangle of I + chanPrec' * chanPrec
+        NrMimoKernels::ChanTimesPrec(chanMat.GetPagePtr(iRb),
+                                     nRx,
+                                     nTx,
+                                     precMats.GetPagePtr(iRb),
+                                     N,
+                                     chanPrec);
+        NrMimoKernels::GramPlusIdentity(NrMimoKernels::FixedDim<N>{}, chanPrec, nRx, gram);
+        NrMimoKernels::Cholesky(NrMimoKernels::FixedDim<N>{}, gram, l, invDiag);
+
+        // inv(L), column by column, and then inv(L * L') = inv(L)' * inv(L)
+        std::fill(invL, invL + N * N, std::complex<double>{0.0, 0.0});
+        for (int k = 0; k < N; k++)
+        {
+            invL[k * N + k] = 1.0;
+            NrMimoKernels::ForwardSubstitution(NrMimoKernels::FixedDim<N>{},
+                                               l,
+                                               invDiag,
+                                               invL + k * N);
+        }
+        auto out = res.GetPagePtr(iRb);
+        for (int j = 0; j < N; j++)
+        {
+            for (int i = 0; i <= j; i++)
+            {
+                std::complex<double> m{0.0, 0.0};
+                for (int k = j; k < N; k++)
+                {
+                    m += NrMimoKernels::MulConj(invL[i * N + k], invL[j * N + k]);
+                }
+                out[j * N + i] = m;
+                out[i * N + j] = std::conj(m);
+            }
+        }
+    }
+}
+
 NrIntfNormChanMat
 NrCovMat::CalcIntfNormChannelMimo(const ComplexMatrixArray& chanMat) const
 {
     auto res = NrIntfNormChanMat{
         ComplexMatrixArray{chanMat.GetNumRows(), chanMat.GetNumCols(), chanMat.GetNumPages()}};
+    switch (chanMat.GetNumRows())
+    {
+    case 1:
+        CalcIntfNormChannelFixed<1>(*this, chanMat, res);
+        return res;
+    case 2:
+        CalcIntfNormChannelFixed<2>(*this, chanMat, res);
+        return res;
+    case 4:
+        CalcIntfNormChannelFixed<4>(*this, chanMat, res);
+        return res;
+    case 8:
+        CalcIntfNormChannelFixed<8>(*this, chanMat, res);
+        return res;
+    default:
+        break;
+    }
+
     for (size_t iRb = 0; iRb < chanMat.GetNumPages(); iRb++)
     {
         ConstEigenMatrix<std::complex<double>> covMatEigen(GetPagePtr(iRb),
@@ -42,8 +167,29 @@ ComplexMatrixArray
 NrIntfNormChanMat::ComputeMseMimo(const ComplexMatrixArray& precMats) const
 {
     auto nDims = precMats.GetNumCols();
-    auto identity = Eigen::MatrixXcd::Identity(nDims, nDims);
     auto res = ComplexMatrixArray{nDims, nDims, precMats.GetNumPages()};
+    if (GetNumRows() <= MAX_FIXED_KERNEL_RX_PORTS)
+    {
+        switch (nDims)
+        {
+        case 1:
+            ComputeMseFixed<1>(*this, precMats, res);
+            return res;
+        case 2:
+            ComputeMseFixed<2>(*this, precMats, res);
+            return res;
+        case 4:
+            ComputeMseFixed<4>(*this, precMats, res);
+            return res;
+        case 8:
+            ComputeMseFixed<8>(*this, precMats, res);
+            return res;
+        default:
+            break;
+        }
+    }
+
+    auto identity = Eigen::MatrixXcd::Identity(nDims, nDims);
     auto chanPrec = (*this) * precMats;
     auto chanCov = chanPrec.HermitianTranspose() * chanPrec;
     for (size_t iRb = 0; iRb < res.GetNumPages(); iRb++)
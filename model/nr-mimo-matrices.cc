@@ -6,6 +6,14 @@
 
 #include "nr-mimo-matrices.h"
 
+#include "nr-mimo-kernels.h"
+
+#include <ns3/assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace ns3
 {
 
@@ -62,6 +70,66 @@ NrIntfNormChanMat::ComputeSinrForPrecoding(const ComplexMatrixArray& precMats) c
     return NrSinrMatrix{res};
 }
 
+DoubleMatrixArray
+NrIntfNormChanMat::ComputeCapacityForPrecoderBank(const ComplexMatrixArray& precBank,
+                                                  size_t rank) const
+{
+    NS_ASSERT_MSG(precBank.GetNumPages() == 1, "The precoder bank must have a single page");
+    NS_ASSERT_MSG(precBank.GetNumRows() == GetNumCols(),
+                  "The precoders must have one row per transmit port");
+    NS_ASSERT_MSG(rank > 0 && precBank.GetNumCols() % rank == 0,
+                  "The precoder bank must have rank columns per precoder");
+
+    auto nRx = GetNumRows();
+    auto nTx = GetNumCols();
+    auto nBankCols = precBank.GetNumCols();
+    auto nPrec = nBankCols / rank;
+    auto nPages = GetNumPages();
+    auto res = DoubleMatrixArray{nPages, nPrec};
+
+    // Matrices are stored column-major: element (i, j) of a page is at j * nRows + i
+    auto bank = precBank.GetPagePtr(0);
+    auto chanPrec = std::vector<std::complex<double>>(nRx * nBankCols);
+    auto gram = std::vector<std::complex<double>>(rank * rank);
+    auto chol = std::vector<std::complex<double>>(rank * rank);
+    auto invDiag = std::vector<double>(rank);
+    auto invCol = std::vector<std::complex<double>>(rank);
+    for (size_t iPage = 0; iPage < nPages; iPage++)
+    {
+        // chanPrec = this * precBank, for all the precoders at once
+        NrMimoKernels::ChanTimesPrec(GetPagePtr(iPage), nRx, nTx, bank, nBankCols, chanPrec.data());
+
+        for (size_t iPrec = 0; iPrec < nPrec; iPrec++)
+        {
+            // Cholesky decomposition L * L' of I + hp' * hp
+            auto hp = chanPrec.data() + iPrec * rank * nRx;
+            NrMimoKernels::GramPlusIdentity(rank, hp, nRx, gram.data());
+            NrMimoKernels::Cholesky(rank, gram.data(), chol.data(), invDiag.data());
+
+            // The k-th diagonal element of inv(L * L') is the squared norm of the k-th
+            // column of inv(L), computed by forward substitution
+            double mseProd = 1.0;
+            for (size_t k = 0; k < rank; k++)
+            {
+                std::fill(invCol.begin(), invCol.end(), std::complex<double>{0.0, 0.0});
+                invCol[k] = 1.0;
+                NrMimoKernels::ForwardSubstitution(rank,
+                                                   chol.data(),
+                                                   invDiag.data(),
+                                                   invCol.data());
+                double mse = 0.0;
+                for (size_t i = k; i < rank; i++)
+                {
+                    mse += std::norm(invCol[i]);
+                }
+                mseProd *= mse;
+            }
+            res(iPage, iPrec) = -std::log2(mseProd);
+        }
+    }
+    return res;
+}
+
 ComplexMatrixArray
 NrIntfNormChanMat::ComputeMse(const ComplexMatrixArray& precMats) const
 {
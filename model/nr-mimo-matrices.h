@@ -73,6 +73,19 @@ class NrIntfNormChanMat : public ComplexMatrixArray
     /// \returns the SINR values for each layer and RB (dim: rank x nRbs)
     virtual NrSinrMatrix ComputeSinrForPrecoding(const ComplexMatrixArray& precMats) const;
 
+    /// \brief Compute the Shannon capacity of an MMSE receiver for a bank of precoders, each one
+    /// applied to all the pages (e.g., subbands) of this matrix.
+    /// The channel is multiplied by all the precoders at once, with a single pass over each page;
+    /// the capacity of each precoder is then obtained from the diagonal of its MSE matrix, as
+    /// sum(log2(1 + SINR)) = -log2(prod(diag(MSE))), where MSE = inv(I + P' * this' * this * P).
+    /// It does not need the Eigen library.
+    /// \param precBank the precoders, concatenated along the columns, in a single page
+    /// (dim: nTxPorts * (rank * nPrecoders))
+    /// \param rank the number of columns (layers) of each precoder
+    /// \returns the capacity for each page and each precoder (dim: nPages x nPrecoders)
+    DoubleMatrixArray ComputeCapacityForPrecoderBank(const ComplexMatrixArray& precBank,
+                                                     size_t rank) const;
+
   private:
     /// \brief Compute the MSE (mean square error) for an MMSE receiver, for SISO and MIMO.
     /// \param precMats the precoding matrices (dim: nTxPorts * rank * nRbs)
@@ -0,0 +1,473 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-pm-search-fast.h"
+
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/trace-source-accessor.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <set>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrPmSearchFast");
+NS_OBJECT_ENSURE_REGISTERED(NrPmSearchFast);
+
+/// \brief Compute the eigenvalues (and optionally the eigenvectors) of a Hermitian matrix with
+/// the cyclic Jacobi method. The matrices are small (at most 32 x 32), and they are decomposed
+/// only at wideband PMI updates, so a simple method is enough.
+/// \param mat the matrix (column-major, dim: n * n), which is overwritten
+/// \param n the number of rows and columns of the matrix
+/// \param vecs if not null, filled with the eigenvectors (column-major, dim: n * n)
+/// \return the eigenvalues, unsorted (the eigenvector of eigenvalue k is the column k of vecs)
+static std::vector<double>
+HermitianEigen(std::vector<std::complex<double>>& mat,
+               size_t n,
+               std::vector<std::complex<double>>* vecs)
+{
+    auto a = [&mat, n](size_t i, size_t j) -> std::complex<double>& { return mat[j * n + i]; };
+    if (vecs)
+    {
+        vecs->assign(n * n, std::complex<double>{0.0, 0.0});
+        for (size_t i = 0; i < n; i++)
+        {
+            (*vecs)[i * n + i] = 1.0;
+        }
+    }
+
+    for (size_t sweep = 0; sweep < 30; sweep++)
+    {
+        double off = 0.0;
+        double total = 0.0;
+        for (size_t j = 0; j < n; j++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                total += std::norm(a(i, j));
+                off += (i != j) ? std::norm(a(i, j)) : 0.0;
+            }
+        }
+        if (off <= 1e-24 * total)
+        {
+            break;
+        }
+
+        for (size_t p = 0; p + 1 < n; p++)
+        {
+            for (size_t q = p + 1; q < n; q++)
+            {
+                auto absApq = std::abs(a(p, q));
+                if (absApq <= 1e-300)
+                {
+                    continue;
+                }
+                // Make a(p, q) real by scaling row and column q by a phase
+                auto d = std::conj(a(p, q)) / absApq;
+                for (size_t k = 0; k < n; k++)
+                {
+                    a(k, q) *= d;
+                }
+                for (size_t k = 0; k < n; k++)
+                {
+                    a(q, k) *= std::conj(d);
+                }
+                // Real Jacobi rotation that zeroes a(p, q)
+                auto theta =
+                    0.5 * std::atan2(2.0 * absApq, std::real(a(q, q)) - std::real(a(p, p)));
+                auto c = std::cos(theta);
+                auto s = std::sin(theta);
+                for (size_t k = 0; k < n; k++)
+                {
+                    auto akp = a(k, p);
+                    auto akq = a(k, q);
+                    a(k, p) = c * akp - s * akq;
+                    a(k, q) = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < n; k++)
+                {
+                    auto apk = a(p, k);
+                    auto aqk = a(q, k);
+                    a(p, k) = c * apk - s * aqk;
+                    a(q, k) = s * apk + c * aqk;
+                }
+                if (vecs)
+                {
+                    auto v = [vecs, n](size_t i, size_t j) -> std::complex<double>& {
+                        return (*vecs)[j * n + i];
+                    };
+                    for (size_t k = 0; k < n; k++)
+                    {
+                        v(k, q) *= d;
+                        auto vkp = v(k, p);
+                        auto vkq = v(k, q);
+                        v(k, p) = c * vkp - s * vkq;
+                        v(k, q) = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+    }
+
+    auto eigVals = std::vector<double>(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        eigVals[i] = std::real(a(i, i));
+    }
+    return eigVals;
+}
+
+TypeId
+NrPmSearchFast::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrPmSearchFast")
+            .SetParent<NrPmSearchFull>()
+            .AddConstructor<NrPmSearchFast>()
+            .AddAttribute("NumCandidatesI1",
+                          "Number of wideband precoding matrices (i1) kept after the beam "
+                          "prefiltering, and evaluated with the capacity metric",
+                          UintegerValue(4),
+                          MakeUintegerAccessor(&NrPmSearchFast::m_numCandidatesI1),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("NumNeighborsI1",
+                          "Number of neighbors of a wideband precoding matrix (i1) evaluated by "
+                          "the local search (0 disables the local search)",
+                          UintegerValue(4),
+                          MakeUintegerAccessor(&NrPmSearchFast::m_numNeighborsI1),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxEigenvalueSpread",
+                          "Maximum ratio (dB) between the largest eigenvalue of the channel and "
+                          "the eigenvalue of a rank for the rank to be evaluated",
+                          DoubleValue(20.0),
+                          MakeDoubleAccessor(&NrPmSearchFast::m_maxEigenvalueSpreadDb),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("CompareWithFullSearch",
+                          "Run also the full search at each wideband PMI update, and report the "
+                          "TB sizes of both searches in the FullSearchComparison trace",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrPmSearchFast::m_compareWithFullSearch),
+                          MakeBooleanChecker())
+            .AddTraceSource("FullSearchComparison",
+                            "TB sizes of the fast and of the full search at each wideband PMI "
+                            "update, when CompareWithFullSearch is enabled",
+                            MakeTraceSourceAccessor(&NrPmSearchFast::m_fullSearchComparisonTrace),
+                            "ns3::NrPmSearchFast::TbSizeComparisonTracedCallback");
+    return tid;
+}
+
+PmCqiInfo
+NrPmSearchFast::CreateCqiFeedbackMimo(const NrMimoSignal& rxSignalRb, PmiUpdate pmiUpdate)
+{
+    NS_LOG_FUNCTION(this);
+
+    // Extract parameters from received signal
+    auto nRows = rxSignalRb.m_chanMat.GetNumRows();
+    auto nCols = rxSignalRb.m_chanMat.GetNumCols();
+    NS_ASSERT_MSG(nRows == m_nRxPorts, "Channel mat has {} rows but UE has {} ports");
+    NS_ASSERT_MSG(nCols == m_nGnbPorts, "Channel mat has {} cols but gNB has {} ports");
+
+    // Compute the interference-normalized channel matrix
+    auto rbNormChanMat = rxSignalRb.m_covMat.CalcIntfNormChannel(rxSignalRb.m_chanMat);
+
+    // The ranks are pruned at the wideband updates, so the first update must be a wideband one
+    if (m_activeRanks.empty())
+    {
+        pmiUpdate.updateWb = true;
+    }
+
+    // Update optimal precoding matrices based on received signal, if update is requested
+    ConditionallyUpdatePrecoding(rbNormChanMat, pmiUpdate);
+    auto cqi = CreateCqiForOptRank(m_activeRanks, rbNormChanMat);
+
+    if (m_compareWithFullSearch && pmiUpdate.updateWb)
+    {
+        // Run the full search, and restore the precoding parameters of the fast search. Note
+        // that, with the RandomPRB downsampling, the full search draws additional random values.
+        auto fastPrecParams = std::vector<Ptr<PrecMatParams>>(m_rankParams.size());
+        for (auto rank : m_ranks)
+        {
+            fastPrecParams[rank] = m_rankParams[rank].precParams;
+        }
+        NrPmSearchFull::UpdateAllPrecoding(rbNormChanMat);
+        auto fullCqi = CreateCqiForOptRank(m_ranks, rbNormChanMat);
+        for (auto rank : m_ranks)
+        {
+            m_rankParams[rank].precParams = fastPrecParams[rank];
+        }
+
+        NS_LOG_INFO("TB size of the fast search: " << cqi.m_tbSize << " (rank " << +cqi.m_rank
+                                                   << "), full search: " << fullCqi.m_tbSize
+                                                   << " (rank " << +fullCqi.m_rank << ")");
+        m_fullSearchComparisonTrace(cqi.m_tbSize, fullCqi.m_tbSize);
+    }
+    return cqi;
+}
+
+void
+NrPmSearchFast::UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat)
+{
+    // Compute downsampled channel per subband
+    auto sbNormChanMat = SubbandDownsampling(rbNormChanMat);
+
+    UpdateActiveRanks(sbNormChanMat);
+    auto scoringFactor = ComputeBeamScoringFactor(sbNormChanMat);
+    for (auto rank : m_activeRanks)
+    {
+        m_rankParams[rank].precParams = SearchWidebandPrecoding(sbNormChanMat, scoringFactor, rank);
+    }
+}
+
+void
+NrPmSearchFast::UpdateSubbandPrecoding(const NrIntfNormChanMat& rbNormChanMat)
+{
+    // Compute downsampled channel per subband
+    auto sbNormChanMat = SubbandDownsampling(rbNormChanMat);
+    for (auto rank : m_activeRanks)
+    {
+        // Recompute the best subband precoding (W2) for previously found W1 and store results
+        auto& optPrec = m_rankParams[rank].precParams;
+        NS_ASSERT(optPrec);
+        auto wbPmi = optPrec->wbPmi;
+        optPrec = FindOptSubbandPrecoding(sbNormChanMat, wbPmi, rank);
+    }
+}
+
+void
+NrPmSearchFast::UpdateActiveRanks(const NrIntfNormChanMat& sbNormChanMat)
+{
+    // Wideband receive covariance of the channel: sum over the subbands of H * H'
+    auto nRx = sbNormChanMat.GetNumRows();
+    auto nTx = sbNormChanMat.GetNumCols();
+    auto rxCov = std::vector<std::complex<double>>(nRx * nRx);
+    for (size_t p = 0; p < sbNormChanMat.GetNumPages(); p++)
+    {
+        for (size_t j = 0; j < nRx; j++)
+        {
+            for (size_t i = 0; i < nRx; i++)
+            {
+                std::complex<double> sum = 0.0;
+                for (size_t k = 0; k < nTx; k++)
+                {
+                    sum += sbNormChanMat(i, k, p) * std::conj(sbNormChanMat(j, k, p));
+                }
+                rxCov[j * nRx + i] += sum;
+            }
+        }
+    }
+    auto eigVals = HermitianEigen(rxCov, nRx, nullptr);
+    std::sort(eigVals.begin(), eigVals.end(), std::greater<>());
+
+    // Rank 1 is always evaluated; each other rank needs a large enough eigenvalue
+    auto minEigVal = eigVals.front() * std::pow(10.0, -m_maxEigenvalueSpreadDb / 10.0);
+    m_activeRanks.clear();
+    for (auto rank : m_ranks)
+    {
+        if (rank == 1 || eigVals[rank - 1] >= minEigVal)
+        {
+            m_activeRanks.push_back(rank);
+        }
+    }
+    NS_LOG_DEBUG("Evaluating " << m_activeRanks.size() << " of " << m_ranks.size() << " ranks");
+}
+
+std::vector<std::complex<double>>
+NrPmSearchFast::ComputeBeamScoringFactor(const NrIntfNormChanMat& sbNormChanMat) const
+{
+    // Wideband transmit covariance of the channel: sum over the subbands of H' * H
+    auto nRx = sbNormChanMat.GetNumRows();
+    auto nTx = sbNormChanMat.GetNumCols();
+    auto txCov = std::vector<std::complex<double>>(nTx * nTx);
+    for (size_t p = 0; p < sbNormChanMat.GetNumPages(); p++)
+    {
+        for (size_t j = 0; j < nTx; j++)
+        {
+            for (size_t i = 0; i < nTx; i++)
+            {
+                std::complex<double> sum = 0.0;
+                for (size_t k = 0; k < nRx; k++)
+                {
+                    sum += std::conj(sbNormChanMat(k, i, p)) * sbNormChanMat(k, j, p);
+                }
+                txCov[j * nTx + i] += sum;
+            }
+        }
+    }
+    std::vector<std::complex<double>> eigVecs;
+    auto eigVals = HermitianEigen(txCov, nTx, &eigVecs);
+
+    // Keep the dominant eigenvectors (at most one per receive port), scaled by the square root
+    // of their eigenvalue, so that ||G' * p||^2 approximates the gain p' * R * p of a beam p
+    auto order = std::vector<size_t>(nTx);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&eigVals](size_t a, size_t b) {
+        return eigVals[a] > eigVals[b];
+    });
+    auto factor = std::vector<std::complex<double>>{};
+    for (size_t k = 0; k < std::min(nRx, nTx); k++)
+    {
+        auto eigVal = eigVals[order[k]];
+        if (eigVal <= 0.0 || eigVal < 1e-3 * eigVals[order[0]])
+        {
+            break;
+        }
+        auto scale = std::sqrt(eigVal);
+        for (size_t i = 0; i < nTx; i++)
+        {
+            factor.push_back(scale * eigVecs[order[k] * nTx + i]);
+        }
+    }
+    return factor;
+}
+
+Ptr<NrPmSearchFull::PrecMatParams>
+NrPmSearchFast::SearchWidebandPrecoding(const NrIntfNormChanMat& sbNormChanMat,
+                                        const std::vector<std::complex<double>>& scoringFactor,
+                                        uint8_t rank) const
+{
+    const auto& bank = m_rankParams[rank].bank;
+    NS_ASSERT_MSG(bank, "The precoder bank of rank " << +rank << " does not exist");
+    auto numI1 = bank->precMatsForI1.size();
+    auto numI2 = bank->numI2;
+    auto nTx = sbNormChanMat.GetNumCols();
+    auto nFactors = scoringFactor.size() / nTx;
+
+    // Score each i1 by the largest wideband beamforming gain of its precoders
+    auto scores = std::vector<double>(numI1);
+    for (size_t i1 = 0; i1 < numI1; i1++)
+    {
+        const auto* prec = bank->precMatsForI1[i1].GetPagePtr(0);
+        for (size_t i2 = 0; i2 < numI2; i2++)
+        {
+            double gain = 0.0;
+            for (size_t c = 0; c < rank; c++)
+            {
+                const auto* col = prec + (i2 * rank + c) * nTx;
+                for (size_t f = 0; f < nFactors; f++)
+                {
+                    const auto* g = scoringFactor.data() + f * nTx;
+                    std::complex<double> proj = 0.0;
+                    for (size_t k = 0; k < nTx; k++)
+                    {
+                        proj += std::conj(g[k]) * col[k];
+                    }
+                    gain += std::norm(proj);
+                }
+            }
+            scores[i1] = std::max(scores[i1], gain);
+        }
+    }
+
+    // Evaluate the best candidates (in case of a tie, the lowest i1 first)
+    auto candidates = std::vector<size_t>(numI1);
+    std::iota(candidates.begin(), candidates.end(), 0);
+    std::stable_sort(candidates.begin(), candidates.end(), [&scores](size_t a, size_t b) {
+        return scores[a] > scores[b];
+    });
+    candidates.resize(std::min<size_t>(numI1, m_numCandidatesI1));
+
+    auto evaluated = std::set<size_t>{};
+    Ptr<PrecMatParams> optPrec{nullptr};
+    auto evaluate = [&](size_t i1) {
+        evaluated.insert(i1);
+        auto subbandParams = FindOptSubbandPrecoding(sbNormChanMat, i1, rank);
+        if (!optPrec || subbandParams->perfMetric > optPrec->perfMetric)
+        {
+            optPrec = subbandParams;
+            return true;
+        }
+        return false;
+    };
+    for (auto i1 : candidates)
+    {
+        evaluate(i1);
+    }
+
+    // Local search: move to the neighbors of the best i1, as long as the metric improves
+    if (m_numNeighborsI1 > 0 && evaluated.size() < numI1)
+    {
+        auto neighbors = GetI1Neighbors(bank, m_numNeighborsI1);
+        auto improved = true;
+        while (improved)
+        {
+            improved = false;
+            for (auto i1 : neighbors->neighbors[optPrec->wbPmi])
+            {
+                if (evaluated.count(i1) == 0 && evaluate(i1))
+                {
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+    NS_LOG_DEBUG("Rank " << +rank << ": evaluated " << evaluated.size() << " of " << numI1
+                         << " i1 values, selected i1 " << optPrec->wbPmi);
+    return optPrec;
+}
+
+Ptr<const NrPmSearchFast::I1Neighbors>
+NrPmSearchFast::GetI1Neighbors(Ptr<const PrecoderBank> bank, size_t numNeighbors)
+{
+    static std::mutex cacheMutex;
+    static std::map<std::pair<const PrecoderBank*, size_t>, Ptr<const I1Neighbors>> cache;
+
+    // The banks are cached for the whole simulation, so their addresses identify them
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto key = std::make_pair(PeekPointer(bank), numNeighbors);
+    auto it = cache.find(key);
+    if (it != cache.end())
+    {
+        return it->second;
+    }
+
+    // The correlation of two i1 is |tr(P1' * P2)|, using the precoders of i2 = 0
+    auto numI1 = bank->precMatsForI1.size();
+    auto res = Create<I1Neighbors>();
+    res->neighbors.resize(numI1);
+    for (size_t a = 0; a < numI1; a++)
+    {
+        const auto& precA = bank->precMatsForI1[a];
+        auto matSize = precA.GetNumRows() * precA.GetNumCols() / bank->numI2;
+        auto corr = std::vector<double>(numI1);
+        for (size_t b = 0; b < numI1; b++)
+        {
+            std::complex<double> tr = 0.0;
+            for (size_t k = 0; k < matSize; k++)
+            {
+                tr += std::conj(precA.GetPagePtr(0)[k]) * bank->precMatsForI1[b].GetPagePtr(0)[k];
+            }
+            corr[b] = std::abs(tr);
+        }
+
+        auto& neighbors = res->neighbors[a];
+        for (size_t b = 0; b < numI1; b++)
+        {
+            if (b != a)
+            {
+                neighbors.push_back(b);
+            }
+        }
+        auto numKept = std::min(numNeighbors, neighbors.size());
+        std::partial_sort(neighbors.begin(),
+                          neighbors.begin() + numKept,
+                          neighbors.end(),
+                          [&corr](size_t x, size_t y) {
+                              return corr[x] > corr[y] || (corr[x] == corr[y] && x < y);
+                          });
+        neighbors.resize(numKept);
+    }
+    cache.emplace(key, res);
+    return res;
+}
+
+} // namespace ns3
@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_PM_SEARCH_FAST_H
+#define NR_PM_SEARCH_FAST_H
+
+#include "nr-pm-search-full.h"
+
+#include <ns3/traced-callback.h>
+
+#include <complex>
+#include <vector>
+
+namespace ns3
+{
+
+/// \brief An approximate implementation of NrPmSearch for 3GPP Type-I codebooks, which avoids
+/// evaluating every wideband precoding matrix (i1) for every rank.
+///
+/// When the wideband PMI is updated, the search has three steps:
+/// - Rank pruning: the ranks whose eigenvalue (of the wideband receive covariance of the
+///   interference-normalized channel) is below the largest one by more than MaxEigenvalueSpread
+///   are not evaluated.
+/// - Beam prefiltering: each i1 is scored by the wideband beamforming gain of its precoders
+///   (the codebook beams are DFT beams), using the dominant eigenvectors of the wideband transmit
+///   covariance of the channel. Only the NumCandidatesI1 best i1 are kept.
+/// - Local search: the candidates are evaluated with the same capacity metric as NrPmSearchFull,
+///   and then the search moves to the best-scoring neighbor of the best i1 (the NumNeighborsI1
+///   precoders most correlated to it), as long as the metric improves.
+///
+/// Subband PMI updates and the CQI computation are the same as in NrPmSearchFull, for the ranks
+/// that were not pruned. When CompareWithFullSearch is enabled, each wideband update also runs
+/// the full search, and the TB sizes of both are reported in the FullSearchComparison trace.
+/// When NumCandidatesI1 is at least the number of i1 and MaxEigenvalueSpread keeps every rank,
+/// the feedback is the same as the one of NrPmSearchFull.
+class NrPmSearchFast : public NrPmSearchFull
+{
+  public:
+    /// \brief Get TypeId
+    /// \return the TypeId
+    static TypeId GetTypeId();
+
+    /// \brief Create CQI feedback with optimal rank, optimal PMI, and corresponding CQI values,
+    /// evaluating only the ranks that were not pruned at the last wideband PMI update.
+    /// \param rxSignalRb the receive signal parameters (channel and interference matrices)
+    /// \param pmiUpdate struct that defines if WB/SB PMIs need to be updated
+    /// \return the CQI feedback message that contains the optimum CQI, RI, PMI, and full precoding
+    /// matrix (dimensions: nGnbPorts * rank * nRbs)
+    PmCqiInfo CreateCqiFeedbackMimo(const NrMimoSignal& rxSignalRb, PmiUpdate pmiUpdate) override;
+
+    /// \brief TracedCallback signature for the comparison with the full search
+    /// \param [in] fastTbSize the TB size of the CQI feedback of the fast search
+    /// \param [in] fullTbSize the TB size of the CQI feedback of the full search
+    typedef void (*TbSizeComparisonTracedCallback)(uint32_t fastTbSize, uint32_t fullTbSize);
+
+  protected:
+    /// \brief Prune the ranks, and update the optimum precoding matrices (wideband and subband)
+    /// of the remaining ones with the approximate search.
+    /// \param rbNormChanMat the interference-normed channel matrix per RB
+    void UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat) override;
+
+    /// \brief For the ranks not pruned, update the opt subband PMI assuming previous value of
+    /// wideband PMI.
+    /// \param rbNormChanMat the interference-normed channel matrix per RB
+    void UpdateSubbandPrecoding(const NrIntfNormChanMat& rbNormChanMat) override;
+
+  private:
+    /// \brief Update the ranks to evaluate, from the eigenvalue spread of the wideband receive
+    /// covariance of the channel.
+    /// \param sbNormChanMat the interference-normed channel matrix per subband
+    void UpdateActiveRanks(const NrIntfNormChanMat& sbNormChanMat);
+
+    /// \brief Compute the factor G (nGnbPorts x k) of the dominant part G * G' of the wideband
+    /// transmit covariance of the channel, used to score the beams.
+    /// \param sbNormChanMat the interference-normed channel matrix per subband
+    /// \return the factor G (column-major, dim: nGnbPorts * k)
+    std::vector<std::complex<double>> ComputeBeamScoringFactor(
+        const NrIntfNormChanMat& sbNormChanMat) const;
+
+    /// \brief Find the wideband precoding (i1) and the corresponding subband precoding of a rank
+    /// \param sbNormChanMat the interference-normed channel matrix per subband
+    /// \param scoringFactor the factor returned by ComputeBeamScoringFactor
+    /// \param rank the rank (number of MIMO layers)
+    /// \return a struct containing wideband and subband PMIs, and full precoding matrix.
+    Ptr<PrecMatParams> SearchWidebandPrecoding(
+        const NrIntfNormChanMat& sbNormChanMat,
+        const std::vector<std::complex<double>>& scoringFactor,
+        uint8_t rank) const;
+
+    /// \brief The neighbors of each i1 in a precoder bank
+    struct I1Neighbors : public SimpleRefCount<I1Neighbors>
+    {
+        /// For each i1, its neighbors, from the most to the least correlated
+        std::vector<std::vector<size_t>> neighbors;
+    };
+
+    /// \brief Get the neighbors of each i1 in a precoder bank, computing them if they are not
+    /// cached yet. The neighbors of i1 are the numNeighbors other i1 whose precoders are the
+    /// most correlated to its precoders. Like the banks, they are shared by all the instances.
+    /// \param bank the precoder bank
+    /// \param numNeighbors the number of neighbors of each i1
+    /// \return the neighbors
+    static Ptr<const I1Neighbors> GetI1Neighbors(Ptr<const PrecoderBank> bank,
+                                                 size_t numNeighbors);
+
+    uint32_t m_numCandidatesI1{4};       ///< Number of i1 kept after the beam prefiltering
+    uint32_t m_numNeighborsI1{4};        ///< Number of neighbors of an i1 in the local search
+    double m_maxEigenvalueSpreadDb{20};  ///< Maximum eigenvalue spread (dB) of a rank
+    bool m_compareWithFullSearch{false}; ///< Run also the full search, to compare the TB sizes
+
+    std::vector<uint8_t> m_activeRanks{}; ///< The ranks not pruned at the last wideband update
+
+    /// Trace of the TB sizes of the fast search and of the full search
+    TracedCallback<uint32_t, uint32_t> m_fullSearchComparisonTrace;
+};
+
+} // namespace ns3
+
+#endif // NR_PM_SEARCH_FAST_H
@@ -10,7 +10,11 @@
 #include <ns3/simulator.h>
 #include <ns3/uinteger.h>
 
+#include <algorithm>
+#include <mutex>
 #include <numeric>
+#include <sstream>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -61,7 +65,54 @@ NrPmSearchFull::InitCodebooks()
         m_cbFactory.Set("Rank", UintegerValue(rank));
         m_rankParams[rank].cb = m_cbFactory.Create<NrCbTypeOne>();
         m_rankParams[rank].cb->Init();
+
+        std::ostringstream cbConfig;
+        cbConfig << m_cbFactory;
+        m_rankParams[rank].bank = GetPrecoderBank(cbConfig.str(), m_rankParams[rank].cb);
+    }
+}
+
+Ptr<const NrPmSearchFull::PrecoderBank>
+NrPmSearchFull::GetPrecoderBank(const std::string& cbConfig, Ptr<const NrCbTypeOne> cb)
+{
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, Ptr<const PrecoderBank>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(cbConfig);
+    if (it != cache.end())
+    {
+        return it->second;
+    }
+
+    NS_LOG_INFO("Creating the precoder bank of codebook " << cbConfig);
+    auto bank = Create<PrecoderBank>();
+    auto numI1 = cb->GetNumI1();
+    bank->numI2 = cb->GetNumI2();
+    bank->precMatsForI1.reserve(numI1);
+    for (auto i1 = size_t{0}; i1 < numI1; i1++)
+    {
+        ComplexMatrixArray precMats;
+        for (auto i2 = size_t{0}; i2 < bank->numI2; i2++)
+        {
+            auto basePrecMat = cb->GetBasePrecMat(i1, i2);
+            NS_ASSERT_MSG(basePrecMat.GetNumPages() == 1, "Base precoding matrix must be 2D");
+            if (i2 == 0)
+            {
+                precMats = ComplexMatrixArray{basePrecMat.GetNumRows(),
+                                              basePrecMat.GetNumCols() * bank->numI2,
+                                              1};
+            }
+            // Matrices are column-major: the columns of i2 are contiguous
+            auto matSize = basePrecMat.GetNumRows() * basePrecMat.GetNumCols();
+            std::copy_n(basePrecMat.GetPagePtr(0),
+                        matSize,
+                        precMats.GetPagePtr(0) + i2 * matSize);
+        }
+        bank->precMatsForI1.emplace_back(std::move(precMats));
     }
+    cache.emplace(cbConfig, bank);
+    return bank;
 }
 
 PmCqiInfo
@@ -81,9 +132,18 @@ NrPmSearchFull::CreateCqiFeedbackMimo(const NrMimoSignal& rxSignalRb, PmiUpdate
     // Update optimal precoding matrices based on received signal, if update is requested
     ConditionallyUpdatePrecoding(rbNormChanMat, pmiUpdate);
 
+    return CreateCqiForOptRank(m_ranks, rbNormChanMat);
+}
+
+PmCqiInfo
+NrPmSearchFull::CreateCqiForOptRank(const std::vector<uint8_t>& ranks,
+                                    const NrIntfNormChanMat& rbNormChanMat) const
+{
+    NS_ASSERT_MSG(!ranks.empty(), "No rank to evaluate");
+
     // Iterate over the ranks, apply the optimal precoding matrix, create CQI message with TB size
     auto optPrecForRanks = std::vector<PmCqiInfo>{};
-    for (auto rank : m_ranks)
+    for (auto rank : ranks)
     {
         auto cqiMsg = CreateCqiForRank(rank, rbNormChanMat);
         optPrecForRanks.emplace_back(std::move(cqiMsg));
@@ -128,25 +188,22 @@ NrPmSearchFull::UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat)
 
     for (auto rank : m_ranks)
     {
-        // Loop over wideband precoding matrices W1 (index i1).
-        std::vector<Ptr<PrecMatParams>> optSubbandPrecoders{};
+        // Loop over wideband precoding matrices W1 (index i1), and keep the optimal one (the
+        // first one, in case of a tie)
+        Ptr<PrecMatParams> optPrec{nullptr};
         auto numI1 = m_rankParams[rank].cb->GetNumI1();
         for (auto i1 = size_t{0}; i1 < numI1; i1++)
         {
             // Find the optimal subband PMI values (i2) for this particular i1
             auto subbandParams = FindOptSubbandPrecoding(sbNormChanMat, i1, rank);
-
-            // Store the parameters for this wideband index i1
-            optSubbandPrecoders.emplace_back(subbandParams);
+            if (!optPrec || subbandParams->perfMetric > optPrec->perfMetric)
+            {
+                optPrec = subbandParams;
+            }
         }
 
-        // Find the optimal wideband PMI i1
-        m_rankParams[rank].precParams =
-            *std::max_element(optSubbandPrecoders.begin(),
-                              optSubbandPrecoders.end(),
-                              [](const Ptr<PrecMatParams>& a, const Ptr<PrecMatParams>& b) {
-                                  return a->perfMetric < b->perfMetric;
-                              });
+        // Store the optimal wideband PMI i1
+        m_rankParams[rank].precParams = optPrec;
     }
 }
 
@@ -200,17 +257,20 @@ NrPmSearchFull::FindOptSubbandPrecoding(const NrIntfNormChanMat& sbNormChanMat,
                                         size_t i1,
                                         uint8_t rank) const
 {
-    // Create the possible subband precoding matrices for each value of i2, and compute the
-    // corresponding performance metric (channel capacity) for each subband and each i2.
+    // Compute the performance metric (channel capacity) for each subband and each possible
+    // subband precoding matrix (value of i2).
     auto nSubbands = sbNormChanMat.GetNumPages();
-    auto allPrecMats = CreateSubbandPrecoders(i1, rank, nSubbands);
-    auto subbandMetricForPrec = ComputeCapacityForPrecoders(sbNormChanMat, allPrecMats);
-    auto numI2 = allPrecMats.size();
+    auto subbandMetricForPrec = ComputeCapacityForPrecoders(sbNormChanMat, i1, rank);
+    const auto& bank = m_rankParams[rank].bank;
+    const auto& precMats = bank->precMatsForI1[i1];
+    auto numI2 = bank->numI2;
 
     // For each subband, find the optimal value of i2 (subband PMI value)
     auto sbPmis = std::vector<size_t>(nSubbands);
     auto optSubbandMetric = DoubleMatrixArray{nSubbands};
-    auto optPrecMat = allPrecMats[0]; // Initialize optimal precoding matrix
+    auto nRows = precMats.GetNumRows();
+    auto optPrecMat = ComplexMatrixArray{nRows, rank, nSubbands};
+    auto matSize = nRows * rank;
     for (auto iSb = size_t{0}; iSb < nSubbands; iSb++)
     {
         // Find the optimal value of i2 (subband PMI value) for the current subband
@@ -223,13 +283,9 @@ NrPmSearchFull::FindOptSubbandPrecoding(const NrIntfNormChanMat& sbNormChanMat,
             }
         }
         // Store the optimal precoding matrix for this subband
-        for (size_t i = 0; i < optPrecMat.GetNumRows(); i++)
-        {
-            for (size_t j = 0; j < optPrecMat.GetNumCols(); j++)
-            {
-                optPrecMat(i, j, iSb) = allPrecMats[sbPmis[iSb]](i, j, iSb);
-            }
-        }
+        std::copy_n(precMats.GetPagePtr(0) + sbPmis[iSb] * matSize,
+                    matSize,
+                    optPrecMat.GetPagePtr(iSb));
     }
     auto widebandMetric = optSubbandMetric.GetValues().sum();
 
@@ -241,66 +297,15 @@ NrPmSearchFull::FindOptSubbandPrecoding(const NrIntfNormChanMat& sbNormChanMat,
     return res;
 }
 
-std::vector<ComplexMatrixArray>
-NrPmSearchFull::CreateSubbandPrecoders(size_t i1, uint8_t rank, size_t nSubbands) const
-{
-    const auto& cb = m_rankParams[rank].cb;
-    auto numI2 = cb->GetNumI2();
-
-    std::vector<ComplexMatrixArray> allPrecMats;
-
-    for (auto i2 = size_t{0}; i2 < numI2; i2++)
-    {
-        auto basePrecMat = cb->GetBasePrecMat(i1, i2);
-        auto sbPrecMat = ExpandPrecodingMatrix(basePrecMat, nSubbands);
-        allPrecMats.emplace_back(sbPrecMat);
-    }
-    return allPrecMats;
-}
-
-ComplexMatrixArray
-NrPmSearchFull::ExpandPrecodingMatrix(ComplexMatrixArray basePrecMat, size_t nSubbands)
-{
-    NS_ASSERT_MSG(basePrecMat.GetNumPages() == 1, "Expanding to 3D requires a 2D input");
-    auto nRows = basePrecMat.GetNumRows();
-    auto nCols = basePrecMat.GetNumCols();
-    ComplexMatrixArray res{nRows, nCols, nSubbands};
-    for (size_t p = 0; p < nSubbands; p++)
-    {
-        for (size_t i = 0; i < nRows; i++)
-        {
-            for (size_t j = 0; j < nCols; j++)
-            {
-                res(i, j, p) = basePrecMat(i, j);
-            }
-        }
-    }
-    return res;
-}
-
 DoubleMatrixArray
 NrPmSearchFull::ComputeCapacityForPrecoders(const NrIntfNormChanMat& sbNormChanMat,
-                                            std::vector<ComplexMatrixArray> allPrecMats) const
+                                            size_t i1,
+                                            uint8_t rank) const
 {
-    auto nSubbands = sbNormChanMat.GetNumPages();
-    auto numI2 = allPrecMats.size();
-    // Loop over subband PMI value i2 and store the capacity for each subband and each i2
-    DoubleMatrixArray subbandCap{nSubbands, numI2};
-    for (auto i2 = size_t{0}; i2 < numI2; i2++)
-    {
-        const auto& sbPrecMat = allPrecMats[i2];
-        auto sinr = sbNormChanMat.ComputeSinrForPrecoding(sbPrecMat);
-        for (auto iSb = size_t{0}; iSb < nSubbands; iSb++)
-        {
-            double currCap = 0;
-            for (size_t iLayer = 0; iLayer < sinr.GetNumRows(); iLayer++)
-            {
-                currCap += log2(1.0 + sinr(iLayer, iSb));
-            }
-            subbandCap(iSb, i2) = currCap;
-        }
-    }
-    return subbandCap;
+    const auto& bank = m_rankParams[rank].bank;
+    NS_ASSERT_MSG(bank, "The precoder bank of rank " << +rank << " does not exist");
+    NS_ASSERT(i1 < bank->precMatsForI1.size());
+    return sbNormChanMat.ComputeCapacityForPrecoderBank(bank->precMatsForI1[i1], rank);
 }
 
 } // namespace ns3
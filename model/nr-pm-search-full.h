@@ -52,12 +52,32 @@ class NrPmSearchFull : public NrPmSearch
     void SetCodebookAttribute(const std::string& attrName, const AttributeValue& attrVal);
 
   protected:
+    /// \brief The base precoding matrices of a codebook, for all the (i1, i2) values of a rank.
+    /// The bank is computed once per codebook configuration, and it is shared by all the
+    /// NrPmSearchFull instances that use the same configuration.
+    struct PrecoderBank : public SimpleRefCount<PrecoderBank>
+    {
+        /// For each i1, the base precoding matrices of all the i2 values, concatenated along the
+        /// columns (dim: nGnbPorts * (rank * numI2)). A single page is stored, which applies
+        /// to all the subbands.
+        std::vector<ComplexMatrixArray> precMatsForI1;
+        size_t numI2{0}; ///< Number of i2 values
+    };
+
     struct RankParams
     {
         Ptr<PrecMatParams> precParams; ///< The precoding parameters (WB/SB PMIs)
         Ptr<NrCbTypeOne> cb;           ///< The codebook
+        Ptr<const PrecoderBank> bank;  ///< The base precoding matrices of the codebook
     };
 
+    /// \brief Get the precoder bank of a codebook, creating it if it is not cached yet.
+    /// \param cbConfig the string that identifies the codebook configuration (type, attributes)
+    /// \param cb the codebook
+    /// \return the precoder bank
+    static Ptr<const PrecoderBank> GetPrecoderBank(const std::string& cbConfig,
+                                                   Ptr<const NrCbTypeOne> cb);
+
     /// \brief Update the WB and/or SB PMI, or neither.
     /// \param rbNormChanMat the interference-normed channel matrix per RB
     /// \param pmiUpdate the struct defining if updates to SB or WB PMI are necessary
@@ -65,11 +85,19 @@ class NrPmSearchFull : public NrPmSearch
 
     /// \brief For all ranks, update the optimum precoding matrices (wideband and subband).
     /// \param rbNormChanMat the interference-normed channel matrix per RB
-    void UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat);
+    virtual void UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat);
 
     /// \brief For all ranks, update the opt subband PMI assuming previous value of wideband PMI.
     /// \param rbNormChanMat the interference-normed channel matrix per RB
-    void UpdateSubbandPrecoding(const NrIntfNormChanMat& rbNormChanMat);
+    virtual void UpdateSubbandPrecoding(const NrIntfNormChanMat& rbNormChanMat);
+
+    /// \brief Create the CQI feedback message of the rank that results in the largest TB size.
+    /// The ranks are evaluated in the given order, stopping at the first one with CQI 0.
+    /// \param ranks the ranks to evaluate, whose optimal precoding matrices must be available
+    /// \param rbNormChanMat the interference-normed channel matrix per RB
+    /// \return the CQI message of the optimal rank
+    PmCqiInfo CreateCqiForOptRank(const std::vector<uint8_t>& ranks,
+                                  const NrIntfNormChanMat& rbNormChanMat) const;
 
     /// \brief Create CQI feedback message for a particular rank.
     /// \param rank the rank for which to create the CQI feedback
@@ -86,25 +114,16 @@ class NrPmSearchFull : public NrPmSearch
                                                size_t i1,
                                                uint8_t rank) const;
 
-    /// \brief Create the subband precoding matrices for the given wideband precoding.
+    /// \brief Compute the Shannon capacity for each possible subband precoding matrix (i2) in each
+    /// subband, for a fixed wideband precoding matrix.
+    /// All the i2 values are evaluated with a single pass over the channel of each subband.
+    /// \param sbNormChanMat the interference-normed channel matrix per subband
     /// \param i1 the index of the wideband precoding matrix W1
     /// \param rank the rank (number of MIMO layers)
-    /// \param nSubbands the number of subbands (desired number of pages in each precoding matrix)
-    /// \return a vector of all possible precoding matrices for fixed i1 and rank
-    std::vector<ComplexMatrixArray> CreateSubbandPrecoders(size_t i1,
-                                                           uint8_t rank,
-                                                           size_t nSubbands) const;
-
-    static ComplexMatrixArray ExpandPrecodingMatrix(ComplexMatrixArray basePrecMat,
-                                                    size_t nSubbands);
-
-    /// \brief Compute the Shannon capacity for each possible precoding matrix in each subband.
-    /// \param sbNormChanMat the interference-normed channel matrix per subband
-    /// \param allPrecMats a vector of all possible subband precoding matrices for fixed i1 and rank
-    /// \return a matrix with the capacity values (nSubbands x allPrecMats.size())
-    DoubleMatrixArray ComputeCapacityForPrecoders(
-        const NrIntfNormChanMat& sbNormChanMat,
-        std::vector<ComplexMatrixArray> allPrecMats) const;
+    /// \return a matrix with the capacity values (nSubbands x numI2)
+    DoubleMatrixArray ComputeCapacityForPrecoders(const NrIntfNormChanMat& sbNormChanMat,
+                                                  size_t i1,
+                                                  uint8_t rank) const;
 
     std::vector<RankParams> m_rankParams; ///< The parameters (PMI values, codebook) for each rank
     ObjectFactory m_cbFactory;            ///< The factory used to create the codebooks
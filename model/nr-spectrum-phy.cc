@@ -19,6 +19,9 @@
 #include <ns3/lte-radio-bearer-tag.h>
 #include <ns3/trace-source-accessor.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3
 {
 
@@ -62,6 +65,8 @@ NrSpectrumPhy::NrSpectrumPhy()
 {
     m_interferenceData = CreateObject<NrInterference>();
     m_interferenceCtrl = CreateObject<NrInterference>();
+    // The interference objects see the same signals: share the covariance matrices of the signals
+    m_interferenceCtrl->SetSignalCovCache(m_interferenceData->GetSignalCovCache());
     m_random = CreateObject<UniformRandomVariable>();
     m_random->SetAttribute("Min", DoubleValue(0.0));
     m_random->SetAttribute("Max", DoubleValue(1.0));
@@ -98,6 +103,12 @@ NrSpectrumPhy::DoDispose()
         m_interferenceSrs = nullptr;
     }
 
+    if (m_interferenceCsiRs)
+    {
+        m_interferenceCsiRs->Dispose();
+        m_interferenceCsiRs = nullptr;
+    }
+
     m_interferenceData = nullptr;
     m_interferenceCtrl = nullptr;
     m_mobility = nullptr;
@@ -137,6 +148,23 @@ NrSpectrumPhy::GetTypeId()
                 BooleanValue(false),
                 MakeBooleanAccessor(&NrSpectrumPhy::SetUnlicensedMode),
                 MakeBooleanChecker())
+            .AddAttribute("InterferencePruning",
+                          "Leave out of the interference calculations the signals of the other "
+                          "cells that are too weak to change the SINR significantly. In "
+                          "unlicensed mode, they are still added to the data interference, "
+                          "which measures the energy of the channel for the CCA",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrSpectrumPhy::m_interferencePruning),
+                          MakeBooleanChecker())
+            .AddAttribute("InterferencePruningThreshold",
+                          "Bound of the total power of the pruned interfering signals, on every "
+                          "RB, relative to the noise (dB). The SINR error is lower than "
+                          "10 log10 (1 + InterferencePruningThreshold) dB, e.g., 0.0043 dB "
+                          "with -30 dB.",
+                          DoubleValue(-30.0),
+                          MakeDoubleAccessor(&NrSpectrumPhy::SetInterferencePruningThreshold,
+                                             &NrSpectrumPhy::GetInterferencePruningThreshold),
+                          MakeDoubleChecker<double>())
             .AddAttribute("CcaMode1Threshold",
                           "The energy of a received signal should be higher than "
                           "this threshold (dbm) to allow the PHY layer to declare CCA BUSY state.",
@@ -185,7 +213,11 @@ NrSpectrumPhy::GetTypeId()
             .AddTraceSource("DlDataPathloss",
                             "Pathloss calculated for CTRL",
                             MakeTraceSourceAccessor(&NrSpectrumPhy::m_dlDataPathlossTrace),
-                            "ns3::NrSpectrumPhy::DlPathlossTrace");
+                            "ns3::NrSpectrumPhy::DlPathlossTrace")
+            .AddTraceSource("PrunedInterference",
+                            "An interfering signal left out of the interference calculations",
+                            MakeTraceSourceAccessor(&NrSpectrumPhy::m_prunedInterferenceTrace),
+                            "ns3::NrSpectrumPhy::PrunedInterferenceTracedCallback");
 
     return tid;
 }
@@ -244,6 +276,7 @@ NrSpectrumPhy::SetDevice(Ptr<NetDevice> d)
     if (m_isEnb)
     {
         m_interferenceSrs = CreateObject<NrInterference>();
+        m_interferenceSrs->SetSignalCovCache(m_interferenceData->GetSignalCovCache());
         m_interferenceSrs->TraceConnectWithoutContext(
             "SnrPerProcessedChunk",
             MakeCallback(&NrSpectrumPhy::UpdateSrsSnrPerceived, this));
@@ -347,6 +380,19 @@ NrSpectrumPhy::SetCcaMode1Threshold(double thresholdDBm)
     m_ccaMode1ThresholdW = (std::pow(10.0, thresholdDBm / 10.0)) / 1000.0;
 }
 
+void
+NrSpectrumPhy::SetInterferencePruningThreshold(double thresholdDb)
+{
+    NS_LOG_FUNCTION(this << thresholdDb);
+    m_pruningThreshold = std::pow(10.0, thresholdDb / 10.0);
+}
+
+double
+NrSpectrumPhy::GetInterferencePruningThreshold() const
+{
+    return 10.0 * std::log10(m_pruningThreshold);
+}
+
 double
 NrSpectrumPhy::GetCcaMode1Threshold() const
 {
@@ -381,12 +427,17 @@ NrSpectrumPhy::SetNoisePowerSpectralDensity(const Ptr<const SpectrumValue>& nois
     NS_LOG_FUNCTION(this << noisePsd);
     NS_ASSERT(noisePsd);
     m_rxSpectrumModel = noisePsd->GetSpectrumModel();
+    m_noisePsd = noisePsd;
     m_interferenceData->SetNoisePowerSpectralDensity(noisePsd);
     m_interferenceCtrl->SetNoisePowerSpectralDensity(noisePsd);
     if (m_interferenceSrs)
     {
         m_interferenceSrs->SetNoisePowerSpectralDensity(noisePsd);
     }
+    if (m_interferenceCsiRs)
+    {
+        m_interferenceCsiRs->SetNoisePowerSpectralDensity(noisePsd);
+    }
 }
 
 void
@@ -409,11 +460,18 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
     Time duration = params->duration;
     NS_LOG_INFO("Start receiving signal: " << rxPsd << " duration= " << duration);
 
-    // pass it to interference calculations regardless of the type (nr or non-nr)
-    m_interferenceData->AddSignalMimo(params, duration);
+    const bool pruned = m_interferencePruning && PruneInterference(params);
+
+    // pass it to interference calculations regardless of the type (nr or non-nr). In unlicensed
+    // mode, the data interference also measures the energy of the channel for the CCA, so even
+    // the pruned signals are added to it
+    if (!pruned || m_unlicensedMode)
+    {
+        m_interferenceData->AddSignalMimo(params, duration);
+    }
 
     // pass the signal to the interference calculator regardless of the type (nr or non-nr)
-    if (m_interferenceSrs)
+    if (m_interferenceSrs && !pruned)
     {
         m_interferenceSrs->AddSignalMimo(params, duration);
     }
@@ -427,6 +485,17 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
     Ptr<NrSpectrumSignalParametersUlCtrlFrame> ulCtrlRxParams =
         DynamicCast<NrSpectrumSignalParametersUlCtrlFrame>(params);
 
+    Ptr<NrSpectrumSignalParametersCsiRs> csiRsRxParams =
+        DynamicCast<NrSpectrumSignalParametersCsiRs>(params);
+
+    // The CSI-RS and the DL CTRL use different resource elements: no DL CTRL interferes with
+    // the CSI-RS. The load of the neighbor cells is represented by their CSI-RS, which is sent
+    // with the same power, so counting their DL CTRL too would count their interference twice
+    if (m_interferenceCsiRs && !pruned && !dlCtrlRxParams)
+    {
+        m_interferenceCsiRs->AddSignalMimo(params, duration);
+    }
+
     if (nrDataRxParams)
     {
         if (nrDataRxParams->cellId == GetCellId())
@@ -436,11 +505,13 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
             //  - or if the receiver device is either a gNB or not configured (has no RNTI)
             auto isIntendedRx = (nrDataRxParams->rnti == m_rnti) || !m_hasRnti;
 
-            // Workaround: always receive the signal, to keep performance equal to OSS code.
-            // This ensures all UEs can generate CQI feedback from data signals, even from those
-            // signals that are intended for other UEs in the same cell.
-            // TODO: implement proper CSI-RS signalling for CQI and disable this workaround
-            isIntendedRx = true;
+            // Without CSI-RS, receive all the signals, so that all UEs can generate CQI feedback
+            // from data signals, even from those signals that are intended for other UEs in the
+            // same cell
+            if (!m_interferenceCsiRs)
+            {
+                isIntendedRx = true;
+            }
 
             if (isIntendedRx)
             {
@@ -468,7 +539,10 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
     }
     else if (dlCtrlRxParams != nullptr)
     {
-        m_interferenceCtrl->AddSignalMimo(params, duration);
+        if (!pruned)
+        {
+            m_interferenceCtrl->AddSignalMimo(params, duration);
+        }
 
         if (!m_isEnb)
         {
@@ -520,6 +594,19 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
             NS_LOG_DEBUG("DL CTRL ignored at gNB");
         }
     }
+    else if (csiRsRxParams != nullptr)
+    {
+        if (m_interferenceCsiRs && csiRsRxParams->cellId == GetCellId() && m_hasRnti &&
+            csiRsRxParams->rnti == m_rnti)
+        {
+            StartRxCsiRs(csiRsRxParams);
+        }
+        else
+        {
+            NS_LOG_INFO("CSI-RS ignored, not for this device (cellId="
+                        << csiRsRxParams->cellId << ", rnti=" << csiRsRxParams->rnti << ")");
+        }
+    }
     else if (ulCtrlRxParams != nullptr)
     {
         if (m_isEnb) // only gNBs should enter into reception of UL CTRL signals
@@ -560,6 +647,80 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
     }
 }
 
+bool
+NrSpectrumPhy::PruneInterference(const Ptr<const SpectrumSignalParameters>& params)
+{
+    // The signals of this cell may be received, or interfere with the ones received
+    if (auto data = DynamicCast<const NrSpectrumSignalParametersDataFrame>(params))
+    {
+        if (data->cellId == GetCellId())
+        {
+            return false;
+        }
+    }
+    else if (auto dlCtrl = DynamicCast<const NrSpectrumSignalParametersDlCtrlFrame>(params))
+    {
+        if (dlCtrl->cellId == GetCellId())
+        {
+            return false;
+        }
+    }
+    else if (auto ulCtrl = DynamicCast<const NrSpectrumSignalParametersUlCtrlFrame>(params))
+    {
+        if (ulCtrl->cellId == GetCellId())
+        {
+            return false;
+        }
+    }
+    else if (auto csiRs = DynamicCast<const NrSpectrumSignalParametersCsiRs>(params))
+    {
+        if (csiRs->cellId == GetCellId())
+        {
+            return false;
+        }
+    }
+
+    if (!m_noisePsd || params->psd->GetSpectrumModel() != m_noisePsd->GetSpectrumModel())
+    {
+        return false;
+    }
+
+    // The highest ratio to the noise over the RBs
+    double ratio = 0.0;
+    auto noise = m_noisePsd->ConstValuesBegin();
+    for (auto psd = params->psd->ConstValuesBegin(); psd != params->psd->ConstValuesEnd();
+         ++psd, ++noise)
+    {
+        ratio = std::max(ratio, *psd / *noise);
+        if (m_prunedRatio + ratio > m_pruningThreshold)
+        {
+            return false;
+        }
+    }
+
+    m_prunedRatio += ratio;
+    m_numPruned++;
+    Simulator::Schedule(params->duration, &NrSpectrumPhy::EndPrunedInterference, this, ratio);
+    NS_LOG_LOGIC("Pruned interfering signal with ratio to the noise " << ratio);
+    m_prunedInterferenceTrace(Integral(*params->psd), params->duration);
+    return true;
+}
+
+void
+NrSpectrumPhy::EndPrunedInterference(double ratio)
+{
+    NS_ASSERT(m_numPruned > 0);
+    if (--m_numPruned == 0)
+    {
+        // Restart from an exact zero, so that the rounding errors do not accumulate
+        m_prunedRatio = 0.0;
+    }
+    else
+    {
+        m_prunedRatio -= ratio;
+    }
+}
+
 void
 NrSpectrumPhy::StartTxDataFrames(const Ptr<PacketBurst>& pb,
                                  const std::list<Ptr<NrControlMessage>>& ctrlMsgList,
@@ -675,7 +836,8 @@ NrSpectrumPhy::StartTxDlControlFrames(const std::list<Ptr<NrControlMessage>>& ct
         txParams->psd = m_txPsd;
         txParams->cellId = GetCellId();
         txParams->pss = true;
-        txParams->ctrlMsgList = ctrlMsgList;
+        // Each UE gets only its own DCIs, without copying the whole list
+        txParams->ctrlMsgIndex = std::make_shared<const NrDlCtrlMsgIndex>(ctrlMsgList);
 
         m_txCtrlTrace(duration);
         if (m_channel)
@@ -766,6 +928,87 @@ NrSpectrumPhy::AddSrsSinrChunkProcessor(const Ptr<LteChunkProcessor>& p)
     m_interferenceSrs->AddSinrChunkProcessor(p);
 }
 
+void
+NrSpectrumPhy::StartTxCsiRs(uint16_t rnti, const Time& duration)
+{
+    NS_LOG_FUNCTION(this << rnti << duration);
+    NS_ASSERT_MSG(m_isEnb, "Only gNBs transmit the CSI-RS");
+
+    switch (m_state)
+    {
+    case RX_DATA:
+        /* no break */
+    case RX_DL_CTRL:
+        /* no break */
+    case RX_UL_CTRL:
+        /* no break*/
+    case RX_UL_SRS:
+        NS_FATAL_ERROR("Cannot TX while RX.");
+        break;
+    case TX:
+        // The CSI-RS is transmitted together with the DL CTRL
+        /* no break */
+    case CCA_BUSY:
+        /* no break */
+    case IDLE: {
+        NS_ASSERT(m_txPsd);
+        ChangeState(TX, duration);
+        Ptr<NrSpectrumSignalParametersCsiRs> txParams = Create<NrSpectrumSignalParametersCsiRs>();
+        txParams->duration = duration;
+        txParams->txPhy = GetObject<SpectrumPhy>();
+        txParams->psd = m_txPsd;
+        txParams->cellId = GetCellId();
+        txParams->rnti = rnti;
+
+        if (m_channel)
+        {
+            m_channel->StartTx(txParams);
+        }
+        else
+        {
+            NS_LOG_WARN("Working without channel (i.e., under test)");
+        }
+
+        Simulator::Schedule(duration, &NrSpectrumPhy::EndTx, this);
+        m_activeTransmissions++;
+    }
+    }
+}
+
+void
+NrSpectrumPhy::EnableCsiRs()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(!m_isEnb, "The CSI-RS is received only by UEs");
+    if (!m_interferenceCsiRs)
+    {
+        m_interferenceCsiRs = CreateObject<NrInterference>();
+        m_interferenceCsiRs->SetSignalCovCache(m_interferenceData->GetSignalCovCache());
+    }
+}
+
+bool
+NrSpectrumPhy::IsCsiRsEnabled() const
+{
+    return m_interferenceCsiRs != nullptr;
+}
+
+void
+NrSpectrumPhy::AddCsiRsSinrChunkProcessor(const Ptr<LteChunkProcessor>& p)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(m_interferenceCsiRs, "The CSI-RS is not enabled");
+    m_interferenceCsiRs->AddSinrChunkProcessor(p);
+}
+
+void
+NrSpectrumPhy::AddCsiRsMimoChunkProcessor(const Ptr<NrMimoChunkProcessor>& p)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(m_interferenceCsiRs, "The CSI-RS is not enabled");
+    m_interferenceCsiRs->AddMimoChunkProcessor(p);
+}
+
 void
 NrSpectrumPhy::ReportDlCtrlSinr(const SpectrumValue& sinr)
 {
@@ -1037,8 +1280,10 @@ NrSpectrumPhy::StartRxDlCtrl(const Ptr<NrSpectrumSignalParametersDlCtrlFrame>& p
         NS_ASSERT(m_rxControlMessageList.empty());
         NS_LOG_LOGIC(this << "receiving DL CTRL from cellId:" << params->cellId
                           << "and scheduling EndRx with delay " << params->duration);
-        // store the DCIs
-        m_rxControlMessageList = params->ctrlMsgList;
+        // store the DCIs of this UE, and the messages for all the UEs
+        m_rxControlMessageList = params->ctrlMsgIndex
+                                     ? params->ctrlMsgIndex->GetMessages(m_hasRnti ? m_rnti : 0)
+                                     : params->ctrlMsgList;
         Simulator::Schedule(params->duration, &NrSpectrumPhy::EndRxCtrl, this);
         ChangeState(RX_DL_CTRL, params->duration);
         break;
@@ -1579,6 +1824,26 @@ NrSpectrumPhy::EndRxCtrl()
     m_rxControlMessageList.clear();
 }
 
+void
+NrSpectrumPhy::StartRxCsiRs(const Ptr<NrSpectrumSignalParametersCsiRs>& params)
+{
+    NS_LOG_FUNCTION(this);
+    if (m_state == TX)
+    {
+        NS_LOG_INFO("CSI-RS ignored while transmitting");
+        return;
+    }
+    m_interferenceCsiRs->StartRxMimo(params);
+    Simulator::Schedule(params->duration, &NrSpectrumPhy::EndRxCsiRs, this);
+}
+
+void
+NrSpectrumPhy::EndRxCsiRs()
+{
+    NS_LOG_FUNCTION(this);
+    m_interferenceCsiRs->EndRx();
+}
+
 void
 NrSpectrumPhy::EndRxSrs()
 {
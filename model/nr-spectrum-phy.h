@@ -240,6 +240,17 @@ class NrSpectrumPhy : public SpectrumPhy
      * \brief Sets the error model type
      */
     void SetErrorModelType(TypeId errorModelType);
+    /**
+     * \brief Set the threshold of the interference pruning
+     * \param thresholdDb the bound of the power of the pruned interference, relative to the
+     * noise, in dB
+     */
+    void SetInterferencePruningThreshold(double thresholdDb);
+    /**
+     * \brief Get the threshold of the interference pruning
+     * \return the bound of the power of the pruned interference, relative to the noise, in dB
+     */
+    double GetInterferencePruningThreshold() const;
 
     // other methods
     /**
@@ -305,6 +316,38 @@ class NrSpectrumPhy : public SpectrumPhy
      */
     void AddSrsSinrChunkProcessor(const Ptr<LteChunkProcessor>& p);
 
+    /**
+     * \brief Starts the transmission of the CSI-RS of a UE, over the whole bandwidth. It can
+     * overlap with the DL CTRL transmission.
+     * \param rnti the RNTI of the UE
+     * \param duration the duration of the transmission
+     */
+    void StartTxCsiRs(uint16_t rnti, const Time& duration);
+
+    /**
+     * \brief Enables the reception of the CSI-RS at a UE. From then on, the UE measures the
+     * channel quality on its CSI-RS (and on its own DL data), and it does not receive anymore
+     * the DL data of the other UEs of the cell.
+     */
+    void EnableCsiRs();
+
+    /**
+     * \return true if the reception of the CSI-RS is enabled
+     */
+    bool IsCsiRsEnabled() const;
+
+    /**
+     * \brief Adds the chunk processor that will process the SINR of the CSI-RS at UEs
+     * \param p the chunk processor
+     */
+    void AddCsiRsSinrChunkProcessor(const Ptr<LteChunkProcessor>& p);
+
+    /**
+     * \brief Adds the MIMO chunk processor that will process the CSI-RS at UEs
+     * \param p the chunk processor
+     */
+    void AddCsiRsMimoChunkProcessor(const Ptr<NrMimoChunkProcessor>& p);
+
     /**
      * \brief Adds the chunk processor that will process the received power
      * \param p the chunk processor
@@ -404,6 +447,14 @@ class NrSpectrumPhy : public SpectrumPhy
                                          uint16_t bwpId,
                                          uint16_t cellId);
 
+    /**
+     * \brief TracedCallback signature for the interfering signals that are pruned
+     *
+     * \param [in] rxPowerW the received power of the signal, in W
+     * \param [in] duration the duration of the signal
+     */
+    typedef void (*PrunedInterferenceTracedCallback)(double rxPowerW, Time duration);
+
     void AddExpectedSrsRnti(uint16_t rnti);
 
     /*
@@ -486,6 +537,24 @@ class NrSpectrumPhy : public SpectrumPhy
      * \param params holds DL CTRL frame signal parameters structure
      */
     void StartRxDlCtrl(const Ptr<NrSpectrumSignalParametersDlCtrlFrame>& params);
+    /**
+     * \brief Decide whether a received signal is left out of the interference calculations
+     *
+     * A signal of another cell is pruned when its power is, on every RB, so low that the power
+     * of all the pruned signals that are being received, added up RB by RB, stays below
+     * InterferencePruningThreshold times the noise. The SINR error due to the pruning is then
+     * lower than 10 log10 (1 + InterferencePruningThreshold) dB. In unlicensed mode, the pruned
+     * signals are still added to the data interference, whose energy detection drives the CCA.
+     *
+     * \param params the received signal
+     * \return true if the signal is pruned
+     */
+    bool PruneInterference(const Ptr<const SpectrumSignalParameters>& params);
+    /**
+     * \brief Remove the bound of a pruned signal from the pruned power, at the end of the signal
+     * \param ratio the ratio to the noise of the pruned signal
+     */
+    void EndPrunedInterference(double ratio);
     /**
      * \brief Function that is called when is being received UL CTRL
      * \param params holds UL CTRL frame signal parameters structure
@@ -497,6 +566,13 @@ class NrSpectrumPhy : public SpectrumPhy
      * one CTRL message which should be of type SRS
      */
     void StartRxSrs(const Ptr<NrSpectrumSignalParametersUlCtrlFrame>& params);
+    /**
+     * \brief Function that is called when the CSI-RS of this UE is being received. The
+     * reception does not change the state of the spectrum phy, since it overlaps with the
+     * reception of the DL CTRL.
+     * \param params the CSI-RS signal parameters
+     */
+    void StartRxCsiRs(const Ptr<NrSpectrumSignalParametersCsiRs>& params);
     /**
      * \return true if this class is inside an enb/gnb
      */
@@ -539,6 +615,12 @@ class NrSpectrumPhy : public SpectrumPhy
      * state.
      */
     void EndRxSrs();
+    /**
+     * \brief Function that is called when the spectrum phy finishes the reception of the
+     * CSI-RS. It notifies the interference calculator, which triggers the CSI-RS chunk
+     * processors.
+     */
+    void EndRxCsiRs();
     /**
      * \brief Check if the channel is busy. If yes, updates the spectrum phy state.
      */
@@ -600,6 +682,11 @@ class NrSpectrumPhy : public SpectrumPhy
         false}; //!< Whether this spectrum phy is configure to work in an unlicensed mode.
                 //   Unlicensed mode additionally to licensed mode allows channel monitoring to
                 //   discover if is busy before transmission.
+    bool m_interferencePruning{false};            //!< Whether weak interferers are pruned
+    double m_pruningThreshold{0.0};               //!< Bound of the pruned power, to the noise
+    double m_prunedRatio{0.0};                    //!< Pruned power (RB max), to the noise
+    uint32_t m_numPruned{0};                      //!< Number of pruned signals being received
+    Ptr<const SpectrumValue> m_noisePsd{nullptr}; //!< The noise PSD
 
     Ptr<SpectrumChannel> m_channel{
         nullptr}; //!< channel is needed to be able to connect listener spectrum phy (AddRx) or to
@@ -623,6 +710,9 @@ class NrSpectrumPhy : public SpectrumPhy
     Ptr<NrInterference> m_interferenceSrs{
         nullptr}; //!< the interference object used to calculate the interference for this spectrum
                   //!< phy, exists only at gNB phy
+    Ptr<NrInterference> m_interferenceCsiRs{
+        nullptr}; //!< the interference object used to calculate the SINR of the CSI-RS, exists
+                  //!< only at UE phy when the CSI-RS is enabled
     Ptr<SpectrumValue> m_txPsd{nullptr};          //!< tx power spectral density
     Ptr<UniformRandomVariable> m_random{nullptr}; //!< the random variable used for TB decoding
 
@@ -705,6 +795,8 @@ class NrSpectrumPhy : public SpectrumPhy
     DlDataPathlossTrace m_dlDataPathlossTrace; //!< DL DATA pathloss trace
     bool m_enableDlDataPathlossTrace =
         false; //!< By default this trace is disabled to not slow done simulations
+    TracedCallback<double, Time>
+        m_prunedInterferenceTrace; //!< Trace of the interfering signals that are pruned
     bool m_isEnb = false;
 };
 
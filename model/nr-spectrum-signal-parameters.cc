@@ -51,6 +51,66 @@ NrSpectrumSignalParametersDataFrame::Copy() const
     return lssp;
 }
 
+NrDlCtrlMsgIndex::NrDlCtrlMsgIndex(const std::list<Ptr<NrControlMessage>>& ctrlMsgList)
+    : m_all(ctrlMsgList)
+{
+    NS_LOG_FUNCTION(this);
+    size_t position = 0;
+    for (const auto& msg : ctrlMsgList)
+    {
+        uint16_t rnti = 0;
+        if (msg->GetMessageType() == NrControlMessage::DL_DCI)
+        {
+            rnti = DynamicCast<NrDlDciMessage>(msg)->GetDciInfoElement()->m_rnti;
+        }
+        else if (msg->GetMessageType() == NrControlMessage::UL_DCI)
+        {
+            rnti = DynamicCast<NrUlDciMessage>(msg)->GetDciInfoElement()->m_rnti;
+        }
+
+        if (rnti == 0)
+        {
+            m_common.emplace_back(position, msg);
+        }
+        else
+        {
+            m_dcis[rnti].emplace_back(position, msg);
+        }
+        position++;
+    }
+}
+
+std::list<Ptr<NrControlMessage>>
+NrDlCtrlMsgIndex::GetMessages(uint16_t rnti) const
+{
+    static const std::vector<Entry> noDcis;
+    auto it = rnti != 0 ? m_dcis.find(rnti) : m_dcis.end();
+    const auto& dcis = it != m_dcis.end() ? it->second : noDcis;
+
+    // Merge the DCIs and the common messages, by position
+    std::list<Ptr<NrControlMessage>> msgs;
+    auto dci = dcis.begin();
+    auto common = m_common.begin();
+    while (dci != dcis.end() || common != m_common.end())
+    {
+        if (common == m_common.end() || (dci != dcis.end() && dci->first < common->first))
+        {
+            msgs.push_back((dci++)->second);
+        }
+        else
+        {
+            msgs.push_back((common++)->second);
+        }
+    }
+    return msgs;
+}
+
+const std::list<Ptr<NrControlMessage>>&
+NrDlCtrlMsgIndex::GetAllMessages() const
+{
+    return m_all;
+}
+
 NrSpectrumSignalParametersDlCtrlFrame::NrSpectrumSignalParametersDlCtrlFrame()
 {
     NS_LOG_FUNCTION(this);
@@ -64,6 +124,7 @@ NrSpectrumSignalParametersDlCtrlFrame::NrSpectrumSignalParametersDlCtrlFrame(
     cellId = p.cellId;
     pss = p.pss;
     ctrlMsgList = p.ctrlMsgList;
+    ctrlMsgIndex = p.ctrlMsgIndex;
 }
 
 Ptr<SpectrumSignalParameters>
@@ -112,4 +173,27 @@ NrSpectrumSignalParametersUlCtrlFrame::Copy() const
     return lssp;
 }
 
+NrSpectrumSignalParametersCsiRs::NrSpectrumSignalParametersCsiRs()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrSpectrumSignalParametersCsiRs::NrSpectrumSignalParametersCsiRs(
+    const NrSpectrumSignalParametersCsiRs& p)
+    : SpectrumSignalParameters(p)
+{
+    NS_LOG_FUNCTION(this << &p);
+    cellId = p.cellId;
+    rnti = p.rnti;
+}
+
+Ptr<SpectrumSignalParameters>
+NrSpectrumSignalParametersCsiRs::Copy() const
+{
+    NS_LOG_FUNCTION(this);
+    // See the comment in NrSpectrumSignalParametersDlCtrlFrame::Copy
+    Ptr<NrSpectrumSignalParametersCsiRs> lssp(new NrSpectrumSignalParametersCsiRs(*this), false);
+    return lssp;
+}
+
 } // namespace ns3
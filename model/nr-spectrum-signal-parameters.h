@@ -10,6 +10,10 @@
 #include <ns3/spectrum-signal-parameters.h>
 
 #include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace ns3
 {
@@ -47,6 +51,47 @@ struct NrSpectrumSignalParametersDataFrame : public SpectrumSignalParameters
     uint16_t rnti{0};                             //!< RNTI of the transmitting or receiving UE
 };
 
+/**
+ * \ingroup gnb-phy
+ * \ingroup ue-phy
+ *
+ * \brief The messages of a DL CTRL frame, indexed by the RNTI of the UE they are for
+ *
+ * The DL and UL DCIs with a RNTI are stored with the RNTI, and all the other messages (MIB,
+ * SIB1, RAR, DCIs with RNTI 0, ...) are common to all the UEs. A UE gets its messages without
+ * going through the DCIs of the other UEs.
+ */
+class NrDlCtrlMsgIndex
+{
+  public:
+    /**
+     * \brief Index the messages of a DL CTRL frame
+     * \param ctrlMsgList the messages, in the order of the frame
+     */
+    explicit NrDlCtrlMsgIndex(const std::list<Ptr<NrControlMessage>>& ctrlMsgList);
+
+    /**
+     * \brief Get the messages for a UE
+     * \param rnti the RNTI of the UE, or 0 if it has none
+     * \return the DCIs of the UE and the common messages, in the order of the frame
+     */
+    std::list<Ptr<NrControlMessage>> GetMessages(uint16_t rnti) const;
+
+    /**
+     * \brief Get all the messages
+     * \return the messages, in the order of the frame
+     */
+    const std::list<Ptr<NrControlMessage>>& GetAllMessages() const;
+
+  private:
+    /// A message and its position in the frame
+    using Entry = std::pair<size_t, Ptr<NrControlMessage>>;
+
+    std::list<Ptr<NrControlMessage>> m_all;                  //!< All the messages
+    std::unordered_map<uint16_t, std::vector<Entry>> m_dcis; //!< The DCIs, by RNTI
+    std::vector<Entry> m_common;                             //!< The messages for all the UEs
+};
+
 /**
  * \ingroup gnb-phy
  * \ingroup ue-phy
@@ -75,6 +120,9 @@ struct NrSpectrumSignalParametersDlCtrlFrame : public SpectrumSignalParameters
     std::list<Ptr<NrControlMessage>> ctrlMsgList; //!< CTRL message list
     bool pss;                                     //!< PSS (?)
     uint16_t cellId;                              //!< cell id
+    /// The messages indexed by RNTI, shared by the copies of the signal. When it is set,
+    /// ctrlMsgList is empty, so that the copy for each receiver does not copy all the messages
+    std::shared_ptr<const NrDlCtrlMsgIndex> ctrlMsgIndex;
 };
 
 /**
@@ -106,6 +154,35 @@ struct NrSpectrumSignalParametersUlCtrlFrame : public SpectrumSignalParameters
     uint16_t cellId;                              //!< cell id
 };
 
+/**
+ * \ingroup gnb-phy
+ * \ingroup ue-phy
+ *
+ * \brief CSI-RS signal representation for the module
+ *
+ * The CSI-RS is transmitted by the gNB over the whole bandwidth, with the beam of the
+ * UE, and it is used by the UE only to measure the channel quality (CQI, PMI and RI).
+ */
+struct NrSpectrumSignalParametersCsiRs : public SpectrumSignalParameters
+{
+    // inherited from SpectrumSignalParameters
+    Ptr<SpectrumSignalParameters> Copy() const override;
+
+    /**
+     * \brief NrSpectrumSignalParametersCsiRs
+     */
+    NrSpectrumSignalParametersCsiRs();
+
+    /**
+     * \brief NrSpectrumSignalParametersCsiRs copy constructor
+     * \param p the object from which we have to copy from
+     */
+    NrSpectrumSignalParametersCsiRs(const NrSpectrumSignalParametersCsiRs& p);
+
+    uint16_t cellId{0}; //!< cell id
+    uint16_t rnti{0};   //!< RNTI of the UE to which the CSI-RS is configured
+};
+
 } // namespace ns3
 
 #endif /* NR_SPECTRUM_SIGNAL_PARAMETERS_H */
@@ -153,6 +153,14 @@ NrUePhy::GetTypeId()
                             "Report the SINR computed for DL CTRL",
                             MakeTraceSourceAccessor(&NrUePhy::m_dlCtrlSinrTrace),
                             "ns3::NrUePhy::DlCtrlSinrTracedCallback")
+            .AddAttribute("SkipIdleCtrlSymbols",
+                          "If true, the UL CTRL at the end of a slot is not processed when the UE "
+                          "has no control messages to transmit in it, and the UE waits directly "
+                          "for the next slot. Only used with an always-on channel access manager "
+                          "and a single bandwidth part.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrUePhy::m_skipIdleCtrlSymbols),
+                          MakeBooleanChecker())
             .AddAttribute("UeMeasurementsFilterPeriod",
                           "Time period for reporting UE measurements, i.e., the"
                           "length of layer-1 filtering.",
@@ -811,9 +819,49 @@ NrUePhy::StartSlot(const SfnSf& s)
         }
     }
 
+    if (IsIdleUlCtrl(allocation.m_dci))
+    {
+        SkipIdleUlCtrl(allocation.m_dci);
+        return;
+    }
+
     Simulator::Schedule(nextVarTtiStart, &NrUePhy::StartVarTti, this, allocation.m_dci);
 }
 
+bool
+NrUePhy::IsIdleUlCtrl(const std::shared_ptr<DciInfoElementTdma>& dci) const
+{
+    if (!m_skipIdleCtrlSymbols || !m_currSlotAllocInfo.m_varTtiAllocInfo.empty() ||
+        dci->m_type != DciInfoElementTdma::CTRL || dci->m_format != DciInfoElementTdma::UL ||
+        !m_ctrlMsgs.empty() || DynamicCast<NrAlwaysOnAccessManager>(m_cam) == nullptr)
+    {
+        return false;
+    }
+    // The PHY of another bandwidth part could route its control messages to this one before the
+    // UL CTRL starts
+    auto ueDev = DynamicCast<NrUeNetDevice>(m_netDevice);
+    return ueDev == nullptr || ueDev->GetCcMapSize() == 1;
+}
+
+void
+NrUePhy::SkipIdleUlCtrl(const std::shared_ptr<DciInfoElementTdma>& dci)
+{
+    NS_LOG_FUNCTION(this);
+    NS_LOG_DEBUG("UE" << m_rnti << " has no UL CTRL to transmit in slot " << m_currentSlot
+                      << ", skip it");
+
+    // What StartVarTti and EndVarTti would have done for the UL CTRL, without any message
+    m_currTbs = dci->m_tbSize;
+    m_receptionEnabled = false;
+
+    SfnSf nextSlot = m_currentSlot;
+    nextSlot.Add(1);
+    Simulator::Schedule(m_lastSlotStart + GetSlotPeriod() - Simulator::Now(),
+                        &NrUePhy::StartSlot,
+                        this,
+                        nextSlot);
+}
+
 Time
 NrUePhy::DlCtrl(const std::shared_ptr<DciInfoElementTdma>& dci)
 {
@@ -1068,10 +1116,17 @@ NrUePhy::EndVarTti(const std::shared_ptr<DciInfoElementTdma>& dci)
 
         Time nextVarTtiStart = GetSymbolPeriod() * allocation.m_dci->m_symStart;
 
-        Simulator::Schedule(nextVarTtiStart + m_lastSlotStart - Simulator::Now(),
-                            &NrUePhy::StartVarTti,
-                            this,
-                            allocation.m_dci);
+        if (IsIdleUlCtrl(allocation.m_dci))
+        {
+            SkipIdleUlCtrl(allocation.m_dci);
+        }
+        else
+        {
+            Simulator::Schedule(nextVarTtiStart + m_lastSlotStart - Simulator::Now(),
+                                &NrUePhy::StartVarTti,
+                                this,
+                                allocation.m_dci);
+        }
     }
 
     m_receptionEnabled = false;
@@ -1152,6 +1207,21 @@ NrUePhy::GenerateDlCqiReport(const SpectrumValue& sinr)
     }
 }
 
+void
+NrUePhy::GenerateCsiRsCqiReport(const SpectrumValue& sinr)
+{
+    NS_LOG_FUNCTION(this);
+    if (m_ulConfigured && (m_rnti > 0) && Simulator::Now() > m_wbCqiLast)
+    {
+        Ptr<NrDlCqiMessage> msg = CreateDlCqiFeedbackMessage(sinr);
+
+        if (msg)
+        {
+            DoSendControlMessage(msg);
+        }
+    }
+}
+
 void
 NrUePhy::EnqueueDlHarqFeedback(const DlHarqInfo& m)
 {
@@ -1581,7 +1651,23 @@ NrUePhy::GenerateDlCqiReportMimo(const std::vector<MimoSignalChunk>& mimoChunks)
     {
         return;
     }
+    SendDlCqiReportMimo(mimoChunks);
+}
+
+void
+NrUePhy::GenerateCsiRsCqiReportMimo(const std::vector<MimoSignalChunk>& mimoChunks)
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_ulConfigured || (m_rnti == 0))
+    {
+        return;
+    }
+    SendDlCqiReportMimo(mimoChunks);
+}
 
+void
+NrUePhy::SendDlCqiReportMimo(const std::vector<MimoSignalChunk>& mimoChunks)
+{
     // Combine multiple signal chunks into a single channel matrix and interference covariance
     auto rxSignal = NrMimoSignal{mimoChunks};
 
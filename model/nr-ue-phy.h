@@ -236,6 +236,16 @@ class NrUePhy : public NrPhy
      */
     void GenerateDlCqiReport(const SpectrumValue& sinr);
 
+    /**
+     * \brief Generate a DL CQI report from the SINR of the CSI-RS of the UE
+     *
+     * Connected by the helper to a callback in the CSI-RS ChunkProcessor. Unlike
+     * GenerateDlCqiReport, the UE does not need to be receiving DL data.
+     *
+     * \param sinr the SINR
+     */
+    void GenerateCsiRsCqiReport(const SpectrumValue& sinr);
+
     /**
      * \brief Get the current RNTI of the user
      *
@@ -438,6 +448,15 @@ class NrUePhy : public NrPhy
     /// \param mimoChunks a vector of parameters of the received signals and interference
     void GenerateDlCqiReportMimo(const std::vector<MimoSignalChunk>& mimoChunks);
 
+    /// \brief Generate DL CQI, PMI, and RI from the CSI-RS of the UE. Unlike
+    /// GenerateDlCqiReportMimo, the UE does not need to be receiving DL data.
+    /// \param mimoChunks a vector of parameters of the received CSI-RS and interference
+    void GenerateCsiRsCqiReportMimo(const std::vector<MimoSignalChunk>& mimoChunks);
+
+    /// \brief Send the DL CQI, PMI, and RI computed from the received signals
+    /// \param mimoChunks a vector of parameters of the received signals and interference
+    void SendDlCqiReportMimo(const std::vector<MimoSignalChunk>& mimoChunks);
+
     /// \brief Check if updates to wideband and/or subband PMI are necessary.
     /// This function is used to limit the frequency of PMI updates because computational complexity
     /// of PMI feedback can be very high, and because PMI feedback requires PUSCH/PUCCH resources.
@@ -584,6 +603,26 @@ class NrUePhy : public NrPhy
      */
     void EndVarTti(const std::shared_ptr<DciInfoElementTdma>& dci);
 
+    /**
+     * \brief Check if the UL CTRL of a DCI can be skipped
+     *
+     * The UL CTRL can be skipped when it is the last allocation of the slot, the UE has no
+     * control messages to transmit in it, the channel access manager is always on, and no other
+     * bandwidth part can route its control messages to this one.
+     *
+     * \param dci the DCI of the next variable TTI of the slot
+     * \return true if the variable TTI is an UL CTRL that can be skipped
+     */
+    bool IsIdleUlCtrl(const std::shared_ptr<DciInfoElementTdma>& dci) const;
+
+    /**
+     * \brief Skip the UL CTRL of a DCI and schedule the start of the next slot
+     * \param dci the DCI of the UL CTRL
+     *
+     * \see IsIdleUlCtrl
+     */
+    void SkipIdleUlCtrl(const std::shared_ptr<DciInfoElementTdma>& dci);
+
     /**
      * \brief Set the Tx power spectral density based on the RB index vector
      * \param mask vector of the index of the RB (in SpectrumValue array)
@@ -788,6 +827,7 @@ class NrUePhy : public NrPhy
     Ptr<NrChAccessManager> m_cam;        //!< Channel Access Manager
     Time m_lbtThresholdForCtrl;          //!< Threshold for LBT before the UL CTRL
     bool m_tryToPerformLbt{false};       //!< Boolean value set in DlCtrl() method
+    bool m_skipIdleCtrlSymbols{false};   //!< Skip the UL CTRL without messages to transmit
     EventId m_lbtEvent;
     uint8_t m_dlCtrlSyms{1}; //!< Number of CTRL symbols in DL
     uint8_t m_ulCtrlSyms{1}; //!< Number of CTRL symbols in UL
@@ -81,7 +81,17 @@ RealisticBeamformingAlgorithm::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&RealisticBeamformingAlgorithm::SetUseSnrSrs,
                                               &RealisticBeamformingAlgorithm::UseSnrSrs),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute(
+                "BatchedBeamSearch",
+                "If true, the long term components of all the beam pairs are computed at once "
+                "from the channel matrix, and the estimation error of each pair and cluster is "
+                "drawn as a single complex normal variable, which has the same distribution as "
+                "the sum of the errors of the channel matrix elements. If false, an error is "
+                "drawn for each element of the channel matrix, for each pair of beams.",
+                BooleanValue(false),
+                MakeBooleanAccessor(&RealisticBeamformingAlgorithm::m_batchedBeamSearch),
+                MakeBooleanChecker());
     return tid;
 }
 
@@ -322,68 +332,87 @@ RealisticBeamformingAlgorithm::GetBeamformingVectors()
         channelMatrix = GetChannelMatrix();
     }
 
-    for (double gnbTheta = 60; gnbTheta < 121; gnbTheta = gnbTheta + m_beamSearchAngleStep)
+    Ptr<UniformPlanarArray> gnbAntenna =
+        m_gnbSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
+    Ptr<UniformPlanarArray> ueAntenna =
+        m_ueSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
+
+    // The UE elevation is truncated to an integer at each step of the search
+    Ptr<const CellScanCodebook> gnbCodebook =
+        GetCellScanCodebook(gnbAntenna, m_beamSearchAngleStep, false);
+    Ptr<const CellScanCodebook> ueCodebook =
+        GetCellScanCodebook(ueAntenna, m_beamSearchAngleStep, true);
+
+    ComplexMatrixArray batchedLongTerm;
+    if (m_batchedBeamSearch)
     {
-        for (uint16_t gnbSector = 0; gnbSector <= gnbNumRows; gnbSector++)
+        batchedLongTerm = GetEstimatedLongTermComponents(channelMatrix,
+                                                         *gnbCodebook,
+                                                         *ueCodebook,
+                                                         srsSinr,
+                                                         gnbAntenna,
+                                                         ueAntenna);
+    }
+
+    for (size_t gnbBeam = 0; gnbBeam < gnbCodebook->bfvs.size(); gnbBeam++)
+    {
+        const PhasedArrayModel::ComplexVector& gnbW = gnbCodebook->bfvs[gnbBeam];
+        uint16_t gnbSector = gnbCodebook->beamIds[gnbBeam].GetSector();
+        double gnbTheta = gnbCodebook->beamIds[gnbBeam].GetElevation();
+
+        for (size_t ueBeam = 0; ueBeam < ueCodebook->bfvs.size(); ueBeam++)
         {
-            NS_ASSERT(gnbSector < UINT16_MAX);
-            m_gnbSpectrumPhy->GetBeamManager()->SetSector(gnbSector, gnbTheta);
-            PhasedArrayModel::ComplexVector gnbW =
-                m_gnbSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
+            const PhasedArrayModel::ComplexVector& ueW = ueCodebook->bfvs[ueBeam];
+            uint16_t ueSector = ueCodebook->beamIds[ueBeam].GetSector();
+            double ueTheta = ueCodebook->beamIds[ueBeam].GetElevation();
 
-            for (double ueTheta = 60; ueTheta < 121;
-                 ueTheta = static_cast<uint16_t>(ueTheta + m_beamSearchAngleStep))
+            double estimatedLongTermMetric = 0;
+            if (m_batchedBeamSearch)
             {
-                for (uint16_t ueSector = 0; ueSector <= ueNumRows; ueSector++)
+                for (size_t cluster = 0; cluster < batchedLongTerm.GetNumPages(); cluster++)
                 {
-                    NS_ASSERT(ueSector < UINT16_MAX);
-                    m_ueSpectrumPhy->GetBeamManager()->SetSector(ueSector, ueTheta);
-                    PhasedArrayModel::ComplexVector ueW =
-                        m_ueSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-                    NS_ABORT_MSG_IF(gnbW.GetSize() == 0 || ueW.GetSize() == 0,
-                                    "Beamforming vectors must be initialized in order to calculate "
-                                    "the long term matrix.");
-
-                    const UniformPlanarArray::ComplexVector estimatedLongTermComponent =
-                        GetEstimatedLongTermComponent(
-                            channelMatrix,
-                            gnbW,
-                            ueW,
-                            m_gnbSpectrumPhy->GetObject<MobilityModel>(),
-                            m_ueSpectrumPhy->GetObject<MobilityModel>(),
-                            srsSinr,
-                            m_gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
-                            m_ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>());
-
-                    double estimatedLongTermMetric =
-                        CalculateTheEstimatedLongTermMetric(estimatedLongTermComponent);
-
-                    NS_LOG_LOGIC(
-                        " Estimated long term metric value: "
-                        << estimatedLongTermMetric << " gnb theta " << gnbTheta << " ue theta "
-                        << ueTheta << " gnb sector "
-                        << (M_PI * static_cast<double>(gnbSector) /
-                                static_cast<double>(gnbNumRows) -
-                            0.5 * M_PI) /
-                               M_PI * 180
-                        << " ue sector "
-                        << (M_PI * static_cast<double>(ueSector) / static_cast<double>(ueNumRows) -
-                            0.5 * M_PI) /
-                               M_PI * 180);
-
-                    if (max < estimatedLongTermMetric)
-                    {
-                        max = estimatedLongTermMetric;
-                        maxTxSector = gnbSector;
-                        maxRxSector = ueSector;
-                        maxTxTheta = gnbTheta;
-                        maxRxTheta = ueTheta;
-                        maxTxW = gnbW;
-                        maxRxW = ueW;
-                    }
+                    estimatedLongTermMetric += std::norm(batchedLongTerm(ueBeam, gnbBeam, cluster));
                 }
             }
+            else
+            {
+                const UniformPlanarArray::ComplexVector estimatedLongTermComponent =
+                    GetEstimatedLongTermComponent(
+                        channelMatrix,
+                        gnbW,
+                        ueW,
+                        m_gnbSpectrumPhy->GetObject<MobilityModel>(),
+                        m_ueSpectrumPhy->GetObject<MobilityModel>(),
+                        srsSinr,
+                        gnbAntenna,
+                        ueAntenna);
+
+                estimatedLongTermMetric =
+                    CalculateTheEstimatedLongTermMetric(estimatedLongTermComponent);
+            }
+
+            NS_LOG_LOGIC(
+                " Estimated long term metric value: "
+                << estimatedLongTermMetric << " gnb theta " << gnbTheta << " ue theta " << ueTheta
+                << " gnb sector "
+                << (M_PI * static_cast<double>(gnbSector) / static_cast<double>(gnbNumRows) -
+                    0.5 * M_PI) /
+                       M_PI * 180
+                << " ue sector "
+                << (M_PI * static_cast<double>(ueSector) / static_cast<double>(ueNumRows) -
+                    0.5 * M_PI) /
+                       M_PI * 180);
+
+            if (max < estimatedLongTermMetric)
+            {
+                max = estimatedLongTermMetric;
+                maxTxSector = gnbSector;
+                maxRxSector = ueSector;
+                maxTxTheta = gnbTheta;
+                maxRxTheta = ueTheta;
+                maxTxW = gnbW;
+                maxRxW = ueW;
+            }
         }
     }
 
@@ -482,4 +511,61 @@ RealisticBeamformingAlgorithm::GetEstimatedLongTermComponent(
     return estimatedlongTerm;
 }
 
+ComplexMatrixArray
+RealisticBeamformingAlgorithm::GetEstimatedLongTermComponents(
+    const Ptr<const MatrixBasedChannelModel::ChannelMatrix>& channelMatrix,
+    const CellScanCodebook& gnbCodebook,
+    const CellScanCodebook& ueCodebook,
+    double srsSinr,
+    Ptr<const PhasedArrayModel> gnbArray,
+    Ptr<const PhasedArrayModel> ueArray) const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_IF(srsSinr == 0);
+
+    // check if the channel matrix was generated considering the gNB as the s-node and
+    // the UE as the u-node or vice-versa
+    bool reverse = channelMatrix->IsReverse(gnbArray->GetId(), ueArray->GetId());
+    ComplexMatrixArray longTerm =
+        reverse ? ComputeLongTermComponents(channelMatrix->m_channel, ueCodebook, gnbCodebook)
+                : ComputeLongTermComponents(channelMatrix->m_channel, gnbCodebook, ueCodebook);
+
+    size_t numGnbBeams = gnbCodebook.bfvs.size();
+    size_t numUeBeams = ueCodebook.bfvs.size();
+    size_t numCluster = longTerm.GetNumPages();
+    double varError = 1 / (srsSinr); // SINR the SINR from UL SRS reception
+
+    // The error of the long term component of a pair, sum over the elements of the channel
+    // matrix of sW[s] * uW[u] * error(u, s), is a complex normal variable whose real and
+    // imaginary parts have the variance of the element errors times |sW|^2 * |uW|^2
+    ComplexMatrixArray estimatedLongTerm(numUeBeams, numGnbBeams, numCluster);
+    for (size_t gnbBeam = 0; gnbBeam < numGnbBeams; gnbBeam++)
+    {
+        double gnbNorm = 0;
+        for (std::complex<double> w : gnbCodebook.bfvs[gnbBeam].GetValues())
+        {
+            gnbNorm += std::norm(w);
+        }
+        for (size_t ueBeam = 0; ueBeam < numUeBeams; ueBeam++)
+        {
+            double ueNorm = 0;
+            for (std::complex<double> w : ueCodebook.bfvs[ueBeam].GetValues())
+            {
+                ueNorm += std::norm(w);
+            }
+            double variance = sqrt(0.5) * varError * gnbNorm * ueNorm;
+            for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+            {
+                std::complex<double> error =
+                    std::complex<double>(m_normalRandomVariable->GetValue(0, variance),
+                                         m_normalRandomVariable->GetValue(0, variance));
+                std::complex<double> value = reverse ? longTerm(gnbBeam, ueBeam, cIndex)
+                                                     : longTerm(ueBeam, gnbBeam, cIndex);
+                estimatedLongTerm(ueBeam, gnbBeam, cIndex) = value + error;
+            }
+        }
+    }
+    return estimatedLongTerm;
+}
+
 } // namespace ns3
@@ -229,6 +229,25 @@ class RealisticBeamformingAlgorithm : public Object
         Ptr<const PhasedArrayModel> aArray,
         Ptr<const PhasedArrayModel> bArray) const;
 
+    /**
+     * \brief Calculates an estimation of the long term component for all the pairs of beams of
+     * the cell scan codebooks of the gNB and of the UE at once
+     * \param channelMatrix the channel matrix H
+     * \param gnbCodebook the codebook of the gNB
+     * \param ueCodebook the codebook of the UE
+     * \param srsSinr the SRS report to be used to estimate the long term component metric
+     * \param gnbArray the antenna array of the gNB
+     * \param ueArray the antenna array of the UE
+     * \return the estimated long term components (dims: ueBeams x gnbBeams x numClusters)
+     */
+    ComplexMatrixArray GetEstimatedLongTermComponents(
+        const Ptr<const MatrixBasedChannelModel::ChannelMatrix>& channelMatrix,
+        const CellScanCodebook& gnbCodebook,
+        const CellScanCodebook& ueCodebook,
+        double srsSinr,
+        Ptr<const PhasedArrayModel> gnbArray,
+        Ptr<const PhasedArrayModel> ueArray) const;
+
     /*
      * \brief Calculates the total metric based on the each element of the long term component
      * \param longTermComponent the vector of complex numbers representing the long term component
@@ -248,6 +267,7 @@ class RealisticBeamformingAlgorithm : public Object
     double m_beamSearchAngleStep{30}; //!< The beam angle step that will be used to define the set
                                       //!< of beams for which will be estimated the channel
     bool m_useSnrSrs{true};           //!< SRS SNR used as measurement (attribute)
+    bool m_batchedBeamSearch{false};  //!< Estimate all the beam pairs at once (attribute)
     // variable members, counters, and saving values
     double m_maxSrsSinrPerSlot{
         0}; //!< the maximum SRS SINR/SNR per slot in Watts, e.g. if there are 4 SRS symbols per UE,
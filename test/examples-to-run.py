@@ -235,6 +235,16 @@ cpp_examples = [
         "True",
         "True",
     ),
+    (
+        "cttc-nr-mimo-demo --fullSearchCb=ns3::NrCbTypeOneSp --pmSearchMethod=ns3::NrPmSearchFast --bandwidth=5e6 --subbandSize=4 --downsamplingTechnique=FirstPRB",
+        "True",
+        "True",
+    ),
+    (
+        "cttc-nr-mimo-demo --fullSearchCb=ns3::NrCbTypeOneSp --pmSearchMethod=ns3::NrPmSearchFast --bandwidth=20e6 --subbandSize=16 --downsamplingTechnique=AveragePRB",
+        "True",
+        "True",
+    ),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/basic-data-calculators.h>
+#include <ns3/nr-bearer-stats-calculator.h>
+#include <ns3/test.h>
+
+#include <vector>
+
+/**
+ * \file nr-test-bearer-stats-calculator.cc
+ * \ingroup test
+ *
+ * \brief Check that NrBearerStatsCalculator counts the PDUs of each flow and direction, and that
+ * its delay and PDU size statistics are the ones of MinMaxAvgTotalCalculator.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case for the statistics of NrBearerStatsCalculator
+ */
+class NrBearerStatsCalculatorTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrBearerStatsCalculatorTestCase()
+        : TestCase("Bearer stats calculator")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrBearerStatsCalculatorTestCase::DoRun()
+{
+    auto calculator = CreateObject<NrBearerStatsCalculator>();
+    auto delay = CreateObject<MinMaxAvgTotalCalculator<uint64_t>>();
+    auto pduSize = CreateObject<MinMaxAvgTotalCalculator<uint32_t>>();
+
+    const std::vector<uint32_t> sizes{100, 1500, 40, 700, 700};
+    const std::vector<uint64_t> delays{1000000, 2500000, 300000, 7000000, 1000001};
+    for (size_t i = 0; i < sizes.size(); i++)
+    {
+        calculator->DlTxPdu(1, 7, 3, 4, sizes[i]);
+        calculator->DlRxPdu(1, 7, 3, 4, sizes[i], delays[i]);
+        delay->Update(delays[i]);
+        pduSize->Update(sizes[i]);
+    }
+    calculator->UlTxPdu(2, 7, 3, 4, 10);
+    calculator->DlTxPdu(1, 8, 5, 4, 20);
+
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetDlTxPackets(7, 4), sizes.size(), "Wrong DL TX PDUs");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetDlRxPackets(7, 4), sizes.size(), "Wrong DL RX PDUs");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetDlTxData(7, 4), 3040U, "Wrong DL TX data");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetDlRxData(7, 4), 3040U, "Wrong DL RX data");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetDlCellId(7, 4), 1U, "Wrong DL CellId");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetUlCellId(7, 4), 2U, "Wrong UL CellId");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetUlTxPackets(7, 4), 1U, "Wrong UL TX PDUs");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetUlRxPackets(7, 4), 0U, "Wrong UL RX PDUs");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetDlTxData(8, 4), 20U, "Wrong DL TX data of other flow");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetDlTxPackets(7, 5), 0U, "Wrong DL TX PDUs of unknown flow");
+
+    const std::vector<double> expectedDelay{delay->getMean(),
+                                            delay->getStddev(),
+                                            static_cast<double>(delay->getMin()),
+                                            static_cast<double>(delay->getMax())};
+    const std::vector<double> expectedSize{pduSize->getMean(),
+                                           pduSize->getStddev(),
+                                           static_cast<double>(pduSize->getMin()),
+                                           static_cast<double>(pduSize->getMax())};
+    NS_TEST_ASSERT_MSG_EQ((calculator->GetDlDelayStats(7, 4) == expectedDelay),
+                          true,
+                          "Wrong DL delay statistics");
+    NS_TEST_ASSERT_MSG_EQ((calculator->GetDlPduSizeStats(7, 4) == expectedSize),
+                          true,
+                          "Wrong DL PDU size statistics");
+    NS_TEST_ASSERT_MSG_EQ(calculator->GetDlDelay(7, 4), delay->getMean(), "Wrong DL delay");
+    NS_TEST_ASSERT_MSG_EQ((calculator->GetUlDelayStats(7, 4) == std::vector<double>(4, 0.0)),
+                          true,
+                          "Wrong UL delay statistics without RX PDUs");
+    NS_TEST_ASSERT_MSG_EQ((calculator->GetDlPduSizeStats(9, 4) == std::vector<double>(4, 0.0)),
+                          true,
+                          "Wrong DL PDU size statistics of unknown flow");
+}
+
+/**
+ * \brief Test suite for the bearer stats calculator
+ */
+class NrTestBearerStatsCalculatorSuite : public TestSuite
+{
+  public:
+    NrTestBearerStatsCalculatorSuite()
+        : TestSuite("nr-test-bearer-stats-calculator", Type::UNIT)
+    {
+        AddTestCase(new NrBearerStatsCalculatorTestCase(), Duration::QUICK);
+    }
+};
+
+static NrTestBearerStatsCalculatorSuite
+    nrTestBearerStatsCalculatorSuite; //!< Bearer stats calculator test suite
+
+} // namespace ns3
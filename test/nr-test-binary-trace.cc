@@ -0,0 +1,283 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-binary-trace.h>
+#include <ns3/test.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-binary-trace.cc
+ * \ingroup test
+ *
+ * \brief Check that the records written by NrBinaryTraceWriter are read back unchanged, and that
+ * NrBinaryTraceReader::ConvertToText writes the same text trace as the text formatters of the
+ * records, which are the ones used by the sinks in NrTraceFormat::TEXT. The conversion of a DL and
+ * an UL RX packet record is also compared with rows written by hand in the layout of the original
+ * text trace, which has no separator between the BWP ID and the RNTI on the UL rows, and repeats
+ * the RNTI on the DL rows.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that writes, reads and converts a binary trace
+ */
+template <typename Record>
+class NrBinaryTraceTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param name the name of the record type
+     * \param records the records to write
+     */
+    NrBinaryTraceTestCase(const std::string& name, const std::vector<Record>& records)
+        : TestCase("Binary trace of " + name + ", " + std::to_string(records.size()) +
+                   " records"),
+          m_records(records)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    std::vector<Record> m_records; //!< The records to write
+};
+
+template <typename Record>
+void
+NrBinaryTraceTestCase<Record>::DoRun()
+{
+    auto filename = CreateTempDirFilename("nr-binary-trace.bin");
+    {
+        // A small buffer, to flush several times
+        NrBinaryTraceWriter writer(filename, Record::TYPE, sizeof(Record), 3 * sizeof(Record));
+        for (const auto& record : m_records)
+        {
+            writer.Write(record);
+        }
+    }
+
+    auto read = NrBinaryTraceReader::ReadRecords<Record>(filename);
+    NS_TEST_ASSERT_MSG_EQ(read.size(), m_records.size(), "Wrong number of records");
+    for (size_t i = 0; i < read.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(std::memcmp(&read[i], &m_records[i], sizeof(Record)),
+                              0,
+                              "Record " << i << " was not read back unchanged");
+    }
+
+    std::ostringstream expected;
+    Record::WriteTextHeader(expected, m_records.empty() ? Record{} : m_records.front());
+    for (const auto& record : m_records)
+    {
+        record.WriteText(expected);
+    }
+    std::ostringstream converted;
+    NrBinaryTraceReader::ConvertToText(filename, converted);
+    NS_TEST_ASSERT_MSG_EQ(converted.str(), expected.str(), "Wrong conversion to text");
+}
+
+/**
+ * \brief Test case that converts RX packet records to the rows of the original text trace
+ */
+class NrBinaryTraceLegacyTextTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrBinaryTraceLegacyTextTestCase()
+        : TestCase("Conversion of the RX packet trace to the original text layout")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrBinaryTraceLegacyTextTestCase::DoRun()
+{
+    NrRxPacketTraceRecord dl{};
+    dl.m_time = 0.5;
+    dl.m_sinr = 100.0;
+    dl.m_tbler = 0.25;
+    dl.m_cellId = 2;
+    dl.m_frameNum = 3;
+    dl.m_tbSize = 1500;
+    dl.m_rnti = 7;
+    dl.m_slotNum = 1;
+    dl.m_bwpId = 1;
+    dl.m_subframeNum = 4;
+    dl.m_symStart = 1;
+    dl.m_numSym = 12;
+    dl.m_mcs = 20;
+    dl.m_rank = 2;
+    dl.m_rv = 0;
+    dl.m_corrupt = 0;
+    dl.m_isUplink = 0;
+
+    NrRxPacketTraceRecord ul = dl;
+    ul.m_time = 0.75;
+    ul.m_sinr = 10.0;
+    ul.m_tbler = 0.5;
+    ul.m_tbSize = 800;
+    ul.m_slotNum = 0;
+    ul.m_subframeNum = 5;
+    ul.m_symStart = 0;
+    ul.m_numSym = 13;
+    ul.m_mcs = 5;
+    ul.m_rank = 1;
+    ul.m_rv = 1;
+    ul.m_corrupt = 1;
+    ul.m_isUplink = 1;
+
+    auto filename = CreateTempDirFilename("nr-binary-trace-legacy.bin");
+    {
+        NrBinaryTraceWriter writer(filename,
+                                   NrRxPacketTraceRecord::TYPE,
+                                   sizeof(NrRxPacketTraceRecord),
+                                   sizeof(NrRxPacketTraceRecord));
+        writer.Write(dl);
+        writer.Write(ul);
+    }
+
+    // The DL rows repeat the RNTI (7), and the UL rows join the BWP ID (1) and the RNTI (7)
+    const std::string expected =
+        "Time\tdirection\tframe\tsubF\tslot\t1stSym\tnSymbol\tcellId\tbwpId\trnti\ttbSize\tmcs"
+        "\trank\trv\tSINR(dB)\tCQI\tcorrupt\tTBler\n"
+        "0.5\tDL\t3\t4\t1\t1\t12\t2\t1\t7\t7\t1500\t20\t2\t0\t20\t0\t0.25\t\n"
+        "0.75\tUL\t3\t5\t0\t0\t13\t2\t17\t800\t5\t1\t1\t10\t1\t0.5\t\n";
+    std::ostringstream converted;
+    NrBinaryTraceReader::ConvertToText(filename, converted);
+    NS_TEST_ASSERT_MSG_EQ(converted.str(), expected, "Wrong conversion to the original layout");
+}
+
+/**
+ * \brief Create SINR records
+ * \param n the number of records
+ * \return the records
+ */
+static std::vector<NrSinrTraceRecord>
+CreateSinrRecords(size_t n)
+{
+    std::vector<NrSinrTraceRecord> records;
+    for (size_t i = 0; i < n; i++)
+    {
+        NrSinrTraceRecord record{};
+        record.m_time = 0.001 * i;
+        record.m_sinr = 1.5 + i;
+        record.m_cellId = 1 + i % 3;
+        record.m_rnti = 10 + i;
+        record.m_bwpId = i % 2;
+        records.push_back(record);
+    }
+    return records;
+}
+
+/**
+ * \brief Create RX packet records
+ * \param n the number of records
+ * \param firstUplink whether the first record is an UL one
+ * \return the records
+ */
+static std::vector<NrRxPacketTraceRecord>
+CreateRxPacketRecords(size_t n, bool firstUplink)
+{
+    std::vector<NrRxPacketTraceRecord> records;
+    for (size_t i = 0; i < n; i++)
+    {
+        NrRxPacketTraceRecord record{};
+        record.m_time = 0.0005 * i;
+        record.m_sinr = 20.0 / (1 + i);
+        record.m_tbler = 0.01 * i;
+        record.m_cellId = 1 + i % 2;
+        record.m_frameNum = i / 20;
+        record.m_tbSize = 1000 + 10 * i;
+        record.m_rnti = 1 + i % 4;
+        record.m_slotNum = i % 2;
+        record.m_bwpId = 0;
+        record.m_subframeNum = (i / 2) % 10;
+        record.m_symStart = 1;
+        record.m_numSym = 12;
+        record.m_mcs = i % 28;
+        record.m_rank = 1 + i % 2;
+        record.m_rv = i % 4;
+        record.m_corrupt = i % 5 == 0;
+        record.m_isUplink = (i % 2 == 0) == firstUplink;
+        records.push_back(record);
+    }
+    return records;
+}
+
+/**
+ * \brief Create MAC scheduling records
+ * \param n the number of records
+ * \return the records
+ */
+static std::vector<NrMacSchedulingTraceRecord>
+CreateMacSchedulingRecords(size_t n)
+{
+    std::vector<NrMacSchedulingTraceRecord> records;
+    for (size_t i = 0; i < n; i++)
+    {
+        NrMacSchedulingTraceRecord record{};
+        record.m_time = 0.00025 * i;
+        record.m_imsi = 100 + i % 7;
+        record.m_tbSize = 500 + i;
+        record.m_cellId = 2;
+        record.m_rnti = 1 + i % 7;
+        record.m_frameNum = i / 40;
+        record.m_slotNum = i % 4;
+        record.m_bwpId = 1;
+        record.m_subframeNum = (i / 4) % 10;
+        record.m_symStart = 0;
+        record.m_numSym = 14;
+        record.m_harqId = i % 16;
+        record.m_ndi = i % 2;
+        record.m_rv = 0;
+        record.m_mcs = 27 - i % 28;
+        records.push_back(record);
+    }
+    return records;
+}
+
+/**
+ * \brief Test suite for the binary traces
+ */
+class NrTestBinaryTraceSuite : public TestSuite
+{
+  public:
+    NrTestBinaryTraceSuite()
+        : TestSuite("nr-test-binary-trace", Type::UNIT)
+    {
+        for (size_t n : {0, 1, 10})
+        {
+            AddTestCase(new NrBinaryTraceTestCase<NrSinrTraceRecord>("SINR", CreateSinrRecords(n)),
+                        Duration::QUICK);
+            AddTestCase(new NrBinaryTraceTestCase<NrMacSchedulingTraceRecord>(
+                            "MAC scheduling",
+                            CreateMacSchedulingRecords(n)),
+                        Duration::QUICK);
+        }
+        // The header of the RX packet trace depends on the direction of the first record
+        for (bool firstUplink : {false, true})
+        {
+            AddTestCase(new NrBinaryTraceTestCase<NrRxPacketTraceRecord>(
+                            firstUplink ? "RX packet (UL first)" : "RX packet (DL first)",
+                            CreateRxPacketRecords(10, firstUplink)),
+                        Duration::QUICK);
+        }
+        AddTestCase(new NrBinaryTraceLegacyTextTestCase(), Duration::QUICK);
+    }
+};
+
+static NrTestBinaryTraceSuite nrTestBinaryTraceSuite; //!< Binary trace test suite
+
+} // namespace ns3
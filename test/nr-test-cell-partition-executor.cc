@@ -0,0 +1,159 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-cell-partition-executor.h>
+#include <ns3/nstime.h>
+#include <ns3/simulator.h>
+#include <ns3/test.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * \file nr-test-cell-partition-executor.cc
+ * \ingroup test
+ *
+ * \brief Check that NrCellPartitionExecutor runs the parallel parts of all the partitions
+ * before the sequential ones, in the same time step, and that the sequential parts run in the
+ * order of the partitions and of the submissions, for any number of threads.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that submits work to the partitions of a NrCellPartitionExecutor
+ */
+class NrCellPartitionExecutorTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param numThreads the number of threads of the executor
+     */
+    NrCellPartitionExecutorTestCase(uint32_t numThreads)
+        : TestCase("Cell partitions with " + std::to_string(numThreads) + " threads"),
+          m_numThreads(numThreads)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Submit the work of the partitions
+     */
+    void SubmitWork();
+
+    /**
+     * \brief Sequential part of a work
+     * \param partition the partition
+     * \param index the index of the work in the partition
+     */
+    void SequentialWork(uint32_t partition, uint32_t index);
+
+    /// The partitions, in the order of the submissions
+    const std::vector<uint32_t> m_partitions{7, 3, 5, 3, 7, 3};
+    uint32_t m_numThreads;                   //!< The number of threads
+    Ptr<NrCellPartitionExecutor> m_executor; //!< The executor
+    std::atomic<uint32_t> m_numParallel{0};  //!< Number of parallel parts that ran
+    std::vector<Time> m_sequentialTimes;     //!< Times of the sequential parts
+    /// Indexes of the parallel parts that ran, by partition
+    std::map<uint32_t, std::vector<uint32_t>> m_parallelLog;
+    /// Partitions and indexes of the sequential parts that ran
+    std::vector<std::pair<uint32_t, uint32_t>> m_sequentialLog;
+};
+
+void
+NrCellPartitionExecutorTestCase::SubmitWork()
+{
+    std::map<uint32_t, uint32_t> numWork;
+    for (auto partition : m_partitions)
+    {
+        auto index = numWork[partition]++;
+        m_executor->Submit(
+            partition,
+            [this, partition, index]() {
+                m_parallelLog.at(partition).push_back(index);
+                m_numParallel++;
+            },
+            [this, partition, index]() { SequentialWork(partition, index); });
+    }
+}
+
+void
+NrCellPartitionExecutorTestCase::SequentialWork(uint32_t partition, uint32_t index)
+{
+    NS_TEST_ASSERT_MSG_EQ(m_numParallel.load(),
+                          m_partitions.size(),
+                          "A sequential part ran before all the parallel parts");
+    m_sequentialLog.emplace_back(partition, index);
+    m_sequentialTimes.push_back(Simulator::Now());
+}
+
+void
+NrCellPartitionExecutorTestCase::DoRun()
+{
+    m_executor = CreateObject<NrCellPartitionExecutor>();
+    m_executor->SetNumThreads(m_numThreads);
+    for (auto partition : m_partitions)
+    {
+        m_parallelLog[partition] = {};
+    }
+
+    Simulator::Schedule(MilliSeconds(1), &NrCellPartitionExecutorTestCase::SubmitWork, this);
+    Simulator::Run();
+    m_executor->Dispose();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ((m_parallelLog.at(3) == std::vector<uint32_t>{0, 1, 2}),
+                          true,
+                          "Wrong order of the parallel parts of a partition");
+    NS_TEST_ASSERT_MSG_EQ((m_parallelLog.at(7) == std::vector<uint32_t>{0, 1}),
+                          true,
+                          "Wrong order of the parallel parts of a partition");
+
+    const std::vector<std::pair<uint32_t, uint32_t>> expected{{3, 0},
+                                                              {3, 1},
+                                                              {3, 2},
+                                                              {5, 0},
+                                                              {7, 0},
+                                                              {7, 1}};
+    NS_TEST_ASSERT_MSG_EQ(m_sequentialLog.size(), expected.size(), "Wrong number of parts");
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_sequentialLog[i].first,
+                              expected[i].first,
+                              "Wrong partition of sequential part " << i);
+        NS_TEST_ASSERT_MSG_EQ(m_sequentialLog[i].second,
+                              expected[i].second,
+                              "Wrong order of sequential part " << i);
+        NS_TEST_ASSERT_MSG_EQ(m_sequentialTimes[i],
+                              MilliSeconds(1),
+                              "Sequential part " << i << " not in the time step");
+    }
+}
+
+/**
+ * \brief Test suite for the cell partitions
+ */
+class NrTestCellPartitionExecutorSuite : public TestSuite
+{
+  public:
+    NrTestCellPartitionExecutorSuite()
+        : TestSuite("nr-test-cell-partition-executor", Type::UNIT)
+    {
+        for (uint32_t numThreads : {1, 2, 4})
+        {
+            AddTestCase(new NrCellPartitionExecutorTestCase(numThreads), Duration::QUICK);
+        }
+    }
+};
+
+static NrTestCellPartitionExecutorSuite
+    nrTestCellPartitionExecutorSuite; //!< Cell partitions test suite
+
+} // namespace ns3
@@ -0,0 +1,294 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/beamforming-vector.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+#include <ns3/uniform-planar-array.h>
+
+#include <complex>
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-cell-scan-codebook.cc
+ * \ingroup test
+ *
+ * \brief Check that GetCellScanCodebook builds the beams of the cell scan in the order of the
+ * search and shares them among the antennas with the same configuration, and that the batched
+ * beam search (ComputeLongTermComponents) selects the same beam pair, with the same gain, as
+ * the long term component computed for each pair of beams.
+ */
+namespace ns3
+{
+
+/// Relative tolerance of the long term components, which are summed in a different order
+static constexpr double CELL_SCAN_LONG_TERM_TOLERANCE = 1e-9;
+
+/**
+ * \brief Create a uniform planar array
+ * \param numRows the number of rows
+ * \param numColumns the number of columns
+ * \return the antenna
+ */
+static Ptr<UniformPlanarArray>
+CreateUpa(uint32_t numRows, uint32_t numColumns)
+{
+    auto antenna = CreateObject<UniformPlanarArray>();
+    antenna->SetAttribute("NumRows", UintegerValue(numRows));
+    antenna->SetAttribute("NumColumns", UintegerValue(numColumns));
+    return antenna;
+}
+
+/**
+ * \brief Test case for the cache and the beams of GetCellScanCodebook
+ */
+class NrCellScanCodebookTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrCellScanCodebookTestCase()
+        : TestCase("Cell scan codebook")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the beams of a codebook
+     * \param antenna the antenna of the codebook
+     * \param step the elevation step (degrees)
+     * \param integerElevation whether the elevation is truncated to an integer at each step
+     */
+    void CheckBeams(Ptr<const UniformPlanarArray> antenna, double step, bool integerElevation);
+};
+
+void
+NrCellScanCodebookTestCase::CheckBeams(Ptr<const UniformPlanarArray> antenna,
+                                       double step,
+                                       bool integerElevation)
+{
+    auto codebook = GetCellScanCodebook(antenna, step, integerElevation);
+    UintegerValue numRows;
+    antenna->GetAttribute("NumRows", numRows);
+
+    size_t beam = 0;
+    for (double elevation = 60; elevation < 121;)
+    {
+        for (uint16_t sector = 0; sector <= numRows.Get(); sector++)
+        {
+            NS_TEST_ASSERT_MSG_LT(beam, codebook->beamIds.size(), "Missing beams");
+            NS_TEST_ASSERT_MSG_EQ(codebook->beamIds[beam],
+                                  BeamId(sector, elevation),
+                                  "Wrong beam " << beam);
+            auto bfv = CreateDirectionalBfv(antenna, sector, elevation);
+            for (size_t ind = 0; ind < antenna->GetNumElems(); ind++)
+            {
+                NS_TEST_ASSERT_MSG_EQ(codebook->bfvs[beam][ind],
+                                      bfv[ind],
+                                      "Wrong beamforming vector of beam " << beam);
+                NS_TEST_ASSERT_MSG_EQ(codebook->bfvMatrix(ind, beam),
+                                      bfv[ind],
+                                      "Wrong beamforming matrix column " << beam);
+            }
+            beam++;
+        }
+        elevation += step;
+        if (integerElevation)
+        {
+            elevation = static_cast<uint16_t>(elevation);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(codebook->beamIds.size(), beam, "Too many beams");
+    NS_TEST_ASSERT_MSG_EQ(codebook->bfvs.size(), beam, "Too many beamforming vectors");
+    NS_TEST_ASSERT_MSG_EQ(codebook->bfvMatrix.GetNumCols(), beam, "Wrong beamforming matrix");
+}
+
+void
+NrCellScanCodebookTestCase::DoRun()
+{
+    auto antenna = CreateUpa(4, 4);
+    auto sameConfig = CreateUpa(4, 4);
+    auto otherConfig = CreateUpa(2, 4);
+
+    // The codebooks are shared by the antennas with the same configuration
+    auto codebook = GetCellScanCodebook(antenna, 10, false);
+    NS_TEST_ASSERT_MSG_EQ(GetCellScanCodebook(antenna, 10, false),
+                          codebook,
+                          "The codebook is not cached");
+    NS_TEST_ASSERT_MSG_EQ(GetCellScanCodebook(sameConfig, 10, false),
+                          codebook,
+                          "The codebook is not shared by antennas with the same configuration");
+    NS_TEST_ASSERT_MSG_NE(GetCellScanCodebook(otherConfig, 10, false),
+                          codebook,
+                          "The codebook is shared by antennas with another number of rows");
+    NS_TEST_ASSERT_MSG_NE(GetCellScanCodebook(antenna, 7.5, false),
+                          codebook,
+                          "The codebook is shared by another elevation step");
+    NS_TEST_ASSERT_MSG_NE(GetCellScanCodebook(antenna, 7.5, true),
+                          GetCellScanCodebook(antenna, 7.5, false),
+                          "The codebook is shared with and without integer elevations");
+
+    CheckBeams(antenna, 10, false);
+    CheckBeams(otherConfig, 10, false);
+    CheckBeams(antenna, 7.5, false);
+    CheckBeams(antenna, 7.5, true);
+}
+
+/**
+ * \brief Test case that compares the batched beam search with the search over the pairs
+ */
+class NrBatchedBeamSearchTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param reverse whether the UE is the s-node of the channel matrix
+     */
+    NrBatchedBeamSearchTestCase(bool reverse)
+        : TestCase(std::string("Batched beam search, with the ") + (reverse ? "UE" : "gNB") +
+                   " as s-node"),
+          m_reverse(reverse)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Compute the long term component of a pair of beams for a cluster, as
+     * ThreeGppSpectrumPropagationLossModel::CalcLongTerm does for single-port antennas
+     * \param channel the channel matrix (dims: uAntenna x sAntenna x numClusters)
+     * \param sW the beamforming vector of the s-node
+     * \param uW the beamforming vector of the u-node
+     * \param cluster the cluster
+     * \return the long term component
+     */
+    static std::complex<double> CalcLongTerm(const ComplexMatrixArray& channel,
+                                             const PhasedArrayModel::ComplexVector& sW,
+                                             const PhasedArrayModel::ComplexVector& uW,
+                                             size_t cluster);
+
+    bool m_reverse; //!< Whether the UE is the s-node of the channel matrix
+};
+
+std::complex<double>
+NrBatchedBeamSearchTestCase::CalcLongTerm(const ComplexMatrixArray& channel,
+                                          const PhasedArrayModel::ComplexVector& sW,
+                                          const PhasedArrayModel::ComplexVector& uW,
+                                          size_t cluster)
+{
+    std::complex<double> txSum(0, 0);
+    for (size_t sIndex = 0; sIndex < sW.GetSize(); sIndex++)
+    {
+        std::complex<double> rxSum(0, 0);
+        for (size_t uIndex = 0; uIndex < uW.GetSize(); uIndex++)
+        {
+            rxSum += uW[uIndex] * channel(uIndex, sIndex, cluster);
+        }
+        txSum += sW[sIndex] * rxSum;
+    }
+    return txSum;
+}
+
+void
+NrBatchedBeamSearchTestCase::DoRun()
+{
+    auto gnbAntenna = CreateUpa(4, 4);
+    auto ueAntenna = CreateUpa(2, 2);
+    auto gnbCodebook = GetCellScanCodebook(gnbAntenna, 10, false);
+    auto ueCodebook = GetCellScanCodebook(ueAntenna, 10, true);
+    const auto& sCodebook = m_reverse ? *ueCodebook : *gnbCodebook;
+    const auto& uCodebook = m_reverse ? *gnbCodebook : *ueCodebook;
+    size_t numGnbBeams = gnbCodebook->bfvs.size();
+    size_t numUeBeams = ueCodebook->bfvs.size();
+    const size_t numClusters = 8;
+
+    auto normal = CreateObject<NormalRandomVariable>();
+    normal->SetStream(1);
+    for (uint32_t iter = 0; iter < 10; iter++)
+    {
+        auto channel = ComplexMatrixArray{uCodebook.bfvMatrix.GetNumRows(),
+                                          sCodebook.bfvMatrix.GetNumRows(),
+                                          numClusters};
+        for (auto& h : channel.GetValues())
+        {
+            h = std::complex<double>(normal->GetValue(), normal->GetValue());
+        }
+
+        auto longTerm = ComputeLongTermComponents(channel, sCodebook, uCodebook);
+        NS_TEST_ASSERT_MSG_EQ(longTerm.GetNumRows(), uCodebook.bfvs.size(), "Wrong u-beams");
+        NS_TEST_ASSERT_MSG_EQ(longTerm.GetNumCols(), sCodebook.bfvs.size(), "Wrong s-beams");
+        NS_TEST_ASSERT_MSG_EQ(longTerm.GetNumPages(), numClusters, "Wrong clusters");
+
+        // Search the best pair as CellScanBeamforming does, with both long term components
+        double batchedMax = 0;
+        double refMax = 0;
+        size_t batchedPair = 0;
+        size_t refPair = 0;
+        for (size_t gnbBeam = 0; gnbBeam < numGnbBeams; gnbBeam++)
+        {
+            for (size_t ueBeam = 0; ueBeam < numUeBeams; ueBeam++)
+            {
+                size_t sBeam = m_reverse ? ueBeam : gnbBeam;
+                size_t uBeam = m_reverse ? gnbBeam : ueBeam;
+                double batchedMetric = 0;
+                double refMetric = 0;
+                for (size_t cluster = 0; cluster < numClusters; cluster++)
+                {
+                    auto ref = CalcLongTerm(channel,
+                                            sCodebook.bfvs[sBeam],
+                                            uCodebook.bfvs[uBeam],
+                                            cluster);
+                    NS_TEST_ASSERT_MSG_EQ_TOL(std::abs(longTerm(uBeam, sBeam, cluster) - ref),
+                                              0.0,
+                                              std::abs(ref) * CELL_SCAN_LONG_TERM_TOLERANCE +
+                                                  1e-12,
+                                              "Wrong long term component of the pair ("
+                                                  << gnbBeam << ", " << ueBeam << ")");
+                    batchedMetric += std::norm(longTerm(uBeam, sBeam, cluster));
+                    refMetric += std::norm(ref);
+                }
+                if (batchedMax < batchedMetric)
+                {
+                    batchedMax = batchedMetric;
+                    batchedPair = gnbBeam * numUeBeams + ueBeam;
+                }
+                if (refMax < refMetric)
+                {
+                    refMax = refMetric;
+                    refPair = gnbBeam * numUeBeams + ueBeam;
+                }
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(batchedPair, refPair, "Wrong beam pair at iteration " << iter);
+        NS_TEST_ASSERT_MSG_EQ_TOL(batchedMax,
+                                  refMax,
+                                  refMax * CELL_SCAN_LONG_TERM_TOLERANCE,
+                                  "Wrong gain at iteration " << iter);
+    }
+}
+
+/**
+ * \brief Test suite for the cell scan codebooks and the batched beam search
+ */
+class NrTestCellScanCodebookSuite : public TestSuite
+{
+  public:
+    NrTestCellScanCodebookSuite()
+        : TestSuite("nr-test-cell-scan-codebook", Type::UNIT)
+    {
+        AddTestCase(new NrCellScanCodebookTestCase(), Duration::QUICK);
+        AddTestCase(new NrBatchedBeamSearchTestCase(false), Duration::QUICK);
+        AddTestCase(new NrBatchedBeamSearchTestCase(true), Duration::QUICK);
+    }
+};
+
+static NrTestCellScanCodebookSuite nrTestCellScanCodebookSuite; //!< Cell scan codebook test suite
+
+} // namespace ns3
@@ -0,0 +1,401 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/beam-manager.h>
+#include <ns3/boolean.h>
+#include <ns3/cc-bwp-helper.h>
+#include <ns3/config.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/eps-bearer-tag.h>
+#include <ns3/ideal-beamforming-algorithm.h>
+#include <ns3/ideal-beamforming-helper.h>
+#include <ns3/internet-stack-helper.h>
+#include <ns3/ipv4-header.h>
+#include <ns3/ipv4-l3-protocol.h>
+#include <ns3/lte-chunk-processor.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/nr-gnb-net-device.h>
+#include <ns3/nr-gnb-phy.h>
+#include <ns3/nr-helper.h>
+#include <ns3/nr-point-to-point-epc-helper.h>
+#include <ns3/nr-spectrum-phy.h>
+#include <ns3/nr-spectrum-signal-parameters.h>
+#include <ns3/nr-spectrum-value-helper.h>
+#include <ns3/nr-ue-net-device.h>
+#include <ns3/nr-ue-phy.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+#include <ns3/uniform-planar-array.h>
+
+#include <string>
+
+/**
+ * \file nr-test-csi-rs.cc
+ * \ingroup test
+ *
+ * \brief Check the DL CQI measured on the CSI-RS. A gNB serves two UEs, but sends DL data
+ * only to the first one. With the CSI-RS enabled, the second UE reports the DL CQI without
+ * receiving any DL data, and it does not receive the PDSCH of the first UE. The CSI-RS
+ * occasions fall on the UL slots of the TDD pattern, so the gNB must transmit them in the
+ * next slot with DL CTRL. Without the CSI-RS, the second UE receives the PDSCH of the first
+ * one, to measure the CQI on it. The SINR of the CSI-RS is also checked against a neighbor cell
+ * that sends its PDCCH and its CSI-RS: only the CSI-RS interferes.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case for the CQI measured on the CSI-RS
+ */
+class NrCsiRsTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param csiRsPeriodicity the periodicity of the CSI-RS (slots), 0 to disable it
+     */
+    NrCsiRsTestCase(uint16_t csiRsPeriodicity)
+        : TestCase("CSI-RS with periodicity " + std::to_string(csiRsPeriodicity)),
+          m_csiRsPeriodicity(csiRsPeriodicity)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Send a DL packet to the first UE, and schedule the next one
+     * \param gnbDev the gNB device
+     * \param ueDev the device of the first UE
+     */
+    void SendDlPacket(const Ptr<NetDevice>& gnbDev, const Ptr<NetDevice>& ueDev);
+
+    /**
+     * \brief Count the DL CQI reports received by the gNB
+     * \param sfn the slot
+     * \param nodeId the cell ID
+     * \param rnti the RNTI of the UE of the message
+     * \param bwpId the BWP ID
+     * \param msg the message
+     */
+    void GnbPhyRx(SfnSf sfn,
+                  uint16_t nodeId,
+                  uint16_t rnti,
+                  uint8_t bwpId,
+                  Ptr<const NrControlMessage> msg);
+
+    /**
+     * \brief Count the DL data received by a UE
+     * \param test the test case
+     * \param ue the index of the UE
+     * \param sfnSf the slot
+     * \param v the received PSD
+     * \param t the duration of the reception
+     * \param bwpId the BWP ID
+     * \param cellId the cell ID
+     */
+    static void UeRxData(NrCsiRsTestCase* test,
+                         uint32_t ue,
+                         const SfnSf& sfnSf,
+                         Ptr<const SpectrumValue> v,
+                         const Time& t,
+                         uint16_t bwpId,
+                         uint16_t cellId);
+
+    /// Time from which the receptions are counted, when the UEs are attached
+    static constexpr uint32_t COUNT_START_MS = 200;
+    /// Time at which the simulation ends
+    static constexpr uint32_t SIM_END_MS = 400;
+
+    uint16_t m_csiRsPeriodicity;   //!< Periodicity of the CSI-RS (slots)
+    Ptr<NrUePhy> m_uePhys[2];      //!< The PHYs of the UEs
+    uint32_t m_numDlCqi[2]{0, 0};  //!< DL CQI reports of each UE
+    uint32_t m_numRxData[2]{0, 0}; //!< DL data receptions of each UE
+};
+
+void
+NrCsiRsTestCase::SendDlPacket(const Ptr<NetDevice>& gnbDev, const Ptr<NetDevice>& ueDev)
+{
+    Ipv4Header header;
+    Ptr<Packet> pkt = Create<Packet>(100);
+    header.SetProtocol(0x06);
+    EpsBearerTag tag(m_uePhys[0]->GetRnti(), 1);
+    pkt->AddPacketTag(tag);
+    pkt->AddHeader(header);
+    gnbDev->Send(pkt, ueDev->GetAddress(), Ipv4L3Protocol::PROT_NUMBER);
+
+    Simulator::Schedule(MilliSeconds(2), &NrCsiRsTestCase::SendDlPacket, this, gnbDev, ueDev);
+}
+
+void
+NrCsiRsTestCase::GnbPhyRx([[maybe_unused]] SfnSf sfn,
+                          [[maybe_unused]] uint16_t nodeId,
+                          uint16_t rnti,
+                          [[maybe_unused]] uint8_t bwpId,
+                          Ptr<const NrControlMessage> msg)
+{
+    if (msg->GetMessageType() != NrControlMessage::DL_CQI ||
+        Simulator::Now() < MilliSeconds(COUNT_START_MS))
+    {
+        return;
+    }
+    for (uint32_t ue = 0; ue < 2; ue++)
+    {
+        if (m_uePhys[ue]->GetRnti() == rnti)
+        {
+            m_numDlCqi[ue]++;
+        }
+    }
+}
+
+void
+NrCsiRsTestCase::UeRxData(NrCsiRsTestCase* test,
+                          uint32_t ue,
+                          [[maybe_unused]] const SfnSf& sfnSf,
+                          [[maybe_unused]] Ptr<const SpectrumValue> v,
+                          [[maybe_unused]] const Time& t,
+                          [[maybe_unused]] uint16_t bwpId,
+                          [[maybe_unused]] uint16_t cellId)
+{
+    if (Simulator::Now() >= MilliSeconds(COUNT_START_MS))
+    {
+        test->m_numRxData[ue]++;
+    }
+}
+
+void
+NrCsiRsTestCase::DoRun()
+{
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(1);
+    ueNodes.Create(2);
+
+    auto positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0, 0, 10));
+    positionAlloc->Add(Vector(10, 10, 1.5));
+    positionAlloc->Add(Vector(-10, 20, 1.5));
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(NodeContainer(gnbNodes, ueNodes));
+
+    auto epcHelper = CreateObject<NrPointToPointEpcHelper>();
+    auto idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    auto nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(epcHelper);
+    nrHelper->SetAttribute("CsiRsPeriodicity", UintegerValue(m_csiRsPeriodicity));
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9,
+                                                   20e6,
+                                                   1,
+                                                   BandwidthPartInfo::UMi_StreetCanyon);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    Config::SetDefault("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    idealBeamformingHelper->SetAttribute("BeamformingMethod",
+                                         TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    epcHelper->SetAttribute("S1uLinkDelay", TimeValue(MilliSeconds(0)));
+
+    // Every CSI-RS occasion (slot 0 of each period) is an UL slot
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(0));
+    nrHelper->SetGnbPhyAttribute("Pattern", StringValue("UL|F|F|F|F|"));
+
+    NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(gnbDevs, randomStream);
+    randomStream += nrHelper->AssignStreams(ueDevs, randomStream);
+
+    for (auto it = gnbDevs.Begin(); it != gnbDevs.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+    for (auto it = ueDevs.Begin(); it != ueDevs.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    nrHelper->GetGnbPhy(gnbDevs.Get(0), 0)
+        ->TraceConnectWithoutContext("GnbPhyRxedCtrlMsgsTrace",
+                                     MakeCallback(&NrCsiRsTestCase::GnbPhyRx, this));
+    for (uint32_t ue = 0; ue < 2; ue++)
+    {
+        m_uePhys[ue] = nrHelper->GetUePhy(ueDevs.Get(ue), 0);
+        m_uePhys[ue]->GetSpectrumPhy()->TraceConnectWithoutContext(
+            "RxDataTrace",
+            MakeBoundCallback(&NrCsiRsTestCase::UeRxData, this, ue));
+    }
+
+    InternetStackHelper internet;
+    internet.Install(ueNodes);
+    epcHelper->AssignUeIpv4Address(ueDevs);
+    nrHelper->AttachToClosestEnb(ueDevs, gnbDevs);
+
+    Simulator::Schedule(MilliSeconds(COUNT_START_MS),
+                        &NrCsiRsTestCase::SendDlPacket,
+                        this,
+                        gnbDevs.Get(0),
+                        ueDevs.Get(0));
+    Simulator::Stop(MilliSeconds(SIM_END_MS));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_GT(m_numRxData[0], 0, "The first UE did not receive its DL data");
+    NS_TEST_EXPECT_MSG_GT(m_numDlCqi[0], 0, "The first UE did not report the DL CQI");
+    NS_TEST_EXPECT_MSG_GT(m_numDlCqi[1], 0, "The second UE did not report the DL CQI");
+    if (m_csiRsPeriodicity > 0)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_numRxData[1],
+                              0U,
+                              "The second UE received the DL data of the first UE");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_GT(m_numRxData[1],
+                              0,
+                              "Without CSI-RS, the second UE must receive the DL data of the "
+                              "first UE to measure the CQI");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \brief Test case for the interference on the CSI-RS
+ */
+class NrCsiRsInterferenceTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrCsiRsInterferenceTestCase()
+        : TestCase("Interference of a neighbor cell on the CSI-RS")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Save the SINR of the CSI-RS
+     * \param test the test case
+     * \param sinr the SINR
+     */
+    static void SaveSinr(NrCsiRsInterferenceTestCase* test, const SpectrumValue& sinr);
+
+    SpectrumValue m_sinr; //!< The SINR of the CSI-RS
+};
+
+void
+NrCsiRsInterferenceTestCase::SaveSinr(NrCsiRsInterferenceTestCase* test, const SpectrumValue& sinr)
+{
+    test->m_sinr = sinr;
+}
+
+void
+NrCsiRsInterferenceTestCase::DoRun()
+{
+    auto rxPhy = CreateObject<NrSpectrumPhy>();
+    rxPhy->SetMobility(CreateObject<ConstantPositionMobilityModel>());
+    // The PHY only provides the cell ID of the UE
+    auto phy = CreateObject<NrGnbPhy>();
+    phy->InstallSpectrumPhy(rxPhy);
+    rxPhy->InstallPhy(phy);
+    auto antenna = CreateObject<UniformPlanarArray>();
+    rxPhy->SetAntenna(antenna);
+    CreateObject<BeamManager>()->Configure(antenna);
+    phy->DoSetCellId(1);
+    rxPhy->SetRnti(1);
+    rxPhy->EnableCsiRs();
+
+    auto txPhy = CreateObject<NrSpectrumPhy>();
+    txPhy->SetMobility(CreateObject<ConstantPositionMobilityModel>());
+    auto txGnbPhy = CreateObject<NrGnbPhy>();
+    txGnbPhy->InstallSpectrumPhy(txPhy);
+    txPhy->InstallPhy(txGnbPhy);
+    auto txAntenna = CreateObject<UniformPlanarArray>();
+    txPhy->SetAntenna(txAntenna);
+    CreateObject<BeamManager>()->Configure(txAntenna);
+
+    auto sinrProcessor = Create<LteChunkProcessor>();
+    sinrProcessor->AddCallback(MakeBoundCallback(&NrCsiRsInterferenceTestCase::SaveSinr, this));
+    rxPhy->AddCsiRsSinrChunkProcessor(sinrProcessor);
+
+    auto sm = NrSpectrumValueHelper::GetSpectrumModel(111, 28e9, 15000);
+    auto noisePsd = NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(5, sm);
+    rxPhy->SetNoisePowerSpectralDensity(noisePsd);
+
+    // The PDCCH and the CSI-RS of the neighbor cell, each with the power of the noise
+    auto neighborCtrl = Create<NrSpectrumSignalParametersDlCtrlFrame>();
+    neighborCtrl->duration = MicroSeconds(70);
+    neighborCtrl->psd = Create<SpectrumValue>(*noisePsd);
+    neighborCtrl->cellId = 2;
+    neighborCtrl->pss = false;
+    neighborCtrl->txPhy = txPhy;
+
+    auto neighborCsiRs = Create<NrSpectrumSignalParametersCsiRs>();
+    neighborCsiRs->duration = MicroSeconds(70);
+    neighborCsiRs->psd = Create<SpectrumValue>(*noisePsd);
+    neighborCsiRs->cellId = 2;
+    neighborCsiRs->rnti = 1;
+    neighborCsiRs->txPhy = txPhy;
+
+    auto csiRs = Create<NrSpectrumSignalParametersCsiRs>();
+    csiRs->duration = MicroSeconds(70);
+    csiRs->psd = Create<SpectrumValue>(*noisePsd * 100.0);
+    csiRs->cellId = 1;
+    csiRs->rnti = 1;
+    csiRs->txPhy = txPhy;
+
+    rxPhy->StartRx(neighborCtrl);
+    rxPhy->StartRx(neighborCsiRs);
+    rxPhy->StartRx(csiRs);
+
+    Simulator::Run();
+
+    // The signal is 20 dB above the noise, and the CSI-RS of the neighbor adds one more noise
+    NS_TEST_ASSERT_MSG_GT(m_sinr.GetValuesN(), 0, "The SINR of the CSI-RS is missing");
+    for (size_t rb = 0; rb < m_sinr.GetValuesN(); rb++)
+    {
+        NS_TEST_EXPECT_MSG_EQ_TOL(m_sinr[rb],
+                                  50.0,
+                                  1e-6,
+                                  "Wrong interference on the CSI-RS in RB " << rb);
+    }
+
+    rxPhy->Dispose();    // Explicitly dispose NrSpectrumPhy since it is not aggregated to a Node
+    phy->Dispose();      // Explicitly dispose NrPhy since it is not aggregated to a Node
+    txPhy->Dispose();    // Explicitly dispose NrSpectrumPhy since it is not aggregated to a Node
+    txGnbPhy->Dispose(); // Explicitly dispose NrPhy since it is not aggregated to a Node
+    Simulator::Destroy();
+}
+
+/**
+ * \brief Test suite for the CSI-RS
+ */
+class NrTestCsiRsSuite : public TestSuite
+{
+  public:
+    NrTestCsiRsSuite()
+        : TestSuite("nr-test-csi-rs", Type::SYSTEM)
+    {
+        AddTestCase(new NrCsiRsTestCase(0), Duration::QUICK);
+        AddTestCase(new NrCsiRsTestCase(5), Duration::QUICK);
+        AddTestCase(new NrCsiRsInterferenceTestCase(), Duration::QUICK);
+    }
+};
+
+static NrTestCsiRsSuite nrTestCsiRsSuite; //!< CSI-RS test suite
+
+} // namespace ns3
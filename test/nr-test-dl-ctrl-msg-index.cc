@@ -0,0 +1,124 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-control-messages.h>
+#include <ns3/nr-spectrum-signal-parameters.h>
+#include <ns3/test.h>
+
+#include <list>
+#include <memory>
+#include <vector>
+
+/**
+ * \file nr-test-dl-ctrl-msg-index.cc
+ * \ingroup test
+ *
+ * \brief Check that NrDlCtrlMsgIndex gives to each UE its DCIs and the messages for all the UEs,
+ * in the order of the DL CTRL frame, and nothing else.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case for the DL CTRL messages indexed by RNTI
+ */
+class NrDlCtrlMsgIndexTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrDlCtrlMsgIndexTestCase()
+        : TestCase("DL CTRL messages indexed by RNTI")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a DCI
+     * \param rnti the RNTI of the DCI
+     * \param dl whether it is a DL DCI
+     * \return the DCI message
+     */
+    static Ptr<NrControlMessage> CreateDci(uint16_t rnti, bool dl);
+};
+
+Ptr<NrControlMessage>
+NrDlCtrlMsgIndexTestCase::CreateDci(uint16_t rnti, bool dl)
+{
+    auto dci = std::make_shared<DciInfoElementTdma>(rnti,
+                                                    dl ? DciInfoElementTdma::DL
+                                                       : DciInfoElementTdma::UL,
+                                                    1,
+                                                    1,
+                                                    0,
+                                                    1,
+                                                    nullptr,
+                                                    100,
+                                                    1,
+                                                    0,
+                                                    DciInfoElementTdma::DATA,
+                                                    0,
+                                                    1);
+    if (dl)
+    {
+        return Create<NrDlDciMessage>(dci);
+    }
+    return Create<NrUlDciMessage>(dci);
+}
+
+void
+NrDlCtrlMsgIndexTestCase::DoRun()
+{
+    const auto mib = Create<NrMibMessage>();
+    const auto sib = Create<NrSib1Message>();
+    const auto dl1 = CreateDci(1, true);
+    const auto dl2 = CreateDci(2, true);
+    const auto ul1 = CreateDci(1, false);
+    const auto dl0 = CreateDci(0, true);
+    const auto ul3 = CreateDci(3, false);
+    const std::list<Ptr<NrControlMessage>> frame{mib, dl1, dl2, sib, ul1, dl0, ul3};
+
+    NrDlCtrlMsgIndex index(frame);
+    NS_TEST_ASSERT_MSG_EQ((index.GetAllMessages() == frame), true, "Wrong list of all messages");
+    NS_TEST_ASSERT_MSG_EQ((index.GetMessages(1) ==
+                           std::list<Ptr<NrControlMessage>>{mib, dl1, sib, ul1, dl0}),
+                          true,
+                          "Wrong messages of RNTI 1");
+    NS_TEST_ASSERT_MSG_EQ(
+        (index.GetMessages(2) == std::list<Ptr<NrControlMessage>>{mib, dl2, sib, dl0}),
+        true,
+        "Wrong messages of RNTI 2");
+    NS_TEST_ASSERT_MSG_EQ(
+        (index.GetMessages(3) == std::list<Ptr<NrControlMessage>>{mib, sib, dl0, ul3}),
+        true,
+        "Wrong messages of RNTI 3");
+    NS_TEST_ASSERT_MSG_EQ(
+        (index.GetMessages(4) == std::list<Ptr<NrControlMessage>>{mib, sib, dl0}),
+        true,
+        "Wrong messages of a RNTI without DCIs");
+    NS_TEST_ASSERT_MSG_EQ(
+        (index.GetMessages(0) == std::list<Ptr<NrControlMessage>>{mib, sib, dl0}),
+        true,
+        "Wrong messages of a UE without RNTI");
+}
+
+/**
+ * \brief Test suite for the DL CTRL messages indexed by RNTI
+ */
+class NrTestDlCtrlMsgIndexSuite : public TestSuite
+{
+  public:
+    NrTestDlCtrlMsgIndexSuite()
+        : TestSuite("nr-test-dl-ctrl-msg-index", Type::UNIT)
+    {
+        AddTestCase(new NrDlCtrlMsgIndexTestCase(), Duration::QUICK);
+    }
+};
+
+static NrTestDlCtrlMsgIndexSuite nrTestDlCtrlMsgIndexSuite; //!< DL CTRL index test suite
+
+} // namespace ns3
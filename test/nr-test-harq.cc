@@ -184,6 +184,49 @@ TestHarqTestCase::DoRun()
     }
 }
 
+/**
+ * \brief Check that the EESM outputs, once released, are reused with all the
+ * fields reset
+ */
+class TestHarqOutputPoolTestCase : public TestCase
+{
+  public:
+    TestHarqOutputPoolTestCase()
+        : TestCase("HARQ history output pool")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+TestHarqOutputPoolTestCase::DoRun()
+{
+    Ptr<NrEesmErrorModelOutput> output = NrEesmErrorModelOutput::Allocate(0.5);
+    output->m_sinrExp = 1.0;
+    output->m_sinrEff = 2.0;
+    output->m_sinrRb = {3.0, 4.0};
+    output->m_infoBits = 5;
+    output->m_codeBits = 6;
+    const NrEesmErrorModelOutput* released = PeekPointer(output);
+
+    NrErrorModel::NrErrorModelHistory history;
+    history.push_back(output);
+    output = nullptr;
+    history.clear(); // last reference dropped: the output goes back to the pool
+
+    Ptr<NrEesmErrorModelOutput> reused = NrEesmErrorModelOutput::Allocate(0.1);
+    NS_TEST_ASSERT_MSG_EQ(PeekPointer(reused), released, "The released output should be reused");
+    NS_TEST_ASSERT_MSG_EQ(reused->GetReferenceCount(), 1U, "Wrong reference count");
+    NS_TEST_ASSERT_MSG_EQ_TOL(reused->m_tbler, 0.1, 1e-12, "TBLER not set");
+    NS_TEST_ASSERT_MSG_EQ(reused->m_sinrExp, 0.0, "Exponential SINR sum not reset");
+    NS_TEST_ASSERT_MSG_EQ(reused->m_sinrEff, 0.0, "Effective SINR not reset");
+    NS_TEST_ASSERT_MSG_EQ(reused->m_sinrRb.empty(), true, "SINR of the RBs not reset");
+    NS_TEST_ASSERT_MSG_EQ(reused->m_infoBits, 0U, "Info bits not reset");
+    NS_TEST_ASSERT_MSG_EQ(reused->m_codeBits, 0U, "Code bits not reset");
+}
+
 class TestHarq : public TestSuite
 {
   public:
@@ -211,6 +254,7 @@ class TestHarq : public TestSuite
                                          tbSize,
                                          "HARQ test with 2 receptions"),
                     Duration::QUICK);
+        AddTestCase(new TestHarqOutputPoolTestCase(), Duration::QUICK);
     }
 };
 
@@ -0,0 +1,257 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/beam-manager.h>
+#include <ns3/boolean.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/lte-chunk-processor.h>
+#include <ns3/nr-gnb-phy.h>
+#include <ns3/nr-spectrum-phy.h>
+#include <ns3/nr-spectrum-signal-parameters.h>
+#include <ns3/nr-spectrum-value-helper.h>
+#include <ns3/simulator.h>
+#include <ns3/test.h>
+#include <ns3/uniform-planar-array.h>
+
+#include <cmath>
+#include <string>
+
+/**
+ * \file nr-test-interference-pruning.cc
+ * \ingroup test
+ *
+ * \brief Check the interference pruning of NrSpectrumPhy. A gNB receives a signal of its cell,
+ * 20 dB above the noise, and the signal of another cell. The SINR is compared with the one
+ * computed without pruning: an interfering signal below InterferencePruningThreshold times the
+ * noise is pruned, with a SINR error lower than 10 log10 (1 + InterferencePruningThreshold) dB,
+ * and a stronger one is not. In unlicensed mode, the pruned signal must still be detected by the
+ * CCA, and the SINR is not changed.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case for the interference pruning of NrSpectrumPhy
+ */
+class NrInterferencePruningTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param interferenceToNoiseDb the power of the interfering signal, relative to the noise (dB)
+     * \param unlicensed whether the PHY is in unlicensed mode
+     */
+    NrInterferencePruningTestCase(double interferenceToNoiseDb, bool unlicensed)
+        : TestCase("Interference pruning of a signal at " +
+                   std::to_string(static_cast<int>(interferenceToNoiseDb)) + " dB to the noise" +
+                   (unlicensed ? ", in unlicensed mode" : "")),
+          m_interferenceToNoiseDb(interferenceToNoiseDb),
+          m_unlicensed(unlicensed)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /// \brief The result of a reception
+    struct RxResult
+    {
+        SpectrumValue sinr;    //!< The SINR of the signal of the cell
+        uint32_t numPruned{0}; //!< Number of pruned signals
+        bool ccaBusy{false};   //!< Whether the interfering signal made the channel busy
+    };
+
+    /**
+     * \brief Receive the signal of the cell and the interfering signal
+     * \param pruning whether the interference pruning is enabled
+     * \return the result of the reception
+     */
+    RxResult Receive(bool pruning);
+
+    /**
+     * \brief Save the SINR of the data
+     * \param test the test case
+     * \param sinr the SINR
+     */
+    static void SaveSinr(NrInterferencePruningTestCase* test, const SpectrumValue& sinr);
+
+    /**
+     * \brief Count the pruned signals
+     * \param test the test case
+     * \param rxPowerW the power of the pruned signal
+     * \param duration the duration of the pruned signal
+     */
+    static void Pruned(NrInterferencePruningTestCase* test, double rxPowerW, Time duration);
+
+    /**
+     * \brief Count the times the channel is occupied
+     * \param test the test case
+     * \param duration the time the channel is occupied
+     */
+    static void ChannelOccupied(NrInterferencePruningTestCase* test, Time duration);
+
+    /// Bound of the pruned power, relative to the noise (dB)
+    static constexpr double PRUNING_THRESHOLD_DB = -30.0;
+
+    double m_interferenceToNoiseDb; //!< Power of the interfering signal, to the noise (dB)
+    bool m_unlicensed;              //!< Whether the PHY is in unlicensed mode
+    RxResult m_result;              //!< The result of the current reception
+    uint32_t m_numOccupied{0};      //!< Times the channel is occupied in the current reception
+};
+
+void
+NrInterferencePruningTestCase::SaveSinr(NrInterferencePruningTestCase* test,
+                                        const SpectrumValue& sinr)
+{
+    test->m_result.sinr = sinr;
+}
+
+void
+NrInterferencePruningTestCase::Pruned(NrInterferencePruningTestCase* test,
+                                      [[maybe_unused]] double rxPowerW,
+                                      [[maybe_unused]] Time duration)
+{
+    test->m_result.numPruned++;
+}
+
+void
+NrInterferencePruningTestCase::ChannelOccupied(NrInterferencePruningTestCase* test,
+                                               [[maybe_unused]] Time duration)
+{
+    test->m_numOccupied++;
+}
+
+NrInterferencePruningTestCase::RxResult
+NrInterferencePruningTestCase::Receive(bool pruning)
+{
+    m_result = RxResult();
+    m_numOccupied = 0;
+
+    auto rxPhy = CreateObject<NrSpectrumPhy>();
+    rxPhy->SetMobility(CreateObject<ConstantPositionMobilityModel>());
+    rxPhy->SetAttribute("InterferencePruning", BooleanValue(pruning));
+    rxPhy->SetAttribute("InterferencePruningThreshold", DoubleValue(PRUNING_THRESHOLD_DB));
+    rxPhy->SetAttribute("UnlicensedMode", BooleanValue(m_unlicensed));
+    // Low enough to detect the interfering signal
+    rxPhy->SetAttribute("CcaMode1Threshold", DoubleValue(-150.0));
+    auto phy = CreateObject<NrGnbPhy>();
+    phy->InstallSpectrumPhy(rxPhy);
+    rxPhy->InstallPhy(phy);
+    auto antenna = CreateObject<UniformPlanarArray>();
+    rxPhy->SetAntenna(antenna);
+    CreateObject<BeamManager>()->Configure(antenna);
+    phy->DoSetCellId(99);
+
+    auto txPhy = CreateObject<NrSpectrumPhy>();
+    txPhy->SetMobility(CreateObject<ConstantPositionMobilityModel>());
+    auto txGnbPhy = CreateObject<NrGnbPhy>();
+    txGnbPhy->InstallSpectrumPhy(txPhy);
+    txPhy->InstallPhy(txGnbPhy);
+    auto txAntenna = CreateObject<UniformPlanarArray>();
+    txPhy->SetAntenna(txAntenna);
+    CreateObject<BeamManager>()->Configure(txAntenna);
+
+    auto sinrProcessor = Create<LteChunkProcessor>();
+    sinrProcessor->AddCallback(MakeBoundCallback(&NrInterferencePruningTestCase::SaveSinr, this));
+    rxPhy->AddDataSinrChunkProcessor(sinrProcessor);
+    rxPhy->TraceConnectWithoutContext(
+        "PrunedInterference",
+        MakeBoundCallback(&NrInterferencePruningTestCase::Pruned, this));
+    rxPhy->TraceConnectWithoutContext(
+        "ChannelOccupied",
+        MakeBoundCallback(&NrInterferencePruningTestCase::ChannelOccupied, this));
+
+    auto sm = NrSpectrumValueHelper::GetSpectrumModel(111, 28e9, 15000);
+    auto noisePsd = NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(5, sm);
+    rxPhy->SetNoisePowerSpectralDensity(noisePsd);
+
+    auto interference = Create<NrSpectrumSignalParametersDataFrame>();
+    interference->duration = MilliSeconds(1);
+    interference->psd =
+        Create<SpectrumValue>(*noisePsd * std::pow(10.0, m_interferenceToNoiseDb / 10));
+    interference->cellId = 100;
+    interference->txPhy = txPhy;
+
+    auto signal = Create<NrSpectrumSignalParametersDataFrame>();
+    signal->duration = MilliSeconds(1);
+    signal->psd = Create<SpectrumValue>(*noisePsd * 100.0);
+    signal->cellId = 99;
+    signal->txPhy = txPhy;
+
+    // The interfering signal arrives first, so that the CCA evaluates it alone
+    rxPhy->StartRx(interference);
+    m_result.ccaBusy = m_numOccupied > 0;
+    rxPhy->StartRx(signal);
+
+    Simulator::Run();
+    rxPhy->Dispose();    // Explicitly dispose NrSpectrumPhy since it is not aggregated to a Node
+    phy->Dispose();      // Explicitly dispose NrPhy since it is not aggregated to a Node
+    txPhy->Dispose();    // Explicitly dispose NrSpectrumPhy since it is not aggregated to a Node
+    txGnbPhy->Dispose(); // Explicitly dispose NrPhy since it is not aggregated to a Node
+    Simulator::Destroy();
+    return m_result;
+}
+
+void
+NrInterferencePruningTestCase::DoRun()
+{
+    auto reference = Receive(false);
+    auto result = Receive(true);
+    bool expectPruned = m_interferenceToNoiseDb < PRUNING_THRESHOLD_DB;
+
+    NS_TEST_ASSERT_MSG_EQ(reference.numPruned, 0U, "A signal is pruned without pruning");
+    NS_TEST_ASSERT_MSG_EQ(result.numPruned,
+                          (expectPruned ? 1U : 0U),
+                          "Wrong number of pruned signals");
+    NS_TEST_ASSERT_MSG_GT(reference.sinr.GetValuesN(), 0, "The SINR of the signal is missing");
+    NS_TEST_ASSERT_MSG_EQ(result.sinr.GetValuesN(),
+                          reference.sinr.GetValuesN(),
+                          "The SINR of the signal is missing with the pruning");
+    if (m_unlicensed)
+    {
+        NS_TEST_EXPECT_MSG_EQ(reference.ccaBusy, true, "The interference is not detected");
+        NS_TEST_EXPECT_MSG_EQ(result.ccaBusy, true, "The pruned interference is not detected");
+    }
+
+    double maxErrorDb = 10 * std::log10(1 + std::pow(10.0, PRUNING_THRESHOLD_DB / 10));
+    for (size_t rb = 0; rb < reference.sinr.GetValuesN(); rb++)
+    {
+        if (expectPruned && !m_unlicensed)
+        {
+            NS_TEST_ASSERT_MSG_GT(result.sinr[rb],
+                                  reference.sinr[rb],
+                                  "The pruned interference is in the SINR of RB " << rb);
+            NS_TEST_ASSERT_MSG_LT_OR_EQ(10 * std::log10(result.sinr[rb] / reference.sinr[rb]),
+                                        maxErrorDb,
+                                        "SINR error above the bound on RB " << rb);
+        }
+        else
+        {
+            NS_TEST_ASSERT_MSG_EQ(result.sinr[rb],
+                                  reference.sinr[rb],
+                                  "The SINR of RB " << rb << " changed with the pruning");
+        }
+    }
+}
+
+/**
+ * \brief Test suite for the interference pruning
+ */
+class NrTestInterferencePruningSuite : public TestSuite
+{
+  public:
+    NrTestInterferencePruningSuite()
+        : TestSuite("nr-test-interference-pruning", Type::UNIT)
+    {
+        AddTestCase(new NrInterferencePruningTestCase(-35.0, false), Duration::QUICK);
+        AddTestCase(new NrInterferencePruningTestCase(-20.0, false), Duration::QUICK);
+        AddTestCase(new NrInterferencePruningTestCase(-35.0, true), Duration::QUICK);
+    }
+};
+
+static NrTestInterferencePruningSuite
+    nrTestInterferencePruningSuite; //!< Interference pruning test suite
+
+} // namespace ns3
@@ -0,0 +1,209 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-kpi-aggregator.h>
+#include <ns3/nstime.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/test.h>
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-kpi-aggregator.cc
+ * \ingroup test
+ *
+ * \brief Check the quantiles of NrKpiHistogram, and the summaries that NrKpiAggregator writes
+ * per epoch for a few TBs, SINR reports and scheduled TBs.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that checks the statistics of NrKpiHistogram
+ */
+class NrKpiHistogramTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrKpiHistogramTestCase()
+        : TestCase("Streaming histogram of the KPIs")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrKpiHistogramTestCase::DoRun()
+{
+    NrKpiHistogram histogram;
+    NS_TEST_ASSERT_MSG_EQ(std::isnan(histogram.GetQuantile(0.5)), true, "Empty histogram");
+
+    // 1000 values uniformly spread in [0, 10) dB
+    for (size_t i = 0; i < 1000; i++)
+    {
+        histogram.Add(i * 0.01);
+    }
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetCount(), 1000U, "Wrong count");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetMean(), 4.995, 1e-9, "Wrong mean");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetQuantile(0.05), 0.5, 0.02, "Wrong 5th percentile");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetQuantile(0.5), 5.0, 0.02, "Wrong median");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetQuantile(0.95), 9.5, 0.02, "Wrong 95th percentile");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetQuantile(0.0), 0.0, 1e-9, "Wrong minimum");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetQuantile(1.0), 9.99, 1e-9, "Wrong maximum");
+
+    // Values outside of the bins are clamped to the first and last bins, but the extremes are
+    // exact
+    histogram.Reset();
+    histogram.Add(-100.0);
+    histogram.Add(100.0);
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetQuantile(0.0), -100.0, 1e-9, "Wrong minimum");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetQuantile(1.0), 100.0, 1e-9, "Wrong maximum");
+    NS_TEST_ASSERT_MSG_EQ_TOL(histogram.GetMean(), 0.0, 1e-9, "Wrong mean");
+}
+
+/**
+ * \brief Test case that checks the summaries written by NrKpiAggregator
+ */
+class NrKpiAggregatorTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrKpiAggregatorTestCase()
+        : TestCase("Summaries of NrKpiAggregator")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Read the rows of a summary file, without the header
+     * \param filename the name of the file
+     * \return the fields of each row
+     */
+    static std::vector<std::vector<std::string>> ReadRows(const std::string& filename);
+};
+
+std::vector<std::vector<std::string>>
+NrKpiAggregatorTestCase::ReadRows(const std::string& filename)
+{
+    std::ifstream is(filename);
+    std::vector<std::vector<std::string>> rows;
+    std::string line;
+    while (std::getline(is, line))
+    {
+        if (line.empty() || line[0] == '%')
+        {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::istringstream ls(line);
+        std::string field;
+        while (std::getline(ls, field, '\t'))
+        {
+            fields.push_back(field);
+        }
+        rows.push_back(fields);
+    }
+    return rows;
+}
+
+void
+NrKpiAggregatorTestCase::DoRun()
+{
+    auto dlFilename = CreateTempDirFilename("nr-kpi-dl.txt");
+    auto ulFilename = CreateTempDirFilename("nr-kpi-ul.txt");
+    auto aggregator = CreateObject<NrKpiAggregator>();
+    aggregator->SetAttribute("EpochDuration", TimeValue(MilliSeconds(10)));
+    aggregator->SetAttribute("DlOutputFilename", StringValue(dlFilename));
+    aggregator->SetAttribute("UlOutputFilename", StringValue(ulFilename));
+
+    auto rxPacket = [aggregator](uint16_t rnti, bool isUplink, bool corrupt, uint8_t mcs) {
+        NrRxPacketTraceRecord record{};
+        record.m_sinr = 100.0; // 20 dB
+        record.m_tbler = corrupt ? 0.5 : 0.1;
+        record.m_cellId = 1;
+        record.m_tbSize = 1250;
+        record.m_rnti = rnti;
+        record.m_bwpId = 0;
+        record.m_mcs = mcs;
+        record.m_corrupt = corrupt;
+        record.m_isUplink = isUplink;
+        aggregator->RxPacket(record);
+    };
+    NrSchedulingCallbackInfo retx;
+    retx.m_rnti = 1;
+    retx.m_bwpId = 0;
+    retx.m_tbSize = 1250;
+    retx.m_rv = 1;
+
+    // First epoch [0, 10) ms: 3 DL TBs of RNTI 1 (1 corrupted), 1 UL TB of RNTI 2
+    Simulator::Schedule(MilliSeconds(1), rxPacket, 1, false, false, 5);
+    Simulator::Schedule(MilliSeconds(2), rxPacket, 1, false, true, 7);
+    Simulator::Schedule(MilliSeconds(3), rxPacket, 1, false, false, 5);
+    Simulator::Schedule(MilliSeconds(4), rxPacket, 2, true, false, 3);
+    Simulator::Schedule(MilliSeconds(5), &NrKpiAggregator::DlDataSinr, aggregator, 1, 1, 10.0, 0);
+    Simulator::Schedule(MilliSeconds(6), &NrKpiAggregator::Scheduling, aggregator, 1, retx, false);
+    // No samples in [10, 20) ms. Last epoch [20, 25) ms, written at Simulator::Destroy
+    Simulator::Schedule(MilliSeconds(22), rxPacket, 1, false, false, 9);
+    Simulator::Stop(MilliSeconds(25));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    auto dl = ReadRows(dlFilename);
+    NS_TEST_ASSERT_MSG_EQ(dl.size(), 2U, "Wrong number of DL rows");
+    NS_TEST_ASSERT_MSG_EQ(dl[0].size(), 23U, "Wrong number of DL columns");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][0], "0", "Wrong start of the first epoch");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][1], "0.01", "Wrong end of the first epoch");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][4], "1", "Wrong RNTI");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][5], "3", "Wrong number of TBs");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][6], "1", "Wrong number of corrupted TBs");
+    NS_TEST_ASSERT_MSG_EQ_TOL(std::stod(dl[0][7]), 1.0 / 3, 1e-5, "Wrong BLER");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][9], "2500", "Wrong received bytes");
+    NS_TEST_ASSERT_MSG_EQ_TOL(std::stod(dl[0][10]), 2.0, 1e-9, "Wrong throughput");
+    NS_TEST_ASSERT_MSG_EQ_TOL(std::stod(dl[0][11]), 20.0, 1e-9, "Wrong mean SINR");
+    NS_TEST_ASSERT_MSG_EQ_TOL(std::stod(dl[0][15]), 10.0, 1e-9, "Wrong mean data SINR");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][19], "1", "Wrong number of scheduled TBs");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][21], "1", "Wrong number of retransmissions");
+    NS_TEST_ASSERT_MSG_EQ(dl[0][22], "5:2,7:1", "Wrong MCS histogram");
+
+    NS_TEST_ASSERT_MSG_EQ(dl[1][0], "0.02", "Wrong start of the last epoch");
+    NS_TEST_ASSERT_MSG_EQ(dl[1][1], "0.025", "Wrong end of the last epoch");
+    NS_TEST_ASSERT_MSG_EQ(dl[1][5], "1", "Wrong number of TBs");
+    NS_TEST_ASSERT_MSG_EQ_TOL(std::stod(dl[1][10]), 2.0, 1e-9, "Wrong throughput");
+
+    auto ul = ReadRows(ulFilename);
+    NS_TEST_ASSERT_MSG_EQ(ul.size(), 1U, "Wrong number of UL rows");
+    NS_TEST_ASSERT_MSG_EQ(ul[0][4], "2", "Wrong RNTI");
+    NS_TEST_ASSERT_MSG_EQ(ul[0][22], "3:1", "Wrong MCS histogram");
+}
+
+/**
+ * \brief Test suite for the KPI aggregation
+ */
+class NrTestKpiAggregatorSuite : public TestSuite
+{
+  public:
+    NrTestKpiAggregatorSuite()
+        : TestSuite("nr-test-kpi-aggregator", Type::UNIT)
+    {
+        AddTestCase(new NrKpiHistogramTestCase(), Duration::QUICK);
+        AddTestCase(new NrKpiAggregatorTestCase(), Duration::QUICK);
+    }
+};
+
+static NrTestKpiAggregatorSuite nrTestKpiAggregatorSuite; //!< KPI aggregation test suite
+
+} // namespace ns3
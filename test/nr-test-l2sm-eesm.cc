@@ -5,11 +5,13 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <ns3/enum.h>
+#include <ns3/nr-eesm-bler-table.h>
 #include <ns3/nr-eesm-cc-t1.h>
 #include <ns3/nr-eesm-cc-t2.h>
 #include <ns3/nr-eesm-error-model.h>
 #include <ns3/nr-eesm-ir-t1.h>
 #include <ns3/nr-eesm-ir-t2.h>
+#include <ns3/random-variable-stream.h>
 #include <ns3/test.h>
 
 /**
@@ -17,9 +19,12 @@
  * \ingroup test
  *
  * \brief This test validates specific functions of the NR PHY abstraction model.
- * The test checks two issues: 1) LDPC base graph (BG) selection works properly, and 2)
+ * The test checks three issues: 1) LDPC base graph (BG) selection works properly, 2)
  * BLER values are properly obtained from the BLER-SINR look up tables for different
- * block sizes, MCS Tables, BG types, and SINR values.
+ * block sizes, MCS Tables, BG types, and SINR values, and 3) the compiled version of
+ * the look up tables returns the same values as the original tables. It also checks the
+ * vectorization of the MIMO SINR matrices for the error model, and that the MCS selection of
+ * NrEesmErrorModel gives the same MCS as the default one of NrErrorModel.
  *
  */
 namespace ns3
@@ -50,6 +55,7 @@ class NrL2smEesmTestCase : public TestCase
     void TestMappingSinrBler2(const Ptr<NrEesmErrorModel>& em);
     void TestBgType1(const Ptr<NrEesmErrorModel>& em);
     void TestBgType2(const Ptr<NrEesmErrorModel>& em);
+    void TestCompiledTable(const Ptr<NrEesmErrorModel>& em);
 
     void TestEesmCcTable1();
     void TestEesmCcTable2();
@@ -212,6 +218,64 @@ NrL2smEesmTestCase::TestMappingSinrBler2(const Ptr<NrEesmErrorModel>& em)
     }
 }
 
+void
+NrL2smEesmTestCase::TestCompiledTable(const Ptr<NrEesmErrorModel>& em)
+{
+    const auto table = em->GetSimulatedBlerFromSINR();
+    const auto compiled = em->GetCompiledBlerFromSINR();
+
+    for (uint8_t bg = 0; bg < table->size(); ++bg)
+    {
+        auto bgType = static_cast<NrEesmErrorModel::GraphType>(bg);
+        for (uint8_t mcs = 0; mcs < table->at(bg).size(); ++mcs)
+        {
+            for (const auto& [cbSize, curve] : table->at(bg).at(mcs))
+            {
+                // Check the CB sizes just below, at, and just above the simulated one
+                for (uint32_t cbSizeBit : {cbSize > 0 ? cbSize - 1 : 0, cbSize, cbSize + 1})
+                {
+                    const auto& cbMap = table->at(bg).at(mcs);
+                    auto cbIt = cbMap.upper_bound(cbSizeBit);
+                    if (cbIt != cbMap.begin())
+                    {
+                        cbIt--;
+                    }
+                    const auto& sinrDb =
+                        em->GetSinrDbVectorFromSimulatedValues(bgType, mcs, cbIt->first);
+                    const auto& bler =
+                        em->GetBLERVectorFromSimulatedValues(bgType, mcs, cbIt->first);
+
+                    for (std::size_t i = 0; i < sinrDb.size(); ++i)
+                    {
+                        for (double delta : {-0.01, 0.0, 0.01})
+                        {
+                            double sinr = sinrDb.at(i) + delta;
+                            double expected = 0.0;
+                            if (sinr < sinrDb.front())
+                            {
+                                expected = 1.0;
+                            }
+                            else if (sinr <= sinrDb.back())
+                            {
+                                auto it = std::upper_bound(sinrDb.begin(), sinrDb.end(), sinr);
+                                expected = bler.at(std::distance(sinrDb.begin(), it) - 1);
+                            }
+
+                            NS_TEST_ASSERT_MSG_EQ(
+                                compiled->GetBler(bg, mcs, cbSizeBit, sinr),
+                                expected,
+                                "TestCompiledTable: The compiled table differs from "
+                                " the SINR-BLER table. SINR="
+                                    << sinr << " MCS " << +mcs << " CBS " << cbSizeBit
+                                    << " BG " << +bg);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 void
 NrL2smEesmTestCase::TestEesmCcTable1()
 {
@@ -225,6 +289,7 @@ NrL2smEesmTestCase::TestEesmCcTable1()
     // Test here the functions:
     TestBgType1(em);
     TestMappingSinrBler1(em);
+    TestCompiledTable(em);
 }
 
 void
@@ -240,6 +305,7 @@ NrL2smEesmTestCase::TestEesmCcTable2()
     // Test here the functions:
     TestBgType2(em);
     TestMappingSinrBler2(em);
+    TestCompiledTable(em);
 }
 
 void
@@ -255,6 +321,7 @@ NrL2smEesmTestCase::TestEesmIrTable1()
     // Test here the functions:
     TestBgType1(em);
     TestMappingSinrBler1(em);
+    TestCompiledTable(em);
 }
 
 void
@@ -270,6 +337,7 @@ NrL2smEesmTestCase::TestEesmIrTable2()
     // Test here the functions:
     TestBgType2(em);
     TestMappingSinrBler2(em);
+    TestCompiledTable(em);
 }
 
 void
@@ -281,6 +349,172 @@ NrL2smEesmTestCase::DoRun()
     TestEesmIrTable2();
 }
 
+/**
+ * \brief Test case for the vectorization of the MIMO SINR matrices of the error model
+ */
+class NrL2smMimoVectorizationTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrL2smMimoVectorizationTestCase()
+        : TestCase("Vectorization of the MIMO SINR")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrL2smMimoVectorizationTestCase::DoRun()
+{
+    Ptr<NrEesmErrorModel> em = CreateObject<NrEesmCcT1>();
+
+    const uint8_t rank = 2;
+    const size_t nRbs = 4;
+    std::vector<MimoSinrChunk> chunks(2);
+    chunks[0].mimoSinr = NrSinrMatrix{rank, nRbs};
+    chunks[0].dur = NanoSeconds(100);
+    chunks[1].mimoSinr = NrSinrMatrix{rank, nRbs};
+    chunks[1].dur = NanoSeconds(300);
+    for (size_t rb = 0; rb < nRbs; rb++)
+    {
+        for (uint8_t layer = 0; layer < rank; layer++)
+        {
+            chunks[0].mimoSinr(layer, rb) = 1.0 + rb + 10.0 * layer;
+            chunks[1].mimoSinr(layer, rb) = 5.0 + rb + 10.0 * layer;
+        }
+    }
+
+    auto avgSinr = em->ComputeAvgSinrMimo(chunks);
+    auto vectorizedSinr = em->CreateVectorizedSpecVal(avgSinr);
+    NS_TEST_ASSERT_MSG_EQ(vectorizedSinr.GetValuesN(), rank * nRbs, "Wrong number of values");
+    for (size_t rb = 0; rb < nRbs; rb++)
+    {
+        for (uint8_t layer = 0; layer < rank; layer++)
+        {
+            NS_TEST_ASSERT_MSG_EQ_TOL(vectorizedSinr[rb * rank + layer],
+                                      4.0 + rb + 10.0 * layer,
+                                      1e-12,
+                                      "Wrong average SINR of RB " << rb << " layer " << +layer);
+        }
+    }
+
+    // The SpectrumModel is shared by the SpectrumValues of the same size
+    auto otherSinr = em->CreateVectorizedSpecVal(chunks[0].mimoSinr);
+    NS_TEST_ASSERT_MSG_EQ(otherSinr.GetSpectrumModelUid(),
+                          vectorizedSinr.GetSpectrumModelUid(),
+                          "The vectorized SINRs of the same size have different models");
+    auto smallerSinr = em->CreateVectorizedSpecVal(NrSinrMatrix{rank, nRbs - 1});
+    NS_TEST_ASSERT_MSG_NE(smallerSinr.GetSpectrumModelUid(),
+                          vectorizedSinr.GetSpectrumModelUid(),
+                          "The vectorized SINRs of different sizes have the same model");
+
+    const std::vector<int> map{1, 3};
+    NS_TEST_ASSERT_MSG_EQ((em->CreateVectorizedRbMap(map, rank) == std::vector<int>{2, 3, 6, 7}),
+                          true,
+                          "Wrong vectorized RB map");
+
+    auto output = em->GetTbDecodificationStatsMimo(chunks, map, 100, 5, rank, {});
+    auto expected = em->GetTbDecodificationStats(vectorizedSinr, {2, 3, 6, 7}, 100, 5, {});
+    NS_TEST_ASSERT_MSG_EQ_TOL(output->m_tbler, expected->m_tbler, 1e-12, "Wrong TBLER");
+}
+
+/**
+ * \brief Test case that checks that NrEesmErrorModel::GetMaxMcsForTargetTbler returns the same
+ * MCS as the default implementation of NrErrorModel, which probes every MCS with
+ * GetTbDecodificationStats
+ */
+class NrL2smMaxMcsTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param name the name of the error model
+     * \param em the error model
+     */
+    NrL2smMaxMcsTestCase(const std::string& name, const Ptr<NrEesmErrorModel>& em)
+        : TestCase("Max MCS for a target TBLER with " + name),
+          m_em(em)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the MCS of both implementations for a SINR and RB map
+     * \param sinr the SINR
+     * \param map the RB map
+     * \param targetTbler the target TBLER
+     * \return the MCS
+     */
+    int16_t CheckMaxMcs(const SpectrumValue& sinr, const std::vector<int>& map, double targetTbler);
+
+    Ptr<NrEesmErrorModel> m_em; //!< The error model
+};
+
+int16_t
+NrL2smMaxMcsTestCase::CheckMaxMcs(const SpectrumValue& sinr,
+                                  const std::vector<int>& map,
+                                  double targetTbler)
+{
+    const auto rbNum = static_cast<uint32_t>(map.size());
+    auto tbSizeForMcs = [this, rbNum](uint8_t mcs) {
+        return m_em->GetPayloadSize(12 * 12, mcs, 1, rbNum, NrErrorModel::DL);
+    };
+    auto maxMcs = m_em->GetMaxMcsForTargetTbler(sinr, map, tbSizeForMcs, targetTbler);
+    auto expected =
+        m_em->NrErrorModel::GetMaxMcsForTargetTbler(sinr, map, tbSizeForMcs, targetTbler);
+    NS_TEST_EXPECT_MSG_EQ(maxMcs,
+                          expected,
+                          "Wrong max MCS for a TBLER of " << targetTbler << " with SINR " << sinr);
+    return maxMcs;
+}
+
+void
+NrL2smMaxMcsTestCase::DoRun()
+{
+    const size_t nRbs = 50;
+    auto model = NrErrorModel::GetVectorizedSpectrumModel(nRbs);
+    std::vector<int> allRbs(nRbs);
+    for (size_t rb = 0; rb < nRbs; rb++)
+    {
+        allRbs[rb] = static_cast<int>(rb);
+    }
+
+    // Edge cases: even MCS 0 is above the target, and the max MCS is below it
+    SpectrumValue sinr(model);
+    sinr = std::pow(10.0, -20.0 / 10);
+    NS_TEST_ASSERT_MSG_EQ(CheckMaxMcs(sinr, allRbs, 0.1), -1, "MCS 0 should be above the target");
+    sinr = std::pow(10.0, 40.0 / 10);
+    NS_TEST_ASSERT_MSG_EQ(CheckMaxMcs(sinr, allRbs, 0.1),
+                          m_em->GetMaxMcs(),
+                          "The max MCS should be below the target");
+
+    // Random SINRs and RB maps, around the SINRs where the MCS changes
+    auto uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        const double meanDb = uniform->GetValue(-10.0, 30.0);
+        const double spreadDb = uniform->GetValue(0.0, 10.0);
+        for (size_t rb = 0; rb < nRbs; rb++)
+        {
+            sinr[rb] = std::pow(10.0, (meanDb + uniform->GetValue(-spreadDb, spreadDb)) / 10);
+        }
+        const auto firstRb = uniform->GetInteger(0, nRbs - 1);
+        const auto lastRb = uniform->GetInteger(firstRb, nRbs - 1);
+        const std::vector<int> map(allRbs.begin() + firstRb, allRbs.begin() + lastRb + 1);
+        for (double targetTbler : {0.001, 0.01, 0.1, 0.5})
+        {
+            CheckMaxMcs(sinr, map, targetTbler);
+        }
+    }
+}
+
 class NrTestL2smEesm : public TestSuite
 {
   public:
@@ -288,6 +522,15 @@ class NrTestL2smEesm : public TestSuite
         : TestSuite("nr-test-l2sm-eesm", Type::UNIT)
     {
         AddTestCase(new NrL2smEesmTestCase("First test"), Duration::QUICK);
+        AddTestCase(new NrL2smMimoVectorizationTestCase(), Duration::QUICK);
+        AddTestCase(new NrL2smMaxMcsTestCase("NrEesmCcT1", CreateObject<NrEesmCcT1>()),
+                    Duration::QUICK);
+        AddTestCase(new NrL2smMaxMcsTestCase("NrEesmCcT2", CreateObject<NrEesmCcT2>()),
+                    Duration::QUICK);
+        AddTestCase(new NrL2smMaxMcsTestCase("NrEesmIrT1", CreateObject<NrEesmIrT1>()),
+                    Duration::QUICK);
+        AddTestCase(new NrL2smMaxMcsTestCase("NrEesmIrT2", CreateObject<NrEesmIrT2>()),
+                    Duration::QUICK);
     }
 };
 
@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/fast-exp.h>
+#include <ns3/nr-l2sm-kernels.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/test.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-l2sm-kernels.cc
+ * \ingroup test
+ *
+ * \brief Check that the batched L2SM kernels give the same sums as the scalar loops over the RB
+ * map that the EESM and MIESM error models used before, for random SINRs and RB maps, up to the
+ * rounding errors of the different summation order.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that compares the L2SM kernels with the scalar loops
+ */
+class NrL2smKernelsTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param nRbs the number of RBs of the SINR
+     */
+    NrL2smKernelsTestCase(size_t nRbs)
+        : TestCase("L2SM kernels with " + std::to_string(nRbs) + " RBs"),
+          m_nRbs(nRbs)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    size_t m_nRbs; //!< Number of RBs of the SINR
+};
+
+/// Relative tolerance of the sums, which are added in a different order than the scalar loops
+static constexpr double L2SM_KERNELS_TOLERANCE = 1e-12;
+
+void
+NrL2smKernelsTestCase::DoRun()
+{
+    const std::vector<double> betas{1.6, 4.27, 10.97, 34.28, 132.54};
+
+    // A MI-like table, with uniformly spaced abscissas
+    const uint32_t tableSize = 100;
+    std::vector<double> axis(tableSize);
+    std::vector<double> values(tableSize);
+    for (uint32_t i = 0; i < tableSize; i++)
+    {
+        axis[i] = 0.01 + 0.3 * i;
+        values[i] = 1.0 - std::exp(-axis[i] / 5.0);
+    }
+    NrL2smKernels::UniformTable table;
+    table.m_values = values.data();
+    table.m_size = tableSize;
+    table.m_axisFirst = axis.front();
+    table.m_axisLast = axis.back();
+    table.m_scaling = (tableSize - 1) / (axis.back() - axis.front());
+
+    auto uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+    std::vector<double> sinr(m_nRbs);
+    std::vector<uint64_t> mask;
+    for (uint32_t iter = 0; iter < 50; iter++)
+    {
+        for (auto& s : sinr)
+        {
+            s = std::pow(10.0, uniform->GetValue(-10.0, 30.0) / 10);
+        }
+        std::vector<int> map;
+        for (size_t rb = 0; rb < m_nRbs; rb++)
+        {
+            if (uniform->GetValue() < 0.5)
+            {
+                map.push_back(static_cast<int>(rb));
+            }
+        }
+        if (map.empty())
+        {
+            map.push_back(static_cast<int>(m_nRbs - 1));
+        }
+        NrL2smKernels::FillRbMask(map, m_nRbs, mask);
+
+        // EESM: sum of exp(-sinr / beta), as in the previous NrEesmErrorModel::SinrExp
+        std::vector<double> sums(betas.size());
+        NrL2smKernels::SinrExpSums(sinr.data(),
+                                   mask.data(),
+                                   m_nRbs,
+                                   betas.data(),
+                                   betas.size(),
+                                   sums.data());
+        for (size_t b = 0; b < betas.size(); b++)
+        {
+            double expected = 0.0;
+            for (int rb : map)
+            {
+                expected += exp21d(-sinr[rb] / betas[b]);
+            }
+            NS_TEST_ASSERT_MSG_EQ_TOL(sums[b],
+                                      expected,
+                                      expected * L2SM_KERNELS_TOLERANCE,
+                                      "Wrong exponential sum for beta " << betas[b]);
+        }
+
+        // MIESM: sum of the table values, as in the previous NrLteMiErrorModel::Mib
+        double tableSum = 0.0;
+        NrL2smKernels::TableSums(sinr.data(), mask.data(), m_nRbs, &table, 1, &tableSum);
+        double expected = 0.0;
+        for (int rb : map)
+        {
+            if (sinr[rb] > axis.back())
+            {
+                expected += 1.0;
+            }
+            else
+            {
+                const uint32_t idx =
+                    std::max(0.0, std::floor((sinr[rb] - axis.front()) * table.m_scaling + 1));
+                NS_TEST_ASSERT_MSG_LT(idx, tableSize, "MI map out of data");
+                expected += values[idx];
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ_TOL(tableSum,
+                                  expected,
+                                  expected * L2SM_KERNELS_TOLERANCE,
+                                  "Wrong table sum");
+    }
+}
+
+/**
+ * \brief Test suite for the L2SM kernels
+ */
+class NrTestL2smKernelsSuite : public TestSuite
+{
+  public:
+    NrTestL2smKernelsSuite()
+        : TestSuite("nr-test-l2sm-kernels", Type::UNIT)
+    {
+        // Less than one block, one block, and several blocks with a partial one
+        for (size_t nRbs : {1, 7, 64, 65, 130, 275})
+        {
+            AddTestCase(new NrL2smKernelsTestCase(nRbs), Duration::QUICK);
+        }
+    }
+};
+
+static NrTestL2smKernelsSuite nrTestL2smKernelsSuite; //!< L2SM kernels test suite
+
+} // namespace ns3
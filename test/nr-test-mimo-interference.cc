@@ -0,0 +1,267 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-interference.h>
+#include <ns3/nr-mimo-chunk-processor.h>
+#include <ns3/simulator.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/test.h>
+
+#include <complex>
+#include <vector>
+
+/**
+ * \file nr-test-mimo-interference.cc
+ * \ingroup test
+ *
+ * \brief Check the interference-and-noise covariance matrices that NrInterference reports for
+ * MIMO signals, which are maintained incrementally as the interferers start and end, against the
+ * sum of the covariance matrices of the interferers active in each chunk. Check also that the
+ * covariance matrices of the signals are shared through NrMimoSignalCovCache.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that checks the covariance matrices of the MIMO signal chunks
+ */
+class NrMimoInterferenceCovTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrMimoInterferenceCovTestCase()
+        : TestCase("Incremental interference covariance of NrInterference")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a signal with a deterministic channel matrix
+     * \param seed the value used to generate the channel matrix
+     * \param precoded whether the signal has a (rank-1) precoding matrix
+     * \return the signal parameters
+     */
+    Ptr<SpectrumSignalParameters> CreateSignal(double seed, bool precoded) const;
+
+    /**
+     * \brief Store the signal chunks of a reception
+     * \param chunks the signal chunks
+     */
+    void SaveChunks(const std::vector<MimoSignalChunk>& chunks);
+
+    /**
+     * \brief Check the covariance matrix of a chunk
+     * \param chunk the chunk
+     * \param interferers the interferers active during the chunk
+     */
+    void CheckCov(const MimoSignalChunk& chunk,
+                  const std::vector<Ptr<SpectrumSignalParameters>>& interferers);
+
+    static constexpr size_t NUM_RBS = 4;   //!< Number of RBs
+    static constexpr size_t NUM_PORTS = 2; //!< Number of receive and transmit ports
+    static constexpr double NOISE = 1e-3;  //!< Noise power per RB
+
+    Ptr<SpectrumModel> m_model;                              //!< The spectrum model
+    std::vector<std::vector<MimoSignalChunk>> m_receptions; //!< The chunks of each reception
+};
+
+Ptr<SpectrumSignalParameters>
+NrMimoInterferenceCovTestCase::CreateSignal(double seed, bool precoded) const
+{
+    auto params = Create<SpectrumSignalParameters>();
+    auto psd = Create<SpectrumValue>(m_model);
+    *psd = 1e-2;
+    params->psd = psd;
+
+    auto chan = ComplexMatrixArray{NUM_PORTS, NUM_PORTS, NUM_RBS};
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        for (size_t i = 0; i < NUM_PORTS; i++)
+        {
+            for (size_t j = 0; j < NUM_PORTS; j++)
+            {
+                chan(i, j, p) = std::polar(0.05 * seed * (1.0 + i + j), seed * (i + 3 * j + p));
+            }
+        }
+    }
+    params->spectrumChannelMatrix = Create<const ComplexMatrixArray>(chan);
+
+    if (precoded)
+    {
+        auto prec = ComplexMatrixArray{NUM_PORTS, 1, NUM_RBS};
+        for (size_t p = 0; p < NUM_RBS; p++)
+        {
+            prec(0, 0, p) = std::sqrt(0.5);
+            prec(1, 0, p) = std::polar(std::sqrt(0.5), 0.4 * p);
+        }
+        params->precodingMatrix = Create<const ComplexMatrixArray>(prec);
+    }
+    return params;
+}
+
+void
+NrMimoInterferenceCovTestCase::SaveChunks(const std::vector<MimoSignalChunk>& chunks)
+{
+    m_receptions.push_back(chunks);
+}
+
+void
+NrMimoInterferenceCovTestCase::CheckCov(
+    const MimoSignalChunk& chunk,
+    const std::vector<Ptr<SpectrumSignalParameters>>& interferers)
+{
+    const auto& cov = chunk.interfNoiseCov;
+    NS_TEST_ASSERT_MSG_EQ(cov.GetNumRows(), NUM_PORTS, "Wrong covariance dimensions");
+    NS_TEST_ASSERT_MSG_EQ(cov.GetNumPages(), NUM_RBS, "Wrong covariance dimensions");
+
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        for (size_t i = 0; i < NUM_PORTS; i++)
+        {
+            for (size_t j = 0; j < NUM_PORTS; j++)
+            {
+                std::complex<double> expected = (i == j) ? NOISE : 0.0;
+                for (const auto& intf : interferers)
+                {
+                    auto chan = *intf->spectrumChannelMatrix;
+                    if (intf->precodingMatrix)
+                    {
+                        chan = chan * (*intf->precodingMatrix);
+                    }
+                    for (size_t k = 0; k < chan.GetNumCols(); k++)
+                    {
+                        expected += chan(i, k, p) * std::conj(chan(j, k, p));
+                    }
+                }
+                NS_TEST_ASSERT_MSG_EQ_TOL(std::abs(cov(i, j, p) - expected),
+                                          0.0,
+                                          1e-15,
+                                          "Wrong covariance at RB " << p);
+            }
+        }
+    }
+}
+
+void
+NrMimoInterferenceCovTestCase::DoRun()
+{
+    auto freqs = std::vector<double>{};
+    for (size_t i = 0; i < NUM_RBS; i++)
+    {
+        freqs.push_back(3.5e9 + 180e3 * i);
+    }
+    m_model = Create<SpectrumModel>(freqs);
+    auto noise = Create<SpectrumValue>(m_model);
+    *noise = NOISE;
+
+    auto interference = CreateObject<NrInterference>();
+    interference->SetNoisePowerSpectralDensity(noise);
+    auto cp = Create<NrMimoChunkProcessor>();
+    cp->AddCallback(MimoSignalChunksCb(
+        MakeCallback(&NrMimoInterferenceCovTestCase::SaveChunks, this)));
+    interference->AddMimoChunkProcessor(cp);
+
+    auto rx = CreateSignal(1.0, true);
+    auto intf1 = CreateSignal(0.7, false);
+    auto intf2 = CreateSignal(0.9, true);
+    auto intf3 = CreateSignal(1.3, false);
+
+    // First reception of rx, from 0 to 900 us. Chunks: [0, 300] intf1 + intf2,
+    // [300, 600] intf2, [600, 900] intf2 + intf3
+    interference->AddSignalMimo(rx, MicroSeconds(1000));
+    interference->AddSignalMimo(intf1, MicroSeconds(300));
+    interference->AddSignalMimo(intf2, MicroSeconds(1000));
+    interference->StartRxMimo(rx);
+    Simulator::Schedule(MicroSeconds(600),
+                        &NrInterference::AddSignalMimo,
+                        interference,
+                        intf3,
+                        MicroSeconds(1000));
+    Simulator::Schedule(MicroSeconds(900), &NrInterference::EndRx, interference);
+
+    // Second reception, of intf3, which was accounted as interference, from 950 to 1200 us.
+    // Chunks: [950, 1000] rx + intf2, [1000, 1200] no interference
+    Simulator::Schedule(MicroSeconds(950), &NrInterference::StartRxMimo, interference, intf3);
+    Simulator::Schedule(MicroSeconds(1200), &NrInterference::EndRx, interference);
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_receptions.size(), 2U, "Wrong number of receptions");
+    NS_TEST_ASSERT_MSG_EQ(m_receptions[0].size(), 3U, "Wrong number of chunks");
+    NS_TEST_ASSERT_MSG_EQ(m_receptions[1].size(), 2U, "Wrong number of chunks");
+    CheckCov(m_receptions[0][0], {intf1, intf2});
+    CheckCov(m_receptions[0][1], {intf2});
+    CheckCov(m_receptions[0][2], {intf2, intf3});
+    CheckCov(m_receptions[1][0], {rx, intf2});
+    CheckCov(m_receptions[1][1], {});
+}
+
+/**
+ * \brief Test case that checks the sharing of the covariance matrices of the signals
+ */
+class NrMimoSignalCovCacheTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrMimoSignalCovCacheTestCase()
+        : TestCase("Sharing of the covariance matrices of the MIMO signals")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrMimoSignalCovCacheTestCase::DoRun()
+{
+    auto signal = Create<SpectrumSignalParameters>();
+    auto chan = ComplexMatrixArray{2, 1, 1};
+    chan(0, 0, 0) = {1.0, 2.0};
+    chan(1, 0, 0) = {0.0, -1.0};
+    signal->spectrumChannelMatrix = Create<const ComplexMatrixArray>(chan);
+
+    auto cache = Create<NrMimoSignalCovCache>();
+    auto cov1 = cache->Acquire(signal);
+    auto cov2 = cache->Acquire(signal);
+    NS_TEST_ASSERT_MSG_EQ(cov1, cov2, "The users of a signal must share its covariance matrix");
+    NS_TEST_ASSERT_MSG_EQ_TOL(std::abs((*cov1)(0, 1, 0) - std::complex<double>{-2.0, 1.0}),
+                              0.0,
+                              1e-15,
+                              "Wrong covariance matrix");
+
+    // The entry is kept until its last user releases it
+    cache->Release(signal);
+    NS_TEST_ASSERT_MSG_EQ(cache->Acquire(signal), cov1, "The entry was released too early");
+    cache->Release(signal);
+    cache->Release(signal);
+    NS_TEST_ASSERT_MSG_NE(cache->Acquire(signal), cov1, "The entry was not released");
+    cache->Release(signal);
+}
+
+/**
+ * \brief Test suite for the MIMO interference computation
+ */
+class NrTestMimoInterferenceSuite : public TestSuite
+{
+  public:
+    NrTestMimoInterferenceSuite()
+        : TestSuite("nr-test-mimo-interference", Type::UNIT)
+    {
+        AddTestCase(new NrMimoInterferenceCovTestCase(), Duration::QUICK);
+        AddTestCase(new NrMimoSignalCovCacheTestCase(), Duration::QUICK);
+    }
+};
+
+static NrTestMimoInterferenceSuite nrTestMimoInterferenceSuite; //!< MIMO interference test suite
+
+} // namespace ns3
@@ -0,0 +1,264 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-mimo-matrices.h>
+#include <ns3/test.h>
+
+#include <cmath>
+#include <complex>
+#include <string>
+
+/**
+ * \file nr-test-mimo-matrices.cc
+ * \ingroup test
+ *
+ * \brief Check the capacity that NrIntfNormChanMat::ComputeCapacityForPrecoderBank computes
+ * for a bank of precoders against its closed form, for rank 1 and rank 2, and, when the
+ * module is built with Eigen, the MIMO interference normalization and SINR for the port counts
+ * with fixed-size kernels and for the others.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that checks the capacity of a bank of precoders
+ */
+class NrPrecoderBankCapacityTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param nRx number of receive ports
+     * \param nTx number of transmit ports
+     * \param rank number of layers of each precoder (1 or 2)
+     */
+    NrPrecoderBankCapacityTestCase(size_t nRx, size_t nTx, size_t rank)
+        : TestCase("Capacity of a bank of precoders, " + std::to_string(nRx) + "x" +
+                   std::to_string(nTx) + " rank " + std::to_string(rank)),
+          m_nRx(nRx),
+          m_nTx(nTx),
+          m_rank(rank)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    size_t m_nRx;  //!< Number of receive ports
+    size_t m_nTx;  //!< Number of transmit ports
+    size_t m_rank; //!< Number of layers of each precoder
+};
+
+void
+NrPrecoderBankCapacityTestCase::DoRun()
+{
+    const size_t nPages = 3;
+    const size_t nPrec = 4;
+
+    // Arbitrary, but deterministic, channel and precoders
+    auto chan = ComplexMatrixArray{m_nRx, m_nTx, nPages};
+    for (size_t p = 0; p < nPages; p++)
+    {
+        for (size_t i = 0; i < m_nRx; i++)
+        {
+            for (size_t j = 0; j < m_nTx; j++)
+            {
+                chan(i, j, p) = std::polar(1.0 + 0.1 * (i + 2 * j + p), 0.7 * (3 * i + j + 5 * p));
+            }
+        }
+    }
+    auto bank = ComplexMatrixArray{m_nTx, m_rank * nPrec};
+    for (size_t j = 0; j < m_nTx; j++)
+    {
+        for (size_t c = 0; c < m_rank * nPrec; c++)
+        {
+            bank(j, c) = std::polar(1.0 / std::sqrt(m_nTx * m_rank), 1.3 * (j * c + c));
+        }
+    }
+
+    auto cap = NrIntfNormChanMat{chan}.ComputeCapacityForPrecoderBank(bank, m_rank);
+    NS_TEST_ASSERT_MSG_EQ(cap.GetNumRows(), nPages, "Wrong number of pages");
+    NS_TEST_ASSERT_MSG_EQ(cap.GetNumCols(), nPrec, "Wrong number of precoders");
+
+    for (size_t p = 0; p < nPages; p++)
+    {
+        for (size_t k = 0; k < nPrec; k++)
+        {
+            // Gram matrix G = I + (H * P)' * (H * P) of precoder k
+            std::complex<double> g[2][2] = {{1.0, 0.0}, {0.0, 1.0}};
+            for (size_t a = 0; a < m_rank; a++)
+            {
+                for (size_t b = 0; b < m_rank; b++)
+                {
+                    for (size_t i = 0; i < m_nRx; i++)
+                    {
+                        std::complex<double> hpa = 0.0;
+                        std::complex<double> hpb = 0.0;
+                        for (size_t j = 0; j < m_nTx; j++)
+                        {
+                            hpa += chan(i, j, p) * bank(j, k * m_rank + a);
+                            hpb += chan(i, j, p) * bank(j, k * m_rank + b);
+                        }
+                        g[a][b] += std::conj(hpa) * hpb;
+                    }
+                }
+            }
+
+            // MSE = inv(G), SINR = 1 / MSE(l, l) - 1, capacity = sum(log2(1 + SINR))
+            double expected = 0.0;
+            if (m_rank == 1)
+            {
+                expected = std::log2(std::real(g[0][0]));
+            }
+            else
+            {
+                auto det = std::real(g[0][0] * g[1][1] - g[0][1] * g[1][0]);
+                expected = std::log2(1.0 + (1.0 / (std::real(g[1][1]) / det) - 1.0)) +
+                           std::log2(1.0 + (1.0 / (std::real(g[0][0]) / det) - 1.0));
+            }
+            NS_TEST_ASSERT_MSG_EQ_TOL(cap(p, k), expected, 1e-9, "Wrong capacity");
+        }
+    }
+}
+
+#ifdef HAVE_EIGEN3
+// CalcIntfNormChannel and ComputeMseMimo of MIMO matrices need Eigen
+
+/**
+ * \brief Test case that checks the interference-normalized channel and the SINR of a precoder
+ */
+class NrMimoSinrTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param nRx number of receive ports
+     * \param nTx number of transmit ports
+     * \param rank number of layers of the precoder
+     */
+    NrMimoSinrTestCase(size_t nRx, size_t nTx, size_t rank)
+        : TestCase("MIMO SINR, " + std::to_string(nRx) + "x" + std::to_string(nTx) + " rank " +
+                   std::to_string(rank)),
+          m_nRx(nRx),
+          m_nTx(nTx),
+          m_rank(rank)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    size_t m_nRx;  //!< Number of receive ports
+    size_t m_nTx;  //!< Number of transmit ports
+    size_t m_rank; //!< Number of layers of the precoder
+};
+
+void
+NrMimoSinrTestCase::DoRun()
+{
+    const size_t nPages = 3;
+
+    // A covariance matrix L * L' with a known Cholesky factor L, and a channel L * Y: the
+    // interference-normalized channel is Y
+    auto chol = ComplexMatrixArray{m_nRx, m_nRx, nPages};
+    auto normChan = ComplexMatrixArray{m_nRx, m_nTx, nPages};
+    auto prec = ComplexMatrixArray{m_nTx, m_rank, nPages};
+    for (size_t p = 0; p < nPages; p++)
+    {
+        for (size_t i = 0; i < m_nRx; i++)
+        {
+            chol(i, i, p) = 1.0 + 0.2 * (i + p);
+            for (size_t k = 0; k < i; k++)
+            {
+                chol(i, k, p) = std::polar(0.3, 0.9 * (i + 2 * k + p));
+            }
+            for (size_t j = 0; j < m_nTx; j++)
+            {
+                normChan(i, j, p) = std::polar(1.0 + 0.1 * (i + 2 * j + p), 0.7 * (3 * i + j + p));
+            }
+        }
+        for (size_t j = 0; j < m_nTx; j++)
+        {
+            for (size_t c = 0; c < m_rank; c++)
+            {
+                prec(j, c, p) = std::polar(1.0 / std::sqrt(m_nTx * m_rank), 1.3 * (j * c + c + p));
+            }
+        }
+    }
+    auto covMat = NrCovMat{chol * chol.HermitianTranspose()};
+    auto chan = chol * normChan;
+
+    auto res = covMat.CalcIntfNormChannel(chan);
+    for (size_t p = 0; p < nPages; p++)
+    {
+        for (size_t i = 0; i < m_nRx; i++)
+        {
+            for (size_t j = 0; j < m_nTx; j++)
+            {
+                NS_TEST_ASSERT_MSG_LT(std::abs(res(i, j, p) - normChan(i, j, p)),
+                                      1e-9,
+                                      "Wrong interference-normalized channel");
+            }
+        }
+    }
+
+    // The capacity of the SINR matches the one of ComputeCapacityForPrecoderBank, which does not
+    // use the MIMO kernels
+    auto sinr = res.ComputeSinrForPrecoding(prec);
+    NS_TEST_ASSERT_MSG_EQ(sinr.GetRank(), m_rank, "Wrong rank");
+    NS_TEST_ASSERT_MSG_EQ(sinr.GetNumRbs(), nPages, "Wrong number of RBs");
+    for (size_t p = 0; p < nPages; p++)
+    {
+        auto pagePrec = ComplexMatrixArray{m_nTx, m_rank};
+        auto pageChan = NrIntfNormChanMat{ComplexMatrixArray{m_nRx, m_nTx}};
+        for (size_t j = 0; j < m_nTx; j++)
+        {
+            for (size_t c = 0; c < m_rank; c++)
+            {
+                pagePrec(j, c) = prec(j, c, p);
+            }
+            for (size_t i = 0; i < m_nRx; i++)
+            {
+                pageChan(i, j) = res(i, j, p);
+            }
+        }
+        double capacity = 0.0;
+        for (size_t layer = 0; layer < m_rank; layer++)
+        {
+            NS_TEST_ASSERT_MSG_GT(sinr(layer, p), 0.0, "Wrong SINR");
+            capacity += std::log2(1.0 + sinr(layer, p));
+        }
+        auto expected = pageChan.ComputeCapacityForPrecoderBank(pagePrec, m_rank)(0, 0);
+        NS_TEST_ASSERT_MSG_EQ_TOL(capacity, expected, 1e-9, "Wrong SINR");
+    }
+}
+#endif
+
+/**
+ * \brief Test suite for the MIMO matrices
+ */
+class NrTestMimoMatricesSuite : public TestSuite
+{
+  public:
+    NrTestMimoMatricesSuite()
+        : TestSuite("nr-test-mimo-matrices", Type::UNIT)
+    {
+        AddTestCase(new NrPrecoderBankCapacityTestCase(1, 1, 1), Duration::QUICK);
+        AddTestCase(new NrPrecoderBankCapacityTestCase(2, 4, 1), Duration::QUICK);
+        AddTestCase(new NrPrecoderBankCapacityTestCase(2, 4, 2), Duration::QUICK);
+        AddTestCase(new NrPrecoderBankCapacityTestCase(4, 8, 2), Duration::QUICK);
+#ifdef HAVE_EIGEN3
+        AddTestCase(new NrMimoSinrTestCase(1, 2, 1), Duration::QUICK);
+        AddTestCase(new NrMimoSinrTestCase(2, 2, 2), Duration::QUICK);
+        AddTestCase(new NrMimoSinrTestCase(2, 4, 1), Duration::QUICK);
+        AddTestCase(new NrMimoSinrTestCase(3, 3, 3), Duration::QUICK);
+        AddTestCase(new NrMimoSinrTestCase(4, 8, 4), Duration::QUICK);
+        AddTestCase(new NrMimoSinrTestCase(8, 8, 8), Duration::QUICK);
+#endif
+    }
+};
+
+static NrTestMimoMatricesSuite nrTestMimoMatricesSuite; //!< MIMO matrices test suite
+
+} // namespace ns3
@@ -0,0 +1,297 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/beam-id.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-mac-scheduler-ofdma-pf.h>
+#include <ns3/nr-mac-scheduler-ue-info-pf.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/test.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-ofdma-rbg-assignment.cc
+ * \ingroup test
+ *
+ * \brief Check that the heap-based RBG assignment of NrMacSchedulerOfdma (AssignDLRBG and
+ * AssignULRBG) gives the same RBGs, TB sizes and PF metrics as the loop that sorted all the UEs
+ * of the beam for each RBG, for UEs with different MCS, ranks, buffers and average throughputs.
+ * The average throughputs are all different, because std::sort does not define the order of
+ * UEs with the same priority.
+ */
+namespace ns3
+{
+
+/**
+ * \brief OFDMA PF scheduler that exposes the RBG assignment, and the previous sort-based loop
+ */
+class NrTestOfdmaRbgScheduler : public NrMacSchedulerOfdmaPF
+{
+  public:
+    /**
+     * \brief GetTypeId
+     * \return The TypeId of the class
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Assign the RBGs with NrMacSchedulerOfdma
+     * \param dl true for DL, false for UL
+     * \param symAvail the available symbols
+     * \param activeUes the active UEs of each beam
+     * \return the symbols of each beam
+     */
+    BeamSymbolMap Assign(bool dl, uint32_t symAvail, const ActiveUeMap& activeUes) const
+    {
+        return dl ? AssignDLRBG(symAvail, activeUes) : AssignULRBG(symAvail, activeUes);
+    }
+
+    /**
+     * \brief Assign the RBGs with the previous loop, that sorted the UEs for each RBG
+     * \param dl true for DL, false for UL
+     * \param symPerBeam the symbols of each beam
+     * \param activeUes the active UEs of each beam
+     */
+    void SortAssign(bool dl, const BeamSymbolMap& symPerBeam, const ActiveUeMap& activeUes) const;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(NrTestOfdmaRbgScheduler);
+
+TypeId
+NrTestOfdmaRbgScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::NrTestOfdmaRbgScheduler")
+                            .SetParent<NrMacSchedulerOfdmaPF>()
+                            .AddConstructor<NrTestOfdmaRbgScheduler>();
+    return tid;
+}
+
+void
+NrTestOfdmaRbgScheduler::SortAssign(bool dl,
+                                    const BeamSymbolMap& symPerBeam,
+                                    const ActiveUeMap& activeUes) const
+{
+    GetFirst GetUe;
+    for (const auto& el : activeUes)
+    {
+        uint32_t beamSym = symPerBeam.at(el.first);
+        uint32_t rbgAssignable = 1 * beamSym;
+        std::vector<UePtrAndBufferReq> ueVector = el.second;
+        FTResources assigned(0, 0);
+        const auto mask = dl ? GetDlNotchedRbgMask() : GetUlNotchedRbgMask();
+        uint32_t resources = std::count(mask.begin(), mask.end(), 1);
+
+        for (auto& ue : ueVector)
+        {
+            dl ? BeforeDlSched(ue, FTResources(rbgAssignable * beamSym, beamSym))
+               : BeforeUlSched(ue, FTResources(rbgAssignable * beamSym, beamSym));
+        }
+
+        while (resources > 0)
+        {
+            std::sort(ueVector.begin(),
+                      ueVector.end(),
+                      dl ? GetUeCompareDlFn() : GetUeCompareUlFn());
+            auto schedInfoIt = ueVector.begin();
+            while (schedInfoIt != ueVector.end())
+            {
+                uint32_t tbSize = dl ? GetUe(*schedInfoIt)->m_dlTbSize
+                                     : GetUe(*schedInfoIt)->m_ulTbSize;
+                if (tbSize >= std::max(schedInfoIt->second, dl ? 10U : 12U))
+                {
+                    schedInfoIt++;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            if (schedInfoIt == ueVector.end())
+            {
+                break;
+            }
+
+            (dl ? GetUe(*schedInfoIt)->m_dlRBG : GetUe(*schedInfoIt)->m_ulRBG) += rbgAssignable;
+            (dl ? GetUe(*schedInfoIt)->m_dlSym : GetUe(*schedInfoIt)->m_ulSym) = beamSym;
+            assigned.m_rbg += rbgAssignable;
+            assigned.m_sym = beamSym;
+            resources -= 1;
+
+            dl ? AssignedDlResources(*schedInfoIt, FTResources(rbgAssignable, beamSym), assigned)
+               : AssignedUlResources(*schedInfoIt, FTResources(rbgAssignable, beamSym), assigned);
+            for (auto& ue : ueVector)
+            {
+                if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                {
+                    dl ? NotAssignedDlResources(ue, FTResources(rbgAssignable, beamSym), assigned)
+                       : NotAssignedUlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * \brief Test case that compares the heap-based and the sort-based RBG assignments
+ */
+class NrOfdmaRbgAssignmentTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param dl true for DL, false for UL
+     * \param numRbg the number of RBGs
+     * \param numUesPerBeam the number of UEs of each of the two beams
+     */
+    NrOfdmaRbgAssignmentTestCase(bool dl, uint32_t numRbg, uint32_t numUesPerBeam)
+        : TestCase(std::string(dl ? "DL" : "UL") + " OFDMA RBG assignment with " +
+                   std::to_string(numRbg) + " RBGs and " + std::to_string(numUesPerBeam) +
+                   " UEs per beam"),
+          m_dl(dl),
+          m_numRbg(numRbg),
+          m_numUesPerBeam(numUesPerBeam)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /// \brief Parameters of a UE
+    struct UeParams
+    {
+        uint16_t rnti;      //!< RNTI
+        BeamId beamId;      //!< Beam
+        uint8_t mcs;        //!< MCS
+        uint8_t rank;       //!< Rank
+        uint32_t bufSize;   //!< Buffer size
+        double lastAvgTput; //!< Average throughput of the previous slots
+        double avgTput;     //!< Average throughput
+    };
+
+    /**
+     * \brief Create the UEs
+     * \param params the parameters of the UEs
+     * \param ues filled with the UEs, in the order of the parameters
+     * \return the active UEs of each beam
+     */
+    NrMacSchedulerNs3::ActiveUeMap CreateUes(
+        const std::vector<UeParams>& params,
+        std::vector<std::shared_ptr<NrMacSchedulerUeInfoPF>>& ues) const;
+
+    bool m_dl;                //!< true for DL, false for UL
+    uint32_t m_numRbg;        //!< Number of RBGs
+    uint32_t m_numUesPerBeam; //!< Number of UEs of each beam
+};
+
+NrMacSchedulerNs3::ActiveUeMap
+NrOfdmaRbgAssignmentTestCase::CreateUes(
+    const std::vector<UeParams>& params,
+    std::vector<std::shared_ptr<NrMacSchedulerUeInfoPF>>& ues) const
+{
+    NrMacSchedulerNs3::ActiveUeMap activeUes;
+    for (const auto& p : params)
+    {
+        auto ue = std::make_shared<NrMacSchedulerUeInfoPF>(1.0, p.rnti, p.beamId, []() {
+            return 1U;
+        });
+        (m_dl ? ue->m_dlMcs : ue->m_ulMcs) = p.mcs;
+        (m_dl ? ue->m_dlRank : ue->m_ulRank) = p.rank;
+        (m_dl ? ue->m_lastAvgTputDl : ue->m_lastAvgTputUl) = p.lastAvgTput;
+        (m_dl ? ue->m_avgTputDl : ue->m_avgTputUl) = p.avgTput;
+        activeUes[p.beamId].emplace_back(ue, p.bufSize);
+        ues.push_back(ue);
+    }
+    return activeUes;
+}
+
+void
+NrOfdmaRbgAssignmentTestCase::DoRun()
+{
+    auto amc = CreateObject<NrAmc>();
+    auto sched = CreateObject<NrTestOfdmaRbgScheduler>();
+    sched->InstallDlAmc(amc);
+    sched->InstallUlAmc(amc);
+    sched->SetDlNotchedRbgMask(std::vector<uint8_t>(m_numRbg, 1));
+    sched->SetUlNotchedRbgMask(std::vector<uint8_t>(m_numRbg, 1));
+
+    auto uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+    for (uint32_t iter = 0; iter < 20; iter++)
+    {
+        // Every beam has a UE with a large buffer, the other UEs are served with a few RBGs
+        std::vector<UeParams> params;
+        for (uint32_t beam = 0; beam < 2; beam++)
+        {
+            for (uint32_t u = 0; u < m_numUesPerBeam; u++)
+            {
+                UeParams p;
+                p.rnti = static_cast<uint16_t>(params.size() + 1);
+                p.beamId = BeamId(beam, 0.0);
+                p.mcs = static_cast<uint8_t>(uniform->GetInteger(0, 27));
+                p.rank = static_cast<uint8_t>(uniform->GetInteger(1, 2));
+                p.bufSize = (u % 3 == 0) ? 100000 : uniform->GetInteger(1, 2000);
+                p.lastAvgTput = uniform->GetValue(1e3, 1e6);
+                p.avgTput = uniform->GetValue(1e3, 1e6);
+                params.push_back(p);
+            }
+        }
+
+        std::vector<std::shared_ptr<NrMacSchedulerUeInfoPF>> heapUes;
+        std::vector<std::shared_ptr<NrMacSchedulerUeInfoPF>> sortUes;
+        auto symPerBeam = sched->Assign(m_dl, 12, CreateUes(params, heapUes));
+        sched->SortAssign(m_dl, symPerBeam, CreateUes(params, sortUes));
+
+        for (size_t i = 0; i < params.size(); i++)
+        {
+            const auto& h = heapUes[i];
+            const auto& s = sortUes[i];
+            auto msg = " of UE " + std::to_string(params[i].rnti) + " at iteration " +
+                       std::to_string(iter);
+            NS_TEST_ASSERT_MSG_EQ((m_dl ? h->m_dlRBG : h->m_ulRBG),
+                                  (m_dl ? s->m_dlRBG : s->m_ulRBG),
+                                  "Wrong RBGs" << msg);
+            NS_TEST_ASSERT_MSG_EQ(+(m_dl ? h->m_dlSym : h->m_ulSym),
+                                  +(m_dl ? s->m_dlSym : s->m_ulSym),
+                                  "Wrong symbols" << msg);
+            NS_TEST_ASSERT_MSG_EQ((m_dl ? h->m_dlTbSize : h->m_ulTbSize),
+                                  (m_dl ? s->m_dlTbSize : s->m_ulTbSize),
+                                  "Wrong TB size" << msg);
+            NS_TEST_ASSERT_MSG_EQ((m_dl ? h->m_avgTputDl : h->m_avgTputUl),
+                                  (m_dl ? s->m_avgTputDl : s->m_avgTputUl),
+                                  "Wrong average throughput" << msg);
+        }
+    }
+}
+
+/**
+ * \brief Test suite for the OFDMA RBG assignment
+ */
+class NrTestOfdmaRbgAssignmentSuite : public TestSuite
+{
+  public:
+    NrTestOfdmaRbgAssignmentSuite()
+        : TestSuite("nr-test-ofdma-rbg-assignment", Type::UNIT)
+    {
+        for (bool dl : {true, false})
+        {
+            for (uint32_t numRbg : {4, 53})
+            {
+                for (uint32_t numUesPerBeam : {1, 5, 16})
+                {
+                    AddTestCase(new NrOfdmaRbgAssignmentTestCase(dl, numRbg, numUesPerBeam),
+                                Duration::QUICK);
+                }
+            }
+        }
+    }
+};
+
+static NrTestOfdmaRbgAssignmentSuite
+    nrTestOfdmaRbgAssignmentSuite; //!< OFDMA RBG assignment test suite
+
+} // namespace ns3
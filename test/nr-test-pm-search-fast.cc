@@ -0,0 +1,268 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-cb-type-one-sp.h>
+#include <ns3/nr-mimo-chunk-processor.h>
+#include <ns3/nr-mimo-signal.h>
+#include <ns3/nr-pm-search-fast.h>
+#include <ns3/nr-pm-search-full.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+#include <cmath>
+#include <complex>
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-pm-search-fast.cc
+ * \ingroup test
+ *
+ * \brief Check the PMI, rank and CQI of NrPmSearchFast against NrPmSearchFull, on synthetic
+ * channels. When all the wideband precoding matrices are candidates and no rank is pruned, the
+ * fast search must give the same feedback as the full search. With the default attributes, it
+ * must find the codebook beam of a line-of-sight channel, and its TB size over random channels
+ * must be within NR_PM_SEARCH_FAST_TB_TOLERANCE of the one of the full search.
+ */
+namespace ns3
+{
+
+/// Maximum relative loss of the total TB size of the fast search, with the default attributes
+static constexpr double NR_PM_SEARCH_FAST_TB_TOLERANCE = 0.1;
+
+/**
+ * \brief Test case that compares NrPmSearchFast with NrPmSearchFull
+ */
+class NrPmSearchFastTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param numHPorts the number of horizontal ports of the (dual-polarized) gNB antenna
+     * \param numRxPorts the number of UE ports
+     */
+    NrPmSearchFastTestCase(size_t numHPorts, size_t numRxPorts)
+        : TestCase("Fast PM search with " + std::to_string(2 * numHPorts) + " gNB ports and " +
+                   std::to_string(numRxPorts) + " UE ports"),
+          m_numHPorts(numHPorts),
+          m_numRxPorts(numRxPorts)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create and initialize a PM search
+     * \param pmSearch the PM search, with its attributes already set
+     * \return the PM search
+     */
+    Ptr<NrPmSearchFull> InitPmSearch(Ptr<NrPmSearchFull> pmSearch) const;
+
+    /**
+     * \brief Create a signal with a Rayleigh channel
+     * \return the signal
+     */
+    NrMimoSignal CreateRayleighSignal() const;
+
+    /**
+     * \brief Create a signal with a rank-1 channel matched to a codebook precoder
+     * \param prec the rank-1 precoding matrix (nGnbPorts x 1)
+     * \return the signal
+     */
+    NrMimoSignal CreateBeamSignal(const ComplexMatrixArray& prec) const;
+
+    /**
+     * \brief Create a signal from its channel matrix, with white noise
+     * \param chan the channel matrix (nRxPorts x nGnbPorts x nRbs)
+     * \return the signal
+     */
+    NrMimoSignal CreateSignal(const ComplexMatrixArray& chan) const;
+
+    /**
+     * \brief Check that two CQI feedbacks are the same
+     * \param fast the feedback of the fast search
+     * \param full the feedback of the full search
+     * \param msg the context of the check
+     */
+    void CheckSameFeedback(const PmCqiInfo& fast, const PmCqiInfo& full, const std::string& msg);
+
+    static constexpr size_t NUM_RBS = 24;      //!< Number of RBs
+    static constexpr double NOISE = 0.1;       //!< Noise power per RB and receive port
+    static constexpr size_t NUM_CHANNELS = 20; //!< Number of random channels
+
+    size_t m_numHPorts;                   //!< Number of horizontal ports of the gNB antenna
+    size_t m_numRxPorts;                  //!< Number of UE ports
+    Ptr<NrAmc> m_amc;                     //!< The AMC shared by the searches
+    Ptr<NormalRandomVariable> m_normal;   //!< Random variable of the channel coefficients
+    Ptr<UniformRandomVariable> m_uniform; //!< Random variable of the phases
+};
+
+Ptr<NrPmSearchFull>
+NrPmSearchFastTestCase::InitPmSearch(Ptr<NrPmSearchFull> pmSearch) const
+{
+    pmSearch->SetAttribute("CodebookType", TypeIdValue(NrCbTypeOneSp::GetTypeId()));
+    pmSearch->SetAmc(m_amc);
+    pmSearch->SetGnbParams(true, m_numHPorts, 1);
+    pmSearch->SetUeParams(m_numRxPorts);
+    pmSearch->InitCodebooks();
+    return pmSearch;
+}
+
+NrMimoSignal
+NrPmSearchFastTestCase::CreateRayleighSignal() const
+{
+    auto chan = ComplexMatrixArray{m_numRxPorts, 2 * m_numHPorts, NUM_RBS};
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        for (size_t j = 0; j < 2 * m_numHPorts; j++)
+        {
+            for (size_t i = 0; i < m_numRxPorts; i++)
+            {
+                chan(i, j, p) = std::complex<double>{m_normal->GetValue(), m_normal->GetValue()};
+            }
+        }
+    }
+    return CreateSignal(chan);
+}
+
+NrMimoSignal
+NrPmSearchFastTestCase::CreateBeamSignal(const ComplexMatrixArray& prec) const
+{
+    // H = a * p' on each RB, with a random gain and phase per RB and receive port
+    auto chan = ComplexMatrixArray{m_numRxPorts, 2 * m_numHPorts, NUM_RBS};
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        for (size_t i = 0; i < m_numRxPorts; i++)
+        {
+            auto a = std::polar(m_uniform->GetValue(1.0, 2.0), m_uniform->GetValue(0.0, 2 * M_PI));
+            for (size_t j = 0; j < 2 * m_numHPorts; j++)
+            {
+                chan(i, j, p) = a * std::conj(prec(j, 0, 0));
+            }
+        }
+    }
+    return CreateSignal(chan);
+}
+
+NrMimoSignal
+NrPmSearchFastTestCase::CreateSignal(const ComplexMatrixArray& chan) const
+{
+    auto cov = ComplexMatrixArray{m_numRxPorts, m_numRxPorts, NUM_RBS};
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        for (size_t i = 0; i < m_numRxPorts; i++)
+        {
+            cov(i, i, p) = NOISE;
+        }
+    }
+    MimoSignalChunk chunk;
+    chunk.chanSpct = chan;
+    chunk.interfNoiseCov = NrCovMat{cov};
+    chunk.dur = NanoSeconds(1);
+    return NrMimoSignal{std::vector<MimoSignalChunk>{chunk}};
+}
+
+void
+NrPmSearchFastTestCase::CheckSameFeedback(const PmCqiInfo& fast,
+                                          const PmCqiInfo& full,
+                                          const std::string& msg)
+{
+    NS_TEST_EXPECT_MSG_EQ(+fast.m_rank, +full.m_rank, "Wrong rank " << msg);
+    NS_TEST_EXPECT_MSG_EQ(fast.m_wbPmi, full.m_wbPmi, "Wrong wideband PMI " << msg);
+    NS_TEST_EXPECT_MSG_EQ((fast.m_sbPmis == full.m_sbPmis), true, "Wrong subband PMIs " << msg);
+    NS_TEST_EXPECT_MSG_EQ(+fast.m_wbCqi, +full.m_wbCqi, "Wrong wideband CQI " << msg);
+    NS_TEST_EXPECT_MSG_EQ(fast.m_tbSize, full.m_tbSize, "Wrong TB size " << msg);
+}
+
+void
+NrPmSearchFastTestCase::DoRun()
+{
+    m_amc = CreateObject<NrAmc>();
+    m_normal = CreateObject<NormalRandomVariable>();
+    m_normal->SetAttribute("Variance", DoubleValue(0.5));
+    m_normal->SetStream(1);
+    m_uniform = CreateObject<UniformRandomVariable>();
+    m_uniform->SetStream(2);
+    const auto update = NrPmSearch::PmiUpdate{true, true};
+
+    auto full = InitPmSearch(CreateObject<NrPmSearchFull>());
+
+    // Every i1 is a candidate and no rank is pruned: the fast search is exhaustive
+    auto exhaustive = CreateObject<NrPmSearchFast>();
+    exhaustive->SetAttribute("NumCandidatesI1", UintegerValue(UINT32_MAX));
+    exhaustive->SetAttribute("MaxEigenvalueSpread", DoubleValue(1000.0));
+    InitPmSearch(exhaustive);
+
+    auto fast = InitPmSearch(CreateObject<NrPmSearchFast>());
+
+    size_t fastTbSize = 0;
+    size_t fullTbSize = 0;
+    for (size_t c = 0; c < NUM_CHANNELS; c++)
+    {
+        auto signal = CreateRayleighSignal();
+        auto fullCqi = full->CreateCqiFeedbackMimo(signal, update);
+        CheckSameFeedback(exhaustive->CreateCqiFeedbackMimo(signal, update),
+                          fullCqi,
+                          "of the exhaustive search for channel " + std::to_string(c));
+        fullTbSize += fullCqi.m_tbSize;
+        fastTbSize += fast->CreateCqiFeedbackMimo(signal, update).m_tbSize;
+    }
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(fastTbSize,
+                                (1.0 - NR_PM_SEARCH_FAST_TB_TOLERANCE) * fullTbSize,
+                                "The TB size of the fast search is too small");
+
+    // A line-of-sight channel matched to a codebook beam: with a single receive port, there is
+    // only rank 1, and both searches must find the beam and its co-phasing on every subband
+    if (m_numRxPorts == 1)
+    {
+        auto cb = CreateObject<NrCbTypeOneSp>();
+        cb->SetAttribute("N1", UintegerValue(m_numHPorts));
+        cb->SetAttribute("N2", UintegerValue(1));
+        cb->SetAttribute("IsDualPol", BooleanValue(true));
+        cb->SetAttribute("Rank", UintegerValue(1));
+        cb->Init();
+        for (size_t i1 = 0; i1 < cb->GetNumI1(); i1++)
+        {
+            auto i2 = i1 % cb->GetNumI2();
+            auto signal = CreateBeamSignal(cb->GetBasePrecMat(i1, i2));
+            auto fullCqi = full->CreateCqiFeedbackMimo(signal, update);
+            auto msg = "for the beam channel of i1 " + std::to_string(i1);
+            NS_TEST_EXPECT_MSG_EQ(fullCqi.m_wbPmi,
+                                  i1,
+                                  "Wrong wideband PMI of the full search " << msg);
+            NS_TEST_EXPECT_MSG_EQ((fullCqi.m_sbPmis == std::vector<size_t>(NUM_RBS, i2)),
+                                  true,
+                                  "Wrong subband PMIs of the full search " << msg);
+            CheckSameFeedback(fast->CreateCqiFeedbackMimo(signal, update), fullCqi, msg);
+        }
+    }
+}
+
+/**
+ * \brief Test suite for the fast PM search
+ */
+class NrTestPmSearchFastSuite : public TestSuite
+{
+  public:
+    NrTestPmSearchFastSuite()
+        : TestSuite("nr-test-pm-search-fast", Type::UNIT)
+    {
+        for (size_t numHPorts : {2, 4})
+        {
+            for (size_t numRxPorts : {1, 2})
+            {
+                AddTestCase(new NrPmSearchFastTestCase(numHPorts, numRxPorts), Duration::QUICK);
+            }
+        }
+    }
+};
+
+static NrTestPmSearchFastSuite nrTestPmSearchFastSuite; //!< Fast PM search test suite
+
+} // namespace ns3
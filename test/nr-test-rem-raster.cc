@@ -0,0 +1,177 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-rem-raster.h>
+#include <ns3/test.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-rem-raster.cc
+ * \ingroup test
+ *
+ * \brief Check the tiles of NrRemRaster, that the values written tile by tile are read back
+ * at their points, and that a raster keeps its written tiles when it is resumed with the same
+ * header, and cannot be resumed with a different one.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that writes and resumes a REM raster
+ */
+class NrRemRasterTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrRemRasterTestCase()
+        : TestCase("Tiled REM raster")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Write a tile with values that depend on the plane and on the point
+     * \param raster the raster
+     * \param tile the tile
+     */
+    static void WriteTile(NrRemRaster& raster, uint32_t tile);
+
+    /**
+     * \brief Get the value written by WriteTile
+     * \param plane the plane
+     * \param x the x index of the point
+     * \param y the y index of the point
+     * \return the value
+     */
+    static float GetValue(uint32_t plane, uint32_t x, uint32_t y);
+};
+
+float
+NrRemRasterTestCase::GetValue(uint32_t plane, uint32_t x, uint32_t y)
+{
+    return plane * 100.0F + y * 10.0F + x;
+}
+
+void
+NrRemRasterTestCase::WriteTile(NrRemRaster& raster, uint32_t tile)
+{
+    uint32_t xBegin;
+    uint32_t xEnd;
+    uint32_t yBegin;
+    uint32_t yEnd;
+    raster.GetTileBounds(tile, xBegin, xEnd, yBegin, yEnd);
+    std::vector<float> values;
+    for (uint32_t plane = 0; plane < NrRemRaster::NUM_PLANES; plane++)
+    {
+        for (uint32_t y = yBegin; y < yEnd; y++)
+        {
+            for (uint32_t x = xBegin; x < xEnd; x++)
+            {
+                values.push_back(GetValue(plane, x, y));
+            }
+        }
+    }
+    raster.WriteTile(tile, values);
+}
+
+void
+NrRemRasterTestCase::DoRun()
+{
+    auto filename = CreateTempDirFilename("nr-rem-raster.rem");
+    NrRemRasterHeader header{};
+    header.m_numX = 5;
+    header.m_numY = 3;
+    header.m_tileSize = 2;
+    header.m_numIterations = 1;
+    header.m_xStep = 1.0;
+    header.m_yStep = 1.0;
+
+    // 5 x 3 points in tiles of 2 x 2: 3 x 2 tiles, the last ones smaller
+    NrRemRaster raster;
+    NS_TEST_ASSERT_MSG_EQ(raster.Open(filename, header, false), true, "Could not open");
+    NS_TEST_ASSERT_MSG_EQ(raster.GetNumTiles(), 6U, "Wrong number of tiles");
+    uint32_t xBegin;
+    uint32_t xEnd;
+    uint32_t yBegin;
+    uint32_t yEnd;
+    raster.GetTileBounds(5, xBegin, xEnd, yBegin, yEnd);
+    NS_TEST_ASSERT_MSG_EQ(xBegin, 4U, "Wrong first x index of the last tile");
+    NS_TEST_ASSERT_MSG_EQ(xEnd, 5U, "Wrong last x index of the last tile");
+    NS_TEST_ASSERT_MSG_EQ(yBegin, 2U, "Wrong first y index of the last tile");
+    NS_TEST_ASSERT_MSG_EQ(yEnd, 3U, "Wrong last y index of the last tile");
+
+    // Interrupted after 2 tiles
+    WriteTile(raster, 0);
+    WriteTile(raster, 4);
+    raster.Close();
+
+    // A raster of a different map cannot be resumed
+    NrRemRasterHeader otherHeader = header;
+    otherHeader.m_numIterations = 2;
+    NS_TEST_ASSERT_MSG_EQ(raster.Open(filename, otherHeader, true),
+                          false,
+                          "A raster with a different header was resumed");
+    otherHeader = header;
+    otherHeader.m_scenario = 1;
+    NS_TEST_ASSERT_MSG_EQ(raster.Open(filename, otherHeader, true),
+                          false,
+                          "A raster of a different scenario was resumed");
+
+    NS_TEST_ASSERT_MSG_EQ(raster.Open(filename, header, true), true, "Could not resume");
+    for (uint32_t tile = 0; tile < raster.GetNumTiles(); tile++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(raster.IsTileDone(tile),
+                              tile == 0 || tile == 4,
+                              "Wrong written flag of tile " << tile);
+        if (!raster.IsTileDone(tile))
+        {
+            WriteTile(raster, tile);
+        }
+    }
+    raster.Close();
+
+    NS_TEST_ASSERT_MSG_EQ(raster.OpenForReading(filename), true, "Could not open for reading");
+    NS_TEST_ASSERT_MSG_EQ(raster.GetHeader().m_numX, 5U, "Wrong header");
+    for (uint32_t tile = 0; tile < raster.GetNumTiles(); tile++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(raster.IsTileDone(tile), true, "Tile " << tile << " not written");
+    }
+    for (uint32_t plane = 0; plane < NrRemRaster::NUM_PLANES; plane++)
+    {
+        for (uint32_t y = 0; y < 3; y++)
+        {
+            for (uint32_t x = 0; x < 5; x++)
+            {
+                auto value = raster.ReadValue(static_cast<NrRemRaster::Plane>(plane), x, y);
+                NS_TEST_ASSERT_MSG_EQ(value,
+                                      GetValue(plane, x, y),
+                                      "Wrong value of plane " << plane << " at " << x << "," << y);
+            }
+        }
+    }
+    raster.Close();
+}
+
+/**
+ * \brief Test suite for the REM raster
+ */
+class NrTestRemRasterSuite : public TestSuite
+{
+  public:
+    NrTestRemRasterSuite()
+        : TestSuite("nr-test-rem-raster", Type::UNIT)
+    {
+        AddTestCase(new NrRemRasterTestCase(), Duration::QUICK);
+    }
+};
+
+static NrTestRemRasterSuite nrTestRemRasterSuite; //!< REM raster test suite
+
+} // namespace ns3
@@ -0,0 +1,200 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/beamforming-vector.h>
+#include <ns3/boolean.h>
+#include <ns3/cc-bwp-helper.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/node-container.h>
+#include <ns3/nr-gnb-net-device.h>
+#include <ns3/nr-helper.h>
+#include <ns3/nr-radio-environment-map-helper.h>
+#include <ns3/nr-ue-net-device.h>
+#include <ns3/simulator.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+#include <ns3/uniform-planar-array.h>
+
+#include <cstdio>
+#include <list>
+#include <sstream>
+#include <string>
+
+/**
+ * \file nr-test-rem-threads.cc
+ * \ingroup test
+ *
+ * \brief Check that the REM computed with several threads is the same as the one computed
+ * with a single thread, point by point, for each REM mode. Each point of the grid has its own
+ * random variable streams, so the values must be exactly equal, whatever the thread that
+ * computed the point.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that compares the REM computed with one and with several threads
+ */
+class NrRemThreadsTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param remMode the REM mode
+     * \param numThreads the number of threads compared with a single thread
+     */
+    NrRemThreadsTestCase(NrRadioEnvironmentMapHelper::RemMode remMode, uint32_t numThreads)
+        : TestCase("REM of mode " + std::to_string(remMode) + " with 1 and " +
+                   std::to_string(numThreads) + " threads"),
+          m_remMode(remMode),
+          m_numThreads(numThreads)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Compute the REM points as NrRadioEnvironmentMapHelper::DelayedInstall does,
+     * without writing the map to a file
+     * \param numThreads the number of threads
+     * \param rtdNetDev the REM transmitting devices
+     * \param rrdDevice the REM receiving device
+     * \return the REM points
+     */
+    std::list<NrRadioEnvironmentMapHelper::RemPoint> ComputeRem(
+        uint32_t numThreads,
+        const NetDeviceContainer& rtdNetDev,
+        const Ptr<NetDevice>& rrdDevice) const;
+
+    NrRadioEnvironmentMapHelper::RemMode m_remMode; //!< The REM mode
+    uint32_t m_numThreads;                          //!< The number of threads
+};
+
+std::list<NrRadioEnvironmentMapHelper::RemPoint>
+NrRemThreadsTestCase::ComputeRem(uint32_t numThreads,
+                                 const NetDeviceContainer& rtdNetDev,
+                                 const Ptr<NetDevice>& rrdDevice) const
+{
+    auto remHelper = CreateObject<NrRadioEnvironmentMapHelper>();
+    remHelper->SetMinX(-20);
+    remHelper->SetMaxX(80);
+    remHelper->SetResX(10);
+    remHelper->SetMinY(-30);
+    remHelper->SetMaxY(30);
+    remHelper->SetResY(6);
+    remHelper->SetZ(1.5);
+    remHelper->SetNumOfItToAverage(2);
+    remHelper->SetNumThreads(numThreads);
+    remHelper->SetSimTag("nr-test-rem-threads");
+    remHelper->SetRemMode(m_remMode);
+    remHelper->CreateRem(rtdNetDev, rrdDevice, 0);
+
+    remHelper->m_remStartTime = std::chrono::system_clock::now();
+    remHelper->ConfigureRrd(rrdDevice);
+    remHelper->ConfigureRtdList(rtdNetDev);
+    remHelper->ConfigureRemGrid();
+    remHelper->CreateRemWorkers();
+    remHelper->CreateListOfRemPoints(0, remHelper->m_numX, 0, remHelper->m_numY);
+    remHelper->StartProgressReport(remHelper->m_rem.size());
+    remHelper->CalcRemPoints();
+    remHelper->m_remWorkers.clear();
+    std::remove("nr-rem-nr-test-rem-threads-ues.txt");
+    return remHelper->m_rem;
+}
+
+void
+NrRemThreadsTestCase::DoRun()
+{
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(2);
+    ueNodes.Create(1);
+
+    auto positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0, 0, 10));
+    positionAlloc->Add(Vector(60, 0, 10));
+    positionAlloc->Add(Vector(20, 10, 1.5));
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(NodeContainer(gnbNodes, ueNodes));
+
+    auto nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9, 20e6, 1, BandwidthPartInfo::UMa);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(4));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+
+    // The beams of the BEAM_SHAPE map
+    for (uint32_t i = 0; i < gnbDevs.GetN(); i++)
+    {
+        auto antenna = nrHelper->GetGnbPhy(gnbDevs.Get(i), 0)
+                           ->GetSpectrumPhy()
+                           ->GetAntenna()
+                           ->GetObject<UniformPlanarArray>();
+        antenna->SetBeamformingVector(CreateDirectionalBfv(antenna, 2 * i + 1, 90));
+    }
+    auto ueAntenna = nrHelper->GetUePhy(ueDevs.Get(0), 0)
+                         ->GetSpectrumPhy()
+                         ->GetAntenna()
+                         ->GetObject<UniformPlanarArray>();
+    ueAntenna->SetBeamformingVector(CreateQuasiOmniBfv(ueAntenna));
+
+    bool ul = m_remMode == NrRadioEnvironmentMapHelper::UE_COVERAGE;
+    const auto& rtdNetDev = ul ? ueDevs : gnbDevs;
+    auto rrdDevice = ul ? gnbDevs.Get(0) : ueDevs.Get(0);
+    auto singleThreadRem = ComputeRem(1, rtdNetDev, rrdDevice);
+    auto multiThreadRem = ComputeRem(m_numThreads, rtdNetDev, rrdDevice);
+
+    NS_TEST_ASSERT_MSG_EQ(multiThreadRem.size(), singleThreadRem.size(), "Wrong number of points");
+    auto multiThreadIt = multiThreadRem.begin();
+    for (const auto& point : singleThreadRem)
+    {
+        const auto& other = *multiThreadIt++;
+        std::ostringstream msg;
+        msg << " at (" << point.pos.x << ", " << point.pos.y << ")";
+        NS_TEST_ASSERT_MSG_EQ(other.pos, point.pos, "Wrong position" << msg.str());
+        NS_TEST_ASSERT_MSG_EQ(other.avgSnrDb, point.avgSnrDb, "Wrong SNR" << msg.str());
+        NS_TEST_ASSERT_MSG_EQ(other.avgSinrDb, point.avgSinrDb, "Wrong SINR" << msg.str());
+        NS_TEST_ASSERT_MSG_EQ(other.avgSirDb, point.avgSirDb, "Wrong SIR" << msg.str());
+        NS_TEST_ASSERT_MSG_EQ(other.avRxPowerDbm,
+                              point.avRxPowerDbm,
+                              "Wrong received power" << msg.str());
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \brief Test suite for the REM computed with several threads
+ */
+class NrTestRemThreadsSuite : public TestSuite
+{
+  public:
+    NrTestRemThreadsSuite()
+        : TestSuite("nr-test-rem-threads", Type::UNIT)
+    {
+        for (auto remMode : {NrRadioEnvironmentMapHelper::BEAM_SHAPE,
+                             NrRadioEnvironmentMapHelper::COVERAGE_AREA,
+                             NrRadioEnvironmentMapHelper::UE_COVERAGE})
+        {
+            AddTestCase(new NrRemThreadsTestCase(remMode, 4), Duration::QUICK);
+        }
+    }
+};
+
+static NrTestRemThreadsSuite nrTestRemThreadsSuite; //!< REM threads test suite
+
+} // namespace ns3
@@ -0,0 +1,400 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/boolean.h>
+#include <ns3/bwp-manager-gnb.h>
+#include <ns3/bwp-manager-ue.h>
+#include <ns3/cc-bwp-helper.h>
+#include <ns3/config.h>
+#include <ns3/eps-bearer-tag.h>
+#include <ns3/ideal-beamforming-algorithm.h>
+#include <ns3/ideal-beamforming-helper.h>
+#include <ns3/internet-stack-helper.h>
+#include <ns3/ipv4-header.h>
+#include <ns3/ipv4-l3-protocol.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/nr-gnb-net-device.h>
+#include <ns3/nr-gnb-phy.h>
+#include <ns3/nr-helper.h>
+#include <ns3/nr-point-to-point-epc-helper.h>
+#include <ns3/nr-spectrum-phy.h>
+#include <ns3/nr-ue-net-device.h>
+#include <ns3/nr-ue-phy.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-skip-idle-ctrl-symbols.cc
+ * \ingroup test
+ *
+ * \brief Check that the SkipIdleCtrlSymbols attribute of NrGnbPhy and NrUePhy does not change
+ * the results. The same scenario, a gNB with two UEs, one of them receiving DL data from time to
+ * time, is run with and without skipping the idle CTRL symbols. The control messages transmitted
+ * and received by the PHYs, the data and CTRL transmissions and the data receptions must be the
+ * same, at the same time and in the same slot, and the skipping must execute fewer events. The
+ * scenario has a single bandwidth part, or two FDD bandwidth parts, a DL and an UL one, whose
+ * control messages are routed to each other.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that compares the traces with and without skipping the idle CTRL symbols
+ */
+class NrSkipIdleCtrlSymbolsTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param numerology the numerology
+     * \param patterns the TDD pattern of each bandwidth part. With two bandwidth parts, the
+     * control messages of the second one are routed to the first one in the gNB, and the ones of
+     * the first one to the second one in the UEs
+     */
+    NrSkipIdleCtrlSymbolsTestCase(uint16_t numerology, const std::vector<std::string>& patterns)
+        : TestCase("Skip the idle CTRL symbols with numerology " + std::to_string(numerology) +
+                   " and pattern " + patterns.front() +
+                   (patterns.size() > 1 ? " linked to " + patterns.back() : "")),
+          m_numerology(numerology),
+          m_patterns(patterns)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /// \brief The result of a simulation
+    struct SimResult
+    {
+        std::vector<std::string> traces; //!< The traces, in the order they were fired
+        uint64_t numEvents{0};           //!< The number of executed events
+    };
+
+    /**
+     * \brief Run the scenario
+     * \param skip whether the idle CTRL symbols are skipped
+     * \return the result of the simulation
+     */
+    SimResult Simulate(bool skip);
+
+    /**
+     * \brief Send a DL packet to a UE, and schedule the next one
+     * \param gnbDev the gNB device
+     * \param ueDev the device of the UE
+     * \param uePhy the PHY of the UE
+     */
+    static void SendDlPacket(const Ptr<NetDevice>& gnbDev,
+                             const Ptr<NetDevice>& ueDev,
+                             const Ptr<NrUePhy>& uePhy);
+
+    /**
+     * \brief Save a control message transmitted or received by a PHY
+     * \param test the test case
+     * \param trace the name of the trace
+     * \param sfn the slot
+     * \param nodeId the cell ID
+     * \param rnti the RNTI
+     * \param bwpId the BWP ID
+     * \param msg the message
+     */
+    static void CtrlMsg(NrSkipIdleCtrlSymbolsTestCase* test,
+                        std::string trace,
+                        SfnSf sfn,
+                        uint16_t nodeId,
+                        uint16_t rnti,
+                        uint8_t bwpId,
+                        Ptr<const NrControlMessage> msg);
+
+    /**
+     * \brief Save a data reception
+     * \param test the test case
+     * \param trace the name of the trace
+     * \param params the parameters of the reception
+     */
+    static void RxPacket(NrSkipIdleCtrlSymbolsTestCase* test,
+                         std::string trace,
+                         RxPacketTraceParams params);
+
+    /**
+     * \brief Save the start of a transmission
+     * \param test the test case
+     * \param trace the name of the trace
+     * \param duration the duration of the transmission
+     */
+    static void Tx(NrSkipIdleCtrlSymbolsTestCase* test, std::string trace, Time duration);
+
+    /**
+     * \brief Save a trace
+     * \param line the trace
+     */
+    void Save(const std::string& line);
+
+    /// Time from which the DL packets are sent, when the UEs are attached
+    static constexpr uint32_t TRAFFIC_START_MS = 200;
+    /// Time at which the simulation ends
+    static constexpr uint32_t SIM_END_MS = 400;
+
+    uint16_t m_numerology;               //!< The numerology
+    std::vector<std::string> m_patterns; //!< The TDD pattern of each bandwidth part
+    SimResult m_result;                  //!< The result of the current simulation
+};
+
+void
+NrSkipIdleCtrlSymbolsTestCase::SendDlPacket(const Ptr<NetDevice>& gnbDev,
+                                             const Ptr<NetDevice>& ueDev,
+                                             const Ptr<NrUePhy>& uePhy)
+{
+    Ipv4Header header;
+    Ptr<Packet> pkt = Create<Packet>(500);
+    header.SetProtocol(0x06);
+    EpsBearerTag tag(uePhy->GetRnti(), 1);
+    pkt->AddPacketTag(tag);
+    pkt->AddHeader(header);
+    gnbDev->Send(pkt, ueDev->GetAddress(), Ipv4L3Protocol::PROT_NUMBER);
+
+    // Leave idle slots between the packets
+    Simulator::Schedule(MilliSeconds(7),
+                        &NrSkipIdleCtrlSymbolsTestCase::SendDlPacket,
+                        gnbDev,
+                        ueDev,
+                        uePhy);
+}
+
+void
+NrSkipIdleCtrlSymbolsTestCase::Save(const std::string& line)
+{
+    std::ostringstream trace;
+    trace << Simulator::Now().GetNanoSeconds() << " " << line;
+    m_result.traces.push_back(trace.str());
+}
+
+void
+NrSkipIdleCtrlSymbolsTestCase::CtrlMsg(NrSkipIdleCtrlSymbolsTestCase* test,
+                                        std::string trace,
+                                        SfnSf sfn,
+                                        uint16_t nodeId,
+                                        uint16_t rnti,
+                                        uint8_t bwpId,
+                                        Ptr<const NrControlMessage> msg)
+{
+    std::ostringstream line;
+    line << trace << " " << sfn << " " << nodeId << " " << rnti << " " << +bwpId << " "
+         << msg->GetMessageType();
+    test->Save(line.str());
+}
+
+void
+NrSkipIdleCtrlSymbolsTestCase::RxPacket(NrSkipIdleCtrlSymbolsTestCase* test,
+                                         std::string trace,
+                                         RxPacketTraceParams params)
+{
+    std::ostringstream line;
+    line << std::setprecision(17) << trace << " " << params.m_cellId << " " << params.m_rnti
+         << " " << params.m_frameNum << " " << +params.m_subframeNum << " " << params.m_slotNum
+         << " " << +params.m_symStart << " " << +params.m_numSym << " " << params.m_tbSize << " "
+         << +params.m_mcs << " " << +params.m_rank << " " << +params.m_rv << " " << params.m_sinr
+         << " " << params.m_tbler << " " << params.m_corrupt;
+    test->Save(line.str());
+}
+
+void
+NrSkipIdleCtrlSymbolsTestCase::Tx(NrSkipIdleCtrlSymbolsTestCase* test,
+                                   std::string trace,
+                                   Time duration)
+{
+    test->Save(trace + " " + std::to_string(duration.GetNanoSeconds()));
+}
+
+NrSkipIdleCtrlSymbolsTestCase::SimResult
+NrSkipIdleCtrlSymbolsTestCase::Simulate(bool skip)
+{
+    m_result = SimResult();
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(1);
+    ueNodes.Create(2);
+
+    auto positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0, 0, 10));
+    positionAlloc->Add(Vector(10, 10, 1.5));
+    positionAlloc->Add(Vector(-10, 20, 1.5));
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(NodeContainer(gnbNodes, ueNodes));
+
+    auto epcHelper = CreateObject<NrPointToPointEpcHelper>();
+    auto idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    auto nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(epcHelper);
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9,
+                                                   20e6,
+                                                   1,
+                                                   BandwidthPartInfo::UMi_StreetCanyon);
+    bandConf.m_numBwp = static_cast<uint8_t>(m_patterns.size());
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    Config::SetDefault("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    idealBeamformingHelper->SetAttribute("BeamformingMethod",
+                                         TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    epcHelper->SetAttribute("S1uLinkDelay", TimeValue(MilliSeconds(0)));
+
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(m_numerology));
+    nrHelper->SetGnbPhyAttribute("SkipIdleCtrlSymbols", BooleanValue(skip));
+    nrHelper->SetUePhyAttribute("SkipIdleCtrlSymbols", BooleanValue(skip));
+
+    NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(gnbDevs, randomStream);
+    randomStream += nrHelper->AssignStreams(ueDevs, randomStream);
+
+    for (uint32_t bwp = 0; bwp < m_patterns.size(); bwp++)
+    {
+        nrHelper->GetGnbPhy(gnbDevs.Get(0), bwp)
+            ->SetAttribute("Pattern", StringValue(m_patterns[bwp]));
+    }
+    if (m_patterns.size() > 1)
+    {
+        // The UL bandwidth part sends its DCIs in the DL one, and the UEs send their DL feedback
+        // in the UL one
+        nrHelper->GetBwpManagerGnb(gnbDevs.Get(0))->SetOutputLink(1, 0);
+        for (uint32_t ue = 0; ue < ueDevs.GetN(); ue++)
+        {
+            nrHelper->GetBwpManagerUe(ueDevs.Get(ue))->SetOutputLink(0, 1);
+        }
+    }
+
+    for (auto it = gnbDevs.Begin(); it != gnbDevs.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+    for (auto it = ueDevs.Begin(); it != ueDevs.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    for (uint32_t bwp = 0; bwp < m_patterns.size(); bwp++)
+    {
+        auto gnbPhy = nrHelper->GetGnbPhy(gnbDevs.Get(0), bwp);
+        std::string gnbName = "Gnb" + std::to_string(bwp);
+        gnbPhy->TraceConnectWithoutContext(
+            "GnbPhyTxedCtrlMsgsTrace",
+            MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::CtrlMsg, this, gnbName + "PhyTx"));
+        gnbPhy->TraceConnectWithoutContext(
+            "GnbPhyRxedCtrlMsgsTrace",
+            MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::CtrlMsg, this, gnbName + "PhyRx"));
+        gnbPhy->GetSpectrumPhy()->TraceConnectWithoutContext(
+            "RxPacketTraceEnb",
+            MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::RxPacket, this, gnbName + "RxData"));
+        gnbPhy->GetSpectrumPhy()->TraceConnectWithoutContext(
+            "TxDataTrace",
+            MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::Tx, this, gnbName + "TxData"));
+        gnbPhy->GetSpectrumPhy()->TraceConnectWithoutContext(
+            "TxCtrlTrace",
+            MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::Tx, this, gnbName + "TxCtrl"));
+        for (uint32_t ue = 0; ue < ueDevs.GetN(); ue++)
+        {
+            auto uePhy = nrHelper->GetUePhy(ueDevs.Get(ue), bwp);
+            std::string name = "Ue" + std::to_string(ue) + "Bwp" + std::to_string(bwp);
+            uePhy->TraceConnectWithoutContext(
+                "UePhyTxedCtrlMsgsTrace",
+                MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::CtrlMsg, this, name + "PhyTx"));
+            uePhy->TraceConnectWithoutContext(
+                "UePhyRxedCtrlMsgsTrace",
+                MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::CtrlMsg, this, name + "PhyRx"));
+            uePhy->GetSpectrumPhy()->TraceConnectWithoutContext(
+                "RxPacketTraceUe",
+                MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::RxPacket, this, name + "RxData"));
+            uePhy->GetSpectrumPhy()->TraceConnectWithoutContext(
+                "TxDataTrace",
+                MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::Tx, this, name + "TxData"));
+            uePhy->GetSpectrumPhy()->TraceConnectWithoutContext(
+                "TxCtrlTrace",
+                MakeBoundCallback(&NrSkipIdleCtrlSymbolsTestCase::Tx, this, name + "TxCtrl"));
+        }
+    }
+
+    InternetStackHelper internet;
+    internet.Install(ueNodes);
+    epcHelper->AssignUeIpv4Address(ueDevs);
+    nrHelper->AttachToClosestEnb(ueDevs, gnbDevs);
+
+    Simulator::Schedule(MilliSeconds(TRAFFIC_START_MS),
+                        &NrSkipIdleCtrlSymbolsTestCase::SendDlPacket,
+                        gnbDevs.Get(0),
+                        ueDevs.Get(0),
+                        nrHelper->GetUePhy(ueDevs.Get(0), 0));
+    Simulator::Stop(MilliSeconds(SIM_END_MS));
+    Simulator::Run();
+    m_result.numEvents = Simulator::GetEventCount();
+    Simulator::Destroy();
+    return m_result;
+}
+
+void
+NrSkipIdleCtrlSymbolsTestCase::DoRun()
+{
+    auto reference = Simulate(false);
+    auto skipped = Simulate(true);
+
+    NS_TEST_ASSERT_MSG_GT(reference.traces.size(), 0, "No traces without skipping");
+    for (size_t i = 0; i < std::min(reference.traces.size(), skipped.traces.size()); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(skipped.traces[i],
+                              reference.traces[i],
+                              "Trace " << i << " differs when skipping the idle CTRL symbols");
+    }
+    NS_TEST_ASSERT_MSG_EQ(skipped.traces.size(),
+                          reference.traces.size(),
+                          "Wrong number of traces when skipping the idle CTRL symbols");
+    NS_TEST_EXPECT_MSG_LT(skipped.numEvents,
+                          reference.numEvents,
+                          "Skipping the idle CTRL symbols did not save any event");
+}
+
+/**
+ * \brief Test suite for skipping the idle CTRL symbols
+ */
+class NrTestSkipIdleCtrlSymbolsSuite : public TestSuite
+{
+  public:
+    NrTestSkipIdleCtrlSymbolsSuite()
+        : TestSuite("nr-test-skip-idle-ctrl-symbols", Type::SYSTEM)
+    {
+        AddTestCase(new NrSkipIdleCtrlSymbolsTestCase(0, {"F|F|F|F|F|F|F|F|F|F|"}),
+                    Duration::QUICK);
+        AddTestCase(new NrSkipIdleCtrlSymbolsTestCase(1, {"DL|S|UL|UL|DL|DL|S|UL|UL|DL|"}),
+                    Duration::QUICK);
+        AddTestCase(new NrSkipIdleCtrlSymbolsTestCase(
+                        0,
+                        {"DL|DL|DL|DL|DL|DL|DL|DL|DL|DL|", "UL|UL|UL|UL|UL|UL|UL|UL|UL|UL|"}),
+                    Duration::QUICK);
+    }
+};
+
+static NrTestSkipIdleCtrlSymbolsSuite
+    nrTestSkipIdleCtrlSymbolsSuite; //!< Skip the idle CTRL symbols test suite
+
+} // namespace ns3
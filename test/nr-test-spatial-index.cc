@@ -0,0 +1,180 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-spatial-index.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/test.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * \file nr-test-spatial-index.cc
+ * \ingroup test
+ *
+ * \brief Check that the queries of NrSpatialIndex return the same points as a linear scan,
+ * including the ties between points at the same distance, for random and degenerate sets of
+ * points and for positions inside and outside of the deployment.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that compares the queries of a NrSpatialIndex with a linear scan
+ */
+class NrSpatialIndexTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param name the name of the set of points
+     * \param points the points
+     * \param horizontal whether the distances are computed on the xy-plane only
+     */
+    NrSpatialIndexTestCase(const std::string& name,
+                           const std::vector<Vector>& points,
+                           bool horizontal)
+        : TestCase("Spatial index of " + name + (horizontal ? " (2D)" : " (3D)")),
+          m_points(points),
+          m_horizontal(horizontal)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief The points sorted by distance from a position, and then by index
+     * \param index the index, to compute the distances
+     * \param position the position
+     * \return the distances and indexes of the points
+     */
+    std::vector<std::pair<double, size_t>> SortByDistance(const NrSpatialIndex& index,
+                                                          const Vector& position) const;
+
+    std::vector<Vector> m_points; //!< The points
+    bool m_horizontal;            //!< Whether the distances are on the xy-plane
+};
+
+std::vector<std::pair<double, size_t>>
+NrSpatialIndexTestCase::SortByDistance(const NrSpatialIndex& index, const Vector& position) const
+{
+    std::vector<std::pair<double, size_t>> sorted;
+    for (size_t i = 0; i < m_points.size(); i++)
+    {
+        sorted.emplace_back(index.GetDistance(position, m_points[i]), i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+void
+NrSpatialIndexTestCase::DoRun()
+{
+    NrSpatialIndex index(m_points, m_horizontal);
+    NS_TEST_ASSERT_MSG_EQ(index.GetN(), m_points.size(), "Wrong number of points");
+
+    Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+    std::vector<Vector> positions(m_points.begin(), m_points.end());
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        positions.emplace_back(uniform->GetValue(-1500, 1500),
+                               uniform->GetValue(-1500, 1500),
+                               uniform->GetValue(0, 30));
+    }
+
+    for (const auto& position : positions)
+    {
+        const auto sorted = SortByDistance(index, position);
+
+        NS_TEST_ASSERT_MSG_EQ(index.FindNearest(position),
+                              sorted.front().second,
+                              "Wrong nearest point of " << position);
+
+        for (size_t k : {size_t{1}, size_t{3}, size_t{10}, m_points.size() + 1})
+        {
+            const auto nearest = index.FindNearest(position, k);
+            NS_TEST_ASSERT_MSG_EQ(nearest.size(),
+                                  std::min(k, m_points.size()),
+                                  "Wrong number of nearest points");
+            for (size_t i = 0; i < nearest.size(); i++)
+            {
+                NS_TEST_ASSERT_MSG_EQ(nearest[i],
+                                      sorted[i].second,
+                                      "Wrong nearest point " << i << " of " << position);
+            }
+        }
+
+        for (double distance : {0.0, 50.0, 300.0})
+        {
+            std::vector<size_t> expected;
+            for (const auto& [d, i] : sorted)
+            {
+                if (d <= distance)
+                {
+                    expected.push_back(i);
+                }
+            }
+            std::sort(expected.begin(), expected.end());
+            NS_TEST_ASSERT_MSG_EQ((index.FindWithinDistance(position, distance) == expected),
+                                  true,
+                                  "Wrong points within " << distance << " m of " << position);
+        }
+    }
+}
+
+/**
+ * \brief Test suite for the spatial index
+ */
+class NrTestSpatialIndexSuite : public TestSuite
+{
+  public:
+    NrTestSpatialIndexSuite()
+        : TestSuite("nr-test-spatial-index", Type::UNIT)
+    {
+        Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable>();
+        uniform->SetStream(2);
+        std::vector<Vector> random;
+        for (uint32_t i = 0; i < 300; i++)
+        {
+            random.emplace_back(uniform->GetValue(-1000, 1000),
+                                uniform->GetValue(-1000, 1000),
+                                uniform->GetValue(10, 25));
+        }
+
+        // A regular grid, with many points at the same distance, and two points per position
+        std::vector<Vector> grid;
+        for (int x = -5; x <= 5; x++)
+        {
+            for (int y = -5; y <= 5; y++)
+            {
+                grid.emplace_back(100.0 * x, 100.0 * y, 25.0);
+                grid.emplace_back(100.0 * x, 100.0 * y, 25.0);
+            }
+        }
+
+        std::vector<Vector> line;
+        for (int x = 0; x < 40; x++)
+        {
+            line.emplace_back(50.0 * x, 0.0, 10.0);
+        }
+
+        for (bool horizontal : {false, true})
+        {
+            AddTestCase(new NrSpatialIndexTestCase("random points", random, horizontal),
+                        Duration::QUICK);
+            AddTestCase(new NrSpatialIndexTestCase("a grid", grid, horizontal), Duration::QUICK);
+            AddTestCase(new NrSpatialIndexTestCase("a line", line, horizontal), Duration::QUICK);
+            AddTestCase(new NrSpatialIndexTestCase("a point", {Vector(3, 4, 5)}, horizontal),
+                        Duration::QUICK);
+        }
+    }
+};
+
+static NrTestSpatialIndexSuite nrTestSpatialIndexSuite; //!< Spatial index test suite
+
+} // namespace ns3
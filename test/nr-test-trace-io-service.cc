@@ -0,0 +1,146 @@
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/boolean.h>
+#include <ns3/config.h>
+#include <ns3/global-value.h>
+#include <ns3/nr-trace-io-service.h>
+#include <ns3/simulator.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/**
+ * \file nr-test-trace-io-service.cc
+ * \ingroup test
+ *
+ * \brief Check that the files written through NrTraceOfstream, in the background by
+ * NrTraceIoService or directly, contain exactly the rows written by the simulator thread,
+ * also when the ring buffers are much smaller than the rows (backpressure), and that the rows
+ * are in the files after Simulator::Destroy, even if the files are still open.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Test case that writes trace files through NrTraceOfstream
+ */
+class NrTraceIoServiceTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param async whether the files are written in the background
+     * \param bufferSize the size of the ring buffers
+     */
+    NrTraceIoServiceTestCase(bool async, uint32_t bufferSize)
+        : TestCase(std::string(async ? "Background" : "Direct") + " trace file writes, " +
+                   std::to_string(bufferSize) + " bytes ring buffers"),
+          m_async(async),
+          m_bufferSize(bufferSize)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Read a file
+     * \param filename the name of the file
+     * \return the content of the file
+     */
+    static std::string ReadFile(const std::string& filename);
+
+    bool m_async;          //!< Whether the files are written in the background
+    uint32_t m_bufferSize; //!< Size of the ring buffers
+};
+
+std::string
+NrTraceIoServiceTestCase::ReadFile(const std::string& filename)
+{
+    std::ifstream is(filename);
+    std::ostringstream content;
+    content << is.rdbuf();
+    return content.str();
+}
+
+void
+NrTraceIoServiceTestCase::DoRun()
+{
+    BooleanValue async;
+    UintegerValue bufferSize;
+    GlobalValue::GetValueByName("NrAsyncTraceIo", async);
+    GlobalValue::GetValueByName("NrTraceIoBufferSize", bufferSize);
+    Config::SetGlobal("NrAsyncTraceIo", BooleanValue(m_async));
+    Config::SetGlobal("NrTraceIoBufferSize", UintegerValue(m_bufferSize));
+
+    // Rows written and closed: the closed file is complete
+    auto closedFilename = CreateTempDirFilename("nr-trace-io-closed.txt");
+    std::ostringstream expected;
+    {
+        NrTraceOfstream file;
+        file.open(closedFilename);
+        NS_TEST_ASSERT_MSG_EQ(file.is_open(), true, "Could not open " << closedFilename);
+        for (uint32_t i = 0; i < 5000; i++)
+        {
+            file << i * 0.001 << "\t" << i << "\tsome text" << std::endl;
+            expected << i * 0.001 << "\t" << i << "\tsome text" << std::endl;
+        }
+        // A row larger than the put area and than the ring buffers
+        auto longRow = std::string(10000, 'x');
+        file << longRow << '\n';
+        expected << longRow << '\n';
+    }
+    NS_TEST_ASSERT_MSG_EQ(ReadFile(closedFilename), expected.str(), "Wrong closed file");
+
+    // Reopened in append mode
+    {
+        NrTraceOfstream file(closedFilename, std::ios_base::app);
+        file << "appended" << std::endl;
+        expected << "appended" << std::endl;
+    }
+    NS_TEST_ASSERT_MSG_EQ(ReadFile(closedFilename), expected.str(), "Wrong appended file");
+
+    // Rows written, and file still open at Simulator::Destroy
+    auto openFilename = CreateTempDirFilename("nr-trace-io-open.txt");
+    NrTraceOfstream openFile(openFilename);
+    Simulator::Schedule(MilliSeconds(1), [&openFile]() { openFile << "first\t1" << std::endl; });
+    Simulator::Schedule(MilliSeconds(2), [&openFile]() { openFile << "second\t2\n"; });
+    Simulator::Run();
+    Simulator::Destroy();
+    NS_TEST_ASSERT_MSG_EQ(ReadFile(openFilename),
+                          "first\t1\nsecond\t2\n",
+                          "The open file was not flushed at Simulator::Destroy");
+    openFile.close();
+
+    // A file that cannot be opened
+    NrTraceOfstream invalidFile(CreateTempDirFilename("missing-dir/file.txt"));
+    NS_TEST_ASSERT_MSG_EQ(invalidFile.is_open(), false, "The file should not be open");
+    NS_TEST_ASSERT_MSG_EQ(invalidFile.fail(), true, "The failure should be reported");
+
+    Config::SetGlobal("NrAsyncTraceIo", async);
+    Config::SetGlobal("NrTraceIoBufferSize", bufferSize);
+}
+
+/**
+ * \brief Test suite for the trace I/O service
+ */
+class NrTestTraceIoServiceSuite : public TestSuite
+{
+  public:
+    NrTestTraceIoServiceSuite()
+        : TestSuite("nr-test-trace-io-service", Type::UNIT)
+    {
+        AddTestCase(new NrTraceIoServiceTestCase(false, 1 << 20), Duration::QUICK);
+        AddTestCase(new NrTraceIoServiceTestCase(true, 1 << 20), Duration::QUICK);
+        AddTestCase(new NrTraceIoServiceTestCase(true, 64), Duration::QUICK);
+    }
+};
+
+static NrTestTraceIoServiceSuite nrTestTraceIoServiceSuite; //!< Trace I/O service test suite
+
+} // namespace ns3